@@ -0,0 +1,539 @@
+#include "jobserver.h"
+
+#include "Wt/Http/Request.h"
+#include "Wt/Http/Response.h"
+#include "Wt/Json/Object.h"
+#include "Wt/Json/Array.h"
+#include "Wt/Json/Parser.h"
+#include "Wt/Json/Serializer.h"
+
+#include "base/exception.h"
+#include "rapidxml/rapidxml.hpp"
+
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/format.hpp"
+#include "boost/bind.hpp"
+
+#include <fstream>
+
+using namespace std;
+using namespace Wt;
+namespace bf = boost::filesystem;
+
+
+
+
+namespace
+{
+
+std::string stateName(AnalyzeJobServer::JobState s)
+{
+  switch (s)
+  {
+    case AnalyzeJobServer::Queued: return "queued";
+    case AnalyzeJobServer::Running: return "running";
+    case AnalyzeJobServer::Finished: return "finished";
+    case AnalyzeJobServer::Failed: return "failed";
+    case AnalyzeJobServer::Cancelled: return "cancelled";
+  }
+  return "unknown";
+}
+
+
+void answerText(Http::Response &response, int status, const std::string& text)
+{
+  response.setStatus(status);
+  response.setMimeType("text/plain");
+  response.out()<<text<<"\n";
+}
+
+}
+
+
+
+
+AnalyzeJobServer::Job::Job(
+    AnalyzeJobServer& server,
+    int id,
+    const std::string& analysisName,
+    const insight::ParameterSet& parameters,
+    const boost::filesystem::path& workdir
+    )
+  : AnalysisStatus(server),
+    id_(id),
+    analysisName_(analysisName),
+    parameters_(parameters),
+    workdir_(workdir),
+    state_(Queued),
+    cancelRequested_(false)
+{}
+
+
+Json::Object AnalyzeJobServer::Job::statusInfo() const
+{
+  auto s = AnalysisStatus::statusInfo();
+  s["id"] = id_;
+  s["state"] = WString(stateName(state_));
+  if (!errorMessage_.empty())
+  {
+    s["errorMessage"] = WString(errorMessage_);
+  }
+  return s;
+}
+
+
+int AnalyzeJobServer::Job::id() const
+{
+  return id_;
+}
+
+const std::string& AnalyzeJobServer::Job::analysisName() const
+{
+  return analysisName_;
+}
+
+const boost::filesystem::path& AnalyzeJobServer::Job::workdir() const
+{
+  return workdir_;
+}
+
+AnalyzeJobServer::JobState AnalyzeJobServer::Job::state() const
+{
+  boost::mutex::scoped_lock lock(mx_);
+  return state_;
+}
+
+
+void AnalyzeJobServer::Job::run()
+{
+  {
+    boost::mutex::scoped_lock lock(mx_);
+    if (cancelRequested_)
+    {
+      // cancelled while queued: the status event was recorded by cancel()
+      state_=Cancelled;
+      lock.unlock();
+      closeStream();
+      return;
+    }
+    state_=Running;
+  }
+  recordStatusEvent();
+
+  try
+  {
+    analysisPtr_.reset( insight::Analysis::lookup(analysisName_, parameters_, workdir_) );
+    setAnalysis( analysisPtr_.get() );
+
+    insight::ResultSetPtr results;
+    {
+      insight::AnalysisThread solverThread(analysisPtr_, this);
+      setSolverThread(&solverThread);
+
+      {
+        boost::mutex::scoped_lock lock(mx_);
+        if (cancelRequested_)
+        {
+          solverThread.interrupt();
+        }
+      }
+
+      try
+      {
+        results = solverThread.join();
+      }
+      catch (...)
+      {
+        setSolverThread(nullptr);
+        throw;
+      }
+      setSolverThread(nullptr);
+    }
+
+    {
+      boost::mutex::scoped_lock lock(mx_);
+      state_ = results ? Finished : Cancelled;
+    }
+
+    if (results)
+    {
+      setResults(results);
+    }
+    else
+    {
+      recordStatusEvent();
+      closeStream();
+    }
+  }
+  catch (const std::exception& e)
+  {
+    {
+      boost::mutex::scoped_lock lock(mx_);
+      state_=Failed;
+      errorMessage_=e.what();
+    }
+    std::cerr<<"Job "<<id_<<" failed: "<<e.what()<<std::endl;
+    recordStatusEvent();
+    closeStream();
+  }
+}
+
+
+void AnalyzeJobServer::Job::cancel()
+{
+  bool wasQueued=false;
+  {
+    boost::mutex::scoped_lock lock(mx_);
+    cancelRequested_=true;
+    if (state_==Queued)
+    {
+      state_=Cancelled;
+      wasQueued=true;
+    }
+  }
+
+  if (wasQueued)
+  {
+    // run() will not start it. The stream is closed now, the job may wait a long time in the queue.
+    recordStatusEvent();
+    closeStream();
+  }
+  else
+  {
+    interruptAnalysis();
+  }
+}
+
+
+
+
+AnalyzeJobServer::AnalyzeJobServer(
+    const std::string& srvname,
+    const std::string& listenAddr, int port,
+    const boost::filesystem::path& workdir,
+    int nWorkers
+    )
+  : Wt::WServer(srvname.c_str()),
+    workdir_(workdir),
+    nextJobId_(1),
+    stopping_(false)
+{
+  auto addr = boost::str(boost::format(listenAddr+":%d") % port);
+  const char *cargv[]={
+    srvname.c_str(),
+    "--docroot", ".",
+    "--http-listen", addr.c_str()
+  };
+
+  setServerConfiguration(5, const_cast<char**>(cargv) );
+
+  addResource(this, std::string());
+  addResource(this, "/jobs");
+
+  for (int i=0; i<std::max(1, nWorkers); i++)
+  {
+    workers_.create_thread( boost::bind(&AnalyzeJobServer::worker, this) );
+  }
+}
+
+
+AnalyzeJobServer::~AnalyzeJobServer()
+{
+  shutdownWorkers();
+}
+
+
+void AnalyzeJobServer::shutdownWorkers()
+{
+  {
+    boost::mutex::scoped_lock lock(jobsMx_);
+    stopping_=true;
+    for (auto& j: jobs_)
+    {
+      j.second->cancel();
+    }
+    jobsCv_.notify_all();
+  }
+  workers_.join_all();
+}
+
+
+void AnalyzeJobServer::worker()
+{
+  for (;;)
+  {
+    JobPtr job;
+    {
+      boost::mutex::scoped_lock lock(jobsMx_);
+      while (queue_.empty() && !stopping_)
+      {
+        jobsCv_.wait(lock);
+      }
+      if (stopping_)
+      {
+        return;
+      }
+      job=queue_.front();
+      queue_.pop_front();
+    }
+
+    job->run();
+  }
+}
+
+
+AnalyzeJobServer::JobPtr AnalyzeJobServer::submit(
+    const std::string& inputFileContents,
+    const boost::filesystem::path& workdir )
+{
+  std::string contents(inputFileContents); // modified by the parser
+
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(&contents[0]);
+
+  auto *rootnode = doc.first_node("root");
+  if (!rootnode)
+    throw insight::Exception("The input file contains no root node!");
+
+  auto *analysisnamenode = rootnode->first_node("analysis");
+  if (!analysisnamenode || !analysisnamenode->first_attribute("name"))
+    throw insight::Exception("The input file does not specify the analysis!");
+
+  std::string analysisName = analysisnamenode->first_attribute("name")->value();
+
+  // the job directory has to be inside the server workdir
+  if (!workdir.empty())
+  {
+    if (!workdir.is_relative())
+      throw insight::Exception("The job directory has to be relative to the server working directory!");
+    for (const auto& c: workdir)
+    {
+      if (c=="..")
+        throw insight::Exception("The job directory must not contain \"..\"!");
+    }
+  }
+
+  boost::mutex::scoped_lock lock(jobsMx_);
+
+  int id = nextJobId_++;
+
+  bf::path jobdir = workdir_ / ( workdir.empty() ? bf::path(str(boost::format("job%d") % id)) : workdir );
+  bf::create_directories(jobdir);
+
+  insight::ParameterSet parameters = insight::Analysis::defaultParameters(analysisName);
+  parameters.readFromNode(doc, *rootnode, jobdir);
+
+  auto job = std::make_shared<Job>(*this, id, analysisName, parameters, jobdir);
+  jobs_[id]=job;
+  queue_.push_back(job);
+  jobsCv_.notify_one();
+
+  std::cout<<"Queued job "<<id<<" ("<<analysisName<<") in directory "<<jobdir<<std::endl;
+
+  return job;
+}
+
+
+AnalyzeJobServer::JobPtr AnalyzeJobServer::findJob(const std::string& path, std::string& which)
+{
+  // path is /jobs/<id>[/<which>]
+  std::string rest = path.substr(std::string("/jobs/").size());
+  auto sep = rest.find('/');
+  which = sep==std::string::npos ? std::string() : rest.substr(sep);
+
+  int id;
+  try
+  {
+    id = boost::lexical_cast<int>(rest.substr(0, sep));
+  }
+  catch (const boost::bad_lexical_cast&)
+  {
+    return JobPtr();
+  }
+
+  boost::mutex::scoped_lock lock(jobsMx_);
+  auto j = jobs_.find(id);
+  if (j==jobs_.end())
+    return JobPtr();
+  return j->second;
+}
+
+
+void AnalyzeJobServer::removeJob(int id)
+{
+  boost::mutex::scoped_lock lock(jobsMx_);
+  jobs_.erase(id);
+}
+
+
+void AnalyzeJobServer::handleAbort(const Http::Request &request)
+{
+  std::string path = request.path() + request.pathInfo(), which;
+  if (boost::starts_with(path, "/jobs/"))
+  {
+    if (auto job = findJob(path, which))
+    {
+      job->handleStreamAbort(request);
+    }
+  }
+}
+
+
+void AnalyzeJobServer::handleRequest(const Http::Request &request, Http::Response &response)
+{
+  response.addHeader("Server", "InsightCAE analyze");
+
+  std::string path = request.path() + request.pathInfo();
+  while (path.size()>1 && path.back()=='/') path.pop_back();
+
+  Wt::Json::Object payload;
+  if (request.contentType()=="application/json")
+  {
+    std::string raw_payload(
+          std::istreambuf_iterator<char>(request.in()),
+          std::istreambuf_iterator<char>()
+          );
+    Wt::Json::parse(raw_payload, payload);
+  }
+
+  std::string action;
+  if (!payload.isNull("action"))
+  {
+    action = payload.get("action").toString();
+    boost::algorithm::to_lower(action);
+  }
+
+  if (path=="/jobs")
+  {
+    if (request.method()=="GET")
+    {
+      Json::Array jl;
+      {
+        boost::mutex::scoped_lock lock(jobsMx_);
+        for (const auto& j: jobs_)
+        {
+          Json::Object jo;
+          jo["id"]=j.first;
+          jo["analysisName"]=WString(j.second->analysisName());
+          jo["state"]=WString(stateName(j.second->state()));
+          jo["workdir"]=WString(j.second->workdir().string());
+          jl.push_back(jo);
+        }
+      }
+      Json::Object res;
+      res["jobs"]=jl;
+
+      response.setStatus(200);
+      response.setMimeType("application/json");
+      response.out()<<Wt::Json::serialize(res);
+      return;
+    }
+    else if (request.method()=="POST" && request.contentType()=="application/xml")
+    {
+      std::string contents(
+            std::istreambuf_iterator<char>(request.in()),
+            std::istreambuf_iterator<char>()
+            );
+
+      const std::string *workdir = request.getParameter("workdir");
+
+      try
+      {
+        auto job = submit(contents, workdir ? bf::path(*workdir) : bf::path());
+
+        Json::Object res;
+        res["id"]=job->id();
+        res["url"]=WString(str(boost::format("/jobs/%d") % job->id()));
+
+        response.setStatus(200);
+        response.setMimeType("application/json");
+        response.out()<<Wt::Json::serialize(res);
+      }
+      catch (const std::exception& e)
+      {
+        answerText(response, 400, std::string("Could not submit job: ")+e.what());
+      }
+      return;
+    }
+  }
+  else if (boost::starts_with(path, "/jobs/"))
+  {
+    std::string which;
+    auto job = findJob(path, which);
+
+    if (!job)
+    {
+      // waiting stream of a removed job: end the response
+      if (!request.continuation())
+      {
+        answerText(response, 404, "No such job");
+      }
+      return;
+    }
+
+    if (request.method()=="GET")
+    {
+      if (job->handleStatusRequest(request, response, which))
+      {
+        return;
+      }
+    }
+    else if (request.method()=="POST" && which.empty())
+    {
+      if (action=="kill")
+      {
+        job->cancel();
+        answerText(response, 200, "OK");
+        return;
+      }
+      else if (action=="exit")
+      {
+        job->cancel();
+        job->closeStream();
+        removeJob(job->id());
+        answerText(response, 200, "OK");
+        return;
+      }
+      else if (action=="wnow" || action=="wnowandstop")
+      {
+        if (job->state()!=Running)
+        {
+          answerText(response, 409, "Job is not running");
+          return;
+        }
+        // the solver's write-now function object polls for these files in the case directory
+        std::ofstream f( (job->workdir()/action).string() );
+        if (!f.good())
+        {
+          answerText(response, 500, "Could not signal the solver");
+          return;
+        }
+        answerText(response, 200, "OK");
+        return;
+      }
+    }
+  }
+  else if (path.empty() || path=="/")
+  {
+    if (request.method()=="POST" && action=="exit")
+    {
+      {
+        boost::mutex::scoped_lock lock(jobsMx_);
+        stopping_=true;
+        for (auto& j: jobs_)
+        {
+          j.second->cancel();
+          j.second->closeStream();
+        }
+        jobsCv_.notify_all();
+      }
+      scheduleStop();
+
+      answerText(response, 200, "OK");
+      return;
+    }
+  }
+
+  answerText(response, 400, "Malformed request");
+}
@@ -0,0 +1,123 @@
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+#include "restapi.h"
+
+#include "boost/filesystem.hpp"
+
+#include <deque>
+#include <memory>
+
+
+
+/**
+ * REST API server, which executes any number of submitted analyses
+ * on a pool of worker threads, instead of a single analysis per process.
+ * Loaded module libraries and the OpenFOAM environment configuration
+ * stay in memory between the jobs.
+ *
+ * Requests:
+ *  - POST /jobs (input file, application/xml): submit a job,
+ *    answers the job id. The optional parameter "workdir" selects the
+ *    execution directory relative to the server workdir (absolute paths and ".." are rejected),
+ *    otherwise a new subdirectory of the server workdir is used.
+ *  - GET /jobs: list of all jobs with their state
+ *  - GET /jobs/<id>/{next,all,latest,stream,results,exepath}:
+ *    same as for the single analysis server
+ *  - POST /jobs/<id> (action): "kill" interrupts the job,
+ *    "exit" interrupts and removes the job,
+ *    "wnow"/"wnowandstop" make a running OpenFOAM solver write (and stop)
+ *  - POST / (action "exit"): stops the server
+ */
+class AnalyzeJobServer
+: public Wt::WServer,
+  public Wt::WResource
+{
+public:
+  enum JobState { Queued, Running, Finished, Failed, Cancelled };
+
+  class Job
+  : public AnalysisStatus
+  {
+    int id_;
+    std::string analysisName_;
+    insight::ParameterSet parameters_;
+    boost::filesystem::path workdir_;
+
+    JobState state_;
+    std::string errorMessage_;
+    insight::AnalysisPtr analysisPtr_;
+    bool cancelRequested_;
+
+  protected:
+    Wt::Json::Object statusInfo() const override;
+
+  public:
+    Job(
+        AnalyzeJobServer& server,
+        int id,
+        const std::string& analysisName,
+        const insight::ParameterSet& parameters,
+        const boost::filesystem::path& workdir
+        );
+
+    int id() const;
+    const std::string& analysisName() const;
+    const boost::filesystem::path& workdir() const;
+    JobState state() const;
+
+    /**
+     * executes the analysis in the calling thread
+     */
+    void run();
+
+    /**
+     * prevents a queued job from being started and interrupts a running one
+     */
+    void cancel();
+  };
+
+  typedef std::shared_ptr<Job> JobPtr;
+
+protected:
+  boost::filesystem::path workdir_;
+
+  boost::mutex jobsMx_;
+  boost::condition_variable jobsCv_;
+  int nextJobId_;
+  std::map<int, JobPtr> jobs_;
+  std::deque<JobPtr> queue_;
+  bool stopping_;
+
+  boost::thread_group workers_;
+
+  void worker();
+
+  JobPtr submit(const std::string& inputFileContents, const boost::filesystem::path& workdir);
+  JobPtr findJob(const std::string& pathInfo, std::string& which);
+  void removeJob(int id);
+
+  void handleRequest(
+      const Wt::Http::Request &request,
+      Wt::Http::Response &response
+      ) override;
+
+  void handleAbort(const Wt::Http::Request& request) override;
+
+public:
+  AnalyzeJobServer(
+      const std::string& srvname,
+      const std::string& listenAddr, int port,
+      const boost::filesystem::path& workdir,
+      int nWorkers
+      );
+  ~AnalyzeJobServer();
+
+  /**
+   * cancels all jobs and waits for the workers to finish
+   */
+  void shutdownWorkers();
+};
+
+
+#endif // JOBSERVER_H
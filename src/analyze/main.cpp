@@ -45,6 +45,7 @@
 
 #ifdef HAVE_WT
 #include "restapi.h"
+#include "jobserver.h"
 #include "detectionhandler.h"
 #endif
 
@@ -80,9 +81,13 @@ int main(int argc, char *argv[])
       ("int,i", po::value<StringList>(), "int variable assignment")
       ("merge,m", po::value<StringList>(), "additional input file to merge into analysis parameters before variable assignments")
       ("libs", po::value< StringList >(),"Additional libraries with analysis modules to load")
+      ("index-library", po::value< std::string >(), "Write the index of the analyses in the given module library (to the file given by --index-file) and exit. Modules with index are loaded on demand.")
+      ("index-file", po::value< std::string >(), "Output file of --index-library")
       ("input-file,f", po::value< std::string >(),"Specifies input file.")
 #ifdef HAVE_WT
       ("server", "Start with REST API server. Keeps the application running after the analysis has finished. Once the result set is fetched via the REST API, the application exits.")
+      ("jobserver", "Start a REST API server, which accepts any number of analysis submissions and keeps running, until it is stopped. The jobs are executed in subdirectories of the workdir.")
+      ("workers", po::value<int>()->default_value(1), "Number of analyses, which are executed concurrently by the job server")
       ("listen", po::value<std::string>()->default_value("127.0.0.1"), "Server address")
       ("port", po::value<int>()->default_value(8090), "Server port")
       ("broadcastport", po::value<int>()->default_value(8090), "Broadcast listen port")
@@ -133,6 +138,27 @@ int main(int argc, char *argv[])
       exit(0);
     }
 
+    if (vm.count("index-library"))
+    {
+      if (!vm.count("index-file"))
+      {
+        std::cerr << "The output file of the module index has to be specified!" << std::endl;
+        exit(-1);
+      }
+      try
+      {
+        AnalysisLibraryLoader::writeIndex(
+              vm["index-library"].as<std::string>(),
+              vm["index-file"].as<std::string>() );
+      }
+      catch (const std::exception& e)
+      {
+        std::cerr << e.what() << std::endl;
+        exit(-1);
+      }
+      exit(0);
+    }
+
     boost::filesystem::path workdir = boost::filesystem::current_path();
     std::string filestem = "analysis";
 
@@ -147,9 +173,39 @@ int main(int argc, char *argv[])
 
 #ifdef HAVE_WT
     std::unique_ptr<AnalyzeRESTServer> server;
+    std::unique_ptr<AnalyzeJobServer> jobServer;
     std::unique_ptr<DetectionHandler> detectionHandler;
 
-    if (vm.count("server"))
+    if (vm.count("jobserver"))
+    {
+      if (vm.count("server") || vm.count("input-file"))
+      {
+        std::cerr << "The job server mode cannot be combined with the single analysis server or an input file!" << std::endl;
+        exit(-1);
+      }
+
+      jobServer.reset(new AnalyzeJobServer(
+                     argv[0],
+                     vm["listen"].as<std::string>(),
+                     vm["port"].as<int>(),
+                     workdir,
+                     vm["workers"].as<int>()
+          ));
+
+      if (!jobServer->start())
+      {
+        std::cerr << "Could not start web server!" << std::endl;
+        exit(-1);
+      }
+
+      detectionHandler = DetectionHandler::start(
+                      vm["broadcastport"].as<int>(),
+                      vm["listen"].as<std::string>(),
+                      vm["port"].as<int>(),
+                      analysisName
+                    );
+    }
+    else if (vm.count("server"))
     {
 
       server.reset(new AnalyzeRESTServer(
@@ -208,6 +264,19 @@ int main(int argc, char *argv[])
                 loader.addLibrary(l);
             }
         }
+
+#ifdef HAVE_WT
+        if (jobServer)
+        {
+          // the libraries stay loaded for all jobs
+          cout<<"Running as job server in directory "<<workdir<<endl;
+          jobServer->waitForShutdown();
+          jobServer->shutdownWorkers();
+          jobServer->stop();
+          summarizeWarnings();
+          return 0;
+        }
+#endif
         
         std::string contents;
 
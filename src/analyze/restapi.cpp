@@ -9,8 +9,13 @@
 #include "Wt/Json/Serializer.h"
 
 #include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/iostreams/filtering_stream.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
+#include "boost/iostreams/device/back_inserter.hpp"
 
 #include <csignal>
+#include <sstream>
 
 using namespace std;
 using namespace Wt;
@@ -79,13 +84,23 @@ void globalSignalHandler(int sig)
 
 
 
-double AnalyzeRESTServer::nextStateInfo(
-    Json::Object &s
-    )
+
+namespace
 {
-  auto& pi = recordedStates_.front();
-  double t = pi.first; //copy (non-reference) for proper use as return value
-  s["time"]=t;
+
+// events, which follow each other more closely, are merged in the stream
+const auto streamCoalescingInterval = std::chrono::milliseconds(100);
+
+// maximum number of events kept for subscribers, which (re-)connect later
+const size_t maxStreamEvents = 10000;
+
+// size of the pieces, in which the content of result files is sent
+const size_t fileTransferPieceSize = 1<<20;
+
+
+void stateInfo(const insight::ProgressState& pi, Json::Object &s)
+{
+  s["time"]=pi.first;
   Wt::Json::Object pvl;
   for (const auto& cpv: pi.second)
   {
@@ -93,13 +108,57 @@ double AnalyzeRESTServer::nextStateInfo(
   }
   s["ProgressVariableList"]=pvl;
   s["logMessage"]=Wt::WString(pi.logMessage_);
+}
+
+
+Json::Object singleEntryEvent(const std::string& listName, const Json::Object& entry)
+{
+  Json::Array list;
+  list.push_back(entry);
+  Json::Object ev;
+  ev[listName]=list;
+  return ev;
+}
+
+
+/**
+ * writes a server-sent event.
+ * Each line of the data needs its own "data:" prefix.
+ */
+void writeStreamEvent(std::ostream& os, const std::string& data, const std::uint64_t* id = nullptr)
+{
+  if (id)
+  {
+    os << "id: " << *id << "\n";
+  }
+  std::istringstream is(data);
+  std::string line;
+  while (std::getline(is, line))
+  {
+    os << "data: " << line << "\n";
+  }
+  os << "\n";
+}
+
+}
+
+
+
+
+double AnalysisStatus::nextStateInfo(
+    Json::Object &s
+    )
+{
+  auto& pi = recordedStates_.front();
+  double t = pi.first; //copy (non-reference) for proper use as return value
+  stateInfo(pi, s);
 
   recordedStates_.pop_front();
   return t;
 }
 
 
-void AnalyzeRESTServer::nextProgressInfo(
+void AnalysisStatus::nextProgressInfo(
     Json::Object &s
     )
 {
@@ -125,53 +184,148 @@ void AnalyzeRESTServer::nextProgressInfo(
 
 
 
+Json::Object AnalysisStatus::statusInfo() const
+{
+  Json::Object s;
+  s["resultsAvailable"] = results_ ? true : false;
+  return s;
+}
 
 
 
-AnalyzeRESTServer::AnalyzeRESTServer(
-    const std::string& srvname,
-    const std::string& listenAddr, int port
-    )
-  : Wt::WServer(srvname.c_str()),
-    analysisThread_(nullptr),
-    analysis_(nullptr)
+
+void AnalysisStatus::recordStatusEvent()
 {
+  Json::Object s;
+  {
+    boost::mutex::scoped_lock lock(mx_);
+    s=statusInfo();
+  }
+  recordStreamEvent(s);
+}
 
-  auto addr = boost::str(boost::format(listenAddr+":%d") % port);
-  const char *cargv[]={
-    srvname.c_str(),
-    "--docroot", ".",
-    "--http-listen", addr.c_str()
-  };
 
-  setServerConfiguration(5, const_cast<char**>(cargv) );
 
-  addResource(this, std::string());
-  addResource(this, "/next");
-  addResource(this, "/all");
-  addResource(this, "/latest");
-  addResource(this, "/results");
-  addResource(this, "/exepath");
+
+void AnalysisStatus::recordStreamEvent(const Json::Object& ev, const std::string& coalescingKey)
+{
+  auto data = Wt::Json::serialize(ev);
+  auto now = std::chrono::steady_clock::now();
+  bool wakeSubscribers = true;
+
+  {
+    boost::mutex::scoped_lock lock(mx_);
+
+    if ( !coalescingKey.empty()
+         && streamEvents_.size()>0
+         && streamEvents_.back().coalescingKey==coalescingKey
+         && (now - streamEvents_.back().time) < streamCoalescingInterval )
+    {
+      // replace the previous event. It gets a new id, so that
+      // subscribers, which have already received it, get the update as well.
+      // The time of the first event is kept, which limits the event rate.
+      auto& last = streamEvents_.back();
+      last.id = nextEventId_++;
+      last.data = data;
+
+      // deliver at the end of the interval, if nothing else wakes the subscribers.
+      // The resource outlives this object, so only the resource is used in the callback.
+      wakeSubscribers = false;
+      if (now >= flushDue_)
+      {
+        flushDue_ = last.time + streamCoalescingInterval;
+        auto& resource = streamResource_;
+        Wt::WServer::instance()->ioService().schedule(
+              flushDue_ - now,
+              [&resource]()
+              {
+                resource.haveMoreData();
+              }
+        );
+      }
+    }
+    else
+    {
+      streamEvents_.push_back( StreamEvent{ nextEventId_++, coalescingKey, now, data } );
+      while (streamEvents_.size()>maxStreamEvents)
+      {
+        streamEvents_.pop_front();
+      }
+    }
+  }
+
+  if (wakeSubscribers)
+  {
+    streamResource_.haveMoreData();
+  }
+}
+
+
+
+
+void AnalysisStatus::closeStream()
+{
+  {
+    boost::mutex::scoped_lock lock(mx_);
+    streamClosed_ = true;
+  }
+  streamResource_.haveMoreData();
 }
 
 
-void AnalyzeRESTServer::setAnalysis(insight::Analysis *a)
+
+
+
+
+
+AnalysisStatus::AnalysisStatus(Wt::WResource& streamResource)
+  : streamResource_(streamResource),
+    analysisThread_(nullptr),
+    analysis_(nullptr),
+    nextEventId_(0),
+    streamClosed_(false)
+{}
+
+
+AnalysisStatus::~AnalysisStatus()
+{}
+
+
+void AnalysisStatus::setAnalysis(insight::Analysis *a)
 {
   analysis_=a;
 }
 
-void AnalyzeRESTServer::setSolverThread(insight::AnalysisThread *at)
+void AnalysisStatus::setSolverThread(insight::AnalysisThread *at)
 {
+  boost::mutex::scoped_lock lock(mx_);
   analysisThread_=at;
 }
 
-void AnalyzeRESTServer::setResults(insight::ResultSetPtr results)
+void AnalysisStatus::setResults(insight::ResultSetPtr results)
 {
-  results_=results;
+  {
+    boost::mutex::scoped_lock lock(mx_);
+    results_=results;
+    resultSkeleton_.clear();
+    compressedResultFiles_.clear();
+  }
+  recordStatusEvent();
 }
 
+bool AnalysisStatus::interruptAnalysis()
+{
+  boost::mutex::scoped_lock lock(mx_);
+  if (analysisThread_)
+  {
+    analysisThread_->interrupt();
+    return true;
+  }
+  return false;
+}
 
-void AnalyzeRESTServer::update(
+
+void AnalysisStatus::update(
     const insight::ProgressState& pi
     )
 {
@@ -179,30 +333,405 @@ void AnalyzeRESTServer::update(
   mx_.lock();
   recordedStates_.push_back(pi);
   mx_.unlock();
+
+  Json::Object s;
+  stateInfo(pi, s);
+  // log messages must not get lost, pure residual updates may be merged
+  recordStreamEvent(
+        singleEntryEvent("states", s),
+        pi.logMessage_.empty() ? "state" : "" );
 }
 
-void AnalyzeRESTServer::setActionProgressValue(const string &path, double value)
+void AnalysisStatus::setActionProgressValue(const string &path, double value)
 {
   TextProgressDisplayer::setActionProgressValue(path, value);
   mx_.lock();
   recordedProgressStates_.push_back( ProgressState{ path, value } );
   mx_.unlock();
+
+  Json::Object s;
+  s["path"]=Wt::WString(path);
+  s["double"]=value;
+  recordStreamEvent(singleEntryEvent("progressStates", s), "progress:"+path);
 }
 
-void AnalyzeRESTServer::setMessageText(const string &path, const string &message)
+void AnalysisStatus::setMessageText(const string &path, const string &message)
 {
   TextProgressDisplayer::setMessageText(path, message);
   mx_.lock();
   recordedProgressStates_.push_back( ProgressState{ path, message } );
   mx_.unlock();
+
+  Json::Object s;
+  s["path"]=Wt::WString(path);
+  s["text"]=Wt::WString(message);
+  recordStreamEvent(singleEntryEvent("progressStates", s));
 }
 
-void AnalyzeRESTServer::finishActionProgress(const string &path)
+void AnalysisStatus::finishActionProgress(const string &path)
 {
   TextProgressDisplayer::finishActionProgress(path);
   mx_.lock();
   recordedProgressStates_.push_back( ProgressState{ path, boost::blank() } );
   mx_.unlock();
+
+  Json::Object s;
+  s["path"]=Wt::WString(path);
+  recordStreamEvent(singleEntryEvent("progressStates", s));
+}
+
+
+void AnalysisStatus::handleStreamRequest(const Http::Request &request, Http::Response &response)
+{
+  auto *continuation = request.continuation();
+  std::uint64_t nextId = 0;
+
+  boost::mutex::scoped_lock lock(mx_);
+
+  if (!continuation)
+  {
+    // new subscriber: start with the current status and all recorded events
+    // or continue after the last event, which was received before a reconnect
+    response.setStatus(200);
+    response.setMimeType("text/event-stream");
+    response.addHeader("Cache-Control", "no-cache");
+
+    auto lastEventId = request.headerValue("Last-Event-ID");
+    if (!lastEventId.empty())
+    {
+      try
+      {
+        nextId = boost::lexical_cast<std::uint64_t>(lastEventId) + 1;
+      }
+      catch (const boost::bad_lexical_cast&)
+      {}
+    }
+
+    writeStreamEvent(response.out(), Wt::Json::serialize(statusInfo()));
+  }
+  else
+  {
+    auto s = subscribers_.find(continuation);
+    if (s!=subscribers_.end())
+    {
+      nextId = s->second;
+      subscribers_.erase(s);
+    }
+  }
+
+  for (const auto& e: streamEvents_)
+  {
+    if (e.id>=nextId)
+    {
+      writeStreamEvent(response.out(), e.data, &e.id);
+      nextId = e.id+1;
+    }
+  }
+
+  if (!streamClosed_)
+  {
+    continuation = response.createContinuation();
+    subscribers_[continuation] = nextId;
+    continuation->waitForMoreData();
+  }
+}
+
+
+void AnalysisStatus::writeFilePiece(Http::Response &response, FileTransfer ft)
+{
+  size_t n = std::min(fileTransferPieceSize, ft.size-ft.offset);
+  response.out().write(ft.data+ft.offset, n);
+  ft.offset += n;
+
+  if (ft.offset<ft.size)
+  {
+    // Wt continues, when this piece has been sent
+    fileTransfers_[response.createContinuation()] = ft;
+  }
+}
+
+
+bool AnalysisStatus::handleStatusRequest(
+    const Http::Request &request,
+    Http::Response &response,
+    const std::string& requestedPath )
+{
+  std::string which = boost::algorithm::to_lower_copy(requestedPath);
+
+  if (which=="/stream")
+  {
+    handleStreamRequest(request, response);
+    return true;
+  }
+
+  boost::mutex::scoped_lock lock(mx_);
+
+  enum StateSelection {
+    Next, All, Latest, Results, ResultSkeleton, ResultFile, ExePath
+  } stateSelection = Next;
+  if (which=="/next")
+  {
+    stateSelection = Next;
+  }
+  else if (which=="/all")
+  {
+    stateSelection = All;
+  }
+  else if (which=="/latest")
+  {
+    stateSelection = Latest;
+  }
+  else if (which=="/results")
+  {
+    stateSelection = Results;
+  }
+  else if (which=="/results/skeleton")
+  {
+    stateSelection = ResultSkeleton;
+  }
+  else if (which=="/results/file")
+  {
+    stateSelection = ResultFile;
+  }
+  else if (which=="/exepath")
+  {
+    stateSelection = ExePath;
+  }
+
+  if (stateSelection==Results)
+  {
+    if (results_)
+    {
+      response.setStatus(200);
+      response.setMimeType("application/xml");
+      results_->saveToStream( response.out() );
+
+      return true;
+    }
+  }
+  else if (stateSelection==ResultSkeleton)
+  {
+    if (results_)
+    {
+      if (resultSkeleton_.empty())
+      {
+        std::ostringstream os;
+        results_->skeleton()->saveToStream(os);
+        resultSkeleton_=os.str();
+      }
+
+      response.setStatus(200);
+      response.setMimeType("application/xml");
+      response.out() << resultSkeleton_;
+
+      return true;
+    }
+  }
+  else if (stateSelection==ResultFile)
+  {
+    if (auto *continuation = request.continuation())
+    {
+      auto t = fileTransfers_.find(continuation);
+      if (t!=fileTransfers_.end())
+      {
+        FileTransfer ft = t->second;
+        fileTransfers_.erase(t);
+        writeFilePiece(response, ft);
+      }
+      return true;
+    }
+
+    const std::string *path = request.getParameter("path");
+    if (results_ && path)
+    {
+      insight::FileContainer* fc = nullptr;
+      try
+      {
+        fc = dynamic_cast<insight::FileContainer*>(
+              &results_->get<insight::ResultElement>(*path) );
+      }
+      catch (const insight::Exception&)
+      {}
+
+      if (!fc || !fc->hasFileContent())
+      {
+        response.setStatus(404);
+        response.setMimeType("text/plain");
+        response.out()<<"No file content for result element "<<*path<<"\n";
+        return true;
+      }
+
+      const std::string *compression = request.getParameter("compression");
+      bool gzip = compression && (*compression=="gzip");
+
+      FileTransfer ft;
+      ft.results = results_;
+      ft.data = fc->binaryFileContent();
+      ft.size = fc->binaryFileContentSize();
+      ft.offset = 0;
+
+      // the offset refers to the transferred (possibly compressed) data,
+      // X-Content-Size to its complete size
+      if (gzip)
+      {
+        auto c = compressedResultFiles_.find(*path);
+        if (c!=compressedResultFiles_.end())
+        {
+          ft.compressed = c->second;
+        }
+        else
+        {
+          // the result set is kept alive by ft, the status updates need not wait
+          lock.unlock();
+          auto compressed = std::make_shared<std::string>();
+          {
+            boost::iostreams::filtering_ostream out;
+            out.push(boost::iostreams::gzip_compressor());
+            out.push(boost::iostreams::back_inserter(*compressed));
+            out.write(ft.data, ft.size);
+            out.reset(); // completes the gzip stream
+          }
+          lock.lock();
+          ft.compressed = compressed;
+          if (results_==ft.results)
+          {
+            compressedResultFiles_[*path] = compressed;
+          }
+        }
+        ft.data = ft.compressed->data();
+        ft.size = ft.compressed->size();
+      }
+
+      // resume a broken transfer
+      if (const std::string *o = request.getParameter("offset"))
+      {
+        try
+        {
+          ft.offset = std::min( boost::lexical_cast<size_t>(*o), ft.size );
+        }
+        catch (const boost::bad_lexical_cast&)
+        {
+          return false;
+        }
+      }
+
+      response.setStatus(200);
+      response.setMimeType(gzip ? "application/gzip" : "application/octet-stream");
+      response.addHeader("X-Content-Size", boost::lexical_cast<std::string>(ft.size));
+      writeFilePiece(response, ft);
+
+      return true;
+    }
+  }
+  else if (stateSelection==ExePath)
+  {
+    if (analysis_)
+    {
+      response.setStatus(200);
+      response.setMimeType("text/plain");
+      response.out() << analysis_->executionPath();
+
+      return true;
+    }
+  }
+  else
+  {
+    Wt::Json::Object res=statusInfo(), state, progressState;
+    Wt::Json::Array states, progressStates;
+
+    if (recordedStates_.size()>0)
+    {
+      if (stateSelection==Next)
+      {
+        nextStateInfo(state);
+        states.push_back(state);
+      }
+      else if (stateSelection==All)
+      {
+        while (recordedStates_.size()>0)
+        {
+          nextStateInfo(state);
+          states.push_back(state);
+        }
+      }
+      else if (stateSelection==Latest)
+      {
+        // discard everything up to latest
+        while (recordedStates_.size()>1)
+        {
+          recordedStates_.pop_front();
+        }
+        if (recordedStates_.size()>0)
+        {
+          nextStateInfo(state);
+          states.push_back(state);
+        }
+      }
+    }
+
+    while (recordedProgressStates_.size()>0)
+    {
+      nextProgressInfo(progressState);
+      progressStates.push_back(progressState);
+    }
+
+    res["states"] = states;
+    res["progressStates"] = progressStates;
+
+    response.setStatus(200);
+    response.setMimeType("application/json");
+    response.out()<<Wt::Json::serialize(res);
+
+    return true;
+  }
+
+  return false;
+}
+
+
+void AnalysisStatus::handleStreamAbort(const Http::Request &request)
+{
+  boost::mutex::scoped_lock lock(mx_);
+  subscribers_.erase(request.continuation());
+  fileTransfers_.erase(request.continuation());
+}
+
+
+AnalyzeRESTServer::AnalyzeRESTServer(
+    const std::string& srvname,
+    const std::string& listenAddr, int port
+    )
+  : Wt::WServer(srvname.c_str()),
+    AnalysisStatus(static_cast<Wt::WResource&>(*this)),
+    inputFileContents_(nullptr)
+{
+
+  auto addr = boost::str(boost::format(listenAddr+":%d") % port);
+  const char *cargv[]={
+    srvname.c_str(),
+    "--docroot", ".",
+    "--http-listen", addr.c_str()
+  };
+
+  setServerConfiguration(5, const_cast<char**>(cargv) );
+
+  addResource(this, std::string());
+  addResource(this, "/next");
+  addResource(this, "/all");
+  addResource(this, "/latest");
+  addResource(this, "/stream");
+  addResource(this, "/results");
+  addResource(this, "/results/skeleton");
+  addResource(this, "/results/file");
+  addResource(this, "/exepath");
+}
+
+
+Json::Object AnalyzeRESTServer::statusInfo() const
+{
+  auto s = AnalysisStatus::statusInfo();
+  s["inputFileReceived"] = inputFileContents_ && hasInputFileReceived();
+  return s;
 }
 
 
@@ -245,6 +774,12 @@ bool AnalyzeRESTServer::waitForResultDelivery()
   return sig==0;
 }
 
+void AnalyzeRESTServer::handleAbort(const Http::Request &request)
+{
+  handleStreamAbort(request);
+}
+
+
 void AnalyzeRESTServer::handleRequest(const Http::Request &request, Http::Response &response)
 {
 
@@ -267,106 +802,11 @@ void AnalyzeRESTServer::handleRequest(const Http::Request &request, Http::Respon
   {
     std::cerr<<"status or results request"<<std::endl;
 
-
-    //auto whichState = payload.get("whichState");
     std::string which = request.path();
     cout<<"which="<<which<<endl;
-    enum StateSelection { Next, All, Latest, Results, ExePath } stateSelection = Next;
-//    if (!whichState.isNull())
-    {
-//      std::string which = whichState.toString();
-      boost::algorithm::to_lower(which);
-      if (which=="/next")
-      {
-        stateSelection = Next;
-      }
-      else if (which=="/all")
-      {
-        stateSelection = All;
-      }
-      else if (which=="/latest")
-      {
-        stateSelection = Latest;
-      }
-      else if (which=="/results")
-      {
-        stateSelection = Results;
-      }
-      else if (which=="/exepath")
-      {
-        stateSelection = ExePath;
-      }
-    }
 
-    if (stateSelection==Results)
+    if (handleStatusRequest(request, response, which))
     {
-      if (results_)
-      {
-        response.setStatus(200);
-        response.setMimeType("application/xml");
-        results_->saveToStream( response.out() );
-
-        return;
-      }
-    }
-    else if (stateSelection==ExePath)
-    {
-      response.setStatus(200);
-      response.setMimeType("text/plain");
-      response.out() << analysis_->executionPath();
-
-      return;
-    }
-    else
-    {
-      Wt::Json::Object res, state, progressState;
-      Wt::Json::Array states, progressStates;
-
-      if (recordedStates_.size()>0)
-      {
-        if (stateSelection==Next)
-        {
-          nextStateInfo(state);
-          states.push_back(state);
-        }
-        else if (stateSelection==All)
-        {
-          while (recordedStates_.size()>0)
-          {
-            nextStateInfo(state);
-            states.push_back(state);
-          }
-        }
-        else if (stateSelection==Latest)
-        {
-          // discard everything up to latest
-          while (recordedStates_.size()>1)
-          {
-            recordedStates_.pop_front();
-          }
-          if (recordedStates_.size()>0)
-          {
-            nextStateInfo(state);
-            states.push_back(state);
-          }
-        }
-      }
-
-      while (recordedProgressStates_.size()>0)
-      {
-        nextProgressInfo(progressState);
-        progressStates.push_back(progressState);
-      }
-
-      res["states"] = states;
-      res["progressStates"] = progressStates;
-      res["inputFileReceived"] = hasInputFileReceived();
-      res["resultsAvailable"] = results_ ? true : false;
-
-      response.setStatus(200);
-      response.setMimeType("application/json");
-      response.out()<<Wt::Json::serialize(res);
-
       return;
     }
   }
@@ -389,6 +829,7 @@ void AnalyzeRESTServer::handleRequest(const Http::Request &request, Http::Respon
         results_.reset();
         wait_cv_.notify_all();
       }
+      recordStatusEvent();
 
       return;
     }
@@ -401,9 +842,8 @@ void AnalyzeRESTServer::handleRequest(const Http::Request &request, Http::Respon
         boost::algorithm::to_lower(action);
         if (action=="kill")
         {
-          if (analysisThread_)
+          if (interruptAnalysis())
           {
-            analysisThread_->interrupt();
             response.setStatus(200);
             response.setMimeType("text/plain");
             response.out()<<"OK\n";
@@ -412,10 +852,8 @@ void AnalyzeRESTServer::handleRequest(const Http::Request &request, Http::Respon
         }
         else if (action=="exit")
         {
-          if (analysisThread_)
-          {
-            analysisThread_->interrupt();
-          }
+          interruptAnalysis();
+          closeStream();
           scheduleStop();
 
           response.setStatus(200);
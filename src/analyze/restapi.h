@@ -7,20 +7,32 @@
 
 #include <Wt/WServer.h>
 #include <Wt/WResource.h>
+#include <Wt/Http/ResponseContinuation.h>
 
 #include "Wt/Json/Object.h"
 
+#include <chrono>
+#include <map>
 
 
-class AnalyzeRESTServer
-: public Wt::WServer,
-  public Wt::WResource,
-  public insight::TextProgressDisplayer
+
+/**
+ * Records the progress and the results of one analysis
+ * and answers the status requests of the REST API for it.
+ *
+ * The waiting /stream requests are continuations of the resource,
+ * which was given in the constructor. That resource may serve several analyses.
+ */
+class AnalysisStatus
+: public insight::TextProgressDisplayer
 {
+protected:
+  Wt::WResource& streamResource_;
+
   insight::AnalysisThread* analysisThread_;
   insight::Analysis* analysis_;
 
-  boost::mutex mx_;
+  mutable boost::mutex mx_;
   std::deque<insight::ProgressState> recordedStates_;
 
   typedef
@@ -38,29 +50,136 @@ class AnalyzeRESTServer
   std::deque<ProgressState> recordedProgressStates_;
 
   insight::ResultSetPtr results_;
-  std::string* inputFileContents_;
+  std::string resultSkeleton_; // serialized, once requested
 
-  boost::condition_variable wait_cv_;
+  // gzip compressed file contents of the result elements, once requested
+  std::map<std::string, std::shared_ptr<const std::string> > compressedResultFiles_;
+
+  /**
+   * a running transfer of /results/file.
+   * The content is sent in pieces, each one as a continuation of the response.
+   */
+  struct FileTransfer
+  {
+    insight::ResultSetPtr results; // keeps the uncompressed content alive
+    std::shared_ptr<const std::string> compressed;
+    const char* data;
+    size_t size, offset;
+  };
+  std::map<Wt::Http::ResponseContinuation*, FileTransfer> fileTransfers_;
+
+  /**
+   * event log for the subscribers of /stream.
+   * Each event is serialized once, when it is recorded.
+   * Consecutive events with the same coalescing key (residual updates,
+   * progress values of one action), which arrive within a short interval,
+   * replace each other.
+   */
+  struct StreamEvent
+  {
+    std::uint64_t id;
+    std::string coalescingKey;
+    std::chrono::steady_clock::time_point time;
+    std::string data;
+  };
+  std::deque<StreamEvent> streamEvents_;
+  std::uint64_t nextEventId_;
+  std::chrono::steady_clock::time_point flushDue_;
+  bool streamClosed_;
+
+  // id of the next event to send, for each waiting subscriber
+  std::map<Wt::Http::ResponseContinuation*, std::uint64_t> subscribers_;
 
   double nextStateInfo(Wt::Json::Object& ro);
   void nextProgressInfo(Wt::Json::Object& ro);
 
-public:
-  AnalyzeRESTServer(
-      const std::string& srvname,
-      const std::string& listenAddr, int port
+  /**
+   * status flags, which are sent with each status answer.
+   * Called with locked mutex.
+   */
+  virtual Wt::Json::Object statusInfo() const;
+
+  void recordStreamEvent(const Wt::Json::Object& ev, const std::string& coalescingKey = std::string());
+  void recordStatusEvent();
+
+  void handleStreamRequest(
+      const Wt::Http::Request &request,
+      Wt::Http::Response &response
       );
 
+  /**
+   * writes the next piece of the file and continues the response, if there is more.
+   * Called with locked mutex.
+   */
+  void writeFilePiece(Wt::Http::Response &response, FileTransfer ft);
+
+public:
+  AnalysisStatus(Wt::WResource& streamResource);
+  virtual ~AnalysisStatus();
 
   void setAnalysis(insight::Analysis* a);
   void setSolverThread(insight::AnalysisThread* at);
   void setResults(insight::ResultSetPtr results);
 
+  /**
+   * interrupts the analysis thread, if there is one.
+   * Returns false, if no analysis is running.
+   */
+  bool interruptAnalysis();
+
+  /**
+   * ends all subscriptions to the event stream, after the recorded events are sent
+   */
+  void closeStream();
+
   void update( const insight::ProgressState& pi ) override;
   void setActionProgressValue(const std::string &path, double value) override;
   void setMessageText(const std::string &path, const std::string& message) override;
   void finishActionProgress(const std::string &path) override;
 
+  /**
+   * answers a GET request for the analysis status.
+   * which is the requested path relative to the analysis
+   * (/next, /all, /latest, /stream, /results, /results/skeleton,
+   * /results/file or /exepath).
+   *
+   * /results/skeleton delivers the result set without file contents,
+   * /results/file?path=<element path>[&offset=<bytes>][&compression=gzip]
+   * the content of a single file element, starting from offset.
+   * The offset counts the transferred bytes, i.e. the compressed data with gzip.
+   * The compressed content is cached, so that resuming does not compress again.
+   * Returns false, if the request could not be answered.
+   */
+  bool handleStatusRequest(
+      const Wt::Http::Request &request,
+      Wt::Http::Response &response,
+      const std::string& which
+      );
+
+  void handleStreamAbort(const Wt::Http::Request& request);
+};
+
+
+
+
+class AnalyzeRESTServer
+: public Wt::WServer,
+  public Wt::WResource,
+  public AnalysisStatus
+{
+  std::string* inputFileContents_;
+
+  boost::condition_variable wait_cv_;
+
+protected:
+  Wt::Json::Object statusInfo() const override;
+
+public:
+  AnalyzeRESTServer(
+      const std::string& srvname,
+      const std::string& listenAddr, int port
+      );
+
   bool hasResultsDelivered() const;
   bool waitForResultDelivery();
 
@@ -73,6 +192,8 @@ protected:
         const Wt::Http::Request &request,
         Wt::Http::Response &response
         ) override;
+
+    void handleAbort(const Wt::Http::Request& request) override;
 };
 
 
@@ -21,6 +21,8 @@
 #include "geotest.h"
 
 #include <memory>
+#include <mutex>
+#include <list>
 
 #include "cadfeature.h"
 #include "datum.h"
@@ -472,6 +474,7 @@ void Feature::setShape(const TopoDS_Shape& shape)
 {
   volprops_.reset();
   shape_=shape;
+  visMeshed_=false;
   nameFeatures();
   setValid();
 }
@@ -561,6 +564,7 @@ const std::string& Feature::featureSymbolName() const
 void Feature::setVisResolution( ScalarPtr r )
 { 
     visresolution_=r;
+    visMeshed_=false; // re-triangulate with the new resolution on next access
 }
 
 
@@ -715,6 +719,9 @@ Feature& Feature::operator=(const Feature& o)
   density_=o.density_;
   areaWeight_=o.areaWeight_;
 
+  // the copied shape was not necessarily triangulated with this resolution
+  visMeshed_=false;
+
   if (o.valid())
   {
     if (o.volprops_)
@@ -951,7 +958,7 @@ arma::mat Feature::modelBndBox(double deflection) const
   
   if (deflection>0)
   {
-      BRepMesh_IncrementalMesh Inc(shape(), deflection);
+      triangulate(shape(), deflection);
   }
 
   Bnd_Box boundingBox;
@@ -1450,7 +1457,7 @@ void Feature::saveAs
 
   else if ( (ext==".stl") || (ext==".stlb") )
   {
-    BRepMesh_IncrementalMesh Inc(shape(), 1e-2);
+    triangulate(shape(), 1e-2);
     StlAPI_Writer stlwriter;
 
     stlwriter.ASCIIMode() = (ext==".stl");
@@ -1593,7 +1600,7 @@ const TopoDS_Shape& Feature::shape() const
 
   checkForBuildDuringAccess();
 
-  if (visresolution_)
+  if (visresolution_ && !visMeshed_)
   {
 //     Bnd_Box box;
 //     BRepMesh_FastDiscret m
@@ -1603,18 +1610,107 @@ const TopoDS_Shape& Feature::shape() const
 //       true, false, false, false
 //     );
 //     m.Perform(shape_);  
-    BRepMesh_IncrementalMesh aMesher(shape_, visresolution_->value());
+    triangulate(shape_, visresolution_->value());
+    visMeshed_=true;
   }
   return shape_;
 }
 
 
+namespace
+{
+
+// serializes all meshing of feature shapes outside the GUI thread
+std::mutex meshMutex;
+
+bool hasTriangulation(const TopoDS_Shape& s, double deflection)
+{
+  for (TopExp_Explorer ex(s, TopAbs_FACE); ex.More(); ex.Next())
+  {
+    TopLoc_Location loc;
+    Handle_Poly_Triangulation t = BRep_Tool::Triangulation(TopoDS::Face(ex.Current()), loc);
+    if (t.IsNull() || t->Deflection()>deflection) return false;
+  }
+  return true;
+}
+
+}
+
+
+void Feature::triangulate(const TopoDS_Shape& s, double deflection, double angle)
+{
+  std::lock_guard<std::mutex> lock(meshMutex);
+  if (!hasTriangulation(s, deflection))
+  {
+    BRepMesh_IncrementalMesh aMesher(s, deflection, Standard_False, angle);
+  }
+}
+
+
 Handle_AIS_InteractiveObject Feature::buildVisualization() const
 {
     return Handle_AIS_InteractiveObject( new AIS_Shape(shape()) );
 }
 
 
+namespace
+{
+
+/**
+ * Recently computed projections, identified by the hash of
+ * the feature and the view definition.
+ * Accessed from the drawing export threads.
+ */
+class ViewCache
+{
+  std::mutex mx_;
+  std::map<size_t, Feature::View> views_;
+  std::list<size_t> order_;
+
+public:
+  static const size_t maxSize = 64;
+
+  bool lookup(size_t key, Feature::View& v)
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    auto i=views_.find(key);
+    if (i==views_.end()) return false;
+    v=i->second;
+    return true;
+  }
+
+  void insert(size_t key, const Feature::View& v)
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    if (views_.find(key)!=views_.end()) return;
+    views_[key]=v;
+    order_.push_back(key);
+    while (order_.size()>maxSize)
+    {
+      views_.erase(order_.front());
+      order_.pop_front();
+    }
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    views_.clear();
+    order_.clear();
+  }
+};
+
+ViewCache viewCache;
+
+}
+
+
+void Feature::clearViewCache()
+{
+  viewCache.clear();
+}
+
+
 Feature::View Feature::createView
 (
     const arma::mat p0,
@@ -1627,6 +1723,20 @@ Feature::View Feature::createView
 {
     View result_view;
 
+    ParameterListHash h;
+    h+=hash();
+    h+=p0;
+    h+=n;
+    h+=section;
+    h+=up;
+    h+=poly;
+    h+=skiphl;
+    if (visresolution_) h+=visresolution_->value();
+    size_t viewKey=h.getHash();
+
+    if (viewCache.lookup(viewKey, result_view))
+      return result_view;
+
     TopoDS_Shape dispshape=shape();
 
     gp_Pnt p_base = gp_Pnt(p0(0), p0(1), p0(2));
@@ -1764,6 +1874,8 @@ Feature::View Feature::createView
     result_view.width=x(0,1)-x(0,0);
     result_view.height=x(1,1)-x(1,0);
 
+    viewCache.insert(viewKey, result_view);
+
     return result_view;
 
 }
@@ -25,6 +25,7 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 #include "base/boost_include.h"
 
@@ -223,6 +224,9 @@ private:
   // the shape
   // shall only be accessed via the shape() function, which triggers the build function if needed
   TopoDS_Shape shape_;
+
+  // shape_ carries the triangulation for visresolution_
+  mutable std::atomic<bool> visMeshed_{false};
   
   FeatureSetPtr creashapes_;
   
@@ -422,6 +426,14 @@ public:
   operator const TopoDS_Shape& () const;
   const TopoDS_Shape& shape() const;
 
+  /**
+   * creates a triangulation of s with the given absolute deflection,
+   * if its faces do not carry a sufficiently fine one yet.
+   * Meshing modifies s and all shapes, which share its faces.
+   * Calls from different threads are therefore serialized.
+   */
+  static void triangulate(const TopoDS_Shape& s, double deflection, double angle=0.5);
+
   virtual Handle_AIS_InteractiveObject buildVisualization() const;
   
   View createView
@@ -433,6 +445,11 @@ public:
     bool poly=false,
     bool skiphl=false
   ) const;
+
+  /**
+   * remove all projections from the cache of createView
+   */
+  static void clearViewCache();
   
   friend std::ostream& operator<<(std::ostream& os, const Feature& m);
 
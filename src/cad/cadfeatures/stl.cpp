@@ -64,6 +64,8 @@
 #include "vtkPolyDataNormals.h"
 #include "vtkTriangleFilter.h"
 #include "vtkCell.h"
+#include "vtkPoints.h"
+#include "vtkCellArray.h"
 
 namespace qi = boost::spirit::qi;
 namespace repo = boost::spirit::repository;
@@ -97,6 +99,12 @@ size_t STL::calcHash() const
   {
     h+=vpd->Get(); // memory address
   }
+  else if (const auto* bs = boost::get<BooleanSpecification>(&geometry_))
+  {
+    h+=bs->object;
+    h+=bs->tool;
+    h+=int(bs->operation);
+  }
 
   if (const auto* trsf = boost::get<gp_Trsf>(&transform_))
   {
@@ -154,6 +162,17 @@ FeaturePtr STL::create_trsf(
 
 
 
+FeaturePtr STL::create_boolean(
+    const boost::filesystem::path& object,
+    const boost::filesystem::path& tool,
+    TriSurfaceBoolean::Operation operation )
+{
+  return FeaturePtr(new STL(BooleanSpecification{object, tool, operation}));
+}
+
+
+
+
 
 void STL::build()
 {
@@ -174,6 +193,29 @@ void STL::build()
     {
       pd=*vpd;
     }
+    else if (const auto* bs = boost::get<BooleanSpecification>(&geometry_))
+    {
+      TriSurfaceBoolean bo(
+            TriSurface::readSTL(bs->object),
+            TriSurface::readSTL(bs->tool),
+            bs->operation );
+
+      const auto& res = bo.result();
+      vtkSmartPointer<vtkPoints> pts = vtkSmartPointer<vtkPoints>::New();
+      for (const auto& p: res.points())
+      {
+        pts->InsertNextPoint(p[0], p[1], p[2]);
+      }
+      vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+      for (const auto& t: res.triangles())
+      {
+        vtkIdType ids[3] = { t[0], t[1], t[2] };
+        cells->InsertNextCell(3, ids);
+      }
+      pd = vtkSmartPointer<vtkPolyData>::New();
+      pd->SetPoints(pts);
+      pd->SetPolys(cells);
+    }
 
 
     vtkSmartPointer<vtkPolyDataNormals> split = vtkSmartPointer<vtkPolyDataNormals>::New();
@@ -291,6 +333,17 @@ void STL::insertrule(parser::ISCADParser& ruleset) const
            ( '(' >> ruleset.r_path >> ',' >> ruleset.r_solidmodel_expression >> ')' ) [ qi::_val = phx::bind(&STL::create_trsf, qi::_1, qi::_2) ]
           ))
       );
+  ruleset.modelstepFunctionRules.add
+      (
+        "STLBoolean",
+        typename parser::ISCADParser::ModelstepRulePtr(new typename parser::ISCADParser::ModelstepRule(
+           ( '(' >> ruleset.r_path >> ',' >> ruleset.r_path >> ','
+              >> ( ( qi::lit("union") >> qi::attr(TriSurfaceBoolean::Union) )
+                 | ( qi::lit("subtract") >> qi::attr(TriSurfaceBoolean::Subtract) )
+                 | ( qi::lit("intersect") >> qi::attr(TriSurfaceBoolean::Intersect) ) )
+              >> ')' ) [ qi::_val = phx::bind(&STL::create_boolean, qi::_1, qi::_2, qi::_3) ]
+          ))
+      );
 }
 
 
@@ -308,6 +361,16 @@ FeatureCmdInfoList STL::ruleDocumentation() const
           "Import a triangulated surface for display. The result can only be used for display, no operations can be performed on it."
           "Transformations can be reused from other transform features. The name of another transformed feature can be provided optionally."
           )
+      )
+      (
+        FeatureCmdInfo
+        (
+          "STLBoolean",
+
+          "( <path:object>, <path:tool>, union|subtract|intersect )",
+
+          "Import the result of a boolean operation between two closed triangulated surfaces. Like for STL, the result can only be used for display."
+          )
         );
 }
 
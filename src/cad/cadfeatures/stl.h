@@ -22,6 +22,7 @@
 
 #include "cadfeature.h"
 #include "MeshVS_Mesh.hxx"
+#include "base/trisurfaceboolean.h"
 
 #include "boost/variant.hpp"
 #include "vtkSmartPointer.h"
@@ -34,16 +35,24 @@ namespace cad {
 /**
  * @brief The STL class
  * loads and displays a triangulated surface.
- * The surfaces cannot be modified.
+ * The surfaces cannot be modified,
+ * except for boolean operations between two closed STL files.
  */
 class STL
     : public Feature
 {
 public:
 
+  struct BooleanSpecification
+  {
+    boost::filesystem::path object, tool;
+    TriSurfaceBoolean::Operation operation;
+  };
+
   typedef boost::variant<
     boost::filesystem::path,
-    vtkSmartPointer<vtkPolyData>
+    vtkSmartPointer<vtkPolyData>,
+    BooleanSpecification
   > GeometrySpecification;
 
   typedef boost::variant<
@@ -80,6 +89,12 @@ public:
         GeometrySpecification geometry,
         TransformationSpecification transform
     );
+    static FeaturePtr create_boolean
+    (
+        const boost::filesystem::path& object,
+        const boost::filesystem::path& tool,
+        TriSurfaceBoolean::Operation operation
+    );
 
     virtual Handle_AIS_InteractiveObject buildVisualization() const;
 
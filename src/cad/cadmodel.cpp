@@ -132,6 +132,19 @@ void Model::setCost(double cost)
 }
 
 
+void Model::setDefinitionRecorder(const DefinitionRecorder& recorder)
+{
+  definitionRecorder_=recorder;
+}
+
+
+void Model::recordDefinition(const std::string& name, const DefinitionReplay& replay)
+{
+  if (definitionRecorder_)
+    definitionRecorder_(name, replay);
+}
+
+
 void Model::build()
 {
     ExecTimer t("Model::build() [file "+modelfile_.string()+"]");
@@ -156,6 +169,7 @@ void Model::build()
 void Model::addScalar(const std::string& name, ScalarPtr value)
 {
   scalars_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addScalar(name, value); });
 }
 
 void Model::addScalarIfNotPresent(const std::string& name, ScalarPtr value)
@@ -167,6 +181,7 @@ void Model::addScalarIfNotPresent(const std::string& name, ScalarPtr value)
 void Model::addPoint(const std::string& name, VectorPtr value)
 {
   points_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addPoint(name, value); });
 }
 
 void Model::addPointIfNotPresent(const std::string& name, VectorPtr value)
@@ -178,6 +193,7 @@ void Model::addPointIfNotPresent(const std::string& name, VectorPtr value)
 void Model::addDirection(const std::string& name, VectorPtr value)
 {
   directions_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addDirection(name, value); });
 }
 
 void Model::addDirectionIfNotPresent(const std::string& name, VectorPtr value)
@@ -189,6 +205,7 @@ void Model::addDirectionIfNotPresent(const std::string& name, VectorPtr value)
 void Model::addDatum(const std::string& name, DatumPtr value)
 {
   datums_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addDatum(name, value); });
 }
 
 void Model::addDatumIfNotPresent(const std::string& name, DatumPtr value)
@@ -201,6 +218,7 @@ void Model::addModelstep(const std::string& name, FeaturePtr value, const std::s
 {
   value->setFeatureSymbolName(name);
   modelsteps_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addModelstep(name, value); });
 }
 
 void Model::addModelstepIfNotPresent(const std::string& name, FeaturePtr value, const std::string& /*featureDescription*/)
@@ -215,43 +233,51 @@ void Model::addModelstepIfNotPresent(const std::string& name, FeaturePtr value,
 void Model::addComponent(const std::string& name, FeaturePtr value, const std::string& /*featureDescription*/)
 {
   components_.insert(name);
+  recordDefinition(name, [name](Model& m) { m.components_.insert(name); });
   addModelstep(name, value);
 }
 
 void Model::removeScalar(const string& name)
 {
   scalars_.remove(name);
+  recordDefinition(name, [name](Model& m) { m.removeScalar(name); });
 }
 
 
 void Model::addVertexFeature(const std::string& name, FeatureSetPtr value)
 {
   vertexFeatures_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addVertexFeature(name, value); });
 }
 
 void Model::addEdgeFeature(const std::string& name, FeatureSetPtr value)
 {
   edgeFeatures_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addEdgeFeature(name, value); });
 }
 
 void Model::addFaceFeature(const std::string& name, FeatureSetPtr value)
 {
   faceFeatures_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addFaceFeature(name, value); });
 }
 
 void Model::addSolidFeature(const std::string& name, FeatureSetPtr value)
 {
   solidFeatures_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addSolidFeature(name, value); });
 }
 
 void Model::addModel(const std::string& name, ModelPtr value)
 {
   models_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addModel(name, value); });
 }
 
 void Model::addPostprocAction(const std::string& name, PostprocActionPtr value)
 {
   postprocActions_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addPostprocAction(name, value); });
 }
 
 std::string Model::addPostprocActionUnnamed(PostprocActionPtr value)
@@ -269,6 +295,7 @@ std::string Model::addPostprocActionUnnamed(PostprocActionPtr value)
   while (postprocActions_.find(name));
   
   postprocActions_.add(name, value);
+  recordDefinition(name, [name,value](Model& m) { m.addPostprocAction(name, value); });
   return name;
 }
 
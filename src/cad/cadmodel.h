@@ -30,6 +30,7 @@
 
 #include <map>
 #include <string>
+#include <functional>
 
 
 
@@ -75,6 +76,14 @@ public:
     typedef boost::spirit::qi::symbols<char, FeatureSetPtr> 	SolidFeatureTable;
     typedef boost::spirit::qi::symbols<char, PostprocActionPtr> PostprocActionTable;
 
+    /**
+     * Replays a single symbol table modification on another model.
+     * Used by the parse cache to restore the definitions of unchanged statements
+     * without parsing them again.
+     */
+    typedef std::function<void(Model&)> DefinitionReplay;
+    typedef std::function<void(const std::string&, const DefinitionReplay&)> DefinitionRecorder;
+
 protected:
     std::string                 description_;
     double                      cost_;
@@ -94,6 +103,9 @@ protected:
     insight::cad::parser::SyntaxElementDirectoryPtr syn_elem_dir_;
     boost::filesystem::path modelfile_;
 
+    DefinitionRecorder definitionRecorder_;
+
+    void recordDefinition(const std::string& name, const DefinitionReplay& replay);
 
     void defaultVariables();
     void copyVariables(const ModelVariableTable& vars);
@@ -110,6 +122,12 @@ public:
     void setDescription(const std::string& description);
     void setCost(double cost);
 
+    /**
+     * install a callback, which receives all subsequent symbol definitions.
+     * An empty function disables recording.
+     */
+    void setDefinitionRecorder(const DefinitionRecorder& recorder);
+
     const ScalarTable& 	scalarSymbols() const;
     const VectorTable&	pointSymbols() const;
     const VectorTable&	directionSymbols() const;
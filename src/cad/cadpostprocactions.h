@@ -25,6 +25,7 @@
 #include "cadpostprocactions/drawingexport.h"
 #include "cadpostprocactions/export.h"
 #include "cadpostprocactions/hydrostatics.h"
+#include "cadpostprocactions/hydrostatictable.h"
 #include "cadpostprocactions/mesh.h"
 #include "cadpostprocactions/solidproperties.h"
 #include "cadpostprocactions/pointdistance.h"
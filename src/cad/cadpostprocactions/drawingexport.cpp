@@ -21,6 +21,9 @@
 #include "drawingexport.h"
 #include "dxfwriter.h"
 
+#include <atomic>
+#include <thread>
+
 namespace insight 
 {
 namespace cad 
@@ -67,9 +70,75 @@ DrawingExport::DrawingExport
 
 
 
+namespace
+{
+
+struct ViewJob
+{
+  std::string name;
+  FeaturePtr model;
+  arma::mat p0, dir, up;
+  bool sec, poly, skiphl;
+};
+
+/**
+ * project all views concurrently
+ */
+void createViews(const std::vector<ViewJob>& jobs, Feature::Views& views)
+{
+  // build all features, compute their hashes and create the triangulations for the polygonal HLR
+  // before starting the threads: the projections then only read the features
+  for (const ViewJob& j: jobs)
+  {
+    j.model->shape();
+    j.model->hash();
+  }
+
+  std::vector<Feature::View> results(jobs.size());
+  std::vector<std::exception_ptr> errors(jobs.size());
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]()
+  {
+    for (size_t i=next++; i<jobs.size(); i=next++)
+    {
+      const ViewJob& j=jobs[i];
+      try
+      {
+        results[i]=j.model->createView(j.p0, j.dir, j.sec, j.up, j.poly, j.skiphl);
+      }
+      catch (...)
+      {
+        errors[i]=std::current_exception();
+      }
+    }
+  };
+
+  unsigned int nthreads=std::max(1u, std::thread::hardware_concurrency());
+  nthreads=std::min<size_t>(nthreads, jobs.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i=1; i<nthreads; i++)
+  {
+    threads.push_back(std::thread(worker));
+  }
+  worker();
+  for (std::thread& t: threads) t.join();
+
+  for (size_t i=0; i<jobs.size(); i++)
+  {
+    if (errors[i]) std::rethrow_exception(errors[i]);
+    views[jobs[i].name]=results[i];
+  }
+}
+
+}
+
+
+
+
 void DrawingExport::build()
 {
-    Feature::Views views;
+    std::vector<ViewJob> jobs;
     for (const DrawingViewDefinitions& vds: viewdefs_)
     {
         FeaturePtr model_=boost::fusion::at_c<0>(vds);
@@ -102,97 +171,46 @@ void DrawingExport::build()
             if (arma::norm(up,2)<1e-6)
                 throw insight::Exception("length of upward direction vector must not be zero!");
 
-            views[name] =
-                model_->createView
-                (
-                    p0,
-                    dir,
-                    sec,
-                    up,
-                    poly,
-                    skiphl
-                );
-                
+            jobs.push_back(ViewJob{name, model_, p0, dir, up, sec, poly, skiphl});
             if (left_view)
-            {
-                std::string thisname = name+"_left";
-                
-                views[thisname] =
-                    model_->createView
-                    (
-                        p0,
-                        -right,
-                        false,
-                        up,
-                        poly,
-                        skiphl
-                    );
-                views[thisname].insert_x = +( 0.55 * views[name].width +0.55 * views[thisname].width );
-            }
+                jobs.push_back(ViewJob{name+"_left", model_, p0, -right, up, false, poly, skiphl});
             if (back_view)
-            {
-                std::string thisname = name+"_back";
-                
-                views[thisname] =
-                    model_->createView
-                    (
-                        p0,
-                        -dir,
-                        false,
-                        up,
-                        poly,
-                        skiphl
-                    );
-                views[thisname].insert_x = +( 0.55 * views[name].width +1.1 * views[name+"_left"].width +0.55 * views[thisname].width );
-            }
+                jobs.push_back(ViewJob{name+"_back", model_, p0, -dir, up, false, poly, skiphl});
             if (right_view)
-            {
-                std::string thisname = name+"_right";
-                
-                views[thisname] =
-                    model_->createView
-                    (
-                        p0,
-                        right,
-                        false,
-                        up,
-                        poly,
-                        skiphl
-                    );
-                views[thisname].insert_x = -( 0.55 * views[name].width +0.55 * views[thisname].width );
-            }
+                jobs.push_back(ViewJob{name+"_right", model_, p0, right, up, false, poly, skiphl});
             if (top_view)
-            {
-                std::string thisname = name+"_top";
-                
-                views[thisname] =
-                    model_->createView
-                    (
-                        p0,
-                        up,
-                        false,
-                        -dir,
-                        poly,
-                        skiphl
-                    );
-                views[thisname].insert_y = -( 0.55 * views[name].height +0.55 * views[thisname].height );
-            }
+                jobs.push_back(ViewJob{name+"_top", model_, p0, up, -dir, false, poly, skiphl});
             if (bottom_view)
-            {
-                std::string thisname = name+"_bottom";
-                
-                views[thisname] =
-                    model_->createView
-                    (
-                        p0,
-                        -up,
-                        false,
-                        dir,
-                        poly,
-                        skiphl
-                    );
-                views[thisname].insert_y = +( 0.55 * views[name].height +0.55 * views[thisname].height );
-            }
+                jobs.push_back(ViewJob{name+"_bottom", model_, p0, -up, dir, false, poly, skiphl});
+        }
+    }
+
+    Feature::Views views;
+    createViews(jobs, views);
+
+    // arrange the additional views around their main view
+    for (const DrawingViewDefinitions& vds: viewdefs_)
+    {
+        for (const DrawingViewDefinition& vd: boost::fusion::at_c<1>(vds))
+        {
+            std::string name = boost::get<0>(vd);
+            const Feature::View& mv = views[name];
+
+            auto v=views.find(name+"_left");
+            if (v!=views.end())
+                v->second.insert_x = +( 0.55 * mv.width +0.55 * v->second.width );
+            v=views.find(name+"_back");
+            if (v!=views.end())
+                v->second.insert_x = +( 0.55 * mv.width +1.1 * views[name+"_left"].width +0.55 * v->second.width );
+            v=views.find(name+"_right");
+            if (v!=views.end())
+                v->second.insert_x = -( 0.55 * mv.width +0.55 * v->second.width );
+            v=views.find(name+"_top");
+            if (v!=views.end())
+                v->second.insert_y = -( 0.55 * mv.height +0.55 * v->second.height );
+            v=views.find(name+"_bottom");
+            if (v!=views.end())
+                v->second.insert_y = +( 0.55 * mv.height +0.55 * v->second.height );
         }
     }
     shape_=views.begin()->second.visibleEdges;
@@ -87,8 +87,6 @@ void Hydrostatics::build()
   if (ex.More()) std::cout<<"yet another"<<std::endl; }
 //     throw insight::Exception("cut surface consists of more than a single face!");
   
-  BRepTools::Write(f, "test.brep");
-  
   GProp_GProps props;
   BRepGProp::SurfaceProperties(f, props);
   GProp_PrincipalProps pcp = props.PrincipalProperties();
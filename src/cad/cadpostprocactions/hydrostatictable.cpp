@@ -0,0 +1,438 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "hydrostatictable.h"
+#include "cadfeature.h"
+#include "occtools.h"
+
+#include "base/linearalgebra.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace boost;
+using namespace std;
+
+namespace insight
+{
+namespace cad
+{
+
+
+
+
+TriangulatedHull::TriangulatedHull(const TopoDS_Shape& shape, double deflection)
+{
+  // the hull shares its faces with other features, which may be meshed concurrently
+  Feature::triangulate(shape, deflection);
+
+  for (TopExp_Explorer ex(shape, TopAbs_FACE); ex.More(); ex.Next())
+  {
+    TopoDS_Face f=TopoDS::Face(ex.Current());
+
+    TopLoc_Location L;
+    Handle_Poly_Triangulation tri = BRep_Tool::Triangulation(f, L);
+    if (tri.IsNull())
+      throw insight::Exception("HydrostaticTable: could not triangulate a face of the hull!");
+
+    bool reversed = (f.Orientation()==TopAbs_REVERSED);
+    const gp_Trsf& tr = L.Transformation();
+
+    const TColgp_Array1OfPnt& nodes = tri->Nodes();
+    const Poly_Array1OfTriangle& tris = tri->Triangles();
+    for (int i=tris.Lower(); i<=tris.Upper(); i++)
+    {
+      int n[3];
+      tris(i).Get(n[0], n[1], n[2]);
+      if (reversed) std::swap(n[1], n[2]);
+
+      Triangle t;
+      for (int j=0; j<3; j++)
+      {
+        gp_Pnt p = nodes(n[j]).Transformed(tr);
+        t[3*j]=p.X(); t[3*j+1]=p.Y(); t[3*j+2]=p.Z();
+      }
+      triangles_.push_back(t);
+    }
+  }
+
+  if (triangles_.size()==0)
+    throw insight::Exception("HydrostaticTable: the hull shape does not contain any faces!");
+}
+
+
+
+
+double TriangulatedHull::relativeLeakage() const
+{
+  double S[3]={0,0,0}, Atot=0.;
+  for (const Triangle& t: triangles_)
+  {
+    double a[3]={t[3]-t[0], t[4]-t[1], t[5]-t[2]};
+    double b[3]={t[6]-t[0], t[7]-t[1], t[8]-t[2]};
+    double n[3]={a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0]};
+    for (int k=0; k<3; k++) S[k]+=0.5*n[k];
+    Atot+=0.5*sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+  }
+  return sqrt(S[0]*S[0]+S[1]*S[1]+S[2]*S[2]) / std::max(Atot, 1e-30);
+}
+
+
+
+
+namespace
+{
+
+struct LocalPoint
+{
+  double u, v, w;
+};
+
+/**
+ * add the contributions of the (partial) triangle a, b, c
+ * which lies entirely below the waterplane
+ */
+void addSubmergedTriangle
+(
+    TriangulatedHull::Integrals& I,
+    const LocalPoint& a, const LocalPoint& b, const LocalPoint& c
+)
+{
+  // tetrahedron with apex in the origin of the waterplane
+  double dV = ( a.u*(b.v*c.w-b.w*c.v)
+               -a.v*(b.u*c.w-b.w*c.u)
+               +a.w*(b.u*c.v-b.v*c.u) ) / 6.;
+  I.V += dV;
+  I.Vu += dV*(a.u+b.u+c.u)/4.;
+  I.Vv += dV*(a.v+b.v+c.v)/4.;
+  I.Vw += dV*(a.w+b.w+c.w)/4.;
+
+  // area projected on the waterplane, counted negative
+  double dA = -0.5*( (b.u-a.u)*(c.v-a.v) - (b.v-a.v)*(c.u-a.u) );
+  double su=a.u+b.u+c.u, sv=a.v+b.v+c.v;
+  I.A += dA;
+  I.Au += dA*su/3.;
+  I.Av += dA*sv/3.;
+  I.Auu += dA*( a.u*a.u+b.u*b.u+c.u*c.u + su*su )/12.;
+  I.Avv += dA*( a.v*a.v+b.v*b.v+c.v*c.v + sv*sv )/12.;
+  I.Auv += dA*( a.u*a.v+b.u*b.v+c.u*c.v + su*sv )/12.;
+}
+
+LocalPoint intersect(const LocalPoint& a, const LocalPoint& b)
+{
+  double s=a.w/(a.w-b.w);
+  return LocalPoint{ a.u+s*(b.u-a.u), a.v+s*(b.v-a.v), 0. };
+}
+
+}
+
+
+
+
+TriangulatedHull::Integrals TriangulatedHull::integrate
+(
+    const arma::mat& p0,
+    const arma::mat& eu, const arma::mat& ev, const arma::mat& ew
+) const
+{
+  Integrals I = {0,0,0,0, 0,0,0,0,0,0};
+
+  for (const Triangle& t: triangles_)
+  {
+    LocalPoint p[3];
+    int nbelow=0;
+    for (int j=0; j<3; j++)
+    {
+      double d[3]={t[3*j]-p0(0), t[3*j+1]-p0(1), t[3*j+2]-p0(2)};
+      p[j].u = d[0]*eu(0)+d[1]*eu(1)+d[2]*eu(2);
+      p[j].v = d[0]*ev(0)+d[1]*ev(1)+d[2]*ev(2);
+      p[j].w = d[0]*ew(0)+d[1]*ew(1)+d[2]*ew(2);
+      if (p[j].w<=0.) nbelow++;
+    }
+
+    if (nbelow==3)
+    {
+      addSubmergedTriangle(I, p[0], p[1], p[2]);
+    }
+    else if (nbelow>0)
+    {
+      // clip the triangle at the waterplane, keeping the vertex order
+      LocalPoint poly[4];
+      int np=0;
+      for (int j=0; j<3; j++)
+      {
+        const LocalPoint& a=p[j];
+        const LocalPoint& b=p[(j+1)%3];
+        if (a.w<=0.) poly[np++]=a;
+        if ( (a.w<=0.) != (b.w<=0.) ) poly[np++]=intersect(a, b);
+      }
+      for (int j=1; j+1<np; j++)
+      {
+        addSubmergedTriangle(I, poly[0], poly[j], poly[j+1]);
+      }
+    }
+  }
+
+  return I;
+}
+
+
+
+
+const double HydrostaticTable::relativeDeflection = 1e-3;
+
+
+
+
+namespace
+{
+
+std::vector<double> rangeValues(const HydrostaticRange& r)
+{
+  const ScalarPtr& first = boost::fusion::at_c<0>(r);
+  const ScalarPtr& last = boost::fusion::at_c<1>(r);
+  const ScalarPtr& n = boost::fusion::at_c<2>(r);
+
+  if (!first) return std::vector<double>(1, 0.);
+
+  double x0=first->value();
+  if (!last) return std::vector<double>(1, x0);
+
+  if (!n)
+    throw insight::Exception("HydrostaticTable: number of values in range is missing!");
+  int nv=std::max(1, int(round(n->value())));
+
+  std::vector<double> xs;
+  for (int i=0; i<nv; i++)
+  {
+    xs.push_back( nv>1 ? x0+(last->value()-x0)*double(i)/double(nv-1) : x0 );
+  }
+  return xs;
+}
+
+
+void addRangeHash(ParameterListHash& h, const HydrostaticRange& r)
+{
+  if (const ScalarPtr& s=boost::fusion::at_c<0>(r)) h+=s->value();
+  if (const ScalarPtr& s=boost::fusion::at_c<1>(r)) h+=s->value();
+  if (const ScalarPtr& s=boost::fusion::at_c<2>(r)) h+=s->value();
+}
+
+}
+
+
+
+
+size_t HydrostaticTable::calcHash() const
+{
+  ParameterListHash h;
+  h+=outpath_;
+  h+=pref_->value();
+  h+=elong_->value();
+  h+=evert_->value();
+  h+=*hullvolume_;
+  h+=*shipmodel_;
+  addRangeHash(h, drafts_);
+  addRangeHash(h, heel_);
+  addRangeHash(h, trim_);
+  return h.getHash();
+}
+
+
+
+
+HydrostaticTable::HydrostaticTable
+(
+  const boost::filesystem::path& outpath,
+  VectorPtr pref,
+  VectorPtr elong,
+  VectorPtr evert,
+  FeaturePtr hullvolume,
+  FeaturePtr shipmodel,
+  HydrostaticRange drafts,
+  HydrostaticRange heel,
+  HydrostaticRange trim
+)
+: outpath_(outpath),
+  pref_(pref), elong_(elong), evert_(evert),
+  hullvolume_(hullvolume), shipmodel_(shipmodel),
+  drafts_(drafts), heel_(heel), trim_(trim)
+{}
+
+
+
+
+void HydrostaticTable::build()
+{
+  arma::mat p0=pref_->value();
+  arma::mat ez=evert_->value() / arma::norm(evert_->value(),2);
+  arma::mat ex=elong_->value() - arma::dot(elong_->value(), ez)*ez;
+  ex/=arma::norm(ex,2);
+  arma::mat ey=arma::cross(ez, ex);
+
+  G_=shipmodel_->modelCoG();
+
+  arma::mat bb=hullvolume_->modelBndBox();
+  double L=arma::norm(bb.col(1)-bb.col(0), 2);
+  TriangulatedHull hull(hullvolume_->shape(), relativeDeflection*L);
+
+  double leak=hull.relativeLeakage();
+  if (leak>1e-3)
+    insight::Warning(str(format(
+        "HydrostaticTable: the hull triangulation is not closed (relative leakage %g). Results may be inaccurate.")
+        % leak ));
+
+  std::vector<double> Ts=rangeValues(drafts_);
+  // angles in degrees
+  std::vector<double> phis=rangeValues(heel_);
+  std::vector<double> thetas=rangeValues(trim_);
+
+  results_.clear();
+  for (double theta: thetas)
+    for (double phi: phis)
+      for (double T: Ts)
+      {
+        FloatingCondition c;
+        c.T=T; c.heel=phi*M_PI/180.; c.trim=theta*M_PI/180.;
+        results_.push_back(c);
+      }
+
+  auto evaluate = [&](FloatingCondition& c)
+  {
+    // rotate waterplane: first trim around lateral axis, then heel around longitudinal axis
+    arma::mat R = rotMatrix(c.heel, ex) * rotMatrix(c.trim, ey);
+    arma::mat eu = R*ex, ew = R*ez;
+    arma::mat ev = arma::cross(ew, eu);
+    arma::mat pw = p0 + c.T*ez;
+
+    TriangulatedHull::Integrals I = hull.integrate(pw, eu, ev, ew);
+
+    c.V=I.V;
+    c.Awp=I.A;
+    if (I.V>0.)
+    {
+      c.B = pw + (I.Vu*eu + I.Vv*ev + I.Vw*ew)/I.V;
+      c.KB = arma::dot(c.B-p0, ez);
+      c.LCB = arma::dot(c.B-p0, ex);
+      c.TCB = arma::dot(c.B-p0, ey);
+      c.GZ = arma::dot(c.B-G_, ev);
+    }
+    else
+    {
+      c.B=pw;
+      c.KB=c.LCB=c.TCB=c.GZ=0.;
+    }
+
+    if (I.A>0. && I.V>0.)
+    {
+      double uF=I.Au/I.A, vF=I.Av/I.A;
+      c.LCF = arma::dot(pw + uF*eu - p0, ex);
+      double It = I.Avv - I.A*vF*vF;
+      double Il = I.Auu - I.A*uF*uF;
+      c.BMt = It/I.V;
+      c.BMl = Il/I.V;
+    }
+    else
+    {
+      c.LCF=c.BMt=c.BMl=0.;
+    }
+
+    double KG = arma::dot(G_-p0, ez);
+    c.GMt = c.KB + c.BMt - KG;
+    c.GMl = c.KB + c.BMl - KG;
+  };
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]()
+  {
+    for (size_t i=next++; i<results_.size(); i=next++)
+    {
+      evaluate(results_[i]);
+    }
+  };
+
+  unsigned int nthreads=std::max(1u, std::thread::hardware_concurrency());
+  nthreads=std::min<size_t>(nthreads, results_.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i=1; i<nthreads; i++)
+  {
+    threads.push_back(std::thread(worker));
+  }
+  worker();
+  for (std::thread& t: threads) t.join();
+
+  cout<<"######### Hydrostatic Table ###########################################"<<endl;
+  write(cout);
+
+  if (!outpath_.empty())
+  {
+    std::ofstream f(outpath_.c_str());
+    if (!f.good())
+      throw insight::Exception("HydrostaticTable: could not open output file "+outpath_.string());
+    write(f);
+  }
+}
+
+
+
+
+Handle_AIS_InteractiveObject HydrostaticTable::createAISRepr() const
+{
+  checkForBuildDuringAccess();
+
+  // curve of centres of buoyancy
+  BRepBuilderAPI_MakePolygon pg;
+  for (const FloatingCondition& c: results_)
+  {
+    pg.Add(to_Pnt(c.B));
+  }
+
+  TopoDS_Edge cG = BRepBuilderAPI_MakeEdge(gp_Circ(gp_Ax2(to_Pnt(G_),gp_Dir(to_Vec(evert_->value()))), 1));
+
+  Handle_AIS_MultipleConnectedInteractive ais(new AIS_MultipleConnectedInteractive());
+  ais->Connect(Handle_AIS_Shape(new AIS_Shape(cG)));
+  if (results_.size()>1)
+  {
+    ais->Connect(Handle_AIS_Shape(new AIS_Shape(pg.Wire())));
+  }
+
+  return ais;
+}
+
+
+
+
+void HydrostaticTable::write(std::ostream& os) const
+{
+  os<<"T,heel_deg,trim_deg,V,Awp,KB,LCB,TCB,LCF,BMt,BMl,GMt,GMl,GZ"<<endl;
+  for (const FloatingCondition& c: results_)
+  {
+    os<<c.T<<","<<c.heel*180./M_PI<<","<<c.trim*180./M_PI
+      <<","<<c.V<<","<<c.Awp
+      <<","<<c.KB<<","<<c.LCB<<","<<c.TCB<<","<<c.LCF
+      <<","<<c.BMt<<","<<c.BMl<<","<<c.GMt<<","<<c.GMl
+      <<","<<c.GZ<<endl;
+  }
+}
+
+
+
+
+}
+}
@@ -0,0 +1,177 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INSIGHT_CAD_HYDROSTATICTABLE_H
+#define INSIGHT_CAD_HYDROSTATICTABLE_H
+
+#include "cadtypes.h"
+#include "cadparameters.h"
+#include "cadpostprocaction.h"
+#include "base/boost_include.h"
+
+#include <array>
+
+namespace insight
+{
+namespace cad
+{
+
+
+
+/**
+ * Closed triangulated surface, on which the integrals for the submerged part
+ * below an arbitrary plane can be evaluated without any boolean operation.
+ *
+ * The volume integrals are evaluated as a sum over tetrahedra between the clipped
+ * surface triangles and the origin of the waterplane. Since the origin lies in the plane,
+ * the waterplane itself does not contribute. The waterplane integrals are obtained from
+ * the divergence theorem as well: for any function f, which is constant along the plane normal,
+ * the integral over the waterplane equals minus the integral of f*n_w over the clipped hull surface.
+ *
+ * The triangles must be consistently oriented with outward pointing normals.
+ */
+class TriangulatedHull
+{
+public:
+  typedef std::array<double, 9> Triangle;
+
+  /**
+   * integrals over the submerged volume and the waterplane,
+   * expressed in the waterplane coordinate system (u, v in plane, w along normal)
+   */
+  struct Integrals
+  {
+    double V, Vu, Vv, Vw;
+    double A, Au, Av, Auu, Avv, Auv;
+  };
+
+protected:
+  std::vector<Triangle> triangles_;
+
+public:
+  /**
+   * triangulate the shape with the given (absolute) deflection
+   */
+  TriangulatedHull(const TopoDS_Shape& shape, double deflection);
+
+  inline const std::vector<Triangle>& triangles() const { return triangles_; }
+
+  /**
+   * returns the norm of the sum of all triangle area vectors, divided by the total area.
+   * Should be close to zero for a closed surface.
+   */
+  double relativeLeakage() const;
+
+  /**
+   * integrate the part below the plane through p0 with normal ew.
+   * eu, ev and ew have to form an orthonormal system.
+   */
+  Integrals integrate
+  (
+      const arma::mat& p0,
+      const arma::mat& eu, const arma::mat& ev, const arma::mat& ew
+  ) const;
+};
+
+
+
+
+/**
+ * range of a floating condition parameter:
+ * first value, optional last value and number of values
+ */
+typedef boost::fusion::vector3<ScalarPtr, ScalarPtr, ScalarPtr> HydrostaticRange;
+
+
+
+/**
+ * Hydrostatic data for a grid of drafts, heel and trim angles.
+ *
+ * The hull is triangulated once and all floating conditions are evaluated
+ * on the triangulation in parallel. The result is written as a table (CSV).
+ */
+class HydrostaticTable
+: public insight::cad::PostprocAction
+{
+public:
+  struct FloatingCondition
+  {
+    /**
+     * draft; heel and trim angle in radians
+     */
+    double T, heel, trim;
+
+    double V, Awp;
+    double KB, LCB, TCB, LCF;
+    double BMt, BMl, GMt, GMl;
+
+    /**
+     * righting lever, positive if restoring
+     */
+    double GZ;
+
+    arma::mat B;
+  };
+
+protected:
+  boost::filesystem::path outpath_;
+  VectorPtr pref_;
+  VectorPtr elong_;
+  VectorPtr evert_;
+  FeaturePtr hullvolume_;
+  FeaturePtr shipmodel_;
+  HydrostaticRange drafts_;
+  HydrostaticRange heel_;
+  HydrostaticRange trim_;
+
+  /**
+   * deflection of the hull triangulation, relative to the hull dimension
+   */
+  static const double relativeDeflection;
+
+  arma::mat G_;
+  std::vector<FloatingCondition> results_;
+
+  virtual size_t calcHash() const;
+  virtual void build();
+
+public:
+  HydrostaticTable
+  (
+    const boost::filesystem::path& outpath,
+    VectorPtr pref,
+    VectorPtr elong,
+    VectorPtr evert,
+    FeaturePtr hullvolume,
+    FeaturePtr shipmodel,
+    HydrostaticRange drafts,
+    HydrostaticRange heel,
+    HydrostaticRange trim
+  );
+
+  inline const std::vector<FloatingCondition>& results() const { return results_; }
+
+  virtual Handle_AIS_InteractiveObject createAISRepr() const;
+  virtual void write(std::ostream& ) const;
+};
+
+}
+}
+
+#endif // INSIGHT_CAD_HYDROSTATICTABLE_H
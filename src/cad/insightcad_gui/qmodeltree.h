@@ -107,6 +107,7 @@ public:
     bool isHidden() const;
 
     Handle_AIS_InteractiveObject ais(AIS_InteractiveContext& context);
+    inline bool hasAIS() const { return !ais_.IsNull(); }
     inline AIS_DisplayMode shadingMode() const { return shadingMode_; }
     inline double red() const { return r_; }
     inline double green() const { return g_; }
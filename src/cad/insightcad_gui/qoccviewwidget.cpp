@@ -58,6 +58,7 @@
 #include "datum.h"
 #include "pointertransient.h"
 #include "qmodelstepitem.h"
+#include "visualizationqueue.h"
 
 #include "qoccviewwidget.h"
 
@@ -133,7 +134,8 @@ QoccViewWidget::QoccViewWidget
     myKeyboardFlags     ( Qt::NoModifier ),
     myButtonFlags	( Qt::NoButton ),
     showGrid            ( false ),
-    cimode_             ( CIM_Normal )
+    cimode_             ( CIM_Normal ),
+    visualizationQueue_ ( new VisualizationQueue(this) )
 {
   // Needed to generate mouse events
   setMouseTracking( true );
@@ -172,6 +174,12 @@ QoccViewWidget::QoccViewWidget
         this, &QoccViewWidget::onGraphicalSelectionChanged
       );
 
+  connect
+      (
+        visualizationQueue_, &VisualizationQueue::visualizationsReady,
+        this, &QoccViewWidget::onVisualizationsReady
+      );
+
 }
 
 /*!
@@ -181,6 +189,9 @@ QoccViewWidget::QoccViewWidget
 */
 QoccViewWidget::~QoccViewWidget()
 {
+ // stop the worker thread before the context goes away
+ delete visualizationQueue_;
+
  if ( myRubberBand )
     {
       delete myRubberBand;
@@ -1163,22 +1174,89 @@ void QoccViewWidget::updatePlanesSizes()
     }
 }
 
+void QoccViewWidget::displayItem(QDisplayableModelTreeItem* di, bool updateViewer)
+{
+  Handle_AIS_InteractiveObject ais = di->ais( *getContext() );
+
+  getContext()->Display
+  (
+    ais
+#if (OCC_VERSION_MAJOR>=7)
+    , false
+#endif
+  );
+  getContext()->SetDisplayMode(ais, di->shadingMode(), Standard_False );
+  getContext()->SetColor(ais, di->color(), updateViewer );
+}
+
+
 void QoccViewWidget::onShow(QDisplayableModelTreeItem* di)
 {
   if (di)
     {
-      Handle_AIS_InteractiveObject ais = di->ais( *getContext() );
+      if (!di->hasAIS())
+        {
+          if (QFeatureItem* fi = dynamic_cast<QFeatureItem*>(di))
+            {
+              // tessellate in background, displayed in onVisualizationsReady
+              visualizationQueue_->enqueue
+                  (
+                    fi, fi->solidmodelPtr(),
+                    fi->isSelected(),
+                    getContext()->DeviationCoefficient()
+                  );
+              return;
+            }
+        }
 
-      getContext()->Display
-      (
-        ais
+      displayItem(di, true);
+      updatePlanesSizes();
+    }
+}
+
+
+void QoccViewWidget::onVisualizationsReady()
+{
+  bool someDisplayed=false;
+
+  for (const VisualizationQueue::Result& r: visualizationQueue_->takeFinished())
+    {
+      QDisplayableModelTreeItem* di=r.item.data();
+      if (di && di->isVisible())
+        {
+          try
+            {
+              Handle_AIS_InteractiveObject ais = di->ais( *getContext() );
+
+              // the shape is shared with other threads:
+              // present it with the triangulation of the queue, never mesh here
+              ais->Attributes()->SetAutoTriangulation(Standard_False);
+
+              getContext()->SetDeviationCoefficient
+                  (
+                    ais,
+                    r.deviationCoefficient
 #if (OCC_VERSION_MAJOR>=7)
-        , false
+                    , false
 #endif
-      );
-      getContext()->SetDisplayMode(ais, di->shadingMode(), Standard_False );
-      getContext()->SetColor(ais, di->color(), Standard_True );
+                  );
+
+              if (!getContext()->IsDisplayed(ais))
+                {
+                  displayItem(di, false);
+                }
+              someDisplayed=true;
+            }
+          catch (const std::exception& e)
+            {
+              emit sendStatus( QString("Could not display ")+di->name()+": "+e.what() );
+            }
+        }
+    }
 
+  if (someDisplayed)
+    {
+      getContext()->UpdateCurrentViewer();
       updatePlanesSizes();
     }
 }
@@ -1219,7 +1297,19 @@ void QoccViewWidget::onSetColor(QDisplayableModelTreeItem* di, Quantity_Color c)
 
 void QoccViewWidget::onSetResolution(QDisplayableModelTreeItem* di, double res)
 {
-  if (di)
+  if (QFeatureItem* fi = dynamic_cast<QFeatureItem*>(di))
+    {
+      // the new triangulation is created in background,
+      // the presentation is updated in onVisualizationsReady
+      visualizationQueue_->cancel(fi);
+      visualizationQueue_->enqueue
+          (
+            fi, fi->solidmodelPtr(),
+            fi->isSelected(),
+            res
+          );
+    }
+  else if (di)
     {
       getContext()->SetDeviationCoefficient
           (
@@ -1234,6 +1324,13 @@ void QoccViewWidget::onSetResolution(QDisplayableModelTreeItem* di, double res)
 
 
 
+void QoccViewWidget::cancelPendingVisualizations()
+{
+  visualizationQueue_->cancelAll();
+}
+
+
+
 void QoccViewWidget::onSetClipPlane(QObject* qdatum)
 {
     insight::cad::Datum* datum = reinterpret_cast<insight::cad::Datum*>(qdatum);
@@ -22,6 +22,7 @@ class QRubberBand;
 class OpenGl_GraphicDriver;
 class V3d_Viewer;
 class Xw_Window;
+class VisualizationQueue;
 
 namespace insight { namespace cad {
 class PostprocAction;
@@ -104,6 +105,11 @@ protected:
 
   void init();
 
+  /**
+   * display the presentation of the item, create it, if needed
+   */
+  void displayItem(QDisplayableModelTreeItem* di, bool updateViewer);
+
 public:
 
   QoccViewWidget
@@ -200,6 +206,12 @@ public Q_SLOTS:
   void onSetColor(QDisplayableModelTreeItem* di, Quantity_Color c);
   void onSetResolution(QDisplayableModelTreeItem* di, double res);
 
+  /**
+   * drop the pending background tessellations,
+   * e.g. when the model is rebuilt and all features are replaced
+   */
+  void cancelPendingVisualizations();
+
   void onSetClipPlane(QObject* datumplane);
 
   void onMeasureDistance();
@@ -212,6 +224,11 @@ public Q_SLOTS:
   void doUnfocus(bool newFocusIntended = false);
   void onFocus(Handle_AIS_InteractiveObject di);
 
+  /**
+   * display the features, which have been tessellated in background
+   */
+  void onVisualizationsReady();
+
 protected: // methods
 
   virtual void paintEvent        ( QPaintEvent* e );
@@ -279,6 +296,9 @@ private: // members
   // for pointIDs
   std::shared_ptr<insight::cad::FeatureSet> selpts_;
 
+  // background tessellation of features
+  VisualizationQueue*           visualizationQueue_;
+
 private: // methods
   
   void onLeftButtonDown  ( Qt::KeyboardModifiers nFlags, const QPoint point );
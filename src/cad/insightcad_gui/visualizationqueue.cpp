@@ -0,0 +1,234 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "visualizationqueue.h"
+#include "qmodeltree.h"
+
+#ifndef Q_MOC_RUN
+#include "cadfeature.h"
+
+#include "Bnd_Box.hxx"
+#include "BRepBndLib.hxx"
+#endif
+
+
+const double VisualizationQueue::coarseningFactor = 10.;
+
+
+namespace
+{
+
+/**
+ * creates the triangulation, which AIS_Shape would compute for the given deviation coefficient
+ * (same deflection as Prs3d::GetDeflection).
+ * The shape is shared with the GUI and the parser thread: mesh only under the lock of Feature.
+ */
+void tessellate(const TopoDS_Shape& s, double deviationCoefficient)
+{
+  Bnd_Box box;
+  BRepBndLib::Add(s, box, Standard_False);
+  if (box.IsVoid()) return;
+
+  double xmin, ymin, zmin, xmax, ymax, zmax;
+  box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+  double deflection =
+      std::max(xmax-xmin, std::max(ymax-ymin, zmax-zmin))
+      * deviationCoefficient * 4.;
+
+  if (deflection>0.)
+  {
+    insight::cad::Feature::triangulate(s, deflection, 20.*M_PI/180.);
+  }
+}
+
+}
+
+
+
+
+VisualizationQueue::VisualizationQueue(QObject* parent)
+: QThread(parent),
+  stop_(false),
+  nextTicket_(1)
+{
+  start(QThread::LowPriority);
+}
+
+
+
+
+VisualizationQueue::~VisualizationQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    stop_=true;
+  }
+  cv_.notify_all();
+  wait();
+}
+
+
+
+
+void VisualizationQueue::run()
+{
+  for (;;)
+  {
+    Job j;
+    {
+      std::unique_lock<std::mutex> lock(mx_);
+      cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+      if (stop_) return;
+      j=jobs_.begin()->second;
+      jobs_.erase(jobs_.begin());
+    }
+
+    try
+    {
+      tessellate(j.feature->shape(), j.deviationCoefficient);
+    }
+    catch (const std::exception&)
+    {
+      // nothing to do here:
+      // the error is reported, when the viewer accesses the shape
+    }
+
+    bool notify;
+    {
+      std::lock_guard<std::mutex> lock(mx_);
+      notify=finished_.empty();
+      finished_.push_back(j);
+    }
+    if (notify)
+    {
+      emit visualizationsReady();
+    }
+  }
+}
+
+
+
+
+void VisualizationQueue::removeJobs(const std::set<long>& tickets)
+{
+  std::lock_guard<std::mutex> lock(mx_);
+  for (auto i=jobs_.begin(); i!=jobs_.end(); )
+  {
+    if (tickets.find(i->second.ticket)!=tickets.end())
+      i=jobs_.erase(i);
+    else
+      ++i;
+  }
+}
+
+
+
+
+void VisualizationQueue::enqueue
+(
+    QDisplayableModelTreeItem* item,
+    insight::cad::ConstFeaturePtr feature,
+    bool selected,
+    double deviationCoefficient
+)
+{
+  if (isPending(item)) return;
+
+  long ticket=nextTicket_++;
+  tickets_[ticket] = Ticket{ item, item };
+
+  connect(item, &QObject::destroyed,
+          this, &VisualizationQueue::cancel,
+          Qt::UniqueConnection);
+
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    int p = selected ? 0 : 1;
+    jobs_[std::make_pair(p, ticket)] =
+        Job{ ticket, false, feature, coarseningFactor*deviationCoefficient };
+    jobs_[std::make_pair(2+p, ticket)] =
+        Job{ ticket, true, feature, deviationCoefficient };
+  }
+  cv_.notify_one();
+}
+
+
+
+
+bool VisualizationQueue::isPending(QDisplayableModelTreeItem* item) const
+{
+  for (const auto& t: tickets_)
+  {
+    if (t.second.key==item) return true;
+  }
+  return false;
+}
+
+
+
+
+std::vector<VisualizationQueue::Result> VisualizationQueue::takeFinished()
+{
+  std::vector<Job> finished;
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+    finished.swap(finished_);
+  }
+
+  std::vector<Result> results;
+  for (const Job& j: finished)
+  {
+    auto t=tickets_.find(j.ticket);
+    if (t!=tickets_.end()) // otherwise cancelled
+    {
+      results.push_back(Result{ t->second.item, j.deviationCoefficient, j.isFinal });
+      if (j.isFinal) tickets_.erase(t);
+    }
+  }
+  return results;
+}
+
+
+
+
+void VisualizationQueue::cancel(QObject* item)
+{
+  std::set<long> cancelled;
+  for (auto t=tickets_.begin(); t!=tickets_.end(); )
+  {
+    if (t->second.key==item)
+    {
+      cancelled.insert(t->first);
+      t=tickets_.erase(t);
+    }
+    else
+      ++t;
+  }
+  removeJobs(cancelled);
+}
+
+
+
+
+void VisualizationQueue::cancelAll()
+{
+  tickets_.clear();
+  std::lock_guard<std::mutex> lock(mx_);
+  jobs_.clear();
+}
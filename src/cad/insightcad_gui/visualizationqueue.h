@@ -0,0 +1,137 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef VISUALIZATIONQUEUE_H
+#define VISUALIZATIONQUEUE_H
+
+#include <QThread>
+#include <QPointer>
+
+#include <map>
+#include <set>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#ifndef Q_MOC_RUN
+#include "cadtypes.h"
+#endif
+
+class QDisplayableModelTreeItem;
+
+
+
+/**
+ * Tessellates features for display in a background thread.
+ *
+ * Each request is processed in two levels: first with a coarse deviation
+ * coefficient, then with the requested one. All coarse levels are processed
+ * before any fine level and selected items before the others.
+ * Only the triangulation is computed here; the presentations are created
+ * by the viewer in the GUI thread, after the visualizationsReady signal.
+ * Since the shape then carries a sufficient triangulation, this is fast.
+ * The viewer switches off the automatic triangulation of these presentations,
+ * so that all meshing of feature shapes happens here, also on resolution changes.
+ * Meshing is done through Feature::triangulate, which serializes it
+ * with the other threads working on the same shapes.
+ *
+ * The item pointers are only touched in the GUI thread.
+ */
+class VisualizationQueue
+: public QThread
+{
+  Q_OBJECT
+
+public:
+  struct Result
+  {
+    QPointer<QDisplayableModelTreeItem> item;
+    double deviationCoefficient;
+    bool isFinal;
+  };
+
+  /**
+   * ratio between the deviation coefficients of the coarse and the final level
+   */
+  static const double coarseningFactor;
+
+protected:
+  struct Job
+  {
+    long ticket;
+    bool isFinal;
+    insight::cad::ConstFeaturePtr feature;
+    double deviationCoefficient;
+  };
+
+  struct Ticket
+  {
+    QObject* key;
+    QPointer<QDisplayableModelTreeItem> item;
+  };
+
+  std::mutex mx_;
+  std::condition_variable cv_;
+  bool stop_;
+
+  /**
+   * pending jobs, sorted by (priority, ticket)
+   */
+  std::map<std::pair<int, long>, Job> jobs_;
+  std::vector<Job> finished_;
+
+  // GUI thread only
+  long nextTicket_;
+  std::map<long, Ticket> tickets_;
+
+  void run() override;
+  void removeJobs(const std::set<long>& tickets);
+
+public:
+  VisualizationQueue(QObject* parent = nullptr);
+  ~VisualizationQueue();
+
+  void enqueue
+  (
+      QDisplayableModelTreeItem* item,
+      insight::cad::ConstFeaturePtr feature,
+      bool selected,
+      double deviationCoefficient
+  );
+
+  bool isPending(QDisplayableModelTreeItem* item) const;
+
+  /**
+   * fetch all results, which are available so far
+   */
+  std::vector<Result> takeFinished();
+
+public Q_SLOTS:
+  void cancel(QObject* item);
+  void cancelAll();
+
+Q_SIGNALS:
+  /**
+   * emitted from the worker thread,
+   * when a result becomes available and no others are waiting
+   */
+  void visualizationsReady();
+};
+
+#endif // VISUALIZATIONQUEUE_H
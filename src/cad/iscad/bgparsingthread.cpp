@@ -41,6 +41,15 @@ void BGParsingThread::launch(const std::string& script, Action action)
 }
 
 
+void BGParsingThread::clearParseCache()
+{
+    if (!isRunning())
+    {
+        parseCache_.clear();
+    }
+}
+
+
 
 template<class T>
 class MapDirectory
@@ -76,12 +85,23 @@ public:
 };
 
 
+/**
+ * true, if the symbol refers to the very same object as in the previously rebuilt model.
+ * The parse cache keeps the objects of unchanged statements and their dependencies,
+ * so these need neither to be rebuilt nor to be displayed again.
+ */
+template<class T>
+bool isUnchanged(const T& oldTable, const typename T::value_type& v)
+{
+  typename T::const_iterator i=oldTable.find(v.first);
+  return (i!=oldTable.end()) && (i->second==v.second);
+}
+
+
 void BGParsingThread::run()
 {
     thread_id_=std::this_thread::get_id();
 
-    std::istringstream is(script_);
-
     int failloc=-1;
 
 
@@ -95,7 +115,7 @@ void BGParsingThread::run()
 
       try
       {
-          r=insight::cad::parseISCADModelStream(is, model_.get(), &failloc, &syn_elem_dir_);
+          r=parseCache_.parse(script_, model_.get(), &failloc, &syn_elem_dir_);
       }
       catch (const insight::cad::parser::iscadParserException& e)
       {
@@ -111,7 +131,9 @@ void BGParsingThread::run()
       else
       {
 
-          emit statusMessage("Model parsed successfully.");
+          emit statusMessage(QString("Model parsed successfully (%1 of %2 statements re-parsed).")
+                             .arg(parseCache_.lastStatistics().nParsed)
+                             .arg(parseCache_.lastStatistics().nStatements));
 
           if (action_ >= Rebuild)
           {
@@ -129,17 +151,24 @@ void BGParsingThread::run()
 
               {
                   // get set with scalar symbols before rebuild (for finding out which have vanished)
-                  MapDirectory<insight::cad::Model::ScalarTableContents> removedScalars;
-                  if (oldmodel) removedScalars.set(oldmodel->scalars());
+                  insight::cad::Model::ScalarTableContents oldScalars;
+                  if (oldmodel) oldScalars=oldmodel->scalars();
+                  MapDirectory<insight::cad::Model::ScalarTableContents> removedScalars(oldScalars);
 
                   for (insight::cad::Model::ScalarTableContents::value_type v: scalars)
                   {
+                      removedScalars.removeIfPresent(v.first);
+                      if (isUnchanged(oldScalars, v))
+                      {
+                          is++;
+                          continue;
+                      }
+
                       emit statusMessage("Building scalar "+QString::fromStdString(v.first));
   //                    v.second->value();
                       std::cout<<v.first<<"="<<v.second->value()<<std::endl; // Trigger evaluation
                       emit statusProgress(is++, istepmax);
                       emit createdVariable(QString::fromStdString(v.first), v.second);
-                      removedScalars.removeIfPresent(v.first);
                   }
 
                   for (const std::string& sn: removedScalars)
@@ -150,16 +179,23 @@ void BGParsingThread::run()
 
 
               {
-                  MapDirectory<insight::cad::Model::VectorTableContents> removedPoints;
-                  if (oldmodel) removedPoints.set(oldmodel->points());
+                  insight::cad::Model::VectorTableContents oldPoints;
+                  if (oldmodel) oldPoints=oldmodel->points();
+                  MapDirectory<insight::cad::Model::VectorTableContents> removedPoints(oldPoints);
 
                   for (auto p: points)
                   {
+                      removedPoints.removeIfPresent(p.first);
+                      if (isUnchanged(oldPoints, p))
+                      {
+                          is++;
+                          continue;
+                      }
+
                       emit statusMessage("Building point "+QString::fromStdString(p.first));
                       p.second->value(); // Trigger evaluation
                       emit statusProgress(is++, istepmax);
                       emit createdVariable(QString::fromStdString(p.first), p.second, insight::cad::VectorVariableType::Point);
-                      removedPoints.removeIfPresent(p.first);
                   }
 
                   for (const auto& sn: removedPoints)
@@ -169,16 +205,23 @@ void BGParsingThread::run()
               }
 
               {
-                  MapDirectory<insight::cad::Model::VectorTableContents> removedDirections;
-                  if (oldmodel) removedDirections.set(oldmodel->directions());
+                  insight::cad::Model::VectorTableContents oldDirections;
+                  if (oldmodel) oldDirections=oldmodel->directions();
+                  MapDirectory<insight::cad::Model::VectorTableContents> removedDirections(oldDirections);
 
                   for (auto d: directions)
                   {
+                      removedDirections.removeIfPresent(d.first);
+                      if (isUnchanged(oldDirections, d))
+                      {
+                          is++;
+                          continue;
+                      }
+
                       emit statusMessage("Building vector "+QString::fromStdString(d.first));
                       d.second->value(); // Trigger evaluation
                       emit statusProgress(is++, istepmax);
                       emit createdVariable(QString::fromStdString(d.first), d.second, insight::cad::VectorVariableType::Direction);
-                      removedDirections.removeIfPresent(d.first);
                   }
 
                   for (const auto& sn: removedDirections)
@@ -188,11 +231,19 @@ void BGParsingThread::run()
               }
 
               {
-                  MapDirectory<insight::cad::Model::ModelstepTableContents> removedFeatures;
-                  if (oldmodel) removedFeatures.set(oldmodel->modelsteps());
+                  insight::cad::Model::ModelstepTableContents oldFeatures;
+                  if (oldmodel) oldFeatures=oldmodel->modelsteps();
+                  MapDirectory<insight::cad::Model::ModelstepTableContents> removedFeatures(oldFeatures);
 
                   for (insight::cad::Model::ModelstepTableContents::value_type v: modelsteps)
                   {
+                      removedFeatures.removeIfPresent(v.first);
+                      if (isUnchanged(oldFeatures, v))
+                      {
+                          is++;
+                          continue;
+                      }
+
                       bool is_comp=false;
                       if (model_->components().find(v.first) != model_->components().end())
                       {
@@ -205,8 +256,6 @@ void BGParsingThread::run()
                       v.second->checkForBuildDuringAccess(); // Trigger rebuild
                       emit statusProgress(is++, istepmax);
                       emit createdFeature(QString::fromStdString(v.first), v.second, is_comp);
-
-                      removedFeatures.removeIfPresent(v.first);
                   }
 
                   for (const std::string& sn: removedFeatures)
@@ -217,16 +266,23 @@ void BGParsingThread::run()
               }
 
               {
-                  MapDirectory<insight::cad::Model::DatumTableContents> removedDatums;
-                  if (oldmodel) removedDatums.set(oldmodel->datums());
+                  insight::cad::Model::DatumTableContents oldDatums;
+                  if (oldmodel) oldDatums=oldmodel->datums();
+                  MapDirectory<insight::cad::Model::DatumTableContents> removedDatums(oldDatums);
 
                   for (insight::cad::Model::DatumTableContents::value_type v: datums)
                   {
+                      removedDatums.removeIfPresent(v.first);
+                      if (isUnchanged(oldDatums, v))
+                      {
+                          is++;
+                          continue;
+                      }
+
                       emit statusMessage("Building datum "+QString::fromStdString(v.first));
                       v.second->checkForBuildDuringAccess(); // Trigger rebuild
                       emit statusProgress(is++, istepmax);
                       emit createdDatum(QString::fromStdString(v.first), v.second);
-                      removedDatums.removeIfPresent(v.first);
                   }
 
                   for (const std::string& sn: removedDatums)
@@ -28,6 +28,7 @@
 #include "cadmodel.h"
 #include "cadtypes.h"
 #include "parser.h"
+#include "parsecache.h"
 #endif
 
 class ISCADSyntaxHighlighter;
@@ -51,6 +52,11 @@ protected:
     Action action_;
     std::thread::id thread_id_;
 
+    /**
+     * keeps the parse results of unchanged statements between launches
+     */
+    insight::cad::parser::ParseCache parseCache_;
+
 public:
     insight::cad::ModelPtr last_rebuilt_model_, model_;
     insight::cad::parser::SyntaxElementDirectoryPtr syn_elem_dir_;
@@ -69,6 +75,12 @@ public:
     inline Action action() const { return action_; }
     void cancelRebuild();
 
+    /**
+     * forget all cached parse results,
+     * the next rebuild will then process all symbols
+     */
+    void clearParseCache();
+
 signals:
 
     void createdVariable    (const QString& sn, insight::cad::ScalarPtr sv);
@@ -549,6 +549,7 @@ void ISCADModel::rebuildModel(bool upToCursor)
               skipPostprocActions_ ? BGParsingThread::Rebuild : BGParsingThread::Post
             );
 
+        emit rebuildStarted();
     }
     else
     {
@@ -565,6 +566,8 @@ void ISCADModel::rebuildModelUpToCursor()
 void ISCADModel::clearCache()
 {
     insight::cad::cache.clear();
+    insight::cad::Feature::clearViewCache();
+    bgparsethread_.clearParseCache();
 }
 
 
@@ -810,6 +813,8 @@ ISCADModelEditor::ISCADModelEditor(QWidget* parent)
             viewer_, &QoccViewWidget::onFocus);
     connect(model_, &ISCADModel::unfocus,
             viewer_, &QoccViewWidget::onUnfocus);
+    connect(model_, &ISCADModel::rebuildStarted,
+            viewer_, &QoccViewWidget::cancelPendingVisualizations);
 
     connect(modeltree_, &QModelTree::insertIntoNotebook,
             this, &ISCADModelEditor::onInsertNotebookText);
@@ -255,6 +255,11 @@ Q_SIGNALS:
      * errorState != 0 indicates that an error occurred and the model may be incomplete
      */
     void modelUpdated(int errorState =0);
+
+    /**
+     * a rebuild of the model has been launched, all features will be replaced
+     */
+    void rebuildStarted();
     
     /**
      * open another model for editing
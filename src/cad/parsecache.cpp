@@ -0,0 +1,495 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "parsecache.h"
+
+#include "boost/functional/hash.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <memory>
+#include <set>
+
+using namespace std;
+
+namespace insight {
+namespace cad {
+namespace parser {
+
+
+
+
+namespace
+{
+
+struct ScriptStatement
+{
+  std::size_t begin, end;
+  std::string firstIdentifier;
+  bool isPropertyAssignment;
+  std::vector<std::string> identifiers;
+  std::vector<std::string> referencedFiles;
+
+  ScriptStatement()
+    : begin(0), end(0), isPropertyAssignment(false)
+  {}
+};
+
+
+/**
+ * splits a script into header, top-level statements and the doc/post sections.
+ * Comments are recognized in the same way as by skip_grammar.
+ */
+class ScriptScanner
+{
+  const std::string& s_;
+  std::size_t i_;
+
+  inline bool atEnd() const { return i_>=s_.size(); }
+  inline char cur() const { return s_[i_]; }
+  inline char next() const { return i_+1<s_.size() ? s_[i_+1] : '\0'; }
+
+  bool skipComment()
+  {
+    if (cur()=='/' && next()=='*')
+    {
+      std::size_t e=s_.find("*/", i_+2);
+      if (e==std::string::npos) return false; // unterminated, leave to the parser
+      i_=e+2;
+      return true;
+    }
+    else if ( (cur()=='/' && next()=='/') || cur()=='#' )
+    {
+      std::size_t e=s_.find('\n', i_);
+      i_ = (e==std::string::npos) ? s_.size() : e+1;
+      return true;
+    }
+    return false;
+  }
+
+  void skipSpace()
+  {
+    while (!atEnd())
+    {
+      if (std::isspace(static_cast<unsigned char>(cur())))
+        ++i_;
+      else if (!skipComment())
+        break;
+    }
+  }
+
+  void skipQuoted()
+  {
+    std::size_t e=s_.find(cur(), i_+1);
+    i_ = (e==std::string::npos) ? s_.size() : e+1;
+  }
+
+  inline bool isIdentifierStart() const
+  {
+    return std::isalpha(static_cast<unsigned char>(cur()));
+  }
+
+  std::string identifier()
+  {
+    std::size_t b=i_;
+    while (!atEnd() && (std::isalnum(static_cast<unsigned char>(cur())) || cur()=='_')) ++i_;
+    return s_.substr(b, i_-b);
+  }
+
+public:
+  ScriptScanner(const std::string& s)
+    : s_(s), i_(0)
+  {}
+
+  inline std::size_t pos() const { return i_; }
+
+  /**
+   * optional description string and cost statement
+   */
+  std::size_t scanHeader()
+  {
+    skipSpace();
+    if (!atEnd() && cur()=='\'') skipQuoted();
+    std::size_t afterDescription=i_;
+
+    skipSpace();
+    if (!atEnd() && isIdentifierStart() && identifier()=="cost")
+    {
+      skipSpace();
+      if (!atEnd() && (std::isdigit(static_cast<unsigned char>(cur())) || cur()=='+' || cur()=='-' || cur()=='.'))
+      {
+        std::size_t e=s_.find(';', i_);
+        i_ = (e==std::string::npos) ? s_.size() : e+1;
+        return i_;
+      }
+    }
+
+    i_=afterDescription;
+    return i_;
+  }
+
+  /**
+   * returns false at the end of the script or at the beginning of the doc/post sections
+   */
+  bool scanStatement(ScriptStatement& st)
+  {
+    skipSpace();
+    if (atEnd() || cur()=='@') return false;
+
+    st=ScriptStatement();
+    st.begin=i_;
+    int depth=0;
+    while (!atEnd())
+    {
+      char c=cur();
+      if ( (c=='/' || c=='#') && skipComment() )
+        continue;
+      else if (c=='\'' || c=='"')
+      {
+        std::size_t b=i_;
+        skipQuoted();
+        if (c=='"' && i_-b>=2)
+          st.referencedFiles.push_back(s_.substr(b+1, i_-b-2));
+        continue;
+      }
+      else if (isIdentifierStart())
+      {
+        std::string id=identifier();
+        if (st.identifiers.empty())
+        {
+          std::size_t p=i_;
+          st.firstIdentifier=id;
+          skipSpace();
+          st.isPropertyAssignment = s_.compare(i_, 2, "->")==0;
+          i_=p;
+        }
+        if (id=="loadmodel")
+        {
+          std::size_t p=i_;
+          skipSpace();
+          if (!atEnd() && cur()=='(')
+          {
+            ++i_;
+            skipSpace();
+            if (!atEnd() && isIdentifierStart())
+              st.referencedFiles.push_back(identifier()+".iscad");
+          }
+          i_=p;
+        }
+        st.identifiers.push_back(id);
+        continue;
+      }
+      else if (std::isdigit(static_cast<unsigned char>(c)))
+      {
+        while (!atEnd() && (std::isalnum(static_cast<unsigned char>(cur())) || cur()=='.' || cur()=='_')) ++i_;
+        continue;
+      }
+      else if (c=='(' || c=='[' || c=='{')
+        depth++;
+      else if (c==')' || c==']' || c=='}')
+        depth=std::max(0, depth-1);
+      else if (depth==0 && c=='@')
+        break;
+      else if (depth==0 && c==';')
+      {
+        ++i_;
+        break;
+      }
+      ++i_;
+    }
+    st.end=i_;
+
+    std::sort(st.identifiers.begin(), st.identifiers.end());
+    st.identifiers.erase(std::unique(st.identifiers.begin(), st.identifiers.end()), st.identifiers.end());
+    return true;
+  }
+};
+
+
+/**
+ * installs a definition recorder for the lifetime of this object
+ */
+struct DefinitionRecording
+{
+  Model* model_;
+
+  DefinitionRecording(Model* m, const Model::DefinitionRecorder& r)
+    : model_(m)
+  {
+    model_->setDefinitionRecorder(r);
+  }
+
+  ~DefinitionRecording()
+  {
+    model_->setDefinitionRecorder(Model::DefinitionRecorder());
+  }
+};
+
+}
+
+
+
+
+ParseCache::ParseCache()
+  : nextSerial_(1)
+{
+  lastStatistics_.nStatements=0;
+  lastStatistics_.nParsed=0;
+}
+
+
+
+
+bool ParseCache::parse
+(
+    const std::string& script,
+    Model* m,
+    int* failloc,
+    SyntaxElementDirectoryPtr* sd,
+    const boost::filesystem::path& filenameinfo
+)
+{
+  std::string contents(script);
+
+  std::size_t headerEnd, sectionsBegin;
+  std::vector<ScriptStatement> statements;
+  {
+    ScriptScanner scanner(contents);
+    headerEnd=scanner.scanHeader();
+    ScriptStatement st;
+    while (scanner.scanStatement(st))
+      statements.push_back(st);
+    sectionsBegin=scanner.pos();
+  }
+
+  lastStatistics_.nStatements=statements.size();
+  lastStatistics_.nParsed=0;
+
+  // property assignments modify the feature in place:
+  // the defining statement of a feature is invalidated, if any of them changes
+  std::vector<std::size_t> hashes;
+  std::map<std::string, std::size_t> mutatorHashes;
+  std::unique_ptr<sharedModelLocations> locations;
+  for (const ScriptStatement& st: statements)
+  {
+    std::size_t h=boost::hash_range(contents.begin()+st.begin, contents.begin()+st.end);
+
+    // statements, which load submodels or import files, have to be re-parsed,
+    // when the file is modified (files referenced by submodels are not tracked)
+    for (const std::string& fn: st.referencedFiles)
+    {
+      if (!locations) locations.reset(new sharedModelLocations);
+      for (const boost::filesystem::path& l: *locations)
+      {
+        boost::filesystem::path p = boost::filesystem::path(fn).is_absolute() ? fn : l/fn;
+        boost::system::error_code ec;
+        std::time_t t = boost::filesystem::last_write_time(p, ec);
+        if (!ec)
+        {
+          boost::hash_combine(h, t);
+          break;
+        }
+      }
+    }
+
+    hashes.push_back(h);
+    if (st.isPropertyAssignment)
+      boost::hash_combine(mutatorHashes[st.firstIdentifier], h);
+  }
+
+  std::string::iterator orgbegin=contents.begin();
+
+  std::map<std::string, long> definingStatement;
+  std::map<std::size_t, int> occurrences;
+  std::set<EntryKey> used;
+
+  try
+  {
+    ISCADParser parser ( m, filenameinfo );
+    skip_grammar skip;
+    parser.current_pos.setStartPos ( orgbegin );
+
+    auto parsePart = [&]
+        (
+          const qi::rule<std::string::iterator, skip_grammar>& r,
+          std::size_t b, std::size_t e
+        ) -> bool
+    {
+      std::string::iterator first=orgbegin+b, last=orgbegin+e;
+      bool ok = qi::phrase_parse ( first, last, r, skip );
+      if ( !ok || (first != last) )
+      {
+        if ( failloc ) *failloc=int ( first-orgbegin );
+        return false;
+      }
+      return true;
+    };
+
+    if (!parsePart(parser.r_header, 0, headerEnd))
+      return false;
+
+    for (std::size_t k=0; k<statements.size(); k++)
+    {
+      const ScriptStatement& st=statements[k];
+      EntryKey key(hashes[k], occurrences[hashes[k]]++);
+      used.insert(key);
+
+      std::size_t mutatorHash=0;
+      if (!st.isPropertyAssignment)
+      {
+        auto mh=mutatorHashes.find(st.firstIdentifier);
+        if (mh!=mutatorHashes.end()) mutatorHash=mh->second;
+      }
+
+      auto lookupDefinition = [&](const std::string& name) -> long
+      {
+        auto i=definingStatement.find(name);
+        return i==definingStatement.end() ? 0 : i->second;
+      };
+
+      EntryTable::iterator ie=entries_.find(key);
+      bool reuse =
+          ie!=entries_.end()
+          && contents.compare(st.begin, st.end-st.begin, ie->second.text)==0
+          && ie->second.mutatorHash==mutatorHash;
+      if (reuse)
+      {
+        for (const auto& d: ie->second.dependencies)
+        {
+          if (lookupDefinition(d.first)!=d.second)
+          {
+            reuse=false;
+            break;
+          }
+        }
+      }
+
+      if (reuse)
+      {
+        const Entry& e=ie->second;
+        for (const Model::DefinitionReplay& r: e.replay)
+          r(*m);
+        for (const auto& se: e.syntaxElements)
+        {
+          parser.syntax_element_locations->addEntry
+              (
+                SyntaxElementLocation(
+                  filenameinfo,
+                  SyntaxElementPos(se.first.first+st.begin, se.first.second+st.begin)
+                  ),
+                se.second
+              );
+        }
+      }
+      else
+      {
+        Entry e;
+        e.text=contents.substr(st.begin, st.end-st.begin);
+        e.serial=nextSerial_++;
+        e.mutatorHash=mutatorHash;
+        for (const std::string& id: st.identifiers)
+          e.dependencies.push_back(std::make_pair(id, lookupDefinition(id)));
+
+        {
+          DefinitionRecording rec
+              (
+                m,
+                [&e](const std::string& name, const Model::DefinitionReplay& r)
+                {
+                  e.definedSymbols.push_back(name);
+                  e.replay.push_back(r);
+                }
+              );
+
+          if (!parsePart(parser.r_statement, st.begin, st.end))
+            return false;
+        }
+
+        const SyntaxElementDirectory& dir=*parser.syntax_element_locations;
+        for
+        (
+          SyntaxElementDirectory::const_iterator i=dir.lower_bound(
+              SyntaxElementLocation(filenameinfo, SyntaxElementPos(st.begin, std::numeric_limits<long>::min())) );
+          i!=dir.end() && i->first.first==filenameinfo && i->first.second.first<long(st.end);
+          ++i
+        )
+        {
+          e.syntaxElements.push_back
+              (
+                std::make_pair
+                (
+                  SyntaxElementPos(i->first.second.first-st.begin, i->first.second.second-st.begin),
+                  i->second
+                )
+              );
+        }
+
+        // also covers the target of property assignments
+        e.definedSymbols.push_back(st.firstIdentifier);
+
+        entries_[key]=e;
+        ie=entries_.find(key);
+        lastStatistics_.nParsed++;
+      }
+
+      for (const std::string& s: ie->second.definedSymbols)
+        definingStatement[s]=ie->second.serial;
+    }
+
+    if (!parsePart(parser.r_sections, sectionsBegin, contents.size()))
+      return false;
+
+    if ( sd )
+      *sd = parser.syntax_element_locations;
+  }
+  catch ( const qi::expectation_failure<std::string::iterator>& e )
+  {
+    std::ostringstream os;
+    os << e.what_;
+    throw iscadParserException(os.str(), int(e.first-orgbegin), int(e.last-orgbegin));
+  }
+
+  // forget statements, which are no longer part of the script
+  for (EntryTable::iterator i=entries_.begin(); i!=entries_.end(); )
+  {
+    if (used.find(i->first)==used.end())
+      i=entries_.erase(i);
+    else
+      ++i;
+  }
+
+  return true;
+}
+
+
+
+
+void ParseCache::clear()
+{
+  entries_.clear();
+}
+
+
+
+
+}
+}
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef INSIGHT_CAD_PARSECACHE_H
+#define INSIGHT_CAD_PARSECACHE_H
+
+#include "parser.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace insight {
+namespace cad {
+namespace parser {
+
+
+
+/**
+ * Incremental parser for ISCAD scripts.
+ *
+ * The script is split into its top-level statements (header, assignments,
+ * modelsteps, property assignments and the trailing doc/post sections).
+ * For every statement, the symbol definitions it produced are remembered
+ * under the hash of its text. On the next parse, a statement is only run
+ * through the grammar again, if its text changed or if one of the symbols
+ * it refers to was (re-)defined by a different statement than before.
+ * All other statements are replayed from the cache.
+ *
+ * Dependencies are determined lexically: every identifier in the statement
+ * text counts as a reference. This is conservative, i.e. it might re-parse
+ * more than necessary but never too little.
+ *
+ * The cached definitions are the live objects of the previous model.
+ * A cache instance must therefore always be used with models,
+ * which start from the same set of predefined variables.
+ */
+class ParseCache
+{
+public:
+  struct Statistics
+  {
+    int nStatements;
+    int nParsed;
+  };
+
+protected:
+  struct Entry
+  {
+    std::string text;
+
+    /**
+     * id of this version of the statement.
+     * Changes each time, the statement is parsed again.
+     */
+    long serial;
+
+    /**
+     * the ids of the defining statements of all identifiers,
+     * as they were at the time of parsing (0: not defined)
+     */
+    std::vector<std::pair<std::string, long> > dependencies;
+
+    /**
+     * hash over all property assignments, which modify the symbol defined here
+     */
+    std::size_t mutatorHash;
+
+    std::vector<std::string> definedSymbols;
+    std::vector<Model::DefinitionReplay> replay;
+
+    /**
+     * syntax element locations, relative to the beginning of the statement
+     */
+    std::vector<std::pair<SyntaxElementPos, FeaturePtr> > syntaxElements;
+  };
+
+  typedef std::pair<std::size_t, int> EntryKey;
+  typedef std::map<EntryKey, Entry> EntryTable;
+
+  EntryTable entries_;
+  long nextSerial_;
+  Statistics lastStatistics_;
+
+public:
+  ParseCache();
+
+  /**
+   * parse the script into the model m.
+   * Has the same semantics as parseISCADModelStream.
+   */
+  bool parse
+  (
+      const std::string& script,
+      Model* m,
+      int* failloc=NULL,
+      SyntaxElementDirectoryPtr* sd=NULL,
+      const boost::filesystem::path& filenameinfo=""
+  );
+
+  void clear();
+
+  inline const Statistics& lastStatistics() const { return lastStatistics_; }
+};
+
+
+
+}
+}
+}
+
+#endif // INSIGHT_CAD_PARSECACHE_H
@@ -216,21 +216,36 @@ ISCADParser::ISCADParser(Model* model, const boost::filesystem::path& filenamein
 {
     r_model =
 //      current_pos.save_start_pos >>
+        r_header
+        >>
+        *r_statement
+        >>
+        r_sections
+        ;
+    r_model.name("model description");
+
+    // the parts of r_model are also used separately by the parse cache
+    r_header =
         ( r_string | qi::attr(std::string()) ) [ phx::bind( &Model::setDescription, model_, qi::_1 ) ]
         >>
         ( (qi::lit("cost") >> qi::double_ >> ';' ) | qi::attr(0.0) ) [ phx::bind( &Model::setCost, model_, qi::_1 ) ]
-        >>
-        *(
+        ;
+    r_header.name("model header");
+
+    r_statement =
             r_assignment
             |
             r_modelstep
             |
             r_solidmodel_propertyAssignment
-        )
-        >> -( lit("@doc") > *r_doc )
+        ;
+    r_statement.name("statement");
+
+    r_sections =
+        -( lit("@doc") > *r_doc )
         >> -( lit("@post") > *r_postproc )
         ;
-    r_model.name("model description");
+    r_sections.name("doc and postprocessing sections");
 
 
     r_identifier = lexeme[ alpha >> *(alnum | char_('_')) >> !(alnum | '_') ];
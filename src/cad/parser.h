@@ -25,6 +25,7 @@
 #include "base/exception.h"
 #include "base/linearalgebra.h"
 #include "cadpostprocactions/drawingexport.h"
+#include "cadpostprocactions/hydrostatictable.h"
 
 #ifndef Q_MOC_RUN
 #include "boost/spirit/include/qi.hpp"
@@ -166,11 +167,12 @@ struct ISCADParser
     qi::rule<std::string::iterator, FeatureSetPtr(), skip_grammar, qi::locals<FeaturePtr> > r_solidFeaturesExpression;
     qi::rule<std::string::iterator, DatumPtr(), skip_grammar> r_datumExpression;
     
-    qi::rule<std::string::iterator, skip_grammar> r_model;
+    qi::rule<std::string::iterator, skip_grammar> r_model, r_header, r_statement, r_sections;
     qi::rule<std::string::iterator, skip_grammar> r_assignment;
     qi::rule<std::string::iterator, qi::locals<FeaturePtr>, skip_grammar> r_solidmodel_propertyAssignment;
     qi::rule<std::string::iterator, skip_grammar> r_postproc, r_doc;
     qi::rule<std::string::iterator, DrawingViewDefinition(), skip_grammar> r_viewDef;
+    qi::rule<std::string::iterator, HydrostaticRange(), skip_grammar> r_hydrostaticRange;
     qi::symbols<char, ModelstepRulePtr> modelstepFunctionRules;
     qi::rule<std::string::iterator, boost::fusion::vector3<std::size_t, std::size_t, FeaturePtr>(), skip_grammar, qi::locals<ModelstepRulePtr> > r_modelstepFunction;
     ModelstepRule r_modelstep;
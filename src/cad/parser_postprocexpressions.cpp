@@ -92,6 +92,14 @@ void ISCADParser::createPostProcExpressions()
         ;
     r_viewDef.name("view definition");
 
+    r_hydrostaticRange =
+        '(' >> r_scalarExpression
+        >> ( ( lit("to") >> r_scalarExpression ) | attr(ScalarPtr()) )
+        >> ( ( ':' >> r_scalarExpression ) | attr(ScalarPtr()) )
+        >> ')'
+        ;
+    r_hydrostaticRange.name("hydrostatic range");
+
     r_postproc =
 
         /** \page iscad_postprocessing_DXF DXF: Save DXF drawing.
@@ -233,6 +241,31 @@ void ISCADParser::createPostProcExpressions()
         [ phx::bind(&Model::addPostprocAction, model_, qi::_1,
                     phx::construct<PostprocActionPtr>(new_<Hydrostatics>(qi::_6, qi::_7, qi::_2, qi::_3, qi::_4, qi::_5)))
         ]
+        |
+
+        /** \page iscad_postprocessing_hydrostatictable HydrostaticTable: Hydrostatic data for a range of floating conditions
+        *
+        * Syntax:
+        *
+        * <b>HydrostaticTable( \ref iscad_identifier_expression "<identifier:name>", \ref iscad_filename_expression "<filename:CSV output>",
+        *    \ref iscad_vector_expression "<vector:draft reference point>", \ref iscad_vector_expression "<vector:longitudinal direction>", \ref iscad_vector_expression "<vector:vertical direction>" )
+        *   << ( \ref iscad_feature_expression "<feature:hull volume>", \ref iscad_feature_expression "<feature:ship model>" )
+        *   drafts = ( \ref iscad_scalar_expression "<scalar:first>" [ to \ref iscad_scalar_expression "<scalar:last>" : \ref iscad_scalar_expression "<scalar:number of values>" ] )
+        *  [heel = ( ... )] [trim = ( ... )] </b>
+        *
+        * Heel and trim angles are given in degrees. They rotate the waterplane about the longitudinal and the lateral axis.
+        */
+        ( lit("HydrostaticTable") >> '('
+          >> r_identifier >> ',' >> r_path >> ','
+          >> r_vectorExpression >> ',' >> r_vectorExpression >> ',' >> r_vectorExpression
+          >> ')' >> lit("<<") >> '(' >> r_solidmodel_expression >> ',' >> r_solidmodel_expression >> ')'
+          >> lit("drafts") >> '=' >> r_hydrostaticRange
+          >> ( ( lit("heel") >> '=' >> r_hydrostaticRange ) | attr(HydrostaticRange()) )
+          >> ( ( lit("trim") >> '=' >> r_hydrostaticRange ) | attr(HydrostaticRange()) )
+          >> ';' )
+        [ phx::bind(&Model::addPostprocAction, model_, qi::_1,
+                    phx::construct<PostprocActionPtr>(new_<HydrostaticTable>(qi::_2, qi::_3, qi::_4, qi::_5, qi::_6, qi::_7, qi::_8, qi::_9, qi::_10)))
+        ]
         ;
     r_postproc.name("postprocessing statement");
 
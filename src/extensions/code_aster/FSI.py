@@ -1,5 +1,5 @@
 
-import os, sys, re, time, math
+import os, sys, re, time, math, socket, struct
 import numpy as np
 import scipy.interpolate as spi
 
@@ -49,6 +49,112 @@ class ScratchDirComm(object):
       save_remove(os.path.join(self.scratchdir, "complete.%s"%p.cfdname))
       time.sleep(0.5)
 
+  def readLocations(self, cfdname):
+    return np.loadtxt(os.path.join(self.scratchdir, "locations."+cfdname), delimiter=";")
+
+  def readPressures(self, cfdname):
+    return np.loadtxt(os.path.join(self.scratchdir, "pressure_values."+cfdname), delimiter=";")
+
+  def writeDisplacements(self, cfdname, u_pts):
+    f=open(os.path.join(self.scratchdir, "displacements."+cfdname), 'w')
+    f.write("(\n")
+    for u in u_pts: 
+      f.write("(%g %g %g)\n"%(u[0], u[1], u[2]))
+    f.write(")\n")
+    f.flush()
+    os.fsync(f.fileno())
+    f.close()
+
+
+
+class SocketComm(object):
+  """
+  Exchange with the FEMDisplacement boundary condition (option "coupling socket;")
+  by binary arrays over one Unix domain socket per coupled patch.
+  The message format has to match fsicouplingchannel.cpp:
+  header (uint32 type, uint32 version, uint64 number of values), then the values as doubles.
+  """
+  
+  header=struct.Struct("=IIQ")
+  version=1
+  LOCATIONS, PRESSURES, DISPLACEMENTS, STOP = 1, 2, 3, 4
+  
+  def __init__(self, basepath):
+    self.scratchdir=os.path.join(basepath, "scratch")
+    if not os.path.exists(self.scratchdir):
+      os.makedirs(self.scratchdir)
+    print "Using scratchdir: ", self.scratchdir, ", waiting for connections."
+    
+    self.listeners={}
+    self.connections={}
+    self.locations={}
+    self.pressures={}
+    
+  def socketPath(self, cfdname):
+    return os.path.join(self.scratchdir, "fsi.%s.socket"%cfdname)
+  
+  def connection(self, cfdname):
+    if not cfdname in self.connections:
+      if not cfdname in self.listeners:
+        sp=self.socketPath(cfdname)
+        save_remove(sp) # left over from previous run
+        l=socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        l.bind(sp)
+        l.listen(1)
+        self.listeners[cfdname]=l
+      c,_=self.listeners[cfdname].accept()
+      self.connections[cfdname]=c
+    return self.connections[cfdname]
+  
+  def recvAll(self, c, n):
+    buf=[]
+    while n>0:
+      d=c.recv(min(n, 1<<20))
+      if not d:
+        raise GetOutOfLoop()
+      buf.append(d)
+      n-=len(d)
+    return "".join(buf)
+      
+  def receive(self, cfdname):
+    c=self.connection(cfdname)
+    t,v,n=self.header.unpack(self.recvAll(c, self.header.size))
+    if v!=self.version:
+      raise Exception("Unsupported FSI protocol version %d"%v)
+    if t==self.STOP:
+      c.close()
+      del self.connections[cfdname]
+      raise GetOutOfLoop()
+    data=np.frombuffer(self.recvAll(c, 8*n), dtype=np.float64)
+    if t==self.LOCATIONS:
+      self.locations[cfdname]=data.reshape(-1,3)
+    elif t==self.PRESSURES:
+      self.pressures[cfdname]=data
+    else:
+      raise Exception("Unexpected FSI message type %d"%t)
+    
+  def waitForCFDResults(self, pairs):
+    for p in pairs:
+      while not p.cfdname in self.pressures:
+        self.receive(p.cfdname)
+        
+  def releaseFEMResults(self, pairs):
+    pass # displacements have been sent already
+  
+  def readLocations(self, cfdname):
+    while not cfdname in self.locations:
+      self.receive(cfdname)
+    return self.locations[cfdname]
+
+  def readPressures(self, cfdname):
+    return self.pressures.pop(cfdname)
+
+  def writeDisplacements(self, cfdname, u_pts):
+    u=np.ascontiguousarray(u_pts, dtype=np.float64).reshape(-1)
+    c=self.connection(cfdname)
+    c.sendall(self.header.pack(self.DISPLACEMENTS, self.version, u.size))
+    c.sendall(u.tostring())
+
 
 
 class CFDFEMPair(object):
@@ -107,11 +213,11 @@ class IpolCFDFEMPair(CFDFEMPair):
 
     def __init__(self, scratchdircomm, model, label, pairinfo):
       super(IpolCFDFEMPair, self).__init__(scratchdircomm, model, label, pairinfo)
-      self.pts=np.loadtxt(os.path.join(self.scratchdircomm.scratchdir, "locations."+self.cfdname), delimiter=";")
+      self.pts=self.scratchdircomm.readLocations(self.cfdname)
       #self.tree=Invdisttree(self.pts)
 
     def reread(self):
-        cfd_p=np.loadtxt(os.path.join(self.scratchdircomm.scratchdir, "pressure_values."+self.cfdname), delimiter=";")
+        cfd_p=self.scratchdircomm.readPressures(self.cfdname)
         #self.tree.setData(cfd_p)
         self.pinterp=spi.NearestNDInterpolator(self.pts, cfd_p)
         
@@ -169,14 +275,7 @@ class IpolCFDFEMPair(CFDFEMPair):
         print "Pair %s/%s: min cmpt="%(self.cfdname,self.femname), \
 	      np.min(u_pts), "max cmpt=", np.max(u_pts)
 	      
-        f=open(os.path.join(self.scratchdircomm.scratchdir, "displacements."+self.cfdname), 'w')
-        f.write("(\n")
-        for j,u in enumerate(u_pts): 
-	  f.write("(%g %g %g)\n"%(u[0], u[1], u[2]))
-        f.write(")\n")
-        f.flush()
-        os.fsync(f.fileno())
-        f.close()
+        self.scratchdircomm.writeDisplacements(self.cfdname, u_pts)
         
 	DETRUIRE(CONCEPT=( _F(NOM=(utab) ) ), INFO=1);
 
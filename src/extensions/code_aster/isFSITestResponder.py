@@ -0,0 +1,69 @@
+#!/usr/bin/env python2
+
+# Stand-in for the Code_Aster side of an FSI coupling with the FEMDisplacement boundary condition.
+# Answers each pressure transfer immediately with the displacement of a linear spring:
+#   u = compliance * p * direction
+# Useful for testing the coupling setup and for measuring the coupling overhead.
+
+import os, sys, time
+import numpy as np
+from optparse import OptionParser
+
+from Aster.FSI import ScratchDirComm, SocketComm, GetOutOfLoop
+
+parser = OptionParser(usage="%prog [options] <CFD patch name> [<CFD patch name> ...]")
+parser.add_option("-b", "--basepath", dest="basepath", metavar='DIR', default=".",
+                  help="directory, which contains the scratch directory (FEMCaseDir of the BC is <basepath>/scratch)")
+parser.add_option("-c", "--coupling", dest="coupling", metavar='files|socket', default="files",
+                  help="coupling protocol, has to match the setting of the BC")
+parser.add_option("-k", "--compliance", dest="compliance", metavar='K', type="float", default=1e-6,
+                  help="displacement per unit pressure")
+parser.add_option("-d", "--direction", dest="direction", metavar='X,Y,Z', default="0,0,1",
+                  help="direction of the displacement")
+parser.add_option("-n", "--max-iterations", dest="maxIter", metavar='N', type="int", default=0,
+                  help="stop after N coupling iterations (0: until the CFD side stops)")
+
+(opts, args) = parser.parse_args()
+
+if len(args)<1:
+  parser.error("at least one patch name is required")
+
+
+class Pair(object):
+  def __init__(self, cfdname):
+    self.cfdname=cfdname
+
+
+if opts.coupling=="socket":
+  comm=SocketComm(opts.basepath)
+elif opts.coupling=="files":
+  comm=ScratchDirComm(opts.basepath)
+else:
+  parser.error("unknown coupling protocol: "+opts.coupling)
+
+pairs=[Pair(n) for n in args]
+direction=np.array([float(c) for c in opts.direction.split(",")])
+
+i=0
+try:
+  while opts.maxIter<=0 or i<opts.maxIter:
+    t0=time.time()
+    comm.waitForCFDResults(pairs)
+    t1=time.time()
+    
+    for p in pairs:
+      pts=comm.readLocations(p.cfdname)
+      pres=np.atleast_1d(comm.readPressures(p.cfdname))
+      u=opts.compliance*np.outer(pres[:len(pts)], direction)
+      comm.writeDisplacements(p.cfdname, u)
+    comm.releaseFEMResults(pairs)
+    t2=time.time()
+    
+    i+=1
+    print("iteration %d: waited %g s for CFD, answered after %g s"%(i, t1-t0, t2-t1))
+    sys.stdout.flush()
+    
+except GetOutOfLoop:
+  pass
+
+print("Finished after %d coupling iterations."%i)
@@ -0,0 +1,384 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "fsicouplingchannel.h"
+#include "addToRunTimeSelectionTable.H"
+#include "IFstream.H"
+#include "OFstream.H"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+namespace Foam
+{
+
+
+
+
+namespace
+{
+
+// has to match src/extensions/code_aster/FSI.py
+
+const uint32_t FSI_PROTOCOL_VERSION=1;
+
+enum FSIMessageType
+{
+  FSI_LOCATIONS=1,
+  FSI_PRESSURES=2,
+  FSI_DISPLACEMENTS=3,
+  FSI_STOP=4
+};
+
+struct FSIMessageHeader
+{
+  uint32_t type;
+  uint32_t version;
+  uint64_t count;
+};
+
+void sleepSeconds(scalar t)
+{
+  timespec ts;
+  ts.tv_sec=time_t(t);
+  ts.tv_nsec=long(1e9*(t-scalar(ts.tv_sec)));
+  while (nanosleep(&ts, &ts)!=0 && errno==EINTR)
+  {}
+}
+
+bool sendAll(int fd, const char* data, size_t n)
+{
+  while (n>0)
+  {
+    ssize_t r = ::send(fd, data, n, MSG_NOSIGNAL);
+    if (r<0 && errno==EINTR) continue;
+    if (r<=0) return false;
+    data+=r;
+    n-=r;
+  }
+  return true;
+}
+
+bool recvAll(int fd, char* data, size_t n)
+{
+  while (n>0)
+  {
+    ssize_t r = ::recv(fd, data, n, 0);
+    if (r<0 && errno==EINTR) continue;
+    if (r<=0) return false;
+    data+=r;
+    n-=r;
+  }
+  return true;
+}
+
+bool sendMessage(int fd, FSIMessageType type, const std::vector<double>& values)
+{
+  FSIMessageHeader h;
+  h.type=type;
+  h.version=FSI_PROTOCOL_VERSION;
+  h.count=values.size();
+  return
+      sendAll(fd, reinterpret_cast<const char*>(&h), sizeof(h))
+      &&
+      sendAll(fd, reinterpret_cast<const char*>(values.data()), values.size()*sizeof(double));
+}
+
+}
+
+
+
+
+defineTypeNameAndDebug(FSICouplingChannel, 0);
+defineRunTimeSelectionTable(FSICouplingChannel, dictionary);
+
+autoPtr<FSICouplingChannel> FSICouplingChannel::New
+(
+    const fileName& FEMCaseDir,
+    const word& patchName,
+    const dictionary& dict
+)
+{
+    word channelType(FileFSICouplingChannel::typeName);
+
+    dict.readIfPresent("coupling", channelType);
+
+    dictionaryConstructorTable::iterator cstrIter =
+        dictionaryConstructorTablePtr_->find(channelType);
+
+    if (cstrIter == dictionaryConstructorTablePtr_->end())
+    {
+        FatalIOErrorIn
+        (
+            "FSICouplingChannel::New(const fileName&, const word&, const dictionary&)",
+            dict
+        )   << "Unknown FSI coupling type " << channelType << nl << nl
+            << "Valid FSI coupling types are :" << nl
+            << dictionaryConstructorTablePtr_->toc()
+            << exit(FatalIOError);
+    }
+
+    return autoPtr<FSICouplingChannel>(cstrIter()(FEMCaseDir, patchName, dict));
+}
+
+FSICouplingChannel::FSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict)
+: FEMCaseDir_(FEMCaseDir),
+  patchName_(patchName)
+{
+  FEMCaseDir_.expand();
+}
+
+FSICouplingChannel::~FSICouplingChannel()
+{}
+
+void FSICouplingChannel::writeEntry(Ostream& os) const
+{
+  os << "coupling" << token::SPACE << this->type() << token::END_STATEMENT << nl;
+}
+
+
+
+
+defineTypeNameAndDebug(FileFSICouplingChannel, 0);
+addToRunTimeSelectionTable(FSICouplingChannel, FileFSICouplingChannel, dictionary);
+
+FileFSICouplingChannel::FileFSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict)
+: FSICouplingChannel(FEMCaseDir, patchName, dict),
+  pollInterval_(dict.lookupOrDefault<scalar>("pollInterval", 1.0))
+{}
+
+tmp<vectorField> FileFSICouplingChannel::exchange(const pointField& locations, const scalarField& pressures)
+{
+  // write point locations (=mesh points)
+  {
+    OFstream f(FEMCaseDir_/("locations."+patchName_));
+    forAll(locations, i)
+    {
+      const point& p=locations[i];
+      f<<p.x()<<";"<<p.y()<<";"<<p.z()<<nl;
+    }
+  }
+
+  // write pressure values
+  {
+    OFstream f(FEMCaseDir_/("pressure_values."+patchName_));
+    forAll(pressures, i)
+    {
+      f<<pressures[i]<<nl;
+    }
+  }
+
+  // write signal file and wait for it to be deleted
+  {
+    fileName sfn(FEMCaseDir_/("complete."+patchName_));
+    {
+      OFstream f(sfn);
+      f << "COMPLETE" << endl;
+    }
+    do
+    {
+      sleepSeconds(pollInterval_);
+    }
+    while (exists(sfn));
+  }
+
+  // read in the displacements
+  IFstream file(FEMCaseDir_/("displacements."+patchName_));
+  return tmp<vectorField>(new vectorField(file));
+}
+
+void FileFSICouplingChannel::writeEntry(Ostream& os) const
+{
+  FSICouplingChannel::writeEntry(os);
+  os.writeKeyword("pollInterval") << pollInterval_ << token::END_STATEMENT << nl;
+}
+
+
+
+
+defineTypeNameAndDebug(SocketFSICouplingChannel, 0);
+addToRunTimeSelectionTable(FSICouplingChannel, SocketFSICouplingChannel, dictionary);
+
+SocketFSICouplingChannel::SocketFSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict)
+: FSICouplingChannel(FEMCaseDir, patchName, dict),
+  socketPath_(FEMCaseDir_/("fsi."+patchName_+".socket")),
+  connectTimeout_(dict.lookupOrDefault<scalar>("connectTimeout", 0.0)),
+  fd_(-1),
+  locationsSent_(false)
+{
+  if (dict.readIfPresent("couplingSocket", socketPath_))
+  {
+    socketPath_.expand();
+  }
+}
+
+SocketFSICouplingChannel::~SocketFSICouplingChannel()
+{
+  disconnect();
+}
+
+void SocketFSICouplingChannel::connect()
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  if (socketPath_.size() >= sizeof(addr.sun_path))
+  {
+    FatalErrorIn("SocketFSICouplingChannel::connect()")
+      << "Path of FSI coupling socket is too long: " << socketPath_
+      << abort(FatalError);
+  }
+  strncpy(addr.sun_path, socketPath_.c_str(), sizeof(addr.sun_path)-1);
+
+  Info<<"Connecting to FEM solver at "<<socketPath_<<endl;
+
+  // the FEM side may not have created the socket yet
+  scalar waited=0;
+  for (;;)
+  {
+    int fd=::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd<0)
+    {
+      FatalErrorIn("SocketFSICouplingChannel::connect()")
+        << "Could not create socket!"
+        << abort(FatalError);
+    }
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))==0)
+    {
+      fd_=fd;
+      locationsSent_=false;
+      return;
+    }
+    ::close(fd);
+
+    if ( (connectTimeout_>0) && (waited>connectTimeout_) )
+    {
+      FatalErrorIn("SocketFSICouplingChannel::connect()")
+        << "Could not connect to FEM solver at " << socketPath_
+        << " within " << connectTimeout_ << " s"
+        << abort(FatalError);
+    }
+
+    sleepSeconds(0.1);
+    waited+=0.1;
+  }
+}
+
+void SocketFSICouplingChannel::disconnect()
+{
+  if (fd_>=0)
+  {
+    sendMessage(fd_, FSI_STOP, std::vector<double>());
+    ::close(fd_);
+    fd_=-1;
+  }
+}
+
+tmp<vectorField> SocketFSICouplingChannel::exchange(const pointField& locations, const scalarField& pressures)
+{
+  if (fd_<0)
+  {
+    connect();
+  }
+
+  if (!locationsSent_)
+  {
+    std::vector<double> l(3*locations.size());
+    forAll(locations, i)
+    {
+      for (direction c=0; c<3; c++)
+        l[3*i+c]=locations[i][c];
+    }
+    if (!sendMessage(fd_, FSI_LOCATIONS, l))
+    {
+      FatalErrorIn("SocketFSICouplingChannel::exchange()")
+        << "Could not send locations to FEM solver!"
+        << abort(FatalError);
+    }
+    locationsSent_=true;
+  }
+
+  if (!sendMessage(fd_, FSI_PRESSURES, std::vector<double>(pressures.begin(), pressures.end())))
+  {
+    FatalErrorIn("SocketFSICouplingChannel::exchange()")
+      << "Could not send pressures to FEM solver!"
+      << abort(FatalError);
+  }
+
+  // blocks until the FEM solution is done
+  FSIMessageHeader h;
+  if (!recvAll(fd_, reinterpret_cast<char*>(&h), sizeof(h)))
+  {
+    FatalErrorIn("SocketFSICouplingChannel::exchange()")
+      << "Connection closed by FEM solver!"
+      << abort(FatalError);
+  }
+
+  if
+  (
+    (h.version!=FSI_PROTOCOL_VERSION)
+    || (h.type!=FSI_DISPLACEMENTS)
+    || (h.count!=uint64_t(3*locations.size()))
+  )
+  {
+    FatalErrorIn("SocketFSICouplingChannel::exchange()")
+      << "Unexpected answer from FEM solver"
+      << " (message type "<<label(h.type)<<", version "<<label(h.version)
+      << ", "<<label(h.count)<<" values, expected "<<3*locations.size()<<")!"
+      << abort(FatalError);
+  }
+
+  std::vector<double> u(h.count);
+  if (!recvAll(fd_, reinterpret_cast<char*>(u.data()), u.size()*sizeof(double)))
+  {
+    FatalErrorIn("SocketFSICouplingChannel::exchange()")
+      << "Incomplete displacement data from FEM solver!"
+      << abort(FatalError);
+  }
+
+  tmp<vectorField> res(new vectorField(locations.size()));
+  vectorField& d=res();
+  forAll(d, i)
+  {
+    d[i]=vector(u[3*i], u[3*i+1], u[3*i+2]);
+  }
+  return res;
+}
+
+void SocketFSICouplingChannel::writeEntry(Ostream& os) const
+{
+  FSICouplingChannel::writeEntry(os);
+  os.writeKeyword("couplingSocket") << socketPath_ << token::END_STATEMENT << nl;
+  os.writeKeyword("connectTimeout") << connectTimeout_ << token::END_STATEMENT << nl;
+}
+
+
+
+
+}
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef FOAM_FSICOUPLINGCHANNEL_H
+#define FOAM_FSICOUPLINGCHANNEL_H
+
+#include "fvCFD.H"
+#include "typeInfo.H"
+#include "refCount.H"
+
+namespace Foam {
+
+/**
+ * Transfers the pressure values of a coupled patch to the FEM solver
+ * and returns the displacements computed by it.
+ * Selected by the keyword "coupling" (default: files).
+ * The channel is reference counted, since it is shared by all copies of the patch field.
+ */
+class FSICouplingChannel
+: public refCount
+{
+protected:
+  fileName FEMCaseDir_;
+  word patchName_;
+
+public:
+  TypeName("FSICouplingChannel");
+
+  declareRunTimeSelectionTable
+  (
+      autoPtr,
+      FSICouplingChannel,
+      dictionary,
+      (
+          const fileName& FEMCaseDir,
+          const word& patchName,
+          const dictionary& dict
+      ),
+      (FEMCaseDir, patchName, dict)
+  );
+
+  FSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict);
+  virtual ~FSICouplingChannel();
+
+  static autoPtr<FSICouplingChannel> New(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict);
+
+  /**
+   * sends the point locations (FEM coordinates) and the pressure values,
+   * blocks until the FEM solution is available and returns the displacement
+   * of each location (FEM coordinates).
+   */
+  virtual tmp<vectorField> exchange(const pointField& locations, const scalarField& pressures) =0;
+
+  virtual void writeEntry(Ostream& os) const;
+};
+
+
+
+
+/**
+ * The original protocol: ASCII files in the FEM case directory
+ * and a signal file "complete.<patch>", which is removed by the FEM side,
+ * when the displacements are written.
+ */
+class FileFSICouplingChannel
+: public FSICouplingChannel
+{
+  scalar pollInterval_;
+
+public:
+  TypeName("files");
+
+  FileFSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict);
+
+  virtual tmp<vectorField> exchange(const pointField& locations, const scalarField& pressures);
+  virtual void writeEntry(Ostream& os) const;
+};
+
+
+
+
+/**
+ * Binary arrays over a Unix domain socket, which is created by the FEM side
+ * (default: "<FEMCaseDir>/fsi.<patch>.socket", keyword "couplingSocket").
+ *
+ * Each message consists of a header of three fields in native byte order
+ * (uint32 type, uint32 protocol version, uint64 number of values)
+ * followed by the values as doubles.
+ * Per coupling iteration, the CFD side sends "pressures" and waits for "displacements"
+ * (three components per location). The locations are sent once after connecting.
+ * "stop" is sent, when the CFD side closes the connection.
+ */
+class SocketFSICouplingChannel
+: public FSICouplingChannel
+{
+  fileName socketPath_;
+  scalar connectTimeout_;
+  int fd_;
+  bool locationsSent_;
+
+  void connect();
+  void disconnect();
+
+public:
+  TypeName("socket");
+
+  SocketFSICouplingChannel(const fileName& FEMCaseDir, const word& patchName, const dictionary& dict);
+  ~SocketFSICouplingChannel();
+
+  virtual tmp<vectorField> exchange(const pointField& locations, const scalarField& pressures);
+  virtual void writeEntry(Ostream& os) const;
+};
+
+}
+
+#endif // FOAM_FSICOUPLINGCHANNEL_H
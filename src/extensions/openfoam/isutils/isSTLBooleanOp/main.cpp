@@ -0,0 +1,139 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "base/boost_include.h"
+#include "base/exception.h"
+#include "base/trisurfaceboolean.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+
+using namespace std;
+using namespace insight;
+using namespace boost;
+namespace bf = boost::filesystem;
+
+int main(int argc, char *argv[])
+{
+    insight::UnhandledExceptionHandling ueh;
+
+    namespace po = boost::program_options;
+
+    typedef std::vector<string> StringList;
+
+    // Declare the supported options.
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "produce help message")
+    ("subtract,s", "subtract tool from object")
+    ("add,a", "add (unify) tool and object")
+    ("intersect,i", "intersect tool and object")
+    ("binary,b", "write binary STL file")
+    ("files", po::value<StringList>(), "<object mesh file> <tool mesh file> <result mesh file>")
+    ;
+
+    po::positional_options_description p;
+    p.add("files", 3);
+
+    auto displayHelp = [&]{
+      std::ostream &os = std::cout;
+
+      os << "Usage:" << std::endl;
+      os << "  " << boost::filesystem::path(argv[0]).filename().string()
+         << " [options] <object mesh file> <tool mesh file> <result mesh file>" << std::endl;
+      os << std::endl;
+      os << desc << endl;
+    };
+
+    po::variables_map vm;
+    try
+    {
+      po::store(po::command_line_parser(argc, argv).
+                options(desc).positional(p).run(), vm);
+      po::notify(vm);
+    }
+    catch (const po::error& e)
+    {
+      std::cerr << std::endl << "Could not parse command line: " << e.what() << std::endl<<std::endl;
+      displayHelp();
+      exit(-1);
+    }
+
+    if (vm.count("help"))
+    {
+        displayHelp();
+        exit(0);
+    }
+
+    if (vm.count("subtract")+vm.count("add")+vm.count("intersect") != 1)
+    {
+        std::cerr << "Error: you need to specify exactly one operation!" << std::endl;
+        displayHelp();
+        exit(-1);
+    }
+
+    if (!vm.count("files") || vm["files"].as<StringList>().size()!=3)
+    {
+        std::cerr << "Error: you need to specify object, tool and result file!" << std::endl;
+        displayHelp();
+        exit(-1);
+    }
+
+    TriSurfaceBoolean::Operation op = TriSurfaceBoolean::Union;
+    if (vm.count("subtract")) op=TriSurfaceBoolean::Subtract;
+    else if (vm.count("intersect")) op=TriSurfaceBoolean::Intersect;
+
+    const auto& files = vm["files"].as<StringList>();
+
+    try
+    {
+        auto obj = TriSurface::readSTL(files[0]);
+        auto tool = TriSurface::readSTL(files[1]);
+
+        TriSurfaceBoolean bo(obj, tool, op);
+
+        std::cout
+            << "object: " << obj.triangles().size() << " triangles" << std::endl
+            << "tool: " << tool.triangles().size() << " triangles" << std::endl
+            << "intersection curve: " << bo.nIntersectionEdges() << " edges" << std::endl
+            << "result: " << bo.result().triangles().size() << " triangles" << std::endl;
+        if (bo.nPerturbations()>0)
+        {
+            std::cout << "Note: the tool surface was displaced slightly ("
+                      << bo.nPerturbations() << " retries) to resolve degenerate configurations."
+                      << std::endl;
+        }
+
+        bo.result().writeSTL(files[2], vm.count("binary")>0, bf::path(files[2]).stem().string());
+    }
+    catch (const std::exception& e)
+    {
+        insight::printException(e);
+        return -1;
+    }
+
+    return 0;
+}
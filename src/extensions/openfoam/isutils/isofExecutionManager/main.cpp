@@ -27,6 +27,7 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <algorithm>
 
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/parsers.hpp>
@@ -74,6 +75,8 @@ int main(int argc, char *argv[])
       ("include-processor-dirs,p", "if this flag is set, processor directories will be tranferred as well")
       ("command,q", po::value<StringList>(&cmds), "add this command to remote execution queue (will be executed after the previous command has finished successfully)")
       ("immediate-command,i", po::value<StringList>(&icmds), "add this command to remote execution queue (execute in parallel without waiting for the previous command)")
+      ("cores,n", po::value<int>(), "number of cores, which the queued commands need. By default, parallel commands (run by mpirun/mpiexec or with -parallel) need the number of subdomains in the decomposeParDict of the case, if present, and all others 1.")
+      ("memory", po::value<int>(), "memory in MB, which the queued commands need. Not declared by default.")
       ("wait,w", "wait for command queue completion")
       ("wait-last,W", "wait for the last added command to finish")
       ("cancel,c", "cancel remote commands (remove all from queue)")
@@ -198,11 +201,47 @@ int main(int argc, char *argv[])
         anything_done=true;
       }
 
+      TaskSpoolerInterface::JobResources serialResources, parallelResources;
+      if (vm.count("cores"))
+      {
+        serialResources.cores=parallelResources.cores=vm["cores"].as<int>();
+      }
+      else if (bf::exists(location/"system"/"decomposeParDict"))
+      {
+        try
+        {
+          parallelResources.cores=readDecomposeParDict(location);
+        }
+        catch (const std::exception& e)
+        {
+          std::cerr<<"Warning: could not read the number of subdomains: "<<e.what()<<std::endl;
+        }
+      }
+      if (vm.count("memory"))
+      {
+        serialResources.memoryMB=parallelResources.memoryMB=vm["memory"].as<int>();
+      }
+
+      auto resourcesFor = [&](const std::string& cmd) -> const TaskSpoolerInterface::JobResources&
+      {
+        std::vector<std::string> args;
+        boost::split(args, cmd, boost::is_any_of(" \t"), boost::token_compress_on);
+        args.erase(std::remove(args.begin(), args.end(), ""), args.end());
+
+        bool parallel = std::find(args.begin(), args.end(), "-parallel")!=args.end();
+        if (!args.empty())
+        {
+          std::string exe=bf::path(args.front()).filename().string();
+          parallel = parallel || exe=="mpirun" || exe=="mpiexec";
+        }
+        return parallel ? parallelResources : serialResources;
+      };
+
       if (vm.count("command"))
       {
         for (const auto& c: cmds)
         {
-          re.queueRemoteCommand(c);
+          re.queueRemoteCommand(c, true, resourcesFor(c));
           anything_done=true;
         }
       }
@@ -211,7 +250,7 @@ int main(int argc, char *argv[])
       {
         for (const auto& c: icmds)
         {
-          re.queueRemoteCommand(c, false);
+          re.queueRemoteCommand(c, false, resourcesFor(c));
           anything_done=true;
         }
       }
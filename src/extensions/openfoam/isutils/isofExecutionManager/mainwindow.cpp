@@ -41,7 +41,16 @@ void MainWindow::updateGUI()
     auto cmd = QString("ssh ")+remote_->server().c_str()+" -t 'cd '"+remote_->remoteDir().c_str()+"'; bash -l'\n";
     terminal_->sendText(cmd);
 
+    if (tsi_) tsi_->stopJobEvents();
     tsi_.reset(new insight::TaskSpoolerInterface(remote_->socket(), remote_->server()));
+    if (tsi_->startJobEvents(
+          [this](const insight::TaskSpoolerInterface::Job&) {
+            QMetaObject::invokeMethod(this, "onRefreshJobList", Qt::QueuedConnection);
+          }))
+    {
+      // job changes are reported, poll only as a fallback
+      refreshTimer_->setInterval(60000);
+    }
     onRefreshJobList();
   }
 }
@@ -239,6 +248,7 @@ MainWindow::~MainWindow()
 {
   if (tsi_)
   {
+    tsi_->stopJobEvents();
     tsi_->stopTail();
   }
   delete ui;
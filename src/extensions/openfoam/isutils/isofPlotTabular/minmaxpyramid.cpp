@@ -0,0 +1,148 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "minmaxpyramid.h"
+
+#include "base/exception.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+MinMaxPyramid::MinMaxPyramid(const arma::mat& x, const arma::mat& y)
+{
+  insight::assertion(x.n_elem==y.n_elem, "x and y need to have equal length!");
+
+  arma::uword n=x.n_elem;
+
+  x_.resize(n);
+  y_.resize(n);
+  if (std::is_sorted(x.memptr(), x.memptr()+n))
+  {
+    std::copy(x.memptr(), x.memptr()+n, x_.begin());
+    std::copy(y.memptr(), y.memptr()+n, y_.begin());
+  }
+  else
+  {
+    arma::uvec idx=arma::stable_sort_index(arma::vectorise(x));
+    for (arma::uword i=0; i<n; i++)
+    {
+      x_[i]=x(idx(i));
+      y_[i]=y(idx(i));
+    }
+  }
+
+  // level 0 from raw data
+  if (n>2)
+  {
+    std::vector<Bucket> l0( (n+1)/2 );
+    for (arma::uword k=0; k<l0.size(); k++)
+    {
+      arma::uword i=2*k, j=std::min(i+1, n-1);
+      l0[k] = y_[j]<y_[i] ? Bucket{j, i} : Bucket{i, j};
+    }
+    levels_.push_back(std::move(l0));
+  }
+
+  // coarser levels by merging pairs of buckets
+  while (levels_.size()>0 && levels_.back().size()>2)
+  {
+    const std::vector<Bucket>& fine=levels_.back();
+    std::vector<Bucket> coarse( (fine.size()+1)/2 );
+    for (arma::uword k=0; k<coarse.size(); k++)
+    {
+      const Bucket& a=fine[2*k];
+      const Bucket& b=fine[std::min<arma::uword>(2*k+1, fine.size()-1)];
+      coarse[k].i_min = y_[b.i_min]<y_[a.i_min] ? b.i_min : a.i_min;
+      coarse[k].i_max = y_[b.i_max]>y_[a.i_max] ? b.i_max : a.i_max;
+    }
+    levels_.push_back(std::move(coarse));
+  }
+}
+
+
+QVector<QPointF> MinMaxPyramid::query(double x0, double x1, int maxPoints) const
+{
+  QVector<QPointF> pts;
+
+  if (x_.size()==0) return pts;
+
+  // raw index range including one sample beyond each end
+  arma::uword i0 = std::lower_bound(x_.begin(), x_.end(), x0) - x_.begin();
+  arma::uword i1 = std::upper_bound(x_.begin(), x_.end(), x1) - x_.begin();
+  if (i0>0) i0--;
+  if (i1<x_.size()) i1++;
+  if (i1<=i0) return pts;
+
+  arma::uword count=i1-i0;
+  maxPoints=std::max(maxPoints, 2);
+
+  if (count <= arma::uword(maxPoints))
+  {
+    pts.reserve(count);
+    for (arma::uword i=i0; i<i1; i++)
+      pts.append(QPointF(x_[i], y_[i]));
+    return pts;
+  }
+
+  // finest level, which yields no more than maxPoints points
+  size_t l=0;
+  while ( l+1<levels_.size()
+          && 2*( (count+bucketSize(l)-1)/bucketSize(l) ) > arma::uword(maxPoints) )
+  {
+    l++;
+  }
+
+  const std::vector<Bucket>& lvl=levels_[l];
+  arma::uword b=bucketSize(l);
+  arma::uword k0=i0/b, k1=std::min<arma::uword>((i1-1)/b, lvl.size()-1);
+
+  pts.reserve(2*(k1-k0+1));
+  for (arma::uword k=k0; k<=k1; k++)
+  {
+    arma::uword ia=std::min(lvl[k].i_min, lvl[k].i_max);
+    arma::uword ib=std::max(lvl[k].i_min, lvl[k].i_max);
+    pts.append(QPointF(x_[ia], y_[ia]));
+    if (ib!=ia)
+      pts.append(QPointF(x_[ib], y_[ib]));
+  }
+
+  return pts;
+}
+
+
+QVector<QPointF> MinMaxPyramid::query(int maxPoints) const
+{
+  if (x_.size()==0) return QVector<QPointF>();
+  return query(x_.front(), x_.back(), maxPoints);
+}
+
+
+PyramidBuilder::PyramidBuilder(QObject *parent, const arma::mat& x, const arma::mat& y)
+  : QThread(parent),
+    x_(x),
+    y_(y)
+{}
+
+void PyramidBuilder::run()
+{
+  pyramid_=std::make_shared<MinMaxPyramid>(x_, y_);
+}
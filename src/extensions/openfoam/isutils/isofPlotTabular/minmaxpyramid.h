@@ -0,0 +1,105 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <vector>
+#include <memory>
+
+#include <QThread>
+#include <QVector>
+#include <QPointF>
+
+#include "base/linearalgebra.h"
+
+
+/**
+ * Level-of-detail representation of a (possibly huge) x-y series.
+ *
+ * Level l groups 2^(l+1) consecutive samples into buckets and stores the
+ * indices of the minimum and maximum y value in each bucket.
+ * A query for an x-range returns at most maxPoints points:
+ * the raw samples, if they are few enough, otherwise the minimum and
+ * maximum of each bucket of the finest sufficient level.
+ * Thus no peak is lost, regardless of the zoom level.
+ */
+class MinMaxPyramid
+{
+public:
+  struct Bucket
+  {
+    arma::uword i_min, i_max;
+  };
+
+private:
+  std::vector<double> x_, y_;
+  std::vector<std::vector<Bucket> > levels_;
+
+  inline arma::uword bucketSize(size_t level) const
+  {
+    return arma::uword(2)<<level;
+  }
+
+public:
+  /**
+   * x and y are column vectors of equal length.
+   * If x is not sorted, the samples are sorted internally.
+   */
+  MinMaxPyramid(const arma::mat& x, const arma::mat& y);
+
+  inline size_t size() const { return x_.size(); }
+  inline size_t nLevels() const { return levels_.size(); }
+
+  /**
+   * returns the points to draw for the x range [x0, x1]
+   * (including one point beyond each end)
+   */
+  QVector<QPointF> query(double x0, double x1, int maxPoints) const;
+
+  /**
+   * returns all points to draw, limited to maxPoints
+   */
+  QVector<QPointF> query(int maxPoints) const;
+};
+
+typedef std::shared_ptr<MinMaxPyramid> MinMaxPyramidPtr;
+
+
+
+/**
+ * builds a MinMaxPyramid in the background
+ */
+class PyramidBuilder : public QThread
+{
+  Q_OBJECT
+
+  arma::mat x_, y_;
+  MinMaxPyramidPtr pyramid_;
+
+public:
+  PyramidBuilder(QObject *parent, const arma::mat& x, const arma::mat& y);
+  void run() override;
+
+  inline MinMaxPyramidPtr pyramid() const { return pyramid_; }
+};
+
+
+#endif // MINMAXPYRAMID_H
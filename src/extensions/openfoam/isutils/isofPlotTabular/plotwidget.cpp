@@ -69,6 +69,12 @@ PlotWidget::PlotWidget(QWidget *parent) :
   mean_crv_->attachAxis(plotData_->axes(Qt::Horizontal)[0]);
   mean_crv_->attachAxis(plotData_->axes(Qt::Vertical)[0]);
 
+  // re-query the level-of-detail data on zoom
+  plot_->setRubberBand(QtCharts::QChartView::HorizontalRubberBand);
+  connect(dynamic_cast<QtCharts::QValueAxis*>(plotData_->axes(Qt::Horizontal)[0]),
+          &QtCharts::QValueAxis::rangeChanged,
+          this, &PlotWidget::updateDisplayedCurves);
+
   connect(ui->include_0_sw, &QCheckBox::toggled,
           this, &PlotWidget::onToggleY0);
 
@@ -84,17 +90,44 @@ PlotWidget::~PlotWidget()
     if (mc_->isRunning()) mc_->terminate();
     delete mc_;
   }
+  if (pb_)
+  {
+    pb_->wait();
+    delete pb_;
+  }
   delete ui;
 }
 
+int PlotWidget::maxDisplayPoints() const
+{
+  // about two points (min and max) per pixel
+  return std::min(8000, std::max(1000, 2*plot_->width()));
+}
+
 void PlotWidget::setData(const arma::mat& x, const arma::mat& y)
 {
   rawdata_=arma::join_horiz(x,y);
   visible_part_=rawdata_;
 
-  raw_crv_->clear();
-  for (arma::uword i=0; i< x.n_rows; i++)
-    raw_crv_->append(x(i), y(i));
+  rawPyramid_.reset();
+  meanPyramid_.reset();
+
+  // coarse preview until the decimation pyramid is available
+  arma::uword stride=std::max<arma::uword>(1, x.n_rows/arma::uword(maxDisplayPoints()));
+  QVector<QPointF> pts;
+  pts.reserve(x.n_rows/stride+1);
+  for (arma::uword i=0; i< x.n_rows; i+=stride)
+    pts.append(QPointF(x(i), y(i)));
+  raw_crv_->replace(pts);
+
+  if (pb_)
+  {
+    pb_->wait();
+    delete pb_;
+  }
+  pb_=new PyramidBuilder(this, x, y);
+  connect(pb_, &QThread::finished, this, &PlotWidget::onRawPyramidReady);
+  pb_->start();
 
   mean_crv_->clear();
 
@@ -133,7 +166,38 @@ MeanComputer::MeanComputer(QObject* p, const arma::mat& rd, double frac)
 
 void MeanComputer::run()
 {
-  emit resultReady( insight::movingAverage(rawdata_, frac_) );
+  arma::mat avg=insight::movingAverage(rawdata_, frac_);
+  if (avg.n_rows>0)
+    pyramid_=std::make_shared<MinMaxPyramid>(avg.col(0), avg.col(1));
+  emit resultReady( avg );
+}
+
+void PlotWidget::onRawPyramidReady()
+{
+  if (pb_ && sender()==pb_)
+  {
+    rawPyramid_=pb_->pyramid();
+    pb_->deleteLater();
+    pb_=nullptr;
+    updateDisplayedCurves();
+  }
+}
+
+void PlotWidget::updateDisplayedCurves()
+{
+  auto& ax=dynamic_cast<const QtCharts::QValueAxis&>(*plotData_->axisX());
+  double x0=ax.min(), x1=ax.max();
+  if (!(x1>x0) && rawdata_.n_rows>0)
+  {
+    x0=rawdata_.col(0).min();
+    x1=rawdata_.col(0).max();
+  }
+
+  int np=maxDisplayPoints();
+  if (rawPyramid_)
+    raw_crv_->replace(rawPyramid_->query(x0, x1, np));
+  if (meanPyramid_)
+    mean_crv_->replace(meanPyramid_->query(x0, x1, np));
 }
 
 void PlotWidget::onMeanDataReady(arma::mat avg)
@@ -146,9 +210,8 @@ void PlotWidget::onMeanDataReady(arma::mat avg)
            %( avg.col(1)(avg.n_rows-1) ))
     ));
 
-    mean_crv_->clear();
-    for (arma::uword i=0; i<avg.n_rows; ++i)
-      mean_crv_->append(avg(i,0), avg(i,1));
+    meanPyramid_=mc_->pyramid();
+    updateDisplayedCurves();
 
     ui->info->setText("Moving average computed.");
   //  plot_->replot();
@@ -26,6 +26,7 @@
 #include <QThread>
 
 #include "base/linearalgebra.h"
+#include "minmaxpyramid.h"
 
 #include <QtCharts/QChart>
 #include <QtCharts/QChartView>
@@ -39,11 +40,14 @@ namespace Ui {
 class MeanComputer : public QThread
 {
   Q_OBJECT
-  const arma::mat& rawdata_;
+  arma::mat rawdata_;
   double frac_;
+  MinMaxPyramidPtr pyramid_;
 public:
   MeanComputer(QObject *parent, const arma::mat& rawdata, double frac);
   virtual void run();
+
+  inline MinMaxPyramidPtr pyramid() const { return pyramid_; }
 Q_SIGNALS:
   void resultReady(arma::mat meandata);
 };
@@ -57,6 +61,14 @@ class PlotWidget : public QWidget
   arma::mat visible_part_;
   MeanComputer *mc_=nullptr;
 
+  PyramidBuilder *pb_=nullptr;
+  MinMaxPyramidPtr rawPyramid_, meanPyramid_;
+
+  /**
+   * maximum number of points per curve for the current plot size
+   */
+  int maxDisplayPoints() const;
+
 public:
   explicit PlotWidget(QWidget *parent = 0);
   ~PlotWidget();
@@ -69,6 +81,8 @@ public Q_SLOT:
   void onMeanDataReady(arma::mat meandata);
   void onChangeXRange(const QString& x0="", const QString& x1="");
   void onToggleY0(bool);
+  void onRawPyramidReady();
+  void updateDisplayedCurves();
 
 private:
   Ui::PlotWidget *ui;
@@ -1,6 +1,7 @@
 
 #include "base/boost_include.h"
 #include "openfoam/openfoamtools.h"
+#include "openfoam/ofes.h"
 
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/parsers.hpp>
@@ -23,6 +24,7 @@ int main(int argc, char* argv[])
   ("help,h", "produce help message")
   ("vtk,v", po::value<std::string>()->required(), "VTK input file name")
   ("out,o", po::value<std::string>(), "output file name")
+  ("into,i", po::value<std::string>(), "field file of an OpenFOAM case: its internal field is replaced and the file is written in the format of the current OpenFOAM environment")
   ("field,n", po::value<std::string>()->required(), "cell field name")
   ;
 
@@ -78,17 +80,30 @@ int main(int argc, char* argv[])
   try
   {
 
-    std::ostream* os = &std::cout;
-    if (vm.count("out")>0)
+    if (vm.count("into")>0)
     {
-      os=new std::ofstream(vm["out"].as<std::string>().c_str());
+      insight::OpenFOAMCase cm( insight::OFEs::getCurrentOrPreferred() );
+      insight::VTKFieldToOpenFOAMField(
+          vm["vtk"].as<std::string>(),
+          vm["field"].as<std::string>(),
+          cm,
+          vm["into"].as<std::string>()
+       );
+    }
+    else
+    {
+      std::ostream* os = &std::cout;
+      if (vm.count("out")>0)
+      {
+        os=new std::ofstream(vm["out"].as<std::string>().c_str());
+      }
+      insight::VTKFieldToOpenFOAMField(
+          vm["vtk"].as<std::string>(),
+          vm["field"].as<std::string>(),
+          *os
+       );
+      if (os!=&std::cout) delete os;
     }
-    insight::VTKFieldToOpenFOAMField(
-        vm["vtk"].as<std::string>(),
-        vm["field"].as<std::string>(),
-        *os
-     );
-    if (os!=&std::cout) delete os;
 
   }
   catch (const std::exception& e)
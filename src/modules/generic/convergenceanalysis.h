@@ -22,6 +22,7 @@
 #define CONVERGENCEANALYSIS_H
 
 #include "base/analysis.h"
+#include "convergenceanalysis__ConvergenceAnalysis__Parameters_headers.h"
 
 
 namespace insight
@@ -21,6 +21,7 @@
 #define INSIGHT_FILETEMPLATE_H
 
 #include "base/analysis.h"
+#include "filetemplate__FileTemplate__Parameters_headers.h"
 
 namespace insight
 {
@@ -205,7 +205,7 @@ void InternalPressureLoss::createMesh(insight::OpenFOAMCase& cm, ProgressDisplay
     int nb=bmd->nBlocks();
     cm.insert(bmd.release());
     cm.createOnDisk(executionPath());
-    cm.runBlockMesh(executionPath(), nb, &pp);
+    cm.runBlockMesh(executionPath(), nb, &pp, true);
 
 
     create_directory(wallstlfile_.parent_path());
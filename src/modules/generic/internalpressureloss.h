@@ -23,6 +23,7 @@
 #include "openfoam/openfoamanalysis.h"
 #include "parametersetvisualizer.h"
 #include "openfoam/openfoamtools.h"
+#include "internalpressureloss__InternalPressureLoss__Parameters_headers.h"
 
 namespace insight
 {
@@ -341,7 +341,7 @@ void NumericalWindtunnel::createMesh(insight::OpenFOAMCase& cm, ProgressDisplaye
   cm.insert(bmd.release());
   
   cm.createOnDisk(executionPath());
-  cm.runBlockMesh(executionPath(), nb, &parentProgress);
+  cm.runBlockMesh(executionPath(), nb, &parentProgress, true);
     
   create_directory(objectSTLFile.parent_path());
 
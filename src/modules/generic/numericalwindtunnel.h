@@ -24,6 +24,7 @@
 #include "parametersetvisualizer.h"
 
 #include "gp_Trsf.hxx"
+#include "numericalwindtunnel__NumericalWindtunnel__Parameters_headers.h"
 
 namespace insight {
 
@@ -358,6 +358,9 @@ insight::ResultSetPtr AirfoilSection::evaluateResults(insight::OpenFOAMCase& cm,
   arma::mat cd = (f_vs_iter.col(1)+f_vs_iter.col(4))
 		  / ( 0.5*p.fluid.rho * pow(p.operation.vinf,2) * Aref );
   arma::mat eps = cl/cd;
+
+  // moving average with a window length of half the iteration range (plotted for convergence monitoring)
+  arma::mat coeff_mean = movingAverage( join_rows(join_rows(f_vs_iter.col(0), cl), cd), 0.5 );
   
   double minPbyrho=minPatchPressure(cm, executionPath(), "foil")(0,1);
   double cpmin=minPbyrho/(0.5*pow(p.operation.vinf,2));
@@ -378,6 +381,8 @@ insight::ResultSetPtr AirfoilSection::evaluateResults(insight::OpenFOAMCase& cm,
     {
      PlotCurve( arma::mat(join_rows(f_vs_iter.col(0), cl)), "CL", "w l t '$C_L$'" ),
      PlotCurve( arma::mat(join_rows(f_vs_iter.col(0), cd)), "CD", "w l t '$C_D$'" ),
+     PlotCurve( arma::mat(join_rows(coeff_mean.col(0), coeff_mean.col(1))), "CLmean", "w l dt 2 t '$\\langle C_L \\rangle$'" ),
+     PlotCurve( arma::mat(join_rows(coeff_mean.col(0), coeff_mean.col(2))), "CDmean", "w l dt 2 t '$\\langle C_D \\rangle$'" ),
      PlotCurve( arma::mat(join_rows(f_vs_iter.col(0), eps)), "CLbyCD", "axes x1y2 w l t '$C_L/C_D$'" )
     },
     "Convergence history of coefficients",
@@ -22,6 +22,7 @@
 
 #include "openfoam/openfoamanalysis.h"
 #include "openfoam/openfoamparameterstudy.h"
+#include "airfoilsection__AirfoilSection__Parameters_headers.h"
 //#include "base/stltools.h"
 
 
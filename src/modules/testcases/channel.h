@@ -21,6 +21,8 @@
 #define INSIGHT_CHANNEL_H
 
 #include "openfoam/openfoamanalysis.h"
+#include "channel__ChannelBase__Parameters_headers.h"
+#include "channel__ChannelCyclic__Parameters_headers.h"
 
 namespace insight {
 
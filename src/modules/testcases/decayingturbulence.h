@@ -21,6 +21,7 @@
 #define INSIGHT_DECAYINGTURBULENCE_H
 
 #include "openfoam/openfoamanalysis.h"
+#include "decayingturbulence__DecayingTurbulence__Parameters_headers.h"
 
 namespace insight {
 
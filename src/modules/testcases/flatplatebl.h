@@ -22,6 +22,7 @@
 #define INSIGHT_FLATPLATEBL_H
 
 #include "openfoam/openfoamanalysis.h"
+#include "flatplatebl__FlatPlateBL__Parameters_headers.h"
 
 namespace insight {
 
@@ -21,6 +21,7 @@
 #define INSIGHT_PIPE_H
 
 #include "openfoam/openfoamanalysis.h"
+#include "pipe__PipeBase__Parameters_headers.h"
 
 namespace insight 
 {
@@ -20,7 +20,22 @@ std::string DynamicClassParametersSelectableSubsetParameterParser::Data::cppType
 std::string DynamicClassParametersSelectableSubsetParameterParser::Data::cppTypeDecl(const std::string& name,
                                                                                      const std::string& thisscope) const
 {
-    return std::string("struct "+cppTypeName(name)+" { std::string selection; ")+cppType(name)+" parameters; };";
+    std::ostringstream os;
+    std::string structname = cppTypeName(name);
+    os << "struct "<<structname<<" {\n"
+          "std::string selection;\n"
+       << cppType(name) <<" parameters;\n";
+
+    // the parameters are read into the defaults of the selected class
+    os << "template<class Visitor> void visitValues(Visitor& valueVisitor) const\n"
+          "{ valueVisitor(selection); valueVisitor(parameters); }\n"
+          "template<class Visitor> void readValues(Visitor& valueVisitor)\n"
+          "{ valueVisitor(selection); parameters="<<base_type<<"::defaultParameters(selection); valueVisitor(parameters); }\n"
+          "bool operator==(const "<<structname<<"& other) const\n"
+          "{ return selection==other.selection && insight::ParameterValueEquality()(parameters, other.parameters); }\n"
+          "bool operator!=(const "<<structname<<"& other) const { return !operator==(other); }\n"
+          "};";
+    return os.str();
 }
 
 
@@ -51,9 +66,9 @@ void DynamicClassParametersSelectableSubsetParameterParser::Data::cppWriteCreate
         "}";
 
     if (default_sel_==std::string())
-         os<<name<<"->selection() = "<<base_type<<"::factories_->begin()->first;\n";
+         os<<name<<"->setSelection("<<base_type<<"::factories_->begin()->first);\n";
     else
-         os<<name<<"->selection() = \""<<default_sel_<<"\";\n";
+         os<<name<<"->setSelection(\""<<default_sel_<<"\");\n";
     os << "}"
     ;
 }
@@ -68,7 +83,7 @@ void DynamicClassParametersSelectableSubsetParameterParser::Data::cppWriteSetSta
 ) const
 {
     os<<"{\n"
-        <<varname<<".selection()="<<staticname<<".selection;\n"
+        <<varname<<".setSelection("<<staticname<<".selection);\n"
         <<varname<<"() = " << staticname<<".parameters;\n"
         "}\n"<<endl;
 }
@@ -47,9 +47,9 @@ void DynamicClassSelectableSubsetParameterParser::Data::cppWriteCreateStatement
         "}";
 
     if (default_sel_==std::string())
-         os<<name<<"->selection() = "<<base_type<<"::factories_->begin()->first;";
+         os<<name<<"->setSelection("<<base_type<<"::factories_->begin()->first);";
     else
-         os<<name<<"->selection() = \""<<default_sel_<<"\";";
+         os<<name<<"->setSelection(\""<<default_sel_<<"\");";
 
     os << "}"
     ;
@@ -65,7 +65,7 @@ void DynamicClassSelectableSubsetParameterParser::Data::cppWriteSetStatement
 ) const
 {
     os<<"{"
-          <<varname<<".selection()="<<staticname<<"->type();"
+          <<varname<<".setSelection("<<staticname<<"->type());"
           <<varname<<"()="<<staticname<<"->getParameters();"
         "}"<<endl;
 }
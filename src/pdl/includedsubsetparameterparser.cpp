@@ -75,7 +75,7 @@ void IncludedSubsetParameterParser::Data::cppWriteCreateStatement
       }
       else if (type=="selectablesubset")
       {
-        os << name << "->get<SelectableSubsetParameter>(\""<<key<<"\").selection() =   \""<<value<<"\";\n";
+        os << name << "->get<SelectableSubsetParameter>(\""<<key<<"\").setSelection(\""<<value<<"\");\n";
       }
       else
         throw PDLException("Modification of parameter of type "+type+" during subset inclusion is currently not supported!");
@@ -156,3 +156,74 @@ void ParserDataBase::cppWriteGetStatement
 {
     os<<staticname<<" = "<<varname<<"();"<<std::endl;
 }
+
+
+
+
+void writeCppValueVisitors
+(
+    std::ostream& os,
+    const std::string& structname,
+    const std::vector<std::string>& members,
+    const std::string& basestructname
+)
+{
+  std::string arg = (members.empty() && basestructname.empty()) ? "" : " valueVisitor";
+
+  for (const char* fn: {"visitValues", "readValues"})
+  {
+    bool isConst = (std::string(fn)=="visitValues");
+    os<<"template<class Visitor> void "<<fn<<"(Visitor&"<<arg<<")"<<(isConst?" const":"")<<std::endl;
+    os<<"{"<<std::endl;
+    if (!basestructname.empty())
+    {
+      os<<" "<<basestructname<<"::"<<fn<<"(valueVisitor);"<<std::endl;
+    }
+    for (const std::string& m: members)
+    {
+      os<<" valueVisitor("<<m<<");"<<std::endl;
+    }
+    os<<"}"<<std::endl;
+  }
+
+  os<<"bool operator==(const "<<structname<<"&"<<(arg.empty()?"":" other")<<") const"<<std::endl;
+  os<<"{"<<std::endl;
+  if (arg.empty())
+  {
+    os<<" return true;"<<std::endl;
+  }
+  else
+  {
+    os<<" insight::ParameterValueEquality valueEqual;"<<std::endl;
+    os<<" return true";
+    if (!basestructname.empty())
+    {
+      os<<"\n  && "<<basestructname<<"::operator==(other)";
+    }
+    for (const std::string& m: members)
+    {
+      os<<"\n  && valueEqual("<<m<<", other."<<m<<")";
+    }
+    os<<";"<<std::endl;
+  }
+  os<<"}"<<std::endl;
+
+  os<<"bool operator!=(const "<<structname<<"& other) const { return !operator==(other); }"<<std::endl;
+}
+
+
+void writeCppValueVisitors
+(
+    std::ostream& os,
+    const std::string& structname,
+    const ParameterSetData& members,
+    const std::string& basestructname
+)
+{
+  std::vector<std::string> names;
+  for (const ParameterSetEntry& pe: members)
+  {
+    names.push_back(pe.first);
+  }
+  writeCppValueVisitors(os, structname, names, basestructname);
+}
@@ -211,6 +211,30 @@ typedef std::vector< ParameterSetEntry > ParameterSetData;
 
 
 
+/**
+ * write the members of a generated struct, which pass all its values
+ * to a visitor (visitValues for hashing and binary output, readValues for binary input),
+ * and the equality operators
+ */
+void writeCppValueVisitors
+(
+    std::ostream& os,
+    const std::string& structname,
+    const std::vector<std::string>& members,
+    const std::string& basestructname = std::string()
+);
+
+void writeCppValueVisitors
+(
+    std::ostream& os,
+    const std::string& structname,
+    const ParameterSetData& members,
+    const std::string& basestructname = std::string()
+);
+
+
+
+
 template <typename Iterator, typename Skipper = skip_grammar<Iterator> >
 struct PDLParserRuleset
 {
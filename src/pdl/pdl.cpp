@@ -126,6 +126,18 @@ PDLParserRuleset<Iterator,Skipper>::PDLParserRuleset()
  * - Identifiers must not be enclosed by quotes but have to start with an alphabetical character.
  *   They may then contain alphanumerical chars or underscores.
  */
+/**
+ * \addtogroup PDL
+ * \section generated Generated functions
+ * Besides the conversion from and to ParameterSet, each generated struct
+ * - can be compared with operator== and operator!=
+ * - passes its values to a visitor in visitValues and readValues (see base/parameterstructio.h)
+ *
+ * The top level struct additionally provides
+ * - hash(): a hash of all values, which is stable across processes and platforms (cache keys).
+ *   Relative paths of unpacked files are resolved against the given base directory.
+ * - writeBinary()/readBinary(): compact binary serialization
+ */
 
 
 
@@ -241,6 +253,8 @@ int main ( int argc, char *argv[] )
         {
           std::ofstream f ( bname+"_headers.h" );
           std::set<std::string> headers;
+          // visitors used by the generated comparison, hashing and binary I/O
+          headers.insert ( "\"base/parameterstructio.h\"" );
           for ( const ParameterSetEntry& pe: result )
           {
             pe.second->cppAddHeader ( headers );
@@ -367,6 +381,18 @@ int main ( int argc, char *argv[] )
           f<<"virtual operator ParameterSet() const"<<endl;
           f<<"{ ParameterSet p=makeDefault(); set(p); return p; }"<<endl;
 
+          // hashing, comparison and binary serialization
+          writeCppValueVisitors ( f, name, result, base_type_name );
+
+          f<<"virtual std::uint64_t hash(const boost::filesystem::path& baseDirectory = boost::filesystem::path()) const"<<endl;
+          f<<"{ insight::ParameterHash h(baseDirectory); h(*this); return h.value(); }"<<endl;
+
+          f<<"virtual void writeBinary(std::ostream& os) const"<<endl;
+          f<<"{ insight::BinaryParameterWriter w(os); w(*this); }"<<endl;
+
+          f<<"virtual void readBinary(std::istream& is)"<<endl;
+          f<<"{ insight::BinaryParameterReader r(is); r(*this); }"<<endl;
+
           f<<"};"<<endl;
 
 
@@ -116,7 +116,7 @@ void SelectableSubsetParameterParser::Data::cppWriteSetStatement
          ") {\n";
 
          os
-            <<varname<<".selection() = \""<<sel_name<<"\";\n";
+            <<varname<<".setSelection(\""<<sel_name<<"\");\n";
          if (!emptyset) {
               os <<
               "ParameterSet& "<<seliname<<"_param = "<<varname<<"();\n";
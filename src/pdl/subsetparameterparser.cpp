@@ -73,6 +73,8 @@ std::string SubsetParameterParser::Data::cppTypeDecl(const std::string& name,
       os <<"{}\n";
     }
 
+    writeCppValueVisitors(os, structname, value);
+
     os<<"};";
     return os.str();
 }
@@ -14,6 +14,8 @@
 #include <signal.h>
 #include "main.h"
 
+extern char **environ;
+
 static void c_end_of_job(const struct Result *res);
 static void c_wait_job_send();
 static void c_wait_running_job_send();
@@ -54,15 +56,48 @@ char *build_command_string()
     return commandstring;
 }
 
+/* Concatenates the strings of a null terminated array, keeping
+ * their null characters. The total size is returned in *size. */
+static char *build_string_block(char **array, int *size)
+{
+    int i;
+    char *block;
+    char *ptr;
+
+    *size = 0;
+    for (i = 0; array[i] != 0; ++i)
+        *size = *size + strlen(array[i]) + 1;
+
+    block = (char *) malloc(*size > 0 ? *size : 1);
+    if (block == NULL)
+        error("Error in malloc for a string block of size %i", *size);
+
+    ptr = block;
+    for (i = 0; array[i] != 0; ++i)
+    {
+        strcpy(ptr, array[i]);
+        ptr = ptr + strlen(array[i]) + 1;
+    }
+
+    return block;
+}
+
 void c_new_job()
 {
     struct msg m;
     char *new_command;
     char *myenv;
+    char *args;
+    char *environ_block;
+    int args_size;
+    int environ_size;
 
     m.type = NEWJOB;
 
     new_command = build_command_string();
+    /* The server keeps them to resubmit the job after a restart */
+    args = build_string_block(command_line.command.array, &args_size);
+    environ_block = build_string_block(environ, &environ_size);
 
     myenv = get_environment();
 
@@ -83,6 +118,9 @@ void c_new_job()
     m.u.newjob.command_size = strlen(new_command) + 1; /* add null */
     m.u.newjob.wait_enqueuing = command_line.wait_enqueuing;
     m.u.newjob.num_slots = command_line.num_slots;
+    m.u.newjob.mem_mb = command_line.mem_mb;
+    m.u.newjob.args_size = args_size;
+    m.u.newjob.environ_size = environ_size;
 
     /* Send the message */
     send_msg(server_socket, &m);
@@ -96,8 +134,14 @@ void c_new_job()
     /* Send the environment */
     send_bytes(server_socket, myenv, m.u.newjob.env_size);
 
+    /* Send the arguments and the environment of the command */
+    send_bytes(server_socket, args, args_size);
+    send_bytes(server_socket, environ_block, environ_size);
+
     free(new_command);
     free(myenv);
+    free(args);
+    free(environ_block);
 }
 
 int c_wait_newjob_ok()
@@ -4,17 +4,26 @@
 
     Please find the license in the provided COPYING file.
 */
+#define _GNU_SOURCE /* struct ucred */
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <errno.h>
 #include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 #include <time.h>
 #include "main.h"
 
 /* The list will access them */
 int busy_slots = 0;
 int max_slots = 1;
+/* In MB. No limit, if max_mem is 0 */
+int busy_mem = 0;
+int max_mem = 0;
 
 struct Notify
 {
@@ -263,6 +272,10 @@ static struct Job * newjobptr()
         firstjob->next = 0;
         firstjob->output_filename = 0;
         firstjob->command = 0;
+        firstjob->workdir = 0;
+        firstjob->args = 0;
+        firstjob->env = 0;
+        firstjob->orphaned = 0;
         return firstjob;
     }
 
@@ -274,6 +287,10 @@ static struct Job * newjobptr()
     p->next->next = 0;
     p->next->output_filename = 0;
     p->next->command = 0;
+    p->next->workdir = 0;
+    p->next->args = 0;
+    p->next->env = 0;
+    p->next->orphaned = 0;
 
     return p->next;
 }
@@ -313,6 +330,37 @@ static int find_last_stored_jobid_finished()
     return last_jobid;
 }
 
+/* The working directory of the client process, to be able to resubmit
+ * the job after a restart of the server. 0 if unknown. */
+static char * get_peer_workdir(int s)
+{
+#ifdef linux
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    char procpath[50];
+    char buffer[PATH_MAX];
+    char *workdir;
+    int res;
+
+    if (getsockopt(s, SOL_SOCKET, SO_PEERCRED, &cred, &len) == -1)
+        return 0;
+
+    sprintf(procpath, "/proc/%i/cwd", (int) cred.pid);
+    res = readlink(procpath, buffer, sizeof(buffer) - 1);
+    if (res == -1)
+        return 0;
+    buffer[res] = '\0';
+
+    workdir = (char *) malloc(res + 1);
+    if (workdir == 0)
+        error("Cannot allocate memory for the workdir");
+    strcpy(workdir, buffer);
+    return workdir;
+#else
+    return 0;
+#endif
+}
+
 /* Returns job id or -1 on error */
 int s_newjob(int s, struct msg *m)
 {
@@ -327,6 +375,7 @@ int s_newjob(int s, struct msg *m)
     else
         p->state = HOLDING_CLIENT;
     p->num_slots = m->u.newjob.num_slots;
+    p->mem_mb = m->u.newjob.mem_mb;
     p->store_output = m->u.newjob.store_output;
     p->should_keep_finished = m->u.newjob.should_keep_finished;
     p->notify_errorlevel_to = 0;
@@ -460,6 +509,37 @@ int s_newjob(int s, struct msg *m)
         free(ptr);
     }
 
+    /* load the arguments and the environment, for a resubmission */
+    p->args = 0;
+    p->args_size = m->u.newjob.args_size;
+    if (m->u.newjob.args_size > 0)
+    {
+        p->args = (char *) malloc(m->u.newjob.args_size);
+        if (p->args == 0)
+            error("Cannot allocate memory in s_newjob args_size(%i)",
+                    m->u.newjob.args_size);
+        res = recv_bytes(s, p->args, m->u.newjob.args_size);
+        if (res == -1)
+            error("wrong bytes received");
+    }
+
+    p->env = 0;
+    p->env_size = m->u.newjob.environ_size;
+    if (m->u.newjob.environ_size > 0)
+    {
+        p->env = (char *) malloc(m->u.newjob.environ_size);
+        if (p->env == 0)
+            error("Cannot allocate memory in s_newjob environ_size(%i)",
+                    m->u.newjob.environ_size);
+        res = recv_bytes(s, p->env, m->u.newjob.environ_size);
+        if (res == -1)
+            error("wrong bytes received");
+    }
+
+    p->workdir = get_peer_workdir(s);
+
+    journal_newjob(p);
+
     return p->jobid;
 }
 
@@ -476,11 +556,15 @@ void s_removejob(int jobid)
         /* First job is to be removed */
         newfirst = firstjob->next;
         free(firstjob->command);
+        free(firstjob->workdir);
+        free(firstjob->args);
+        free(firstjob->env);
         free(firstjob->output_filename);
         pinfo_free(&firstjob->info);
         free(firstjob->label);
         free(firstjob);
         firstjob = newfirst;
+        journal_removed(jobid);
         return;
     }
 
@@ -498,20 +582,64 @@ void s_removejob(int jobid)
     newnext = p->next->next;
 
     free(p->next->command);
+    free(p->next->workdir);
+    free(p->next->args);
+    free(p->next->env);
     free(p->next);
     p->next = newnext;
+    journal_removed(jobid);
+}
+
+/* The resources a job takes from the server. A job declaring more than
+ * the server has, takes everything, so it runs alone instead of never. */
+static int job_slots(const struct Job *p)
+{
+    return p->num_slots < max_slots ? p->num_slots : max_slots;
+}
+
+static int job_mem(const struct Job *p)
+{
+    if (max_mem <= 0)
+        return 0;
+    return p->mem_mb < max_mem ? p->mem_mb : max_mem;
+}
+
+/* Returns 60 if not set */
+static int get_reserve_after()
+{
+    char *str;
+
+    str = getenv("TS_RESERVE_AFTER");
+    if (str == NULL)
+        return 60;
+    return abs(atoi(str));
 }
 
-/* -1 if no one should be run. */
+/* -1 if no one should be run.
+ *
+ * Jobs are started in queue order, as long as their slots (cores) and memory
+ * are free. A job, which does not fit, may be overtaken by smaller jobs
+ * behind it (backfill). Once it waited for TS_RESERVE_AFTER seconds, its
+ * resources are reserved: a job behind it is only started, if it does not
+ * take anything of a resource the waiting job is short of, and leaves enough
+ * of the others for it. So it is not delayed any more. */
 int next_run_job()
 {
     struct Job *p;
+    struct timeval now;
+    int reserve_after;
+    int reserving = 0;
+    int reserved_slots = 0, reserved_mem = 0;
+    int short_of_slots = 0, short_of_mem = 0;
 
     const int free_slots = max_slots - busy_slots;
+    const int free_mem = max_mem - busy_mem;
 
     /* busy_slots may be bigger than the maximum slots,
      * if the user was running many jobs, and suddenly
-     * trimmed the maximum slots down. */
+     * trimmed the maximum slots down.
+     * Jobs declaring 0 slots need a free slot as well,
+     * otherwise any number of them would run at once. */
     if (free_slots <= 0)
         return -1;
 
@@ -519,12 +647,18 @@ int next_run_job()
     if (firstjob == 0)
         return -1;
 
+    gettimeofday(&now, NULL);
+    reserve_after = get_reserve_after();
+
     /* Look for a runnable task */
     p = firstjob;
     while(p != 0)
     {
         if (p->state == QUEUED)
         {
+            int slots, mem;
+            int fits;
+
             if (p->depend_on >= 0)
             {
                 struct Job *do_depend_job = get_job(p->depend_on);
@@ -539,11 +673,43 @@ int next_run_job()
                 }
             }
 
-            if (free_slots >= p->num_slots)
+            slots = job_slots(p);
+            mem = job_mem(p);
+
+            fits = free_slots >= slots && (max_mem <= 0 || free_mem >= mem);
+
+            if (fits && reserving)
+            {
+                if (short_of_slots)
+                    fits = (slots == 0);
+                else
+                    fits = (free_slots - slots >= reserved_slots);
+
+                if (short_of_mem)
+                    fits = fits && (mem == 0);
+                else if (max_mem > 0)
+                    fits = fits && (free_mem - mem >= reserved_mem);
+            }
+
+            if (fits)
             {
-                busy_slots = busy_slots + p->num_slots;
+                p->run_slots = slots;
+                p->run_mem = mem;
+                busy_slots = busy_slots + slots;
+                busy_mem = busy_mem + mem;
                 return p->jobid;
             }
+
+            /* The first job, which waits too long, gets its reservation */
+            if (!reserving && now.tv_sec - p->info.enqueue_time.tv_sec
+                    >= reserve_after)
+            {
+                reserving = 1;
+                reserved_slots = slots;
+                reserved_mem = mem;
+                short_of_slots = (free_slots < slots);
+                short_of_mem = (max_mem > 0 && free_mem < mem);
+            }
         }
         p = p->next;
     }
@@ -594,6 +760,9 @@ static void new_finished_job(struct Job *j)
         tmp = first_finished_job;
         first_finished_job = first_finished_job->next;
         free(tmp->command);
+        free(tmp->workdir);
+        free(tmp->args);
+        free(tmp->env);
         free(tmp->output_filename);
         pinfo_free(&tmp->info);
         free(tmp->label);
@@ -646,9 +815,6 @@ void job_finished(const struct Result *result, int jobid)
 {
     struct Job *p;
 
-    if (busy_slots <= 0)
-        error("Wrong state in the server. busy_slots = %i instead of greater than 0", busy_slots);
-
     p = findjob(jobid);
     if (p == 0)
         error("on jobid %i finished, it doesn't exist", jobid);
@@ -657,7 +823,13 @@ void job_finished(const struct Result *result, int jobid)
      * we call this to clean up the jobs list in case of the client closing the
      * connection. */
     if (p->state == RUNNING)
-        busy_slots = busy_slots - p->num_slots;
+    {
+        if (busy_slots < p->run_slots || busy_mem < p->run_mem)
+            error("Wrong state in the server. busy_slots = %i, busy_mem = %i"
+                    " on the end of jobid %i", busy_slots, busy_mem, jobid);
+        busy_slots = busy_slots - p->run_slots;
+        busy_mem = busy_mem - p->run_mem;
+    }
 
     /* Mark state */
     if (result->skipped)
@@ -707,6 +879,8 @@ void job_finished(const struct Result *result, int jobid)
 
         *jpointer = newfirst;
     }
+
+    journal_finished(p);
 }
 
 void s_clear_finished()
@@ -724,12 +898,17 @@ void s_clear_finished()
         struct Job *tmp;
         tmp = p->next;
         free(p->command);
+        free(p->workdir);
+        free(p->args);
+        free(p->env);
         free(p->output_filename);
         pinfo_free(&p->info);
         free(p->label);
         free(p);
         p = tmp;
     }
+
+    journal_clear_finished();
 }
 
 void s_process_runjob_ok(int jobid, char *oname, int pid)
@@ -745,6 +924,16 @@ void s_process_runjob_ok(int jobid, char *oname, int pid)
     p->pid = pid;
     p->output_filename = oname;
     pinfo_set_start_time(&p->info);
+
+    /* Only queued jobs are resubmitted */
+    free(p->args);
+    p->args = 0;
+    p->args_size = 0;
+    free(p->env);
+    p->env = 0;
+    p->env_size = 0;
+
+    journal_runjob(p);
 }
 
 void s_send_runjob(int s, int jobid)
@@ -828,6 +1017,8 @@ void s_job_info(int s, int jobid)
     write(s, p->command, strlen(p->command));
     fd_nprintf(s, 100, "\n");
     fd_nprintf(s, 100, "Slots required: %i\n", p->num_slots);
+    if (p->mem_mb > 0)
+        fd_nprintf(s, 100, "Memory required: %i MB\n", p->mem_mb);
     fd_nprintf(s, 100, "Enqueue time: %s",
             ctime(&p->info.enqueue_time.tv_sec));
     if (p->state == RUNNING)
@@ -1027,11 +1218,16 @@ int s_remove_job(int s, int *jobid)
 
     free(p->notify_errorlevel_to);
     free(p->command);
+    free(p->workdir);
+    free(p->args);
+    free(p->env);
     free(p->output_filename);
     pinfo_free(&p->info);
     free(p->label);
     free(p);
 
+    journal_removed(*jobid);
+
     m.type = REMOVEJOB_OK;
     send_msg(s, &m);
     return 1;
@@ -1137,6 +1333,9 @@ static void destroy_finished_job(struct Job *j)
 
     free(j->notify_errorlevel_to);
     free(j->command);
+    free(j->workdir);
+    free(j->args);
+    free(j->env);
     free(j->output_filename);
     pinfo_free(&j->info);
     free(j->label);
@@ -1304,6 +1503,14 @@ void s_set_max_slots(int new_max_slots)
         warning("Received new_max_slots=%i", new_max_slots);
 }
 
+void s_set_max_mem(int new_max_mem)
+{
+    if (new_max_mem >= 0)
+        max_mem = new_max_mem;
+    else
+        warning("Received new_max_mem=%i", new_max_mem);
+}
+
 void s_get_max_slots(int s)
 {
     struct msg m;
@@ -1533,3 +1740,107 @@ void joblist_dump(int fd)
         p = p->next;
     }
 }
+
+/* Takes a job replayed from the journal into the finished list */
+void s_restore_finished_job(struct Job *p)
+{
+    if (p->jobid >= jobids)
+        jobids = p->jobid + 1;
+
+    if (p->jobid > last_finished_jobid)
+    {
+        last_finished_jobid = p->jobid;
+        last_errorlevel = p->result.errorlevel;
+    }
+
+    new_finished_job(p);
+}
+
+/* The job keeps its slots and memory until its process is gone */
+void s_restore_orphaned_job(struct Job *p)
+{
+    struct Job **last;
+
+    if (p->jobid >= jobids)
+        jobids = p->jobid + 1;
+
+    p->state = RUNNING;
+    p->orphaned = 1;
+    p->run_slots = job_slots(p);
+    p->run_mem = job_mem(p);
+    busy_slots = busy_slots + p->run_slots;
+    busy_mem = busy_mem + p->run_mem;
+    pinfo_addinfo(&p->info, 100,
+            "Orphaned by a restart of the server\n");
+
+    last = &firstjob;
+    while (*last != 0)
+        last = &(*last)->next;
+    p->next = 0;
+    *last = p;
+}
+
+/* Finishes the orphaned jobs, whose process has ended. Their exit status
+ * is unknown. The pid could have been reused by an unrelated process
+ * meanwhile, which just delays the end.
+ * Returns the number of orphaned jobs left. */
+int s_check_orphaned_jobs()
+{
+    struct Job *p;
+    int left = 0;
+
+    p = firstjob;
+    while(p != 0)
+    {
+        struct Job *next = p->next;
+
+        if (p->orphaned && p->state == RUNNING)
+        {
+            if (kill(p->pid, 0) == -1 && errno == ESRCH)
+            {
+                struct Result r;
+                int jobid = p->jobid;
+
+                r.errorlevel = -1;
+                r.died_by_signal = 0;
+                r.signal = 0;
+                r.user_ms = 0;
+                r.system_ms = 0;
+                r.real_ms = 0;
+                r.skipped = 0;
+
+                p->orphaned = 0;
+                pinfo_addinfo(&p->info, 100,
+                        "The orphaned job ended, its exit status is unknown\n");
+                job_finished(&r, jobid);
+                check_notify_list(jobid);
+            }
+            else
+                ++left;
+        }
+
+        p = next;
+    }
+
+    return left;
+}
+
+/* Writes the whole job list to the journal */
+void s_journal_jobs()
+{
+    struct Job *p;
+
+    p = first_finished_job;
+    while(p != 0)
+    {
+        journal_write_job(p);
+        p = p->next;
+    }
+
+    p = firstjob;
+    while(p != 0)
+    {
+        journal_write_job(p);
+        p = p->next;
+    }
+}
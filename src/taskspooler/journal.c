@@ -0,0 +1,648 @@
+/*
+    Task Spooler - a task queue system for the unix user
+    Copyright (C) 2007-2013  Lluís Batlle i Rossell
+
+    Please find the license in the provided COPYING file.
+*/
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include "main.h"
+
+/* The journal keeps the job list on disk, so it survives a restart of the
+ * server. It is a sequence of records, one per line. Strings are stored as
+ * <length>:<bytes>, with a length of -1 for a null string.
+ *
+ *   N jobid num_slots mem_mb store_output should_keep_finished
+ *         enqueue_sec enqueue_usec workdir label command args env
+ *   R jobid pid start_sec start_usec output_filename
+ *   F jobid state errorlevel died_by_signal signal user_ms system_ms real_ms
+ *         skipped end_sec end_usec
+ *   D jobid      (removed from the queue or the finished list)
+ *   C            (finished jobs cleared)
+ *
+ * args and env are blocks of null terminated strings: the arguments of the
+ * command and the environment of the client. They are kept for queued
+ * jobs only.
+ *
+ * On startup, the journal is replayed and then rewritten with the current
+ * job list only. While running, it is rewritten the same way once the
+ * appended records outnumber the live ones by far.
+ */
+
+enum
+{
+    JOURNAL_MIN_RECORDS = 1000
+};
+
+static FILE *journal = 0;
+static char *journal_path = 0;
+static int journal_records = 0;
+static int journal_live_records = 0;
+
+/* Jobs, which had not been run before the restart */
+static struct Job *resubmit = 0;
+
+static void free_job(struct Job *p)
+{
+    free(p->notify_errorlevel_to);
+    free(p->command);
+    free(p->workdir);
+    free(p->args);
+    free(p->env);
+    free(p->output_filename);
+    pinfo_free(&p->info);
+    free(p->label);
+    free(p);
+}
+
+static void put_string(const char *str)
+{
+    if (str == 0)
+        fprintf(journal, " -1:");
+    else
+    {
+        fprintf(journal, " %i:", (int) strlen(str));
+        fputs(str, journal);
+    }
+}
+
+/* Like put_string, for data which may contain null characters */
+static void put_block(const char *block, int size)
+{
+    if (block == 0)
+        fprintf(journal, " -1:");
+    else
+    {
+        fprintf(journal, " %i:", size);
+        fwrite(block, 1, size, journal);
+    }
+}
+
+/* Returns 0 on error, with *str untouched. The length is returned in *size,
+ * if size is not null. The block is null terminated in any case. */
+static int get_block(FILE *in, char **str, int *size)
+{
+    int len;
+    char *ptr;
+
+    if (fscanf(in, " %d:", &len) != 1)
+        return 0;
+
+    if (len < 0)
+    {
+        *str = 0;
+        if (size != 0)
+            *size = 0;
+        return 1;
+    }
+
+    ptr = (char *) malloc(len + 1);
+    if (ptr == 0)
+        error("Cannot allocate memory in the journal replay (%i)", len);
+    if (fread(ptr, 1, len, in) != (size_t) len)
+    {
+        free(ptr);
+        return 0;
+    }
+    ptr[len] = '\0';
+    *str = ptr;
+    if (size != 0)
+        *size = len;
+    return 1;
+}
+
+static int get_string(FILE *in, char **str)
+{
+    return get_block(in, str, 0);
+}
+
+static void write_newjob(const struct Job *p)
+{
+    fprintf(journal, "N %i %i %i %i %i %ld %ld", p->jobid, p->num_slots,
+            p->mem_mb, p->store_output, p->should_keep_finished,
+            (long) p->info.enqueue_time.tv_sec,
+            (long) p->info.enqueue_time.tv_usec);
+    put_string(p->workdir);
+    put_string(p->label);
+    put_string(p->command);
+    put_block(p->args, p->args_size);
+    put_block(p->env, p->env_size);
+    fprintf(journal, "\n");
+}
+
+static void write_runjob(const struct Job *p)
+{
+    fprintf(journal, "R %i %i %ld %ld", p->jobid, p->pid,
+            (long) p->info.start_time.tv_sec,
+            (long) p->info.start_time.tv_usec);
+    put_string(p->store_output ? p->output_filename : 0);
+    fprintf(journal, "\n");
+}
+
+static void write_finished(const struct Job *p)
+{
+    fprintf(journal, "F %i %i %i %i %i %f %f %f %i %ld %ld\n", p->jobid,
+            (int) p->state,
+            p->result.errorlevel, p->result.died_by_signal,
+            p->result.signal, p->result.user_ms, p->result.system_ms,
+            p->result.real_ms, p->result.skipped,
+            (long) p->info.end_time.tv_sec,
+            (long) p->info.end_time.tv_usec);
+}
+
+static void journal_rewrite()
+{
+    FILE *newjournal;
+    FILE *oldjournal;
+    char *newpath;
+
+    newpath = (char *) malloc(strlen(journal_path) + 5);
+    if (newpath == 0)
+        error("Cannot allocate memory for the journal path");
+    sprintf(newpath, "%s.new", journal_path);
+
+    newjournal = fopen(newpath, "w");
+    if (newjournal == 0)
+    {
+        warning("The journal \"%s\" cannot be written", newpath);
+        free(newpath);
+        return;
+    }
+
+    oldjournal = journal;
+    journal = newjournal;
+    journal_records = 0;
+    s_journal_jobs();
+    journal_live_records = journal_records;
+
+    if (fflush(journal) != 0 || rename(newpath, journal_path) != 0)
+    {
+        warning("The journal \"%s\" cannot be replaced", journal_path);
+        fclose(journal);
+        unlink(newpath);
+        journal = oldjournal;
+    }
+    else if (oldjournal != 0)
+        fclose(oldjournal);
+
+    free(newpath);
+}
+
+/* Every record is flushed at once, so it is not lost, if the server dies */
+static void end_record()
+{
+    fflush(journal);
+    ++journal_records;
+
+    if (journal_records > 2*journal_live_records + JOURNAL_MIN_RECORDS)
+        journal_rewrite();
+}
+
+void journal_write_job(const struct Job *p)
+{
+    write_newjob(p);
+    ++journal_records;
+
+    if (p->state == RUNNING || p->info.start_time.tv_sec != 0)
+    {
+        write_runjob(p);
+        ++journal_records;
+    }
+
+    if (p->state == FINISHED || p->state == SKIPPED)
+    {
+        write_finished(p);
+        ++journal_records;
+    }
+}
+
+void journal_newjob(const struct Job *p)
+{
+    if (journal == 0)
+        return;
+    write_newjob(p);
+    end_record();
+}
+
+void journal_runjob(const struct Job *p)
+{
+    if (journal == 0)
+        return;
+    write_runjob(p);
+    end_record();
+}
+
+void journal_finished(const struct Job *p)
+{
+    if (journal == 0)
+        return;
+    write_finished(p);
+    end_record();
+}
+
+void journal_removed(int jobid)
+{
+    if (journal == 0)
+        return;
+    fprintf(journal, "D %i\n", jobid);
+    end_record();
+}
+
+void journal_clear_finished()
+{
+    if (journal == 0)
+        return;
+    fprintf(journal, "C\n");
+    end_record();
+}
+
+static struct Job * find_replayed(struct Job *first, int jobid)
+{
+    while (first != 0 && first->jobid != jobid)
+        first = first->next;
+    return first;
+}
+
+/* Reads the journal into a job list, in order of enqueuing.
+ * A damaged record (e.g. the last one, if the server died while writing)
+ * ends the replay. */
+static struct Job * replay(FILE *in)
+{
+    struct Job *first = 0;
+    struct Job **last = &first;
+    char type;
+    int ok = 1;
+
+    while (ok && fscanf(in, " %c", &type) == 1)
+    {
+        struct Job *p;
+        int jobid;
+        long sec, usec;
+
+        switch(type)
+        {
+            case 'N':
+                p = (struct Job *) calloc(1, sizeof(*p));
+                if (p == 0)
+                    error("Cannot allocate memory in the journal replay");
+                pinfo_init(&p->info);
+                p->state = QUEUED;
+                p->depend_on = -1;
+                ok = fscanf(in, "%d %d %d %d %d %ld %ld", &p->jobid,
+                        &p->num_slots, &p->mem_mb, &p->store_output,
+                        &p->should_keep_finished, &sec, &usec) == 7
+                    && get_string(in, &p->workdir)
+                    && get_string(in, &p->label)
+                    && get_string(in, &p->command)
+                    && p->command != 0
+                    && get_block(in, &p->args, &p->args_size)
+                    && get_block(in, &p->env, &p->env_size);
+                if (!ok)
+                {
+                    free_job(p);
+                    break;
+                }
+                p->info.enqueue_time.tv_sec = sec;
+                p->info.enqueue_time.tv_usec = usec;
+                *last = p;
+                last = &p->next;
+                break;
+            case 'R':
+                ok = fscanf(in, "%d", &jobid) == 1
+                    && (p = find_replayed(first, jobid)) != 0
+                    && fscanf(in, "%d %ld %ld", &p->pid, &sec, &usec) == 3
+                    && get_string(in, &p->output_filename);
+                if (ok)
+                {
+                    p->state = RUNNING;
+                    p->info.start_time.tv_sec = sec;
+                    p->info.start_time.tv_usec = usec;
+                }
+                break;
+            case 'F':
+                {
+                    int state;
+                    ok = fscanf(in, "%d", &jobid) == 1
+                        && (p = find_replayed(first, jobid)) != 0
+                        && fscanf(in, "%d %d %d %d %f %f %f %d %ld %ld",
+                                &state, &p->result.errorlevel,
+                                &p->result.died_by_signal, &p->result.signal,
+                                &p->result.user_ms, &p->result.system_ms,
+                                &p->result.real_ms, &p->result.skipped,
+                                &sec, &usec) == 10;
+                    if (ok)
+                    {
+                        p->state = (state == SKIPPED) ? SKIPPED : FINISHED;
+                        p->info.end_time.tv_sec = sec;
+                        p->info.end_time.tv_usec = usec;
+                    }
+                }
+                break;
+            case 'D':
+                ok = fscanf(in, "%d", &jobid) == 1;
+                if (ok)
+                {
+                    struct Job **pp = &first;
+                    while (*pp != 0 && (*pp)->jobid != jobid)
+                        pp = &(*pp)->next;
+                    if (*pp != 0)
+                    {
+                        p = *pp;
+                        *pp = p->next;
+                        free_job(p);
+                    }
+                }
+                break;
+            case 'C':
+                {
+                    struct Job **pp = &first;
+                    while (*pp != 0)
+                    {
+                        p = *pp;
+                        if (p->state == FINISHED || p->state == SKIPPED)
+                        {
+                            *pp = p->next;
+                            free_job(p);
+                        }
+                        else
+                            pp = &p->next;
+                    }
+                }
+                break;
+            default:
+                ok = 0;
+        }
+
+        /* The list end may have been removed */
+        last = &first;
+        while (*last != 0)
+            last = &(*last)->next;
+    }
+
+    if (!ok)
+        warning("The journal \"%s\" is damaged. Ignoring the rest of it.",
+                journal_path);
+
+    return first;
+}
+
+/* The clients of unfinished jobs are gone with the old server.
+ * Jobs, which are still running, are kept as orphaned: they hold their
+ * slots, until their process ends (see s_check_orphaned_jobs). Running
+ * jobs, whose process is gone, are marked as died.
+ * Queued jobs are resubmitted, if their working directory, arguments and
+ * environment are known, unless TS_REQUEUE is set to 0. Otherwise they are
+ * marked as died as well. */
+static void restore(struct Job *first)
+{
+    const char *str;
+    int should_resubmit;
+    struct Job **last_resubmit = &resubmit;
+
+    str = getenv("TS_REQUEUE");
+    should_resubmit = (str == NULL || atoi(str) != 0);
+
+    while (first != 0)
+    {
+        struct Job *p = first;
+        first = p->next;
+        p->next = 0;
+
+        if (p->state == QUEUED && should_resubmit && p->workdir != 0
+                && p->args != 0 && p->env != 0)
+        {
+            *last_resubmit = p;
+            last_resubmit = &p->next;
+            continue;
+        }
+
+        free(p->args);
+        p->args = 0;
+        free(p->env);
+        p->env = 0;
+
+        if (p->state == RUNNING && p->pid > 0
+                && (kill(p->pid, 0) == 0 || errno == EPERM))
+        {
+            s_restore_orphaned_job(p);
+            continue;
+        }
+
+        if (p->state != FINISHED && p->state != SKIPPED)
+        {
+            const char *reason = (p->state == RUNNING) ?
+                "Exit status: unknown, the job ended during a restart of the server\n"
+                : "Exit status: not run, the job was dropped by a restart of the server\n";
+
+            p->state = FINISHED;
+            p->result.errorlevel = -1;
+            p->result.died_by_signal = 0;
+            p->result.signal = 0;
+            p->result.user_ms = 0;
+            p->result.system_ms = 0;
+            p->result.real_ms = 0;
+            p->result.skipped = 0;
+            pinfo_set_end_time(&p->info);
+            pinfo_addinfo(&p->info, 100, "%s", reason);
+        }
+        else if (p->result.died_by_signal)
+            pinfo_addinfo(&p->info, 100, "Exit status: killed by signal %i\n",
+                    p->result.signal);
+        else
+            pinfo_addinfo(&p->info, 100, "Exit status: died with exit code %i\n",
+                    p->result.errorlevel);
+
+        if (p->should_keep_finished)
+            s_restore_finished_job(p);
+        else
+            free_job(p);
+    }
+}
+
+void journal_open(const char *socket_path)
+{
+    const char *str;
+    FILE *in;
+
+    /* An empty TS_JOURNAL disables the journal */
+    str = getenv("TS_JOURNAL");
+    if (str != NULL)
+    {
+        if (str[0] == '\0')
+            return;
+        journal_path = (char *) malloc(strlen(str) + 1);
+        if (journal_path == 0)
+            error("Cannot allocate memory for the journal path");
+        strcpy(journal_path, str);
+    }
+    else
+    {
+        journal_path = (char *) malloc(strlen(socket_path) + 9);
+        if (journal_path == 0)
+            error("Cannot allocate memory for the journal path");
+        sprintf(journal_path, "%s.journal", socket_path);
+    }
+
+    in = fopen(journal_path, "r");
+    if (in != 0)
+    {
+        restore(replay(in));
+        fclose(in);
+    }
+
+    journal_rewrite();
+    if (journal == 0)
+    {
+        free(journal_path);
+        journal_path = 0;
+    }
+}
+
+void journal_close()
+{
+    if (journal != 0)
+        fclose(journal);
+    journal = 0;
+    free(journal_path);
+    journal_path = 0;
+}
+
+#ifdef linux
+/* Splits a block of null terminated strings into a null terminated array,
+ * leaving the first 'reserve' entries free */
+static char **split_block(char *block, int size, int reserve)
+{
+    char **array;
+    int num = 0;
+    int i;
+
+    for (i = 0; i < size; ++i)
+        if (block[i] == '\0')
+            ++num;
+
+    array = (char **) malloc((reserve + num + 1) * sizeof(char *));
+    if (array == 0)
+        return 0;
+
+    num = reserve;
+    for (i = 0; i < size; i = i + strlen(block + i) + 1)
+        array[num++] = block + i;
+    array[num] = 0;
+
+    return array;
+}
+
+/* Runs a ts client for the job, in a detached grandchild */
+static void resubmit_job(const char *self, const struct Job *p)
+{
+    int pid;
+
+    pid = fork();
+    if (pid == -1)
+    {
+        warning("Cannot fork to resubmit the job %i", p->jobid);
+        return;
+    }
+    if (pid != 0)
+    {
+        waitpid(pid, NULL, 0);
+        return;
+    }
+
+    if (fork() == 0)
+    {
+        char slots[20];
+        char mem[20];
+        char *opts[9];
+        char **argv;
+        char **envp;
+        int nopts = 0;
+        int fd;
+
+        /* The server descriptors are not for the client */
+        for (fd = 0; fd < 1024; ++fd)
+            close(fd);
+        open("/dev/null", O_RDONLY);
+        open("/dev/null", O_WRONLY);
+        open("/dev/null", O_WRONLY);
+        signal(SIGTERM, SIG_DFL);
+        setsid();
+
+        sprintf(slots, "%i", p->num_slots);
+        opts[nopts++] = "ts";
+        if (!p->store_output)
+            opts[nopts++] = "-n";
+        opts[nopts++] = "-N";
+        opts[nopts++] = slots;
+        if (p->mem_mb > 0)
+        {
+            sprintf(mem, "%i", p->mem_mb);
+            opts[nopts++] = "-M";
+            opts[nopts++] = mem;
+        }
+        if (p->label != 0)
+        {
+            opts[nopts++] = "-L";
+            opts[nopts++] = p->label;
+        }
+        opts[nopts++] = "--";
+
+        /* The command arguments follow the options unchanged */
+        argv = split_block(p->args, p->args_size, nopts);
+        envp = split_block(p->env, p->env_size, 0);
+
+        if (argv != 0 && envp != 0 && chdir(p->workdir) == 0)
+        {
+            memcpy(argv, opts, nopts * sizeof(char *));
+            execve(self, argv, envp);
+        }
+    }
+    _exit(0);
+}
+#endif
+
+/* Runs a new ts client for each job, which had not been run before the
+ * restart. The job gets a new id. The command is run with the arguments
+ * and the environment of the original client. */
+void journal_resubmit()
+{
+#ifdef linux
+    char self[PATH_MAX];
+    int res;
+
+    res = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (res == -1)
+    {
+        warning("Cannot find the ts executable to resubmit the jobs");
+        res = 0;
+    }
+    self[res] = '\0';
+
+    while (resubmit != 0)
+    {
+        struct Job *p = resubmit;
+        resubmit = p->next;
+
+        if (res > 0)
+            resubmit_job(self, p);
+
+        free_job(p);
+    }
+#else
+    while (resubmit != 0)
+    {
+        struct Job *p = resubmit;
+        resubmit = p->next;
+        free_job(p);
+    }
+#endif
+}
@@ -45,6 +45,7 @@ static void default_command_line()
     command_line.wait_enqueuing = 1;
     command_line.stderr_apart = 0;
     command_line.num_slots = 1;
+    command_line.mem_mb = 0;
 }
 
 void get_command(int index, int argc, char **argv)
@@ -84,7 +85,7 @@ void parse_opts(int argc, char **argv)
 
     /* Parse options */
     while(1) {
-        c = getopt(argc, argv, ":VhKgClnfmBEr:t:c:o:p:w:k:u:s:U:i:N:L:dS:D:");
+        c = getopt(argc, argv, ":VhKgClnfmBEr:t:c:o:p:w:k:u:s:U:i:N:M:L:dS:D:");
 
         if (c == -1)
             break;
@@ -155,6 +156,11 @@ void parse_opts(int argc, char **argv)
                 if (command_line.num_slots < 0)
                     command_line.num_slots = 0;
                 break;
+            case 'M':
+                command_line.mem_mb = atoi(optarg);
+                if (command_line.mem_mb < 0)
+                    command_line.mem_mb = 0;
+                break;
             case 'r':
                 command_line.request = c_REMOVEJOB;
                 command_line.jobid = atoi(optarg);
@@ -344,7 +350,11 @@ static void print_help(const char *cmd)
     printf("  TS_ONFINISH  binary called on job end (passes jobid, error, outfile, command).\n");
     printf("  TS_ENV  command called on enqueue. Its output determines the job information.\n");
     printf("  TS_SAVELIST  filename which will store the list, if the server dies.\n");
+    printf("  TS_JOURNAL  file keeping the job list over server restarts (socket path + .journal by default, empty to disable).\n");
+    printf("  TS_REQUEUE  0 to not resubmit the jobs queued before a server restart (resubmitted by default).\n");
     printf("  TS_SLOTS   amount of jobs which can run at once, read on server start.\n");
+    printf("  TS_MEMORY  memory in MB for all running jobs, read on server start (physical memory by default).\n");
+    printf("  TS_RESERVE_AFTER  seconds, after which a waiting job may not be overtaken any more (60 default).\n");
     printf("  TMPDIR     directory where to place the output files and the default socket.\n");
     printf("Actions:\n");
     printf("  -K       kill the task spooler server\n");
@@ -375,6 +385,7 @@ static void print_help(const char *cmd)
     printf("  -D <id>  the job will be run only if the job of given id ends well.\n");
     printf("  -L <lab> name this task with a label, to be distinguished on listing.\n");
     printf("  -N <num> number of slots required by the job (1 default).\n");
+    printf("  -M <MB>  memory required by the job (not declared by default).\n");
 }
 
 static void print_version()
@@ -4,44 +4,11 @@
 
     Please find the license in the provided COPYING file.
 */
-enum
-{
-    CMD_LEN=500,
-    PROTOCOL_VERSION=730
-};
+#include "protocol.h"
 
-enum msg_types
+enum
 {
-    KILL_SERVER,
-    NEWJOB,
-    NEWJOB_OK,
-    RUNJOB,
-    RUNJOB_OK,
-    ENDJOB,
-    LIST,
-    LIST_LINE,
-    CLEAR_FINISHED,
-    ASK_OUTPUT,
-    ANSWER_OUTPUT,
-    REMOVEJOB,
-    REMOVEJOB_OK,
-    WAITJOB,
-    WAIT_RUNNING_JOB,
-    WAITJOB_OK,
-    URGENT,
-    URGENT_OK,
-    GET_STATE,
-    ANSWER_STATE,
-    SWAP_JOBS,
-    SWAP_JOBS_OK,
-    INFO,
-    INFO_DATA,
-    SET_MAX_SLOTS,
-    GET_MAX_SLOTS,
-    GET_MAX_SLOTS_OK,
-    GET_VERSION,
-    VERSION,
-    NEWJOB_NOK
+    CMD_LEN=500
 };
 
 enum Request
@@ -89,6 +56,7 @@ struct Command_line {
     } command;
     char *label;
     int num_slots; /* Slots for the job to use. Default 1 */
+    int mem_mb; /* Memory for the job to use, in MB. 0 if not declared */
 };
 
 enum Process_type {
@@ -101,61 +69,6 @@ extern int server_socket;
 extern enum Process_type process_type;
 extern int server_socket; /* Used in the client */
 
-struct msg;
-
-enum Jobstate
-{
-    QUEUED,
-    RUNNING,
-    FINISHED,
-    SKIPPED,
-    HOLDING_CLIENT
-};
-
-struct msg
-{
-    enum msg_types type;
-
-    union
-    {
-        struct {
-            int command_size;
-            int store_output;
-            int should_keep_finished;
-            int label_size;
-            int env_size;
-            int do_depend;
-            int depend_on; /* -1 means depend on previous */
-            int wait_enqueuing;
-            int num_slots;
-        } newjob;
-        struct {
-            int ofilename_size;
-            int store_output;
-            int pid;
-        } output;
-        int jobid;
-        struct Result {
-            int errorlevel;
-            int died_by_signal;
-            int signal;
-            float user_ms;
-            float system_ms;
-            float real_ms;
-            int skipped;
-        } result;
-        int size;
-        enum Jobstate state;
-        struct {
-            int jobid1;
-            int jobid2;
-        } swap;
-        int last_errorlevel;
-        int max_slots;
-        int version;
-    } u;
-};
-
 struct Procinfo
 {
     char *ptr;
@@ -185,6 +98,18 @@ struct Job
     char *label;
     struct Procinfo info;
     int num_slots;
+    int mem_mb;
+    int run_slots; /* taken from the server while running */
+    int run_mem;
+    char *workdir; /* of the client, 0 if unknown */
+    /* For a resubmission after a restart. Kept until the job runs. */
+    char *args; /* command arguments, each null terminated */
+    int args_size;
+    char *env; /* client environment, each null terminated */
+    int env_size;
+    /* Running since before a restart of the server. There is no client
+     * any more, so its end is noticed by polling the pid. */
+    int orphaned;
 };
 
 enum ExitCodes
@@ -247,15 +172,31 @@ const char * jstate2string(enum Jobstate s);
 void s_job_info(int s, int jobid);
 void s_send_runjob(int s, int jobid);
 void s_set_max_slots(int new_max_slots);
+void s_set_max_mem(int new_max_mem);
 void s_get_max_slots(int s);
 int job_is_running(int jobid);
 int job_is_holding_client(int jobid);
 int wake_hold_client();
+void s_restore_finished_job(struct Job *p);
+void s_restore_orphaned_job(struct Job *p);
+int s_check_orphaned_jobs();
+void s_journal_jobs();
 
 /* server.c */
 void server_main(int notify_fd, char *_path);
 void dump_conns_struct(FILE *out);
 
+/* journal.c */
+void journal_open(const char *socket_path);
+void journal_close();
+void journal_resubmit();
+void journal_write_job(const struct Job *p);
+void journal_newjob(const struct Job *p);
+void journal_runjob(const struct Job *p);
+void journal_finished(const struct Job *p);
+void journal_removed(int jobid);
+void journal_clear_finished();
+
 /* server_start.c */
 int try_connect(int s);
 void wait_server_up();
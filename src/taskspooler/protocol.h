@@ -0,0 +1,110 @@
+/*
+    Task Spooler - a task queue system for the unix user
+    Copyright (C) 2007-2013  Lluís Batlle i Rossell
+
+    Please find the license in the provided COPYING file.
+*/
+
+/* Messages exchanged between the server and its clients. This header is
+ * also compiled into the native client of the toolkit
+ * (src/toolkit/base/taskspoolerclient.cpp), so it must stay plain C and
+ * must not include anything. Bump PROTOCOL_VERSION on every change. */
+#ifndef TASKSPOOLER_PROTOCOL_H
+#define TASKSPOOLER_PROTOCOL_H
+
+enum
+{
+    PROTOCOL_VERSION=732
+};
+
+enum msg_types
+{
+    KILL_SERVER,
+    NEWJOB,
+    NEWJOB_OK,
+    RUNJOB,
+    RUNJOB_OK,
+    ENDJOB,
+    LIST,
+    LIST_LINE,
+    CLEAR_FINISHED,
+    ASK_OUTPUT,
+    ANSWER_OUTPUT,
+    REMOVEJOB,
+    REMOVEJOB_OK,
+    WAITJOB,
+    WAIT_RUNNING_JOB,
+    WAITJOB_OK,
+    URGENT,
+    URGENT_OK,
+    GET_STATE,
+    ANSWER_STATE,
+    SWAP_JOBS,
+    SWAP_JOBS_OK,
+    INFO,
+    INFO_DATA,
+    SET_MAX_SLOTS,
+    GET_MAX_SLOTS,
+    GET_MAX_SLOTS_OK,
+    GET_VERSION,
+    VERSION,
+    NEWJOB_NOK
+};
+
+enum Jobstate
+{
+    QUEUED,
+    RUNNING,
+    FINISHED,
+    SKIPPED,
+    HOLDING_CLIENT
+};
+
+struct msg
+{
+    enum msg_types type;
+
+    union
+    {
+        struct {
+            int command_size;
+            int store_output;
+            int should_keep_finished;
+            int label_size;
+            int env_size;
+            int do_depend;
+            int depend_on; /* -1 means depend on previous */
+            int wait_enqueuing;
+            int num_slots;
+            int mem_mb;
+            int args_size; /* command arguments, each null terminated */
+            int environ_size; /* client environment, each null terminated */
+        } newjob;
+        struct {
+            int ofilename_size;
+            int store_output;
+            int pid;
+        } output;
+        int jobid;
+        struct Result {
+            int errorlevel;
+            int died_by_signal;
+            int signal;
+            float user_ms;
+            float system_ms;
+            float real_ms;
+            int skipped;
+        } result;
+        int size;
+        enum Jobstate state;
+        struct {
+            int jobid1;
+            int jobid2;
+        } swap;
+        int last_errorlevel;
+        int max_slots;
+        int version;
+    } u;
+};
+
+#endif
@@ -6,7 +6,7 @@
 */
 #include <sys/types.h>
 #include <sys/socket.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #ifdef linux
   #include <sys/time.h>
 #endif
@@ -27,7 +27,8 @@
 
 enum
 {
-    MAXCONN=1000
+    MAXEVENTS=64,
+    ORPHAN_POLL_MS=1000 /* check for the end of orphaned jobs */
 };
 
 enum Break
@@ -55,10 +56,15 @@ struct Client_conn
 };
 
 /* Globals */
-static struct Client_conn client_cs[MAXCONN];
+static struct Client_conn *client_cs;
+static int allocated_connections;
 static int nconnections;
+/* Index in client_cs of each socket, -1 if none */
+static int *conn_of_socket;
+static int conn_of_socket_size;
 static char *path;
 static int max_descriptors;
+static int epoll_fd;
 
 /* in jobs.c */
 extern int max_jobs;
@@ -110,6 +116,25 @@ static void set_default_maxslots()
     }
 }
 
+/* The physical memory, if TS_MEMORY is not set */
+static void set_default_maxmem()
+{
+    char *str;
+    long pages, pagesize;
+
+    str = getenv("TS_MEMORY");
+    if (str != NULL)
+    {
+        s_set_max_mem(abs(atoi(str)));
+        return;
+    }
+
+    pages = sysconf(_SC_PHYS_PAGES);
+    pagesize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pagesize > 0)
+        s_set_max_mem((int) ((pages / 1024) * pagesize / 1024));
+}
+
 static void install_sigterm_handler()
 {
   struct sigaction act;
@@ -124,13 +149,31 @@ static void install_sigterm_handler()
 
 static int get_max_descriptors()
 {
-    const int MARGIN = 5; /* stdin, stderr, listen socket, and whatever */
+    /* stdin, stderr, listen socket, epoll, journal, and whatever */
+    const int MARGIN = 10;
     int max;
     struct rlimit rlim;
     int res;
     const char *str;
 
-    max = MAXCONN;
+    max = INT_MAX;
+
+    /* The connections are not limited by the server itself any more,
+     * so take as many descriptors as we are allowed to */
+    res = getrlimit(RLIMIT_NOFILE, &rlim);
+    if (res != 0)
+        warning("getrlimit for open files");
+    else
+    {
+        if (rlim.rlim_cur < rlim.rlim_max)
+        {
+            rlim.rlim_cur = rlim.rlim_max;
+            if (setrlimit(RLIMIT_NOFILE, &rlim) != 0)
+                getrlimit(RLIMIT_NOFILE, &rlim);
+        }
+        if (rlim.rlim_cur != RLIM_INFINITY && max > rlim.rlim_cur)
+            max = rlim.rlim_cur - MARGIN;
+    }
 
     str = getenv("TS_MAXCONN");
     if (str != NULL)
@@ -141,21 +184,6 @@ static int get_max_descriptors()
             max = user_maxconn;
     }
 
-    if (max > FD_SETSIZE)
-        max = FD_SETSIZE - MARGIN;
-
-    /* I'd like to use OPEN_MAX or NR_OPEN, but I don't know if any
-     * of them is POSIX compliant */
-
-    res = getrlimit(RLIMIT_NOFILE, &rlim);
-    if (res != 0)
-        warning("getrlimit for open files");
-    else
-    {
-        if (max > rlim.rlim_cur)
-            max = rlim.rlim_cur - MARGIN;
-    }
-
     if (max < 1)
         error("Too few opened descriptors available");
 
@@ -197,16 +225,24 @@ void server_main(int notify_fd, char *_path)
     if (res == -1)
         error("Error binding.");
 
-    res = listen(ls, 0);
+    res = listen(ls, SOMAXCONN);
     if (res == -1)
         error("Error listening.");
 
+    /* All pending connections are accepted at once */
+    fcntl(ls, F_SETFL, fcntl(ls, F_GETFL) | O_NONBLOCK);
+
     install_sigterm_handler();
 
     set_default_maxslots();
+    set_default_maxmem();
+
+    journal_open(path);
 
     notify_parent(notify_fd);
 
+    journal_resubmit();
+
     server_loop(ls);
 }
 
@@ -219,61 +255,159 @@ static int get_conn_of_jobid(int jobid)
     return -1;
 }
 
+static int get_conn_of_socket(int s)
+{
+    if (s < 0 || s >= conn_of_socket_size)
+        return -1;
+    return conn_of_socket[s];
+}
+
+static void add_connection(int cs)
+{
+    struct epoll_event ev;
+
+    if (nconnections == allocated_connections)
+    {
+        allocated_connections = allocated_connections ?
+            2*allocated_connections : 64;
+        client_cs = (struct Client_conn *) realloc(client_cs,
+                allocated_connections * sizeof(*client_cs));
+        if (client_cs == 0)
+            error("Cannot allocate memory for %i connections",
+                    allocated_connections);
+    }
+
+    if (cs >= conn_of_socket_size)
+    {
+        int i;
+        int newsize = conn_of_socket_size ? conn_of_socket_size : 64;
+        while (newsize <= cs)
+            newsize = 2*newsize;
+        conn_of_socket = (int *) realloc(conn_of_socket,
+                newsize * sizeof(*conn_of_socket));
+        if (conn_of_socket == 0)
+            error("Cannot allocate memory for %i sockets", newsize);
+        for(i = conn_of_socket_size; i < newsize; ++i)
+            conn_of_socket[i] = -1;
+        conn_of_socket_size = newsize;
+    }
+
+    client_cs[nconnections].hasjob = 0;
+    client_cs[nconnections].socket = cs;
+    conn_of_socket[cs] = nconnections;
+    ++nconnections;
+
+    ev.events = EPOLLIN;
+    ev.data.fd = cs;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, cs, &ev) == -1)
+        error("Cannot watch the socket %i", cs);
+}
+
+/* Stop accepting, if we reached the maximum connections.
+ * The system will keep the new ones waiting meanwhile. */
+static void update_listening(int ls, int *listening)
+{
+    struct epoll_event ev;
+    int should_listen = (nconnections < max_descriptors);
+
+    if (should_listen == *listening)
+        return;
+
+    ev.events = EPOLLIN;
+    ev.data.fd = ls;
+    if (epoll_ctl(epoll_fd, should_listen ? EPOLL_CTL_ADD : EPOLL_CTL_DEL,
+                ls, &ev) == -1)
+        error("Cannot update the watch of the listen socket");
+    *listening = should_listen;
+}
+
+static void accept_connections(int ls)
+{
+    while (nconnections < max_descriptors)
+    {
+        int cs;
+        cs = accept(ls, NULL, NULL);
+        if (cs == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR
+                    || errno == ECONNABORTED)
+                return;
+            error("Accepting from %i", ls);
+        }
+        add_connection(cs);
+    }
+}
+
 static void server_loop(int ls)
 {
-    fd_set readset;
+    struct epoll_event events[MAXEVENTS];
     int i;
-    int maxfd;
+    int nevents;
+    int listening = 0;
     int keep_loop = 1;
     int newjob;
+    int orphaned_jobs;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1)
+        error("Cannot create the epoll instance");
+
+    orphaned_jobs = s_check_orphaned_jobs();
 
     while (keep_loop)
     {
-        FD_ZERO(&readset);
-        maxfd = 0;
-        /* If we can accept more connections, go on.
-         * Otherwise, the system block them (no accept will be done). */
-        if (nconnections < max_descriptors)
-        {
-            FD_SET(ls,&readset);
-            maxfd = ls;
-        }
-        for(i=0; i< nconnections; ++i)
+        int should_accept = 0;
+
+        update_listening(ls, &listening);
+
+        /* The end of orphaned jobs is only noticed by polling */
+        nevents = epoll_wait(epoll_fd, events, MAXEVENTS,
+                orphaned_jobs > 0 ? ORPHAN_POLL_MS : -1);
+        if (nevents == -1)
         {
-            FD_SET(client_cs[i].socket, &readset);
-            if (client_cs[i].socket > maxfd)
-                maxfd = client_cs[i].socket;
+            if (errno == EINTR)
+                continue;
+            error("epoll_wait");
         }
-        select(maxfd + 1, &readset, NULL, NULL, NULL);
-        if (FD_ISSET(ls,&readset))
+
+        /* The new connections are accepted after processing the events,
+         * so no socket closed meanwhile gets reused within this round */
+        for(i=0; i < nevents; ++i)
         {
-            int cs;
-            cs = accept(ls, NULL, NULL);
-            if (cs == -1)
-                error("Accepting from %i", ls);
-            client_cs[nconnections].hasjob = 0;
-            client_cs[nconnections].socket = cs;
-            ++nconnections;
-        }
-        for(i=0; i< nconnections; ++i)
-            if (FD_ISSET(client_cs[i].socket, &readset))
+            int index;
+            enum Break b;
+
+            if (events[i].data.fd == ls)
             {
-                enum Break b;
-                b = client_read(i);
-                /* Check if we should break */
-                if (b == CLOSE)
-                {
-                    warning("Closing");
-                    /* On unknown message, we close the client,
-                       or it may hang waiting for an answer */
-                    clean_after_client_disappeared(client_cs[i].socket, i);
-                }
-                else if (b == BREAK)
-                    keep_loop = 0;
+                should_accept = 1;
+                continue;
             }
+
+            index = get_conn_of_socket(events[i].data.fd);
+            if (index == -1)
+                continue; /* Closed in this round */
+
+            b = client_read(index);
+            /* Check if we should break */
+            if (b == CLOSE)
+            {
+                warning("Closing");
+                /* On unknown message, we close the client,
+                   or it may hang waiting for an answer */
+                clean_after_client_disappeared(client_cs[index].socket, index);
+            }
+            else if (b == BREAK)
+                keep_loop = 0;
+        }
+
+        if (should_accept)
+            accept_connections(ls);
+
+        if (orphaned_jobs > 0)
+            orphaned_jobs = s_check_orphaned_jobs();
+
         /* This will return firstjob->jobid or -1 */
-        newjob = next_run_job();
-        if (newjob != -1)
+        while ((newjob = next_run_job()) != -1)
         {
             int conn, awaken_job;
             conn = get_conn_of_jobid(newjob);
@@ -296,25 +430,31 @@ static void server_loop(int ls)
 
 static void end_server(int ls)
 {
+    close(epoll_fd);
     close(ls);
+    journal_close();
     unlink(path);
     /* This comes from the parent, in the fork after server_main.
      * This is the last use of path in this process.*/
     free(path); 
 }
 
+/* The socket has to be closed already, which also removes it from
+ * the epoll set. The last connection takes the place of the removed one. */
 static void remove_connection(int index)
 {
-    int i;
+    int last = nconnections - 1;
 
     if(client_cs[index].hasjob)
     {
         s_removejob(client_cs[index].jobid);
     }
 
-    for(i=index; i<(nconnections-1); ++i)
+    conn_of_socket[client_cs[index].socket] = -1;
+    if (index != last)
     {
-        memcpy(&client_cs[i], &client_cs[i+1], sizeof(client_cs[0]));
+        memcpy(&client_cs[index], &client_cs[last], sizeof(client_cs[0]));
+        conn_of_socket[client_cs[index].socket] = index;
     }
     nconnections--;
 }
@@ -444,7 +584,7 @@ static enum Break
                 if (went_ok)
                 {
                     int i;
-                    for(i = 0; i < nconnections; ++i)
+                    for(i = 0; i < nconnections; )
                     {
                         if (client_cs[i].hasjob && client_cs[i].jobid == m.u.jobid)
                         {
@@ -456,7 +596,10 @@ static enum Break
                             /* We don't try to remove any notification related to
                              * 'i', because it will be for sure a ts client for a job */
                             remove_connection(i);
+                            /* 'i' holds the former last connection now */
                         }
+                        else
+                            ++i;
                     }
                 }
             }
@@ -0,0 +1,360 @@
+/*
+    Task Spooler - a task queue system for the unix user
+    Copyright (C) 2007-2013  Lluís Batlle i Rossell
+
+    Please find the license in the provided COPYING file.
+*/
+
+/* Load test for the server: many clients list the jobs and ask for the
+ * output of the running one (as "ts -t" does), while jobs are run and
+ * other clients keep waiting connections open.
+ *
+ * usage: tsp-bench [-c clients] [-r requests] [-j jobs] [-w waiters] <ts executable>
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "main.h"
+
+enum
+{
+    BUCKET_US = 50,
+    NBUCKETS = 4000 /* up to 200ms */
+};
+
+struct Stats
+{
+    unsigned int requests;
+    unsigned int failures;
+    double max_ms;
+    unsigned int histogram[NBUCKETS+1];
+};
+
+static char socket_path[200];
+
+static double now_ms()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec*1e3 + tv.tv_usec*1e-3;
+}
+
+static int connect_server()
+{
+    struct sockaddr_un addr;
+    int s;
+
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s == -1)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    if (connect(s, (struct sockaddr *) &addr, sizeof(addr)) == -1)
+    {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+static int recv_all(int fd, void *data, int bytes)
+{
+    int got = 0;
+    while (got < bytes)
+    {
+        int res = read(fd, (char *) data + got, bytes - got);
+        if (res <= 0)
+            return got;
+        got += res;
+    }
+    return got;
+}
+
+static int send_request(int s, enum msg_types type, int jobid)
+{
+    struct msg m;
+    memset(&m, 0, sizeof(m));
+    m.type = type;
+    m.u.jobid = jobid;
+    return send(s, &m, sizeof(m), MSG_NOSIGNAL) == sizeof(m) ? 0 : -1;
+}
+
+/* Skips the text following a LIST_LINE or ANSWER_OUTPUT */
+static int skip_bytes(int s, int bytes)
+{
+    char buffer[1024];
+    while (bytes > 0)
+    {
+        int n = bytes < (int) sizeof(buffer) ? bytes : (int) sizeof(buffer);
+        if (recv_all(s, buffer, n) != n)
+            return -1;
+        bytes -= n;
+    }
+    return 0;
+}
+
+/* The server closes the connection after the list */
+static int do_list()
+{
+    struct msg m;
+    int s;
+    int ok = 0;
+
+    s = connect_server();
+    if (s == -1)
+        return -1;
+
+    if (send_request(s, LIST, 0) == 0)
+    {
+        while (recv_all(s, &m, sizeof(m)) == sizeof(m))
+        {
+            if (m.type != LIST_LINE || skip_bytes(s, m.u.size) != 0)
+            {
+                ok = -1;
+                break;
+            }
+        }
+    }
+    else
+        ok = -1;
+
+    close(s);
+    return ok;
+}
+
+/* What "ts -t" asks, before following the output file */
+static int do_ask_output()
+{
+    struct msg m;
+    int s;
+    int ok = -1;
+
+    s = connect_server();
+    if (s == -1)
+        return -1;
+
+    if (send_request(s, ASK_OUTPUT, -1) == 0
+            && recv_all(s, &m, sizeof(m)) == sizeof(m))
+    {
+        if (m.type == ANSWER_OUTPUT)
+            ok = skip_bytes(s, m.u.output.ofilename_size);
+        else if (m.type == LIST_LINE)
+            ok = skip_bytes(s, m.u.size);
+    }
+
+    close(s);
+    return ok;
+}
+
+static void run_client(int requests, int fd)
+{
+    struct Stats st;
+    int i;
+
+    memset(&st, 0, sizeof(st));
+
+    for(i = 0; i < requests; ++i)
+    {
+        double t0, dt;
+        int res;
+        int bucket;
+
+        t0 = now_ms();
+        res = (i % 2 == 0) ? do_list() : do_ask_output();
+        dt = now_ms() - t0;
+
+        ++st.requests;
+        if (res != 0)
+            ++st.failures;
+        if (dt > st.max_ms)
+            st.max_ms = dt;
+        bucket = (int) (dt*1e3 / BUCKET_US);
+        if (bucket > NBUCKETS)
+            bucket = NBUCKETS;
+        ++st.histogram[bucket];
+    }
+
+    write(fd, &st, sizeof(st));
+    close(fd);
+}
+
+static double percentile(const struct Stats *st, double p)
+{
+    unsigned int count = 0;
+    unsigned int limit = (unsigned int) (p * st->requests);
+    int i;
+
+    for(i = 0; i <= NBUCKETS; ++i)
+    {
+        count += st->histogram[i];
+        if (count > limit)
+            return (i + 1) * BUCKET_US * 1e-3;
+    }
+    return st->max_ms;
+}
+
+static int run_ts(const char *ts, char *const args[])
+{
+    int pid, status;
+
+    pid = fork();
+    if (pid == 0)
+    {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, 1);
+        execv(ts, args);
+        _exit(127);
+    }
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "usage: %s [-c clients] [-r requests] [-j jobs] "
+            "[-w waiters] <ts executable>\n", cmd);
+    exit(-1);
+}
+
+int main(int argc, char **argv)
+{
+    int clients = 200;
+    int requests = 100;
+    int jobs = 20;
+    int waiters = 300;
+    const char *ts;
+    char tmpdir[] = "/tmp/tsbench.XXXXXX";
+    char journal_path[250];
+    int *waiter_sockets;
+    int (*pipes)[2];
+    struct Stats total;
+    struct rlimit rlim;
+    double t0, elapsed;
+    int c, i;
+
+    while ((c = getopt(argc, argv, "c:r:j:w:")) != -1)
+    {
+        switch(c)
+        {
+            case 'c': clients = atoi(optarg); break;
+            case 'r': requests = atoi(optarg); break;
+            case 'j': jobs = atoi(optarg); break;
+            case 'w': waiters = atoi(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1 || clients < 1 || jobs < 1)
+        usage(argv[0]);
+    ts = argv[optind];
+
+    /* The waiting connections need descriptors */
+    if (getrlimit(RLIMIT_NOFILE, &rlim) == 0)
+    {
+        rlim.rlim_cur = rlim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rlim);
+    }
+
+    if (mkdtemp(tmpdir) == NULL)
+    {
+        perror("mkdtemp");
+        return -1;
+    }
+    snprintf(socket_path, sizeof(socket_path), "%s/socket", tmpdir);
+    snprintf(journal_path, sizeof(journal_path), "%s/journal", tmpdir);
+    setenv("TS_SOCKET", socket_path, 1);
+    setenv("TS_JOURNAL", journal_path, 1);
+    setenv("TMPDIR", tmpdir, 1);
+    setenv("TS_SLOTS", "4", 1);
+    signal(SIGPIPE, SIG_IGN);
+
+    /* Jobs long enough to be running during the whole test */
+    for(i = 0; i < jobs; ++i)
+    {
+        char *args[] = { "ts", "sleep", "0.5", 0 };
+        if (run_ts(ts, args) != 0)
+        {
+            fprintf(stderr, "Cannot queue the jobs with %s\n", ts);
+            return -1;
+        }
+    }
+
+    /* Idle connections, as from "ts -w" */
+    waiter_sockets = (int *) malloc(waiters * sizeof(int));
+    for(i = 0; i < waiters; ++i)
+    {
+        waiter_sockets[i] = connect_server();
+        if (waiter_sockets[i] != -1)
+            send_request(waiter_sockets[i], WAITJOB, jobs - 1);
+    }
+
+    pipes = malloc(clients * sizeof(*pipes));
+    t0 = now_ms();
+    for(i = 0; i < clients; ++i)
+    {
+        pipe(pipes[i]);
+        if (fork() == 0)
+        {
+            close(pipes[i][0]);
+            run_client(requests, pipes[i][1]);
+            _exit(0);
+        }
+        close(pipes[i][1]);
+    }
+
+    memset(&total, 0, sizeof(total));
+    for(i = 0; i < clients; ++i)
+    {
+        struct Stats st;
+        int b;
+        if (recv_all(pipes[i][0], &st, sizeof(st)) != sizeof(st))
+        {
+            fprintf(stderr, "Client %i did not report\n", i);
+            continue;
+        }
+        close(pipes[i][0]);
+        total.requests += st.requests;
+        total.failures += st.failures;
+        if (st.max_ms > total.max_ms)
+            total.max_ms = st.max_ms;
+        for(b = 0; b <= NBUCKETS; ++b)
+            total.histogram[b] += st.histogram[b];
+    }
+    elapsed = now_ms() - t0;
+    while (wait(NULL) > 0)
+        ;
+
+    printf("clients %i, waiting connections %i, jobs %i\n",
+            clients, waiters, jobs);
+    printf("requests %u, failed %u, %.0f requests/s\n",
+            total.requests, total.failures, total.requests / (elapsed*1e-3));
+    printf("latency [ms]: median %.2f, p99 %.2f, max %.2f\n",
+            percentile(&total, 0.5), percentile(&total, 0.99), total.max_ms);
+
+    for(i = 0; i < waiters; ++i)
+        if (waiter_sockets[i] != -1)
+            close(waiter_sockets[i]);
+
+    {
+        char *args[] = { "ts", "-K", 0 };
+        run_ts(ts, args);
+    }
+
+    {
+        char command[300];
+        snprintf(command, sizeof(command), "rm -rf %s", tmpdir);
+        system(command);
+    }
+
+    return total.failures != 0;
+}
@@ -1,8 +1,131 @@
 #include "openfoamblockmesh_template_testcase.h"
 
 #include "base/tools.h"
+#include "openfoam/blockmesh.h"
 #include "openfoam/caseelements/numerics/meshingnumerics.h"
 
+#include "boost/regex.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include <fstream>
+#include <sstream>
+
+
+namespace
+{
+
+struct MeshStatistics
+{
+  std::map<std::string, int> counts;
+  double volume;
+  bool ok;
+};
+
+MeshStatistics checkMesh(const OpenFOAMCase& cm, const boost::filesystem::path& dir)
+{
+  std::vector<std::string> output;
+  cm.executeCommand(dir, "checkMesh", {}, &output);
+
+  MeshStatistics ms{ {}, -1., false };
+  boost::regex count_pattern("^ *(points|faces|internal faces|cells): *([0-9]+)");
+  boost::regex volume_pattern("Total volume = (\\S+)\\.\\s");
+  for (const auto& l: output)
+  {
+    boost::smatch m;
+    if (boost::regex_search(l, m, count_pattern))
+    {
+      ms.counts[m[1].str()]=boost::lexical_cast<int>(m[2].str());
+    }
+    else if (boost::regex_search(l, m, volume_pattern))
+    {
+      ms.volume=boost::lexical_cast<double>(m[1].str());
+    }
+    else if (l.find("Mesh OK.")!=std::string::npos)
+    {
+      ms.ok=true;
+    }
+  }
+  return ms;
+}
+
+
+/**
+ * converts the mesh to uncompressed ASCII format
+ */
+void convertToASCII(const OpenFOAMCase& cm, const boost::filesystem::path& dir)
+{
+  auto cdf = dir/"system"/"controlDict";
+  std::string cd;
+  {
+    std::ifstream f(cdf.c_str());
+    cd.assign( std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() );
+  }
+  cd = boost::regex_replace(cd, boost::regex("writeFormat\\s+\\w+;"), "writeFormat ascii;");
+  cd = boost::regex_replace(cd, boost::regex("writeCompression\\s+\\w+;"), "writeCompression off;");
+  {
+    std::ofstream f(cdf.c_str());
+    f << cd;
+  }
+
+  cm.executeCommand(dir, "foamFormatConvert", {"-constant"});
+}
+
+
+/**
+ * all numbers in an ASCII polyMesh file (points, faces, owner or neighbour),
+ * starting with the list size. Faces contribute their vertex count and labels.
+ */
+std::vector<double> readASCIIMeshFile(const boost::filesystem::path& file)
+{
+  std::ifstream f(file.c_str());
+  insight::assertion(f.good(), "could not read mesh file "+file.string());
+  std::string s( (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>() );
+
+  s = boost::regex_replace(s, boost::regex("//[^\\n]*|/\\*.*?\\*/"), " ");
+  auto h = s.find("FoamFile");
+  if (h!=std::string::npos)
+  {
+    s = s.substr( s.find('}', h)+1 );
+  }
+  for (char& c: s)
+  {
+    if (c=='(' || c==')') c=' ';
+  }
+
+  std::vector<double> values;
+  std::istringstream is(s);
+  double v;
+  while (is >> v)
+  {
+    values.push_back(v);
+  }
+  return values;
+}
+
+
+void compareMeshFiles(
+    const boost::filesystem::path& dir1,
+    const boost::filesystem::path& dir2,
+    const std::string& name,
+    double tol )
+{
+  auto ref = readASCIIMeshFile(dir1/"constant"/"polyMesh"/name);
+  auto gen = readASCIIMeshFile(dir2/"constant"/"polyMesh"/name);
+  insight::assertion(
+        gen.size()==ref.size(),
+        str(format("different size of mesh file %s: %d (blockMesh) vs %d (in-process)") % name % ref.size() % gen.size()) );
+  for (size_t i=0; i<ref.size(); i++)
+  {
+    insight::assertion(
+          fabs(gen[i]-ref[i]) <= tol,
+          str(format("different value at position %d of mesh file %s: %g (blockMesh) vs %g (in-process)")
+              % i % name % ref[i] % gen[i]) );
+  }
+}
+
+}
+
+
 OpenFOAM_blockMeshTemplate_Test::OpenFOAM_blockMeshTemplate_Test(const string &OFEname)
     : OpenFOAMTestCase(OFEname)
 {
@@ -14,4 +137,62 @@ void OpenFOAM_blockMeshTemplate_Test::runTest()
   CaseDirectory dir(false);
   createOnDisk(dir);
   executeCommand(dir, "blockMesh");
+
+  // mesh of the in-process generator has to be equivalent
+  CaseDirectory dir2(false);
+  createOnDisk(dir2);
+  try
+  {
+    for (auto* bm: findElements<bmd::blockMesh>())
+    {
+      bm->writePolyMesh(dir2);
+    }
+  }
+  catch (const insight::UnsupportedFeature& e)
+  {
+    cout<<"In-process mesh generation not tested: "<<e.message()<<endl;
+    return;
+  }
+
+  auto ref = checkMesh(*this, dir);
+  auto gen = checkMesh(*this, dir2);
+
+  insight::assertion(ref.counts.size()==4, "could not read statistics of the blockMesh mesh");
+  insight::assertion(gen.counts==ref.counts, "different mesh sizes of blockMesh and the in-process generator");
+  insight::assertion(gen.ok==ref.ok, "mesh check of in-process generated mesh gives different result");
+  insight::assertion(
+        fabs(gen.volume-ref.volume) < 1e-4*fabs(ref.volume),
+        str(format("different mesh volume: %g (blockMesh) vs %g (in-process)") % ref.volume % gen.volume) );
+
+  OFDictData::dict refBoundary, genBoundary;
+  parseBoundaryDict(dir, refBoundary);
+  parseBoundaryDict(dir2, genBoundary);
+  insight::assertion(genBoundary.size()==refBoundary.size(), "different number of patches");
+  for (const auto& p: refBoundary)
+  {
+    auto gp=genBoundary.find(p.first);
+    insight::assertion(gp!=genBoundary.end(), "patch "+p.first+" missing in mesh of in-process generator");
+    const auto& rd=refBoundary.subDict(p.first);
+    const auto& gd=genBoundary.subDict(p.first);
+    insight::assertion(
+          gd.getInt("nFaces")==rd.getInt("nFaces") && gd.getInt("startFace")==rd.getInt("startFace"),
+          "different size or location of patch "+p.first );
+    insight::assertion(gd.getString("type")==rd.getString("type"), "different type of patch "+p.first);
+  }
+
+  // points, faces, owner and neighbour have to match one by one
+  convertToASCII(*this, dir);
+  convertToASCII(*this, dir2);
+
+  auto pts = readASCIIMeshFile(dir/"constant"/"polyMesh"/"points");
+  double extent=0.;
+  for (size_t i=1; i<pts.size(); i++)
+  {
+    extent=std::max(extent, fabs(pts[i]));
+  }
+  compareMeshFiles(dir, dir2, "points", 1e-5*extent);
+  for (const std::string& n: {"faces", "owner", "neighbour"})
+  {
+    compareMeshFiles(dir, dir2, n, 0.);
+  }
 }
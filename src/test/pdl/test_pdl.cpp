@@ -1,12 +1,78 @@
 #include "test_pdl.h"
 
+#include <sstream>
+#include <fstream>
+
+#include "boost/filesystem.hpp"
+
 using namespace std;
+using namespace insight;
 
 int main()
 {
-  insight::TestPDL::Parameters p_test;
+  try
+  {
+    TestPDL::Parameters p_test;
+
+    cout << p_test.L << endl;
+
+    // comparison and hashing
+    TestPDL::Parameters p2;
+    insight::assertion(p_test==p2, "default parameters differ");
+    insight::assertion(p_test.hash()==p2.hash(), "hash of equal parameters differs");
+
+    p2.run.initialization.preRuns.resolutions[0].nax_parameter=0.5;
+    p2.run.regime=TestPDL::Parameters::run_type::regime_steady_type(100);
+    insight::assertion(p_test!=p2, "modified parameters not detected");
+    insight::assertion(p_test.hash()!=p2.hash(), "hash of modified parameters unchanged");
+
+    // binary round trip
+    std::stringstream buf;
+    p2.writeBinary(buf);
+
+    TestPDL::Parameters p3;
+    p3.readBinary(buf);
+    insight::assertion(p3==p2, "parameters changed by binary round trip");
+    insight::assertion(p3.hash()==p2.hash(), "hash changed by binary round trip");
+    insight::assertion(
+          boost::get<TestPDL::Parameters::run_type::regime_steady_type>(p3.run.regime).iter==100,
+          "selection not restored" );
+
+    // truncated data
+    std::string data=buf.str();
+    std::istringstream truncated(data.substr(0, data.size()/2));
+    bool thrown=false;
+    try { p3.readBinary(truncated); } catch (const insight::Exception&) { thrown=true; }
+    insight::assertion(thrown, "truncated binary data not detected");
+
+    // unpacked files: relative paths are resolved against the base directory
+    {
+      auto dir = boost::filesystem::temp_directory_path()
+          / boost::filesystem::unique_path("test_pdl_%%%%-%%%%");
+      boost::filesystem::create_directories(dir);
+      std::ofstream(( dir/"input.stl" ).string()) << "solid test\nendsolid test\n";
+
+      auto f = std::make_shared<PathParameter>(
+            boost::filesystem::path("input.stl"), std::string("file") );
+      insight::ParameterHash h1(dir);
+      h1(f);
 
-  cout << p_test.L << endl;
+      bool missing=false;
+      try
+      {
+        insight::ParameterHash h2(dir/"elsewhere");
+        h2(f);
+      }
+      catch (const insight::Exception&) { missing=true; }
+      boost::filesystem::remove_all(dir);
+      insight::assertion(missing, "missing file not detected in hash");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
 
   return 0;
 }
@@ -23,6 +23,7 @@
 
 #include "base/boost_include.h"
 #include "base/parameterset.h"
+#include "test_pdl__TestPDL__Parameters_headers.h"
 
 namespace insight {
 
@@ -0,0 +1,40 @@
+#!/bin/bash
+#
+# Measures the startup time of an executable (until its command line has
+# been evaluated) with on-demand and with eager loading of the module libraries.
+#
+# usage: startup_benchmark.sh <executable> [<repetitions>]
+#
+
+EXE=$1
+N=${2:-10}
+
+if [ -z "$EXE" ]; then
+  echo "usage: $0 <executable> [<repetitions>]"
+  exit 1
+fi
+
+# mean wall clock time in milliseconds of N runs of "$EXE --help"
+measure()
+{
+  local total=0
+  for ((i=0; i<N; i++)); do
+    local t0=$(date +%s%N)
+    if ! "$EXE" --help >/dev/null 2>&1; then
+      echo "$EXE --help failed!" >&2
+      exit 1
+    fi
+    local t1=$(date +%s%N)
+    total=$(( total + (t1-t0)/1000 ))
+  done
+  echo $(( total/N/1000 ))
+}
+
+lazy=$(INSIGHT_MODULE_LOADING= measure) || exit 1
+eager=$(INSIGHT_MODULE_LOADING=eager measure) || exit 1
+none=$(INSIGHT_MODULE_LOADING=none measure) || exit 1
+
+echo "startup time of $(basename $EXE), mean of $N runs:"
+echo "  modules on demand: ${lazy} ms"
+echo "  all modules eager: ${eager} ms"
+echo "  without modules:   ${none} ms"
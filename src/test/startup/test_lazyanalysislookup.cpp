@@ -0,0 +1,57 @@
+#include "base/exception.h"
+#include "base/analysis.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+using namespace std;
+using namespace insight;
+
+// Looks up all analyses from several threads at once.
+// With on-demand module loading, the first lookups load the module libraries concurrently
+// and every lookup has to return a working factory.
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    std::vector<std::string> keys = Analysis::factoryToC();
+    cout<<keys.size()<<" analyses registered"<<endl;
+
+    std::mutex outmx;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (size_t t=0; t<4; t++)
+    {
+      threads.emplace_back([&,t]()
+      {
+        for (size_t k=0; k<keys.size(); k++)
+        {
+          const std::string& key = keys[(k+t)%keys.size()];
+          try
+          {
+            ParameterSet ps = Analysis::defaultParameters(key);
+            AnalysisPtr a( Analysis::lookup(key, ps, "") );
+            insight::assertion(bool(a), "factory returned no analysis");
+            insight::assertion(a->type()==key, "factory created an analysis of type \""+a->type()+"\"");
+          }
+          catch (const std::exception& e)
+          {
+            std::lock_guard<std::mutex> lock(outmx);
+            cerr<<"lookup of analysis \""<<key<<"\" failed: "<<e.what()<<endl;
+            failures++;
+          }
+        }
+      });
+    }
+    for (auto& t: threads) t.join();
+
+    insight::assertion(failures==0, "some lookups failed");
+  }
+  catch (const std::exception& e)
+  {
+    cerr<<e.what()<<endl;
+    return -1;
+  }
+  return 0;
+}
@@ -20,6 +20,7 @@
 
 #include "base/analysis.h"
 #include "base/parameterstudy.h"
+#include "simple_analysis__SimpleAnalysis__Parameters_headers.h"
 
 namespace insight
 {
@@ -0,0 +1,86 @@
+
+#include "base/exception.h"
+
+#include "boost/format.hpp"
+
+#include <chrono>
+
+using namespace std;
+using namespace insight;
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    // deferred description is rendered, when an exception is thrown
+    {
+      int i=42;
+      std::string what;
+      try
+      {
+        CurrentExceptionContext ex(
+              [&]() { return str(boost::format("processing item %d")%i); },
+              false );
+        throw insight::Exception("test error", false);
+      }
+      catch (const insight::Exception& e)
+      {
+        what=e.what();
+      }
+      cout<<what<<endl;
+      insight::assertion(
+            what.find("while processing item 42")!=std::string::npos,
+            "deferred exception context was not rendered into message" );
+    }
+
+    // micro-benchmark: cost per scope without exception.
+    // Best of several rounds, to be robust against load on the test machine.
+    const int n=200000, nRounds=5;
+    double sum=0.;
+    double te=1e100, td=1e100;
+
+    for (int r=0; r<nRounds; r++)
+    {
+      auto t0=std::chrono::steady_clock::now();
+      for (int i=0; i<n; i++)
+      {
+        CurrentExceptionContext ex(
+              str(boost::format("reading line %d of file %s")%i%"some/file/name.dat"),
+              false );
+        sum+=i;
+      }
+
+      auto t1=std::chrono::steady_clock::now();
+      for (int i=0; i<n; i++)
+      {
+        CurrentExceptionContext ex(
+              [&]() { return str(boost::format("reading line %d of file %s")%i%"some/file/name.dat"); },
+              false );
+        sum+=i;
+      }
+      auto t2=std::chrono::steady_clock::now();
+
+      te=std::min(te, std::chrono::duration<double, std::nano>(t1-t0).count()/double(n));
+      td=std::min(td, std::chrono::duration<double, std::nano>(t2-t1).count()/double(n));
+    }
+
+    cout<<"eager context:    "<<te<<" ns/scope"<<endl;
+    cout<<"deferred context: "<<td<<" ns/scope"<<endl;
+    cout<<"(checksum "<<sum<<")"<<endl;
+
+    // the deferred scope must not format anything
+    const double maxCostRatio=0.25;
+    insight::assertion(
+          td <= maxCostRatio*te,
+          str(boost::format("deferred exception context costs %g ns per scope, "
+                            "which is more than %g times the cost of the eager one (%g ns)")
+              % td % maxCostRatio % te) );
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
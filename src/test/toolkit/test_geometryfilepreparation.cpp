@@ -0,0 +1,85 @@
+#include "base/exception.h"
+#include "base/linearalgebra.h"
+#include "base/trisurface.h"
+#include "openfoam/ofes.h"
+#include "openfoam/openfoamcase.h"
+#include "openfoam/geometryfilepreparation.h"
+
+#include <fstream>
+
+using namespace std;
+using namespace insight;
+namespace bf = boost::filesystem;
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    bf::path dir = bf::unique_path(bf::temp_directory_path()/"test_geometryfilepreparation-%%%%%%");
+    bf::create_directories(dir);
+
+    {
+      std::ofstream f( (dir/"single.stl").c_str() );
+      f << "solid mySolid\n"
+           "facet normal 0.57735 0.57735 0.57735\n"
+           " outer loop\n"
+           "  vertex 1 0 0\n"
+           "  vertex 0 1 0\n"
+           "  vertex 0 0 1\n"
+           " endloop\n"
+           "endfacet\n"
+           "endsolid mySolid\n";
+    }
+    {
+      std::ofstream f( (dir/"two.stl").c_str() );
+      f << "solid first\n"
+           "facet normal 0 0 1\n outer loop\n  vertex 0 0 0\n  vertex 1 0 0\n  vertex 0 1 0\n endloop\nendfacet\n"
+           "endsolid first\n"
+           "solid second\n"
+           "facet normal 0 0 -1\n outer loop\n  vertex 0 0 0\n  vertex 0 1 0\n  vertex 1 0 0\n endloop\nendfacet\n"
+           "endsolid second\n";
+    }
+
+    GeometryFilePreparation gp;
+    GeometryFilePreparation::Transformation tr(vec3(2,3,4), vec3(1,2,3), vec3(90,0,90));
+    gp.addSurface(dir/"single.stl", dir/"out"/"single_t.stl", tr);
+    gp.addSurface(dir/"two.stl", dir/"out"/"two_t.stl", GeometryFilePreparation::Transformation());
+
+    OpenFOAMCase ofc(OFEs::getCurrentOrPreferred());
+    gp.run(ofc, dir);
+
+    {
+      TriSurface s=TriSurface::readSTL(dir/"out"/"single_t.stl");
+      insight::assertion(s.points().size()==3, "unexpected number of points");
+
+      // (1 0 0) translated: (2 2 3),
+      // yaw 90deg about Z: (-2 2 3), roll 90deg about X: (-2 -3 2),
+      // scaled: (-4 -9 8)
+      const TriSurface::Point& p=s.points()[0];
+      double err=fabs(p[0]+4.)+fabs(p[1]+9.)+fabs(p[2]-8.);
+      cout<<"transformed point: "<<p[0]<<" "<<p[1]<<" "<<p[2]<<endl;
+      insight::assertion(err<1e-10, "transformed point is wrong");
+
+      insight::assertion(
+            s.regionNames()==std::vector<std::string>({"mySolid"}),
+            "the name of a single solid was not preserved" );
+    }
+
+    {
+      TriSurface s=TriSurface::readSTL(dir/"out"/"two_t.stl");
+      insight::assertion(
+            s.regionNames()==std::vector<std::string>({"first", "second"}),
+            "the names of the solids were not preserved" );
+      insight::assertion(s.region(0)==0 && s.region(1)==1, "triangles were assigned to the wrong solids");
+    }
+
+    bf::remove_all(dir);
+  }
+  catch (const std::exception& e)
+  {
+    cerr<<e.what()<<endl;
+    return -1;
+  }
+
+  return 0;
+}
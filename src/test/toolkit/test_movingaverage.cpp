@@ -0,0 +1,54 @@
+
+#include "base/exception.h"
+#include "base/linearalgebra.h"
+
+using namespace std;
+using namespace insight;
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    // non-uniform time steps, linear signal: average over any window
+    // equals the value at the window center
+    arma::uword n=200000;
+    arma::mat data(n, 2);
+    double t=0.;
+    for (arma::uword i=0; i<n; i++)
+    {
+      data(i,0)=t;
+      data(i,1)=2.*t+1.;
+      t+= (i%3==0) ? 1e-3 : 3e-3;
+    }
+
+    arma::mat avg=movingAverage(data, 0.25, true, true);
+    insight::assertion(avg.n_rows>n/2, "moving average was decimated");
+    double maxerr=arma::max(arma::abs(avg.col(1)-(2.*avg.col(0)+1.)));
+    cout<<"max error (centered, linear signal) = "<<maxerr<<endl;
+    insight::assertion(maxerr<1e-6, "moving average of linear signal is inexact");
+
+    // incremental update yields identical results
+    TimeSeriesIntegrator tsi(1);
+    for (arma::uword i=0; i<n; i++)
+    {
+      tsi.append(data(i,0), data.row(i).tail_cols(1));
+    }
+    arma::mat avg2=tsi.movingAverage(0.25*(tsi.tEnd()-tsi.tStart()), true);
+    insight::assertion(avg.n_rows==avg2.n_rows, "incremental result differs in size");
+    insight::assertion(arma::max(arma::max(arma::abs(avg-avg2)))<1e-9, "incremental result differs");
+
+    // restart: samples after the new time are discarded
+    tsi.append(1., arma::mat(arma::ones(1,1)*7.));
+    insight::assertion(fabs(tsi.tEnd()-1.)<1e-12, "restart not handled");
+    double ia=arma::as_scalar(tsi.average(0., 1.));
+    cout<<"average after restart = "<<ia<<endl;
+    insight::assertion(ia>2. && ia<7., "unexpected average after restart");
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "base/exception.h"
+#include "base/tools.h"
+#include "openfoam/openfoamdict.h"
+
+#include <chrono>
+
+using namespace std;
+using namespace insight;
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    // number of cells can be given on the command line,
+    // e.g. 10000000 for timing, the default is sized for ctest
+    arma::uword n=10000;
+    if (argc>1) n=boost::lexical_cast<arma::uword>(argv[1]);
+
+    arma::mat U=arma::randu(n, 3)-0.5;
+
+    OFDictData::dictFile fd;
+    fd.className="volVectorField";
+    fd["dimensions"]="[0 1 -1 0 0 0 0]";
+    OFDictData::dict inlet;
+    inlet["type"]="fixedValue";
+    inlet["value"]="uniform (1 0 0)";
+    fd.subDict("boundaryField")["inlet"]=inlet;
+    OFDictData::dict outlet;
+    outlet["type"]="fixedValue";
+    outlet["value"]="nonuniform List<vector> 2((1 2 3) (4.5 5 6))";
+    fd.subDict("boundaryField")["outlet"]=outlet;
+
+    CaseDirectory dir(false);
+
+    struct Variant { std::string label; bool binary, compressed; };
+    for (const Variant& v: {
+         Variant{"ascii", false, false},
+         Variant{"binary", true, false},
+         Variant{"binary, compressed", true, true}
+         })
+    {
+      boost::filesystem::path fn = dir/"0"/"U";
+
+      auto t0=std::chrono::steady_clock::now();
+      writeOpenFOAMField(fn, fd, U, v.binary, v.compressed);
+      auto t1=std::chrono::steady_clock::now();
+      arma::mat U2=readOpenFOAMFieldList(fn);
+      auto t2=std::chrono::steady_clock::now();
+
+      boost::filesystem::path afn = v.compressed ? boost::filesystem::path(fn.string()+".gz") : fn;
+      cout<<v.label<<": "
+          <<"write "<<std::chrono::duration<double>(t1-t0).count()<<" s, "
+          <<"read "<<std::chrono::duration<double>(t2-t1).count()<<" s, "
+          <<"size "<<boost::filesystem::file_size(afn)/1024/1024<<" MB"<<endl;
+
+      insight::assertion(U2.n_rows==n && U2.n_cols==3, "read field has wrong size");
+      insight::assertion(arma::max(arma::max(arma::abs(U-U2)))==0., "read field differs from written field");
+
+      arma::mat bv=readOpenFOAMFieldList(fn, "value");
+      insight::assertion(bv.n_elem==3 && bv(0)==1., "uniform boundary value not read");
+
+      // the complete file, as read before modifying a field;
+      // written again, it has to remain readable
+      for (int pass=0; pass<2; ++pass)
+      {
+        OFDictData::dictFile fd2;
+        readOpenFOAMField(fn, fd2);
+        insight::assertion(fd2.className=="volVectorField", "class name not read from header");
+
+        std::istringstream ov(
+              fd2.subDict("boundaryField").subDict("outlet").getString("value") );
+        std::string kw, type;
+        ov >> kw >> type;
+        arma::mat obv=readOpenFOAMNumericList(ov, OFListTypeComponents(type));
+        insight::assertion(
+              obv.n_rows==2 && obv.n_cols==3 && obv(1,0)==4.5 && obv(1,2)==6.,
+              "nonuniform boundary value not read");
+
+        if (pass==0)
+          writeOpenFOAMField(fn, fd2, U, v.binary, v.compressed);
+      }
+
+      boost::filesystem::remove(afn);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "base/exception.h"
+#include "base/parameterset.h"
+#include "base/linearalgebra.h"
+
+using namespace std;
+using namespace insight;
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    ParameterSet ps({
+      {"L", new DoubleParameter(1., "length")},
+      {"geometry", new SubsetParameter(ParameterSet({
+         {"D", new DoubleParameter(0.1, "diameter")},
+         {"n", new IntParameter(3, "count")}
+       }), "geometry")},
+      {"model", new SelectableSubsetParameter("laminar", {
+         {"laminar", new ParameterSet()},
+         {"kOmegaSST", new ParameterSet({
+            {"Cmu", new DoubleParameter(0.09, "Cmu")}
+          })}
+       }, "turbulence model")},
+      {"points", new ArrayParameter(VectorParameter(vec3(0,0,0), "point"), 2, "points")}
+    });
+
+    // string lookup
+    insight::assertion(ps.getDouble("geometry/D")==0.1, "nested lookup failed");
+    insight::assertion(ps.getDouble("./L")==1., "lookup with \".\" failed");
+    insight::assertion(ps.getSubset("geometry").getInt("n")==3, "subset lookup failed");
+    ps.get<VectorParameter>("points/1")()(0)=2.;
+    insight::assertion(ps.getVector("points/1")(0)==2., "array lookup failed");
+
+    bool thrown=false;
+    try { ps.get<VectorParameter>("points/2"); } catch (const insight::Exception&) { thrown=true; }
+    insight::assertion(thrown, "array index out of range not detected");
+
+    // compiled paths
+    ParameterPath D("geometry/D"), Cmu("model/Cmu");
+    ps.get<DoubleParameter>(D)()=0.2;
+    insight::assertion(ps.getDouble("geometry/D")==0.2, "compiled path resolved wrong parameter");
+    insight::assertion(&ps.get<DoubleParameter>(D)==&ps.get<DoubleParameter>("geometry/D"), "compiled path differs from string lookup");
+
+    thrown=false;
+    try { ps.get<DoubleParameter>(Cmu); } catch (const insight::Exception&) { thrown=true; }
+    insight::assertion(thrown, "parameter of unselected subset was found");
+
+    // changing the selection invalidates cached paths
+    ps.get<SelectableSubsetParameter>("model").setSelection("kOmegaSST");
+    insight::assertion(ps.get<DoubleParameter>(Cmu)()==0.09, "compiled path not updated after selection change");
+
+    // a copy has its own parameters
+    ParameterSet ps2(ps);
+    insight::assertion(&ps2.get<DoubleParameter>(D)!=&ps.get<DoubleParameter>(D), "compiled path resolved into wrong set");
+    insight::assertion(!ps.isDifferent(ps2), "copy reported as different");
+
+    // flat index and value assignment
+    auto idx=ps.flatIndex();
+    insight::assertion(idx.size()==9, "unexpected number of entries in flat index");
+
+    ps2.setDouble("geometry/D", 0.3);
+    ps2.get<DoubleParameter>("model/Cmu")()=0.1;
+    insight::assertion(ps.isDifferent(ps2), "modified copy not reported as different");
+    insight::assertion(ps.assignValues(ps2), "values of equally structured set not assigned");
+    insight::assertion(ps.getDouble("geometry/D")==0.3, "value was not assigned");
+    insight::assertion(!ps.isDifferent(ps2), "sets differ after value assignment");
+
+    ps2.get<ArrayParameter>("points").appendEmpty();
+    insight::assertion(ps.isDifferent(ps2), "different array size not detected");
+    insight::assertion(!ps.assignValues(ps2), "values of differently structured set were assigned");
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include "base/taskspoolerclient.h"
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace insight;
+
+// talks to a freshly started server of the bundled task spooler,
+// so that a mismatch of the protocol definitions is detected
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  auto dir = boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path("tsp-test-%%%%-%%%%");
+  boost::filesystem::create_directories(dir);
+  auto sock = dir / "socket";
+
+  std::string tsp = "TS_SOCKET=\""+sock.string()+"\" TMPDIR=\""+dir.string()+"\" \"" TSP_EXECUTABLE "\"";
+
+  int ret=0;
+  try
+  {
+    // starts the server and queues a job
+    if (std::system((tsp+" sleep 30 >/dev/null").c_str())!=0)
+      throw std::runtime_error("could not queue job in task spooler!");
+
+    // the constructor does the VERSION handshake
+    TaskSpoolerClient tsc(sock);
+
+    TaskSpoolerInterface::JobList jl;
+    for (int i=0; i<50; ++i)
+    {
+      jl=tsc.jobs();
+      if (jl.size()==1 && jl.front().state==TaskSpoolerInterface::Running) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    if (jl.size()!=1)
+      throw std::runtime_error("expected one job in the list, got "+std::to_string(jl.size()));
+    if (jl.front().state!=TaskSpoolerInterface::Running)
+      throw std::runtime_error("the job was expected to run!");
+    if (jl.front().commandLine.find("sleep 30")==std::string::npos)
+      throw std::runtime_error("unexpected command line of job: "+jl.front().commandLine);
+
+    // the pid is known to the server only after the job has started
+    int killed=1;
+    for (int i=0; i<50 && killed!=0; ++i)
+    {
+      killed=tsc.killRunningJob();
+      if (killed!=0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (killed!=0)
+      throw std::runtime_error("could not kill the running job!");
+
+    tsc.shutdownServer();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr<<e.what()<<std::endl;
+    std::system((tsp+" -K >/dev/null 2>&1").c_str());
+    ret=-1;
+  }
+
+  boost::filesystem::remove_all(dir);
+  return ret;
+}
@@ -0,0 +1,159 @@
+#include "base/exception.h"
+#include "base/trisurfaceboolean.h"
+
+#include <cmath>
+#include <map>
+
+using namespace std;
+using namespace insight;
+
+
+TriSurface box(const TriSurface::Point& p0, const TriSurface::Point& p1)
+{
+  std::vector<TriSurface::Point> pts;
+  for (int i=0; i<8; i++)
+  {
+    pts.push_back({{ (i&1)?p1[0]:p0[0], (i&2)?p1[1]:p0[1], (i&4)?p1[2]:p0[2] }});
+  }
+  return TriSurface(pts, {
+      {{0,2,1}}, {{1,2,3}}, {{4,5,6}}, {{5,7,6}},
+      {{0,1,4}}, {{1,5,4}}, {{2,6,3}}, {{3,6,7}},
+      {{0,4,2}}, {{2,4,6}}, {{1,3,5}}, {{3,7,5}}
+    });
+}
+
+
+TriSurface sphere(const TriSurface::Point& c, double r, int nRefine)
+{
+  double t=(1.+std::sqrt(5.))/2.;
+  std::vector<TriSurface::Point> pts={
+    {{-1,t,0}}, {{1,t,0}}, {{-1,-t,0}}, {{1,-t,0}},
+    {{0,-1,t}}, {{0,1,t}}, {{0,-1,-t}}, {{0,1,-t}},
+    {{t,0,-1}}, {{t,0,1}}, {{-t,0,-1}}, {{-t,0,1}}
+  };
+  std::vector<TriSurface::Triangle> tris={
+    {{0,11,5}}, {{0,5,1}}, {{0,1,7}}, {{0,7,10}}, {{0,10,11}},
+    {{1,5,9}}, {{5,11,4}}, {{11,10,2}}, {{10,7,6}}, {{7,1,8}},
+    {{3,9,4}}, {{3,4,2}}, {{3,2,6}}, {{3,6,8}}, {{3,8,9}},
+    {{4,9,5}}, {{2,4,11}}, {{6,2,10}}, {{8,6,7}}, {{9,8,1}}
+  };
+
+  for (int l=0; l<nRefine; l++)
+  {
+    std::map<std::pair<int,int>, int> mid;
+    auto midPoint = [&](int a, int b)
+    {
+      auto k=std::make_pair(std::min(a,b), std::max(a,b));
+      auto i=mid.find(k);
+      if (i!=mid.end()) return i->second;
+      TriSurface::Point m;
+      for (int j=0; j<3; j++) m[j]=0.5*(pts[a][j]+pts[b][j]);
+      pts.push_back(m);
+      return mid[k]=pts.size()-1;
+    };
+    std::vector<TriSurface::Triangle> nt;
+    for (const auto& tr: tris)
+    {
+      int a=midPoint(tr[0],tr[1]), b=midPoint(tr[1],tr[2]), c=midPoint(tr[2],tr[0]);
+      nt.push_back({{tr[0],a,c}});
+      nt.push_back({{tr[1],b,a}});
+      nt.push_back({{tr[2],c,b}});
+      nt.push_back({{a,b,c}});
+    }
+    tris=nt;
+  }
+
+  for (auto& p: pts)
+  {
+    double l=std::sqrt(p[0]*p[0]+p[1]*p[1]+p[2]*p[2]);
+    for (int j=0; j<3; j++) p[j]=c[j]+r*p[j]/l;
+  }
+  return TriSurface(pts, tris);
+}
+
+
+double booleanVolume(const TriSurface& a, const TriSurface& b, TriSurfaceBoolean::Operation op)
+{
+  TriSurfaceBoolean bo(a, b, op);
+  insight::assertion(bo.result().isClosed(), "result of boolean operation is not closed");
+  cout<<"op "<<op<<": "<<bo.result().triangles().size()<<" triangles, "
+      <<bo.nIntersectionEdges()<<" intersection edges, "
+      <<bo.nPerturbations()<<" perturbations, volume "<<bo.result().volume()<<endl;
+  return bo.result().volume();
+}
+
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    // overlapping boxes in general position
+    {
+      TriSurface a=box({{0,0,0}}, {{1,1,1}}), b=box({{0.3,0.4,0.2}}, {{1.3,1.4,1.2}});
+      insight::assertion(std::fabs(a.volume()-1.)<1e-12, "wrong box orientation");
+      double vi=0.7*0.6*0.8;
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Union)-(2.-vi))<1e-10, "wrong union volume");
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Intersect)-vi)<1e-10, "wrong intersection volume");
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Subtract)-(1.-vi))<1e-10, "wrong difference volume");
+    }
+
+    // coplanar faces need perturbation, the result is mapped back to the original tool
+    {
+      TriSurface a=box({{0,0,0}}, {{1,1,1}}), b=box({{0.5,0,0.2}}, {{1.5,1,0.8}});
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Union)-1.3)<1e-10, "wrong union volume of boxes with coplanar faces");
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Intersect)-0.3)<1e-10, "wrong intersection volume of boxes with coplanar faces");
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Subtract)-0.7)<1e-10, "wrong difference volume of boxes with coplanar faces");
+
+      TriSurfaceBoolean bo(a, b, TriSurfaceBoolean::Union);
+      insight::assertion(bo.nPerturbations()>0, "coplanar faces were expected to need perturbation");
+      for (const auto& p: bo.result().points())
+      {
+        insight::assertion(
+              p[0]>=0. && p[0]<=1.5 && p[1]>=0. && p[1]<=1. && p[2]>=0. && p[2]<=1.,
+              "result point outside of the original boxes" );
+      }
+    }
+
+    // coincident boxes
+    {
+      TriSurface a=box({{0,0,0}}, {{1,1,1}});
+      insight::assertion(std::fabs(booleanVolume(a, a, TriSurfaceBoolean::Union)-1.)<1e-10, "wrong union volume of coincident boxes");
+      insight::assertion(std::fabs(booleanVolume(a, a, TriSurfaceBoolean::Intersect)-1.)<1e-10, "wrong intersection volume of coincident boxes");
+      TriSurfaceBoolean bo(a, a, TriSurfaceBoolean::Subtract);
+      insight::assertion(bo.result().triangles().empty(), "difference of coincident boxes not empty");
+    }
+
+    // boxes, which share a face
+    {
+      TriSurface a=box({{0,0,0}}, {{1,1,1}}), b=box({{1,0,0}}, {{2,1,1}});
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Union)-2.)<1e-10, "wrong union volume of boxes sharing a face");
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Subtract)-1.)<1e-10, "wrong difference volume of boxes sharing a face");
+      TriSurfaceBoolean bo(a, b, TriSurfaceBoolean::Intersect);
+      insight::assertion(bo.result().triangles().empty(), "intersection of boxes sharing a face not empty");
+    }
+
+    // spheres
+    {
+      TriSurface a=sphere({{0,0,0}}, 1., 3), b=sphere({{0.9,0.1,0.05}}, 0.8, 3);
+      double vu=booleanVolume(a, b, TriSurfaceBoolean::Union);
+      double vi=booleanVolume(a, b, TriSurfaceBoolean::Intersect);
+      double vs=booleanVolume(a, b, TriSurfaceBoolean::Subtract);
+      insight::assertion(std::fabs(vu+vi-a.volume()-b.volume())<1e-9, "inconsistent union and intersection volumes");
+      insight::assertion(std::fabs(vs-(a.volume()-vi))<1e-9, "inconsistent difference volume");
+    }
+
+    // disjoint surfaces
+    {
+      TriSurface a=box({{0,0,0}}, {{1,1,1}}), b=box({{2,0,0}}, {{3,1,1}});
+      insight::assertion(std::fabs(booleanVolume(a, b, TriSurfaceBoolean::Union)-2.)<1e-12, "wrong union volume of disjoint boxes");
+      insight::assertion(booleanVolume(a, b, TriSurfaceBoolean::Intersect)==0., "intersection of disjoint boxes not empty");
+    }
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,217 @@
+#include "base/exception.h"
+#include "base/vtktools.h"
+
+#include "vtkSmartPointer.h"
+#include "vtkDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkPointData.h"
+#include "vtkCellData.h"
+#include "vtkCellArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkPolyDataReader.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLPolyDataReader.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+using namespace insight;
+namespace bf = boost::filesystem;
+
+
+// a tetrahedron and its surface; the values are chosen
+// such that swapped bytes do not reproduce them
+const int np=4;
+const double x[np]={0.5, 1.25, 0.0, 0.0}, y[np]={0.0, 0.0, 2.5, 0.0}, z[np]={0.0, 0.0, 0.0, 3.75};
+const double p[np]={1.5, -2.25, 3.125, 1e5};
+const double Ux[np]={1., 2., 3., 4.}, Uy[np]={-0.5, 0.5, 7., 9.}, Uz[np]={1e-3, 2e3, -4., 0.};
+const int nf=4;
+const int tri[nf][3]={{0,2,1}, {0,1,3}, {1,2,3}, {0,3,2}};
+const double area[nf]={11., 22., 33., 44.};
+
+
+void checkValue(double v, double expected, double relTol, const std::string& what)
+{
+  insight::assertion(
+        fabs(v-expected) <= relTol*std::max(1., fabs(expected)),
+        str(boost::format("%s: expected %g, got %g") % what % expected % v) );
+}
+
+
+/**
+ * compares the data set read by VTK with the data written above.
+ * The legacy format stores single precision.
+ */
+void checkDataSet(vtkDataSet* ds, vtkIdType nCells, bool withCellData, double relTol, const std::string& label)
+{
+  cout<<label<<": "<<ds->GetNumberOfPoints()<<" points, "<<ds->GetNumberOfCells()<<" cells"<<endl;
+
+  insight::assertion(ds->GetNumberOfPoints()==np, label+": wrong number of points");
+  insight::assertion(ds->GetNumberOfCells()==nCells, label+": wrong number of cells");
+
+  auto* pa=ds->GetPointData()->GetArray("p");
+  auto* Ua=ds->GetPointData()->GetArray("U");
+  insight::assertion(pa!=nullptr && pa->GetNumberOfComponents()==1, label+": point field p missing");
+  insight::assertion(Ua!=nullptr && Ua->GetNumberOfComponents()==3, label+": point field U missing");
+
+  for (int i=0; i<np; i++)
+  {
+    double pt[3];
+    ds->GetPoint(i, pt);
+    checkValue(pt[0], x[i], relTol, label+": x");
+    checkValue(pt[1], y[i], relTol, label+": y");
+    checkValue(pt[2], z[i], relTol, label+": z");
+
+    checkValue(pa->GetTuple1(i), p[i], relTol, label+": p");
+    const double* U=Ua->GetTuple3(i);
+    checkValue(U[0], Ux[i], relTol, label+": Ux");
+    checkValue(U[1], Uy[i], relTol, label+": Uy");
+    checkValue(U[2], Uz[i], relTol, label+": Uz");
+  }
+
+  if (withCellData)
+  {
+    auto* aa=ds->GetCellData()->GetArray("area");
+    insight::assertion(aa!=nullptr, label+": cell field area missing");
+    for (int i=0; i<nf; i++)
+    {
+      checkValue(aa->GetTuple1(i), area[i], relTol, label+": area");
+    }
+  }
+}
+
+
+std::string readFile(const bf::path& fn)
+{
+  std::ifstream f(fn.c_str(), std::ios::in|std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+
+/**
+ * the binary legacy format is big endian, independent of the host
+ */
+void checkLegacyByteOrder(const bf::path& fn)
+{
+  std::string c=readFile(fn);
+  const std::string key="POINTS 4 float\n";
+  auto i=c.find(key);
+  insight::assertion(i!=std::string::npos, "POINTS section not found in "+fn.string());
+
+  float expected=float(x[0]);
+  unsigned char b[4];
+  std::memcpy(b, &expected, 4);
+  const uint16_t one=1;
+  if (*reinterpret_cast<const uint8_t*>(&one)==1)
+  {
+    std::swap(b[0], b[3]);
+    std::swap(b[1], b[2]);
+  }
+  insight::assertion(
+        std::memcmp(c.data()+i+key.size(), b, 4)==0,
+        "legacy binary data in "+fn.string()+" is not big endian" );
+}
+
+
+/**
+ * the XML appended data is in host byte order, which has to be declared in the header
+ */
+void checkXMLByteOrder(const bf::path& fn)
+{
+  std::string c=readFile(fn);
+  const uint16_t one=1;
+  std::string bo = (*reinterpret_cast<const uint8_t*>(&one)==1) ? "LittleEndian" : "BigEndian";
+  insight::assertion(
+        c.find("byte_order=\""+bo+"\"")!=std::string::npos,
+        "host byte order "+bo+" not declared in "+fn.string() );
+}
+
+
+template<class Reader>
+vtkSmartPointer<Reader> readVTK(const bf::path& fn)
+{
+  auto r=vtkSmartPointer<Reader>::New();
+  r->SetFileName(fn.c_str());
+  r->Update();
+  return r;
+}
+
+
+int main(int /*argc*/, char*/*argv*/[])
+{
+  try
+  {
+    bf::path dir = bf::unique_path(bf::temp_directory_path()/"test_vtkmodel-%%%%%%");
+    bf::create_directories(dir);
+
+    // unstructured grid
+    {
+      vtk::vtkUnstructuredGridModel m;
+      m.setPoints(np, x, y, z);
+      int c[]={0, 1, 2, 3};
+      m.appendCell(4, c, 10 /*VTK_TETRA*/);
+      m.appendPointScalarField("p", p);
+      m.appendPointVectorField("U", Ux, Uy, Uz);
+
+      m.createLegacyFile(dir/"grid.vtk", false, true);
+      checkLegacyByteOrder(dir/"grid.vtk");
+      auto lr=readVTK<vtkUnstructuredGridReader>(dir/"grid.vtk");
+      checkDataSet(lr->GetOutput(), 1, false, 1e-6, "binary legacy unstructured grid");
+
+      m.createFile(dir/"grid.vtu");
+      checkXMLByteOrder(dir/"grid.vtu");
+      auto xr=readVTK<vtkXMLUnstructuredGridReader>(dir/"grid.vtu");
+      checkDataSet(xr->GetOutput(), 1, false, 1e-12, "XML unstructured grid");
+      insight::assertion(xr->GetOutput()->GetCellType(0)==10, "XML unstructured grid: wrong cell type");
+    }
+
+    // poly data
+    {
+      vtk::vtkModel2d m;
+      m.setPoints(np, x, y, z);
+      for (int i=0; i<nf; i++)
+      {
+        m.appendPolygon(3, tri[i]);
+      }
+      m.appendPointScalarField("p", p);
+      m.appendPointVectorField("U", Ux, Uy, Uz);
+      m.appendCellScalarField("area", area);
+
+      m.createLegacyFile(dir/"surface.vtk", false, true);
+      checkLegacyByteOrder(dir/"surface.vtk");
+      auto lr=readVTK<vtkPolyDataReader>(dir/"surface.vtk");
+      checkDataSet(lr->GetOutput(), nf, true, 1e-6, "binary legacy poly data");
+
+      m.createFile(dir/"surface.vtp");
+      checkXMLByteOrder(dir/"surface.vtp");
+      auto xr=readVTK<vtkXMLPolyDataReader>(dir/"surface.vtp");
+      checkDataSet(xr->GetOutput(), nf, true, 1e-12, "XML poly data");
+
+      vtkIdType npts=-1;
+      const vtkIdType* pts=nullptr;
+      xr->GetOutput()->GetPolys()->InitTraversal();
+      for (int i=0; i<nf; i++)
+      {
+        xr->GetOutput()->GetPolys()->GetNextCell(npts, pts);
+        insight::assertion(
+              npts==3 && pts[0]==tri[i][0] && pts[1]==tri[i][1] && pts[2]==tri[i][2],
+              "XML poly data: wrong polygon connectivity" );
+      }
+    }
+
+    bf::remove_all(dir);
+  }
+  catch (const std::exception& e)
+  {
+    printException(e);
+    return -1;
+  }
+
+  return 0;
+}
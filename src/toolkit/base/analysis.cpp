@@ -26,9 +26,11 @@
 #include <fstream>
 #include <cstdlib>
 #include <dlfcn.h>
+#include <link.h>
 
 #include "base/boost_include.h"
 #include "boost/function.hpp"
+#include "boost/bind.hpp"
 #include "boost/thread.hpp"
 
 #include "base/progressdisplayer/prefixedprogressdisplayer.h"
@@ -44,20 +46,72 @@ namespace insight
   
 defineType ( Analysis );
 
-defineFactoryTable 
-( 
-  Analysis,
-  LIST(
-      const ParameterSet& ps,
-      const boost::filesystem::path& exePath
-  ),
-  LIST(ps, exePath)
-);
+// The tables of Analysis are modified, when a module library is loaded on first use
+// (see AnalysisLibraryLoader). Unlike the other factory tables, the lookups are therefore
+// done under AnalysisLibraryLoader::tableMutex(). The looked up function is called without the lock.
 
-defineStaticFunctionTable(Analysis, defaultParameters, ParameterSet);
-defineStaticFunctionTable(Analysis, category, std::string);
-defineStaticFunctionTable(Analysis, validator, ParameterSet_ValidatorPtr);
-defineStaticFunctionTable(Analysis, visualizer, ParameterSet_VisualizerPtr);
+namespace
+{
+
+template<class Table>
+typename Table::mapped_type lockedTableLookup(Table* table, const std::string& key, const std::string& what)
+{
+  boost::recursive_mutex::scoped_lock lock(AnalysisLibraryLoader::tableMutex());
+  if (!table)
+    throw insight::Exception("Table of "+what+" of type \"Analysis\" is empty!");
+  auto i = table->find(key);
+  if (i==table->end())
+    throw insight::Exception("Could not lookup \""+key+"\" in table of "+what+" of type \"Analysis\"");
+  return i->second;
+}
+
+}
+
+Analysis::Factory::~Factory() {}
+
+Analysis* Analysis::lookup(const std::string& key, const ParameterSet& ps, const boost::filesystem::path& exePath)
+{
+  Factory* f = lockedTableLookup(factories_, key, "factories");
+  return (*f)(ps, exePath);
+}
+
+std::vector<std::string> Analysis::factoryToC()
+{
+  boost::recursive_mutex::scoped_lock lock(AnalysisLibraryLoader::tableMutex());
+  std::vector<std::string> toc;
+  if (factories_)
+  {
+    for (const FactoryTable::value_type& e: *factories_)
+    { toc.push_back(e.first); }
+  }
+  return toc;
+}
+
+Analysis::FactoryTable* Analysis::factories_=nullptr;
+
+ParameterSet Analysis::defaultParameters(const std::string& key)
+{
+  return lockedTableLookup(defaultParametersFunctions_, key, "static function \"defaultParameters\"")();
+}
+Analysis::defaultParametersFunctionTable* Analysis::defaultParametersFunctions_ =nullptr;
+
+std::string Analysis::category(const std::string& key)
+{
+  return lockedTableLookup(categoryFunctions_, key, "static function \"category\"")();
+}
+Analysis::categoryFunctionTable* Analysis::categoryFunctions_ =nullptr;
+
+ParameterSet_ValidatorPtr Analysis::validator(const std::string& key)
+{
+  return lockedTableLookup(validatorFunctions_, key, "static function \"validator\"")();
+}
+Analysis::validatorFunctionTable* Analysis::validatorFunctions_ =nullptr;
+
+ParameterSet_VisualizerPtr Analysis::visualizer(const std::string& key)
+{
+  return lockedTableLookup(visualizerFunctions_, key, "static function \"visualizer\"")();
+}
+Analysis::visualizerFunctionTable* Analysis::visualizerFunctions_ =nullptr;
 
 
 std::string Analysis::category()
@@ -374,8 +428,124 @@ void SynchronisedAnalysisQueue::cancelAll()
 // ======== AnalysisLibraryLoader
 
 
+/**
+ * a module library, which is loaded on first use of one of its analyses.
+ * Shared by the placeholders of all its analyses.
+ */
+struct AnalysisLibraryLoader::IndexedLibrary
+{
+    boost::filesystem::path location;
+    // both guarded by tableMutex(): the static initialization of the library modifies the factory tables.
+    // Concurrent first uses (e.g. by the job server workers) wait for the one, which loads it.
+    bool tried = false, ok = false;
+
+    IndexedLibrary(const boost::filesystem::path& loc)
+    : location(loc)
+    {}
+};
+
+
+/**
+ * placeholder for an analysis from a module library, which has not been loaded yet.
+ * The static initialization of the library replaces it in the factory tables.
+ */
+class AnalysisLibraryLoader::IndexedAnalysisFactory
+    : public Analysis::Factory
+{
+    AnalysisLibraryLoader& loader_;
+    std::shared_ptr<IndexedLibrary> library_;
+    const std::string key_, category_;
+
+    /**
+     * loads the library, if not tried yet, and checks, that it replaced this placeholder.
+     * Has to be called with tableMutex() locked.
+     */
+    void load() const
+    {
+        if ( !library_->tried )
+        {
+            library_->tried = true;
+            library_->ok = loader_.addLibrary(library_->location);
+        }
+
+        if ( !library_->ok )
+        {
+            throw insight::Exception("Could not load module library "+library_->location.string()+" for analysis \""+key_+"\"!");
+        }
+
+        auto i = Analysis::factories_->find(key_);
+        if ( i==Analysis::factories_->end() || i->second==this )
+        {
+            throw insight::Exception(
+                  "Analysis \""+key_+"\" was not defined by module library "+library_->location.string()+". "
+                  "The module index seems to be outdated." );
+        }
+    }
+
+public:
+    boost::function<ParameterSet(void)> defaultParametersWrapper_;
+    boost::function<std::string(void)> categoryWrapper_;
+
+    IndexedAnalysisFactory(
+            AnalysisLibraryLoader& loader,
+            std::shared_ptr<IndexedLibrary> library,
+            const std::string& key,
+            const std::string& category )
+    : loader_(loader),
+      library_(library),
+      key_(key),
+      category_(category),
+      defaultParametersWrapper_(boost::bind(&IndexedAnalysisFactory::defaultParameters, this)),
+      categoryWrapper_(boost::bind(&IndexedAnalysisFactory::category, this))
+    {}
+
+    Analysis* operator()
+    (
+        const ParameterSet& ps,
+        const boost::filesystem::path& exePath
+    ) const override
+    {
+        Analysis::Factory* f;
+        {
+            boost::recursive_mutex::scoped_lock lock(tableMutex());
+            load();
+            f = Analysis::factories_->at(key_);
+        }
+        return (*f)(ps, exePath);
+    }
+
+    ParameterSet defaultParameters() const
+    {
+        Analysis::defaultParametersPtr f;
+        {
+            boost::recursive_mutex::scoped_lock lock(tableMutex());
+            load();
+            f = Analysis::defaultParametersFunctions_->at(key_);
+        }
+        return f();
+    }
+
+    // available without loading the library
+    std::string category() const
+    {
+        return category_;
+    }
+};
+
+
+
+
 AnalysisLibraryLoader::AnalysisLibraryLoader()
 {
+    std::string mode;
+    if ( const char* m = getenv("INSIGHT_MODULE_LOADING") )
+    {
+        mode = m;
+    }
+    if ( mode=="none" )
+    {
+        return;
+    }
 
     SharedPathList paths;
     for ( const path& p: paths )
@@ -404,7 +574,13 @@ AnalysisLibraryLoader::AnalysisLibraryLoader()
 
                             if ( type=="library" )
                             {
-                                addLibrary(location);
+                                path index = itr->path();
+                                index.replace_extension(".index");
+
+                                if ( mode=="eager" || !exists(index) || !addIndexedLibrary(location, index) )
+                                {
+                                    addLibrary(location);
+                                }
                             }
                         }
                     }
@@ -426,15 +602,122 @@ AnalysisLibraryLoader::~AnalysisLibraryLoader()
 //    }
 }
 
-void AnalysisLibraryLoader::addLibrary(const boost::filesystem::path& location)
+bool AnalysisLibraryLoader::addIndexedLibrary(const path& location, const path& indexFile)
+{
+    std::ifstream f ( indexFile.c_str() );
+    if ( !f.good() )
+    {
+        return false;
+    }
+
+    // lines: analysis <tab> type name <tab> category
+    std::vector<std::vector<std::string> > entries;
+    std::string line;
+    while ( std::getline(f, line) )
+    {
+        if ( line.empty() || line[0]=='#' ) continue;
+
+        std::vector<std::string> fields;
+        boost::split(fields, line, boost::is_any_of("\t"));
+        if ( fields.size()!=3 || fields[0]!="analysis" )
+        {
+            std::cerr<<"Invalid line in module index "<<indexFile<<": "<<line<<std::endl;
+            return false;
+        }
+        entries.push_back(fields);
+    }
+
+    boost::recursive_mutex::scoped_lock lock(tableMutex());
+
+    if (!Analysis::factories_)
+     { Analysis::factories_=new Analysis::FactoryTable(); }
+    if (!Analysis::defaultParametersFunctions_)
+     { Analysis::defaultParametersFunctions_ = new Analysis::defaultParametersFunctionTable(); }
+    if (!Analysis::categoryFunctions_)
+     { Analysis::categoryFunctions_ = new Analysis::categoryFunctionTable(); }
+
+    auto library = std::make_shared<IndexedLibrary>(location);
+
+    for ( const auto& e: entries )
+    {
+        const std::string& key = e[1];
+
+        if ( Analysis::factories_->find(key) != Analysis::factories_->end() )
+        {
+            continue; // already loaded
+        }
+
+        auto fac = std::make_shared<IndexedAnalysisFactory>(*this, library, key, e[2]);
+        (*Analysis::factories_)[key]=fac.get();
+        (*Analysis::defaultParametersFunctions_)[key] = fac->defaultParametersWrapper_;
+        (*Analysis::categoryFunctions_)[key] = fac->categoryWrapper_;
+        indexedAnalyses_.push_back(fac);
+    }
+
+    return true;
+}
+
+boost::recursive_mutex& AnalysisLibraryLoader::tableMutex()
+{
+    static boost::recursive_mutex mx;
+    return mx;
+}
+
+bool AnalysisLibraryLoader::addLibrary(const boost::filesystem::path& location)
 {
+    boost::recursive_mutex::scoped_lock lock(tableMutex());
+
     void *handle = dlopen ( location.c_str(), RTLD_LAZY|RTLD_GLOBAL|RTLD_NODELETE );
     if ( !handle ) 
     {
         std::cerr<<"Could not load module library "<<location<<"!\nReason: " << dlerror() << std::endl;
+        return false;
     } else 
     {
         handles_.push_back ( handle );
+        return true;
+    }
+}
+
+void AnalysisLibraryLoader::writeIndex(const path& location, const path& indexFile)
+{
+    void *handle = dlopen ( location.c_str(), RTLD_NOW|RTLD_GLOBAL|RTLD_NODELETE );
+    if ( !handle )
+    {
+        throw insight::Exception("Could not load module library "+location.string()+"!\nReason: "+dlerror());
+    }
+
+    struct link_map *lm;
+    if ( dlinfo(handle, RTLD_DI_LINKMAP, &lm)!=0 )
+    {
+        throw insight::Exception("Could not get the file name of module library "+location.string());
+    }
+    std::string libFileName(lm->l_name);
+
+    std::ofstream f ( indexFile.c_str() );
+    f << "# analyses in module library " << location.filename().string() << "\n";
+
+    if ( Analysis::factories_ )
+    {
+        for ( const auto& fe: *Analysis::factories_ )
+        {
+            // the vtable of the factory is emitted into the library, which defines the analysis.
+            // Analyses of other libraries, which are loaded as dependencies, are skipped.
+            Dl_info info;
+            if (
+                 dladdr( *reinterpret_cast<void* const*>(fe.second), &info )
+                 && info.dli_fname
+                 && libFileName==info.dli_fname
+                )
+            {
+                f << "analysis\t" << fe.first << "\t" << Analysis::category(fe.first) << "\n";
+            }
+        }
+    }
+
+    if ( !f.good() )
+    {
+        throw insight::Exception("Could not write module index "+indexFile.string());
     }
 }
 
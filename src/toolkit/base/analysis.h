@@ -351,16 +351,54 @@ public:
 
 
 
+/**
+ * Loads the module libraries, which are listed in the modules.d directories.
+ *
+ * If a module comes with an index file (<module>.index next to <module>.module,
+ * written by "analyze --index-library"), its library is not loaded at startup.
+ * Placeholders for its analyses are entered into the factory tables instead
+ * and the library is loaded, when one of them is instantiated
+ * or its default parameters are requested for the first time.
+ *
+ * The environment variable INSIGHT_MODULE_LOADING set to "eager"
+ * loads all libraries at startup, "none" loads no modules at all.
+ */
 class AnalysisLibraryLoader
 {
 protected:
     std::vector<void*> handles_;
 
+    struct IndexedLibrary;
+    class IndexedAnalysisFactory;
+    std::vector<std::shared_ptr<IndexedAnalysisFactory> > indexedAnalyses_;
+
+    /**
+     * register the analyses listed in the index file.
+     * Returns false, if the index could not be read.
+     */
+    bool addIndexedLibrary(const boost::filesystem::path& lib, const boost::filesystem::path& indexFile);
+
 public:
     AnalysisLibraryLoader();
     ~AnalysisLibraryLoader();
+
+    /**
+     * process-wide lock of the factory tables of Analysis.
+     * Held while a library is loaded, since its static initialization modifies them.
+     * Recursive, because a library may load others during its initialization.
+     */
+    static boost::recursive_mutex& tableMutex();
     
-    void addLibrary(const boost::filesystem::path& lib);
+    /**
+     * loads the library immediately. Returns false, if it could not be loaded.
+     */
+    bool addLibrary(const boost::filesystem::path& lib);
+
+    /**
+     * loads the library and writes the index of the analyses,
+     * which are defined in it, to indexFile
+     */
+    static void writeIndex(const boost::filesystem::path& lib, const boost::filesystem::path& indexFile);
 };
 
 
@@ -162,19 +162,31 @@ void assertion(bool condition, const std::string& context_message)
 }
 
 
-CurrentExceptionContext::CurrentExceptionContext(const std::string& desc, bool verbose)
-: desc_(desc)
+void CurrentExceptionContext::registerContext(bool verbose)
 {
-  if (getenv("INSIGHT_VERBOSE"))
+  static const bool verboseEnv = (getenv("INSIGHT_VERBOSE")!=nullptr);
+  if (verboseEnv)
   {
     if (verbose)
     {
-      std::cout << desc << std::endl;
+      std::cout << static_cast<std::string>(*this) << std::endl;
     }
   }
   exceptionContext.push_back(this);
 }
 
+CurrentExceptionContext::CurrentExceptionContext(const std::string& desc, bool verbose)
+: desc_(desc)
+{
+  registerContext(verbose);
+}
+
+CurrentExceptionContext::CurrentExceptionContext(std::function<std::string()> descFunc, bool verbose)
+: descFunc_(std::move(descFunc))
+{
+  registerContext(verbose);
+}
+
 
 CurrentExceptionContext::~CurrentExceptionContext()
 {
@@ -186,6 +198,15 @@ CurrentExceptionContext::~CurrentExceptionContext()
     }
 }
 
+CurrentExceptionContext::operator std::string() const
+{
+  if (descFunc_)
+  {
+    return descFunc_();
+  }
+  return desc_;
+}
+
 void ExceptionContext::snapshot(std::vector<std::string>& context)
 {
   context.clear();
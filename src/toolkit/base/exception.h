@@ -27,6 +27,8 @@
 #include <vector>
 #include <armadillo>
 #include <memory>
+#include <functional>
+#include <map>
 
 namespace insight {
   
@@ -36,14 +38,28 @@ class CurrentExceptionContext
 {
   std::string desc_;
 
+  /**
+   * if set, the description is rendered from this function instead of desc_
+   */
+  std::function<std::string()> descFunc_;
+
+  void registerContext(bool verbose);
+
 public:
   CurrentExceptionContext(const std::string& desc, bool verbose=true);
+
+  /**
+   * Deferred variant: the description is only formatted,
+   * when it is actually needed, i.e. when an exception takes a snapshot
+   * of the context or verbose output is requested.
+   * Intended for hot code paths. The function may capture local variables
+   * by reference, since it is never called after the context is destroyed.
+   */
+  CurrentExceptionContext(std::function<std::string()> descFunc, bool verbose=true);
+
   ~CurrentExceptionContext();
 
-  inline operator std::string() const
-  {
-    return desc_;
-  }
+  operator std::string() const;
 
 };
 
@@ -135,7 +135,7 @@ base64_encode(
 MD5HashPtr calcBufferHash(const std::string& buffer)
 {
   insight::CurrentExceptionContext ex(
-        str(boost::format("computing MD5 hash of buffer (size %d bytes)")%buffer.size()) );
+        [&]() { return str(boost::format("computing MD5 hash of buffer (size %d bytes)")%buffer.size()); } );
 
   auto hash=std::make_shared<MD5Hash>();
 
@@ -151,7 +151,8 @@ MD5HashPtr calcBufferHash(const std::string& buffer)
 
 MD5HashPtr calcFileHash(const boost::filesystem::path& filePath)
 {
-  insight::CurrentExceptionContext ex("computing MD5 hash of file "+filePath.string());
+  insight::CurrentExceptionContext ex(
+        [&]() { return "computing MD5 hash of file "+filePath.string(); } );
 
   auto hash=std::make_shared<MD5Hash>();
 
@@ -410,6 +411,13 @@ const char *FileContainer::binaryFileContent() const
 }
 
 
+size_t FileContainer::binaryFileContentSize() const
+{
+  insight::assertion(bool(file_content_), "There is no file content in memory");
+  return file_content_->size();
+}
+
+
 
 
 //bool FileContainer::isPacked() const
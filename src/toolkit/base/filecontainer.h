@@ -135,6 +135,7 @@ public:
 
   std::istream& stream() const;
   const char* binaryFileContent() const;
+  size_t binaryFileContentSize() const;
 
 
 //  /**
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <algorithm>
 
 #include "linearalgebra.h"
 #include "boost/lexical_cast.hpp"
@@ -657,125 +658,240 @@ arma::mat nonlinearMinimizeND(const ObjectiveND& model, const arma::mat& x0, dou
     return arma::zeros(x0.n_elem)+DBL_MAX;
 }
 
-arma::mat movingAverage(const arma::mat& timeProfs, double fraction, bool first_col_is_time, bool centerwindow)
+TimeSeriesIntegrator::TimeSeriesIntegrator(arma::uword nValueCols)
+  : nCols_(nValueCols)
+{}
+
+TimeSeriesIntegrator::TimeSeriesIntegrator(const arma::mat& timeProfs)
+  : nCols_(timeProfs.n_cols>0 ? timeProfs.n_cols-1 : 0)
 {
-  std::ostringstream msg;
-  msg<<"Computing moving average for "
-       "t="<<valueList_to_string(timeProfs.col(0))<<" and "
-       "y="<<valueList_to_string(timeProfs.cols(1,timeProfs.n_cols-1))<<
-       " with fraction="<<fraction<<", first_col_is_time="<<first_col_is_time<<" and centerwindow="<<centerwindow;
-  CurrentExceptionContext ce(msg.str(), false);
+  if (timeProfs.n_rows>0)
+  {
+    const double *tc=timeProfs.colptr(0);
+    if (std::is_sorted(tc, tc+timeProfs.n_rows))
+    {
+      append(timeProfs);
+    }
+    else
+    {
+      arma::uvec idx=arma::stable_sort_index(timeProfs.col(0));
+      append(arma::mat(timeProfs.rows(idx)));
+    }
+  }
+}
 
-  if (!first_col_is_time)
-    throw insight::Exception("Internal error: moving average without time column is currently unsupported!");
+void TimeSeriesIntegrator::append(double t, const double* values)
+{
+  // restart: discard all samples at or after t
+  if (t_.size()>0 && t<t_.back())
+  {
+    arma::uword n=std::lower_bound(t_.begin(), t_.end(), t) - t_.begin();
+    t_.resize(n);
+    y_.resize(n*nCols_);
+    I_.resize(n*nCols_);
+  }
 
-  if (timeProfs.n_cols<2)
-    throw insight::Exception("movingAverage: only dataset with "
-      +lexical_cast<std::string>(timeProfs.n_cols)+" columns given. There is no data to average.");
+  arma::uword n=t_.size();
+  t_.push_back(t);
+  for (arma::uword j=0; j<nCols_; j++)
+  {
+    double y=values[j], I=0.;
+    if (n>0)
+    {
+      I = I_[(n-1)*nCols_+j]
+          + 0.5*(y_[(n-1)*nCols_+j]+y)*(t-t_[n-1]);
+    }
+    y_.push_back(y);
+    I_.push_back(I);
+  }
+}
+
+void TimeSeriesIntegrator::append(double t, const arma::mat& values)
+{
+  insight::assertion(
+        values.n_elem==nCols_,
+        str(format("expected %d values, got %d")%nCols_%values.n_elem) );
+  append(t, values.memptr());
+}
+
+void TimeSeriesIntegrator::append(const arma::mat& timeProfs)
+{
+  insight::assertion(
+        timeProfs.n_cols==nCols_+1,
+        str(format("expected %d columns (time and values), got %d")%(nCols_+1)%timeProfs.n_cols) );
 
-  const arma::uword n_raw_max=10000;
-  const arma::uword n_avg_max=1000;
+  t_.reserve(t_.size()+timeProfs.n_rows);
+  y_.reserve(y_.size()+timeProfs.n_rows*nCols_);
+  I_.reserve(I_.size()+timeProfs.n_rows*nCols_);
 
-  arma::mat data;
-  if (timeProfs.n_rows>1)
+  std::vector<double> row(nCols_);
+  for (arma::uword i=0; i<timeProfs.n_rows; i++)
   {
-    arma::uword n_raw=timeProfs.n_rows;
+    for (arma::uword j=0; j<nCols_; j++)
+      row[j]=timeProfs(i, j+1);
+    append(timeProfs(i,0), row.data());
+  }
+}
 
-    if (n_raw>n_raw_max)
-    {
-      // remove some rows to limit execution time
-      arma::uword n_il=std::max<arma::uword>(1, n_raw/n_raw_max);
-      arma::uword n_red=n_raw/n_il + (n_raw%n_il>0? 1 : 0);
+double TimeSeriesIntegrator::tStart() const
+{
+  insight::assertion(t_.size()>0, "empty time series");
+  return t_.front();
+}
 
-      data=arma::zeros( n_red, timeProfs.n_cols);
+double TimeSeriesIntegrator::tEnd() const
+{
+  insight::assertion(t_.size()>0, "empty time series");
+  return t_.back();
+}
 
-      arma::uword j=0;
-      for (arma::uword i=0; i<n_raw; i++)
-      {
-        if (i%n_il==0)
-        {
-//          if (j>data.n_rows-1) cout<<"j="<<j<<", i="<<i<<", n_raw="<<n_raw<<", n_il="<<n_il<<", n_red="<<n_red<<endl;
-          data.row(j++)=timeProfs.row(i);
-        }
-      }
+arma::mat TimeSeriesIntegrator::data() const
+{
+  arma::mat res(t_.size(), nCols_+1);
+  for (arma::uword i=0; i<t_.size(); i++)
+  {
+    res(i,0)=t_[i];
+    for (arma::uword j=0; j<nCols_; j++)
+      res(i,j+1)=y_[i*nCols_+j];
+  }
+  return res;
+}
 
-      insight::assertion( j == data.n_rows, str(format("wrong number of elements after reduction (%d <=> %d)")%j%data.n_rows) );
-//      assert( j == data.n_rows );
+arma::uword TimeSeriesIntegrator::locate(double t, arma::uword hint) const
+{
+  arma::uword k=std::min<arma::uword>(hint, t_.size()-1);
+  while (k>0 && t_[k]>t) k--;
+  while (k+1<t_.size() && t_[k+1]<=t) k++;
+  return k;
+}
+
+void TimeSeriesIntegrator::integralUntil(double t, arma::uword& hint, double* res) const
+{
+  arma::uword n=t_.size();
 
-      n_raw=data.n_rows;
+  if (n==0 || t<=t_.front())
+  {
+    std::fill(res, res+nCols_, 0.0);
+    return;
+  }
+  if (t>=t_.back())
+  {
+    std::copy(I_.end()-nCols_, I_.end(), res);
+    hint=n-1;
+    return;
+  }
+
+  arma::uword k=hint=locate(t, hint);
+  double dt=t_[k+1]-t_[k], tau=t-t_[k];
+  for (arma::uword j=0; j<nCols_; j++)
+  {
+    double y0=y_[k*nCols_+j], I0=I_[k*nCols_+j];
+    if (dt>0.)
+    {
+      double y1=y_[(k+1)*nCols_+j];
+      res[j] = I0 + tau*( y0 + 0.5*(y1-y0)*tau/dt );
     }
     else
     {
-      data=timeProfs;
+      res[j] = I0;
     }
+  }
+}
 
-    double x0=arma::min(data.col(0));
-    double dx_raw=arma::max(data.col(0))-x0;
-
-//    std::cout<<"mvg avg: range ["<<x0<<":"<<data.col(0).max()<<"]"<<std::endl;
+arma::rowvec TimeSeriesIntegrator::integral(double from, double to) const
+{
+  arma::rowvec I0(nCols_), I1(nCols_);
+  arma::uword hint=0;
+  integralUntil(from, hint, I0.memptr());
+  integralUntil(to, hint, I1.memptr());
+  return I1-I0;
+}
 
-    double window=fraction*dx_raw;
-    double avgdx=dx_raw/double( std::min<size_t>(n_raw, n_avg_max) );
+arma::rowvec TimeSeriesIntegrator::average(double from, double to) const
+{
+  insight::assertion(t_.size()>0, "empty time series");
 
-    // number of averages to compute
-    arma::uword n_avg=std::min(n_raw, std::max(arma::uword(2), arma::uword((dx_raw-window)/avgdx) ));
+  from=std::max(from, t_.front());
+  to=std::min(to, t_.back());
 
-    double window_ofs=window;
-    if (centerwindow)
+  if (to-from <= 0.)
+  {
+    // degenerate interval: interpolated value
+    arma::uword k=locate(from, 0);
+    arma::rowvec res(nCols_);
+    double dt = k+1<t_.size() ? t_[k+1]-t_[k] : 0.;
+    for (arma::uword j=0; j<nCols_; j++)
     {
-        window_ofs=window/2.0;
+      double y0=y_[k*nCols_+j];
+      res(j) = dt>0. ?
+            y0 + (y_[(k+1)*nCols_+j]-y0)*(from-t_[k])/dt
+          : y0;
     }
+    return res;
+  }
 
-    arma::mat result=zeros(n_avg, data.n_cols);
+  return integral(from, to)/(to-from);
+}
 
-//    cout<<"computing "<<n_avg<<" averages on "<<n_raw<<" raw samples."<<endl;
-    
-    for (arma::uword i=0; i<n_avg; i++)
-    {
-        double x = x0 + window_ofs + double(i)*avgdx;
+arma::mat TimeSeriesIntegrator::movingAverage(double window, bool centerwindow) const
+{
+  arma::uword n=t_.size();
 
-        double from = x - window_ofs, to = from + window;
+  if (n<2 || window<=0.)
+    return data();
 
-        arma::uword j0=0;
-        if (first_col_is_time)
-        {
-            j0=1;
-            result(i,0)=x;
-        }
-        arma::uvec indices = arma::find( (data.col(0)>=from) && (data.col(0)<=to) );
-        arma::mat selrows=data.rows( indices );
-        if (selrows.n_rows==0) // nothing selected: take the closest row
-        {
-            indices = arma::sort_index(arma::mat(pow(data.col(0) - 0.5*(from+to), 2)));
-            selrows=data.row( indices(0) );
-        }
+  double t0=t_.front(), t1=t_.back();
+  window=std::min(window, t1-t0);
+  double window_ofs = centerwindow ? 0.5*window : window;
 
-        if (selrows.n_rows==1)
-        {
-            for (arma::uword j=j0; j<data.n_cols; j++)
-            {
-               result(i, j) = arma::as_scalar(selrows.col(j));
-            }
-        }
-        else
-        {
+  // range of evaluation points, for which the window is complete
+  double xa=t0+window_ofs, xb=t1-window+window_ofs;
 
-            arma::mat xcol=selrows.col(0);
-            for (arma::uword j=j0; j<data.n_cols; j++)
-            {
-              arma::mat ccol=selrows.col(j);
-              double I=0;
-              for (arma::uword k=1; k<xcol.n_rows; k++)
-              {
-                I+=0.5*(ccol(k)+ccol(k-1))*(xcol(k)-xcol(k-1));
-              }
-              result(i, j) = I/(xcol.max()-xcol.min());
-            }
-        }
-    }
-    
-    return result;
-    
+  std::vector<double> x;
+  x.reserve(n);
+  x.push_back(xa);
+  for (arma::uword k=0; k<n; k++)
+  {
+    if ( (t_[k]>xa) && (t_[k]<xb) ) x.push_back(t_[k]);
+  }
+  if (xb>xa) x.push_back(xb);
+
+  arma::mat result(x.size(), nCols_+1);
+  std::vector<double> I0(nCols_), I1(nCols_);
+  arma::uword h0=0, h1=0;
+  for (arma::uword i=0; i<x.size(); i++)
+  {
+    double from=x[i]-window_ofs, to=from+window;
+    integralUntil(from, h0, I0.data());
+    integralUntil(to, h1, I1.data());
+
+    result(i,0)=x[i];
+    for (arma::uword j=0; j<nCols_; j++)
+      result(i,j+1) = window>0. ? (I1[j]-I0[j])/window : y_[j];
+  }
+
+  return result;
+}
+
+
+arma::mat movingAverage(const arma::mat& timeProfs, double fraction, bool first_col_is_time, bool centerwindow)
+{
+  CurrentExceptionContext ce(
+        [&]() { return str(format("Computing moving average of %d samples (%d columns) with fraction=%g, first_col_is_time=%d and centerwindow=%d")
+            % timeProfs.n_rows % timeProfs.n_cols % fraction % first_col_is_time % centerwindow); },
+        false );
+
+  if (!first_col_is_time)
+    throw insight::Exception("Internal error: moving average without time column is currently unsupported!");
+
+  if (timeProfs.n_cols<2)
+    throw insight::Exception("movingAverage: only dataset with "
+      +lexical_cast<std::string>(timeProfs.n_cols)+" columns given. There is no data to average.");
+
+  if (timeProfs.n_rows>1)
+  {
+    TimeSeriesIntegrator tsi(timeProfs);
+    return tsi.movingAverage( fraction*(tsi.tEnd()-tsi.tStart()), centerwindow );
   }
   else
   {
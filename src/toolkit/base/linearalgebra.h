@@ -23,6 +23,7 @@
 
 #include <armadillo>
 #include <map>
+#include <vector>
 
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_spline.h>
@@ -195,6 +196,84 @@ double nonlinearSolve1D(const std::function<double(double)>& model, double x_min
 double nonlinearMinimize1D(const Objective1D& model, double x_min, double x_max);
 arma::mat nonlinearMinimizeND(const ObjectiveND& model, const arma::mat& x0, double tol=1e-3, const arma::mat& steps = arma::mat());
 
+/**
+ * Holds a time series (time and an arbitrary number of value columns)
+ * together with the running trapezoidal integral of all value columns.
+ * Rows can be appended incrementally. Averages over arbitrary time intervals
+ * are then exact (w.r.t. linear interpolation between samples) and cost
+ * O(1) per query with monotonic lookup, the moving average over the whole
+ * series O(n). Non-uniform time steps are supported.
+ */
+class TimeSeriesIntegrator
+{
+  arma::uword nCols_;
+
+  // row-major storage of samples and cumulative integrals
+  std::vector<double> t_, y_, I_;
+
+  /**
+   * find index k with t_[k] <= t < t_[k+1], starting the search from hint
+   */
+  arma::uword locate(double t, arma::uword hint) const;
+
+  /**
+   * cumulative integral from start until t, stored into res (nCols_ values)
+   * hint is updated for subsequent monotonic queries
+   */
+  void integralUntil(double t, arma::uword& hint, double* res) const;
+
+public:
+  TimeSeriesIntegrator(arma::uword nValueCols);
+
+  /**
+   * initialize from matrix with time in first column
+   * rows need not to be sorted
+   */
+  TimeSeriesIntegrator(const arma::mat& timeProfs);
+
+  /**
+   * append a sample.
+   * If t is smaller than the last time, the series is assumed to be restarted
+   * at t and all previous samples at or after t are discarded.
+   */
+  void append(double t, const double* values);
+  void append(double t, const arma::mat& values);
+
+  /**
+   * append all rows of a matrix with time in first column
+   */
+  void append(const arma::mat& timeProfs);
+
+  inline arma::uword size() const { return t_.size(); }
+  inline arma::uword nValueCols() const { return nCols_; }
+  double tStart() const;
+  double tEnd() const;
+
+  /**
+   * returns the data with time in first column
+   */
+  arma::mat data() const;
+
+  arma::rowvec integral(double from, double to) const;
+
+  /**
+   * average of all value columns between from and to.
+   * The interval is clipped to the available time range.
+   */
+  arma::rowvec average(double from, double to) const;
+
+  /**
+   * moving average with given window length, evaluated at every sample
+   * for which the window lies completely within the time range.
+   * Returns time in first column.
+   */
+  arma::mat movingAverage(double window, bool centerwindow=false) const;
+};
+
+/**
+ * computes the moving average over a window of length fraction*(time range)
+ * All samples are considered, the result is exact and computed in O(n).
+ */
 arma::mat movingAverage(const arma::mat& timeProfs, double fraction=0.5, bool first_col_is_time=true, bool centerwindow=false);
 
 arma::mat sortedByCol(const arma::mat&m, int c);
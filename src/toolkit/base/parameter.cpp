@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include <iterator>
+#include <atomic>
 #include "boost/algorithm/string/trim.hpp"
 
 
@@ -75,6 +76,24 @@ void writeMatToXMLNode(const arma::mat& matrix, xml_document< char >& doc, xml_n
 
 
 
+namespace
+{
+std::atomic<unsigned long> structureGeneration(0);
+}
+
+unsigned long parameterStructureGeneration()
+{
+  return structureGeneration.load();
+}
+
+void parameterStructureChanged()
+{
+  ++structureGeneration;
+}
+
+
+
+
 defineType(Parameter);
 defineFactoryTable(Parameter, LIST(const std::string& desc), LIST(desc) );
 
@@ -143,6 +162,12 @@ void Parameter::reset(const Parameter& op)
   order_ = op.order_;
 }
 
+bool Parameter::isDifferent(const Parameter& p) const
+{
+  // generic comparison, overridden where the value can be compared directly
+  return type()!=p.type() || plainTextRepresentation()!=p.plainTextRepresentation();
+}
+
 
 std::string valueToString(const arma::mat& value)
 {
@@ -156,9 +181,23 @@ std::string valueToString(const arma::mat& value)
 }
 
 
+bool valuesEqual(const arma::mat& v1, const arma::mat& v2)
+{
+  if (v1.n_rows!=v2.n_rows || v1.n_cols!=v2.n_cols)
+    return false;
+  for (arma::uword i=0; i<v1.n_elem; i++)
+  {
+    if (v1(i)!=v2(i)) return false;
+  }
+  return true;
+}
+
+
 void stringToValue(const std::string& s, arma::mat& v)
 {
-  CurrentExceptionContext ex("converting string \""+s+"\" into vector", false);
+  CurrentExceptionContext ex(
+        [&]() { return "converting string \""+s+"\" into vector"; },
+        false );
 
   std::vector<std::string> cmpts;
   auto st = boost::trim_copy(s);
@@ -67,6 +67,18 @@ void writeMatToXMLNode(const arma::mat& matrix, rapidxml::xml_document< char >&
 
 
 
+/**
+ * A counter, which changes whenever parameters are replaced or removed from a set or array
+ * or the selection of a selectable subset is changed.
+ * Cached parameter lookups (see ParameterPath) are valid only as long as it does not change.
+ * Direct manipulation of the underlying containers (e.g. std::map::erase) is not tracked.
+ */
+unsigned long parameterStructureGeneration();
+void parameterStructureChanged();
+
+
+
+
 class Parameter
     : public boost::noncopyable
 {
@@ -153,6 +165,11 @@ public:
     virtual void clearPackedData();
 
     virtual void reset(const Parameter&);
+
+    /**
+     * compares the value (not the description) with another parameter
+     */
+    virtual bool isDifferent(const Parameter& p) const;
 };
 
 
@@ -176,6 +193,19 @@ std::string valueToString(const arma::mat& value);
 
 
 
+template<class V>
+bool valuesEqual(const V& v1, const V& v2)
+{
+  return v1==v2;
+}
+
+
+
+bool valuesEqual(const arma::mat& v1, const arma::mat& v2);
+
+
+
+
 template<class V>
 void stringToValue(const std::string& s, V& v)
 {
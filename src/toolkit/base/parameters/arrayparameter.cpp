@@ -125,6 +125,7 @@ void ArrayParameter::readFromNode(const std::string& name, rapidxml::xml_documen
   if (child)
   {
     value_.clear();
+    parameterStructureChanged();
     for (xml_node<> *e = child->first_node(); e; e = e->next_sibling())
     {
       std::string name(e->first_attribute("name")->value());
@@ -187,6 +188,7 @@ void ArrayParameter::reset(const Parameter& p)
     defaultValue_.reset( op->defaultValue_->clone() );
     defaultSize_ = op->defaultSize_;
     value_.clear();
+    parameterStructureChanged();
     for (const auto& v: op->value_)
       value_.push_back( ParameterPtr(v->clone()) );
   }
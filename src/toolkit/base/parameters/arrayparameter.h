@@ -64,6 +64,7 @@ public:
     inline void eraseValue ( int i )
     {
         value_.erase ( value_.begin()+i );
+        parameterStructureChanged();
     }
     inline void appendValue ( const Parameter& np )
     {
@@ -88,6 +89,7 @@ public:
     inline void clear()
     {
         value_.clear();
+        parameterStructureChanged();
     }
 
     std::string latexRepresentation() const override;
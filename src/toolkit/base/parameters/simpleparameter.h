@@ -131,6 +131,13 @@ public:
         throw insight::Exception("Tried to set a "+type()+" from a different type ("+p.type()+")!");
     }
 
+    bool isDifferent(const Parameter& p) const override
+    {
+      if (const auto* op = dynamic_cast<const SimpleParameter<T,N>*>(&p))
+        return !valuesEqual(value_, op->value_);
+      return true;
+    }
+
 };
 
 
@@ -27,9 +27,11 @@
 #include "rapidxml/rapidxml.hpp"
 #include "rapidxml/rapidxml_print.hpp"
 #include "boost/foreach.hpp"
+#include "boost/lexical_cast.hpp"
 
 #include <fstream>
 #include <numeric>
+#include <atomic>
 
 using namespace std;
 using namespace rapidxml;
@@ -39,18 +41,26 @@ namespace insight
 
 
 
+namespace
+{
+std::atomic<unsigned long> nextParameterSetId(1);
+}
+
 ParameterSet::ParameterSet()
+: instanceId_(nextParameterSetId++)
 {
 }
 
 ParameterSet::ParameterSet(const ParameterSet& o)
 //: boost::ptr_map<std::string, Parameter>(o.clone())
-: std::map<std::string, std::unique_ptr<Parameter> >()
+: std::map<std::string, std::unique_ptr<Parameter> >(),
+  instanceId_(nextParameterSetId++)
 {
   operator=(o);
 }
 
 ParameterSet::ParameterSet(const EntryList& entries)
+: instanceId_(nextParameterSetId++)
 {
   extend(entries);
 }
@@ -61,6 +71,8 @@ ParameterSet::~ParameterSet()
 
 void ParameterSet::operator=(const ParameterSet& o)
 {
+  if (!empty())
+    parameterStructureChanged();
   clear();
   std::transform(o.begin(), o.end(), std::inserter(*this, end()),
                  [](const value_type& op)
@@ -134,40 +146,252 @@ ParameterSet& ParameterSet::merge(const ParameterSet& p)
   return *this;
 }
 
-ParameterSet& ParameterSet::getSubset(const std::string& name) 
-{ 
-  if (name==".")
-    return *this;
+namespace
+{
+
+/**
+ * returns the parameter set of a subset or the currently selected set
+ * of a selectable subset, null for all other parameter types
+ */
+ParameterSet* parameterSetOf(Parameter* p)
+{
+  if (auto* sp=dynamic_cast<SubsetParameter*>(p))
+    return &(*sp)();
+  else if (auto* ssp=dynamic_cast<SelectableSubsetParameter*>(p))
+    return &(*ssp)();
   else
+    return nullptr;
+}
+
+bool isContainer(const Parameter& p)
+{
+  return
+      dynamic_cast<const SubsetParameter*>(&p)
+      || dynamic_cast<const SelectableSubsetParameter*>(&p)
+      || dynamic_cast<const ArrayParameter*>(&p);
+}
+
+void appendToFlatIndex(ParameterSet::FlatIndex& idx, const std::string& path, Parameter& p)
+{
+  idx.push_back(ParameterSet::FlatIndex::value_type(path, &p));
+
+  if (auto* ap=dynamic_cast<ArrayParameter*>(&p))
   {
-    try
+    for (int i=0; i<ap->size(); i++)
     {
-      return this->get<SubsetParameter>(name)();
+      appendToFlatIndex(idx, path+"/"+boost::lexical_cast<std::string>(i), (*ap)[i]);
     }
-    catch (...)
+  }
+  else if (auto* ps=parameterSetOf(&p))
+  {
+    for (auto& e: *ps)
     {
-      return this->get<SelectableSubsetParameter>(name)();
+      appendToFlatIndex(idx, path+"/"+e.first, *e.second);
     }
   }
 }
 
-const ParameterSet& ParameterSet::getSubset(const std::string& name) const
+/**
+ * compares keys, types and selections of two flat indices
+ */
+bool sameStructure(const ParameterSet::FlatIndex& i1, const ParameterSet::FlatIndex& i2)
 {
-  if (name==".")
-    return *this;
+  if (i1.size()!=i2.size())
+    return false;
+
+  for (size_t i=0; i<i1.size(); i++)
+  {
+    const Parameter& p1=*i1[i].second;
+    const Parameter& p2=*i2[i].second;
+
+    if ( (i1[i].first!=i2[i].first) || (p1.type()!=p2.type()) )
+      return false;
+
+    if (const auto* ssp1=dynamic_cast<const SelectableSubsetParameter*>(&p1))
+    {
+      if (ssp1->selection()!=dynamic_cast<const SelectableSubsetParameter&>(p2).selection())
+        return false;
+    }
+  }
+  return true;
+}
+
+}
+
+
+
+
+Parameter& ParameterSet::getParameter(const std::string& name)
+{
+  if (name.find('/')==std::string::npos)
+  {
+    // single level key, no need to split
+    iterator i = find ( name );
+    if ( i==end() )
+      throw insight::Exception ( "Parameter "+name+" not found in parameterset" );
+    return *(i->second);
+  }
   else
   {
-    try
+    std::vector<std::string> path;
+    boost::split(path, name, boost::is_any_of("/"));
+    return getParameter(path, name);
+  }
+}
+
+const Parameter& ParameterSet::getParameter(const std::string& name) const
+{
+  return const_cast<ParameterSet&>(*this).getParameter(name);
+}
+
+Parameter& ParameterSet::getParameter(const std::vector<std::string>& path, const std::string& name)
+{
+  Parameter* p=nullptr;
+
+  for (const auto& c: path)
+  {
+    if (c==".")
+      continue;
+
+    if (!p)
     {
-      return this->get<SubsetParameter>(name)();
+      iterator i = find ( c );
+      if ( i==end() )
+        throw insight::Exception ( "Parameter "+name+" not found in parameterset" );
+      p=i->second.get();
     }
-    catch (...)
+    else if (auto* ap=dynamic_cast<ArrayParameter*>(p))
     {
-      return this->get<SelectableSubsetParameter>(name)();
+      int i;
+      try
+      {
+        i=boost::lexical_cast<int>(c);
+      }
+      catch (const boost::bad_lexical_cast&)
+      {
+        throw insight::Exception ( "Invalid array index \""+c+"\" in parameter path "+name );
+      }
+      if ( (i<0) || (i>=ap->size()) )
+        throw insight::Exception ( "Array index "+c+" out of range in parameter path "+name );
+      p=&(*ap)[i];
     }
+    else if (auto* ps=parameterSetOf(p))
+    {
+      iterator i = ps->find ( c );
+      if ( i==ps->end() )
+        throw insight::Exception ( "Parameter "+name+" not found in parameterset" );
+      p=i->second.get();
+    }
+    else
+      throw insight::Exception ( "Parameter "+name+" not found: \""+c+"\" is not in a parameter set or array" );
+  }
+
+  if (!p)
+    throw insight::Exception ( "Parameter "+name+" not found in parameterset" );
+
+  return *p;
+}
+
+ParameterSet& ParameterSet::getSubset(const std::string& name) 
+{ 
+  if (name==".")
+    return *this;
+  else
+  {
+    if (auto* ps=parameterSetOf(&getParameter(name)))
+      return *ps;
+    else
+      throw insight::Exception ( "Parameter "+name+" not of requested type!" );
+  }
+}
+
+const ParameterSet& ParameterSet::getSubset(const std::string& name) const
+{
+  return const_cast<ParameterSet&>(*this).getSubset(name);
+}
+
+ParameterSet::FlatIndex ParameterSet::flatIndex()
+{
+  FlatIndex idx;
+  for (auto& e: *this)
+  {
+    appendToFlatIndex(idx, e.first, *e.second);
+  }
+  return idx;
+}
+
+bool ParameterSet::isDifferent(const ParameterSet& other) const
+{
+  auto i1=const_cast<ParameterSet&>(*this).flatIndex();
+  auto i2=const_cast<ParameterSet&>(other).flatIndex();
+
+  if (!sameStructure(i1, i2))
+    return true;
+
+  for (size_t i=0; i<i1.size(); i++)
+  {
+    // containers are compared by their contents, which are listed themselves
+    if (!isContainer(*i1[i].second) && i1[i].second->isDifferent(*i2[i].second))
+      return true;
   }
+  return false;
 }
 
+bool ParameterSet::assignValues(const ParameterSet& other)
+{
+  auto i1=flatIndex();
+  auto i2=const_cast<ParameterSet&>(other).flatIndex();
+
+  if (!sameStructure(i1, i2))
+    return false;
+
+  for (size_t i=0; i<i1.size(); i++)
+  {
+    Parameter& p=*i1[i].second;
+    if (!isContainer(p) && p.isDifferent(*i2[i].second))
+      p.reset(*i2[i].second);
+  }
+  return true;
+}
+
+ParameterPath::ParameterPath(const std::string& path)
+: path_(path),
+  cachedSetId_(0),
+  cachedGeneration_(0),
+  cachedParameter_(nullptr)
+{
+  boost::split(components_, path_, boost::is_any_of("/"));
+}
+
+ParameterPath::ParameterPath(const ParameterPath& o)
+: path_(o.path_),
+  components_(o.components_),
+  cachedSetId_(0),
+  cachedGeneration_(0),
+  cachedParameter_(nullptr)
+{
+}
+
+Parameter& ParameterPath::resolve(ParameterSet& ps) const
+{
+  std::lock_guard<std::mutex> lock(mx_);
+
+  unsigned long gen=parameterStructureGeneration();
+  if ( cachedParameter_ && (cachedSetId_==ps.instanceId()) && (cachedGeneration_==gen) )
+    return *cachedParameter_;
+
+  cachedParameter_=nullptr;
+  Parameter& p=ps.getParameter(components_, path_);
+
+  cachedSetId_=ps.instanceId();
+  cachedGeneration_=gen;
+  cachedParameter_=&p;
+  return p;
+}
+
+
+
+
 std::string ParameterSet::latexRepresentation() const
 {
   std::string result="";
@@ -465,9 +689,18 @@ void SelectableSubsetParameter::addItem(key_type key, const ParameterSet& ps)
     value_.insert( ItemList::value_type(key, std::unique_ptr<ParameterSet>(ps.cloneParameterSet())) );
 }
 
+void SelectableSubsetParameter::setSelection(const key_type& key)
+{
+    if (key!=selection_)
+    {
+      selection_=key;
+      parameterStructureChanged();
+    }
+}
+
 void SelectableSubsetParameter::setSelection(const key_type& key, const ParameterSet& ps)
 {
-    selection()=key;
+    setSelection(key);
     operator()().merge(ps);
 }
 
@@ -562,6 +795,7 @@ void SelectableSubsetParameter::readFromNode
     auto valuenode=child->first_attribute("value");
     insight::assertion(valuenode, "No value attribute present!");
     selection_=valuenode->value();
+    parameterStructureChanged();
     
     if (value_.find(selection_)==value_.end())
       throw insight::Exception("Invalid selection key during read of selectableSubset "+name);
@@ -601,6 +835,7 @@ void SelectableSubsetParameter::reset(const Parameter& p)
   {
     Parameter::reset(p);
     selection_= op->selection_;
+    parameterStructureChanged();
     for (const auto& v: op->value_)
     {
       std::string key(v.first);
@@ -618,7 +853,8 @@ void ParameterSet_Validator::update(const ParameterSet& ps)
 {
     errors_.clear();
     warnings_.clear();
-    ps_=ps;
+    if (!ps_.assignValues(ps))
+      ps_=ps;
 }
 
 bool ParameterSet_Validator::isValid() const
@@ -648,7 +884,8 @@ ParameterSet_Visualizer::~ParameterSet_Visualizer()
 
 void ParameterSet_Visualizer::update(const ParameterSet& ps)
 {
-    ps_=ps;
+    if (!ps_.assignValues(ps))
+      ps_=ps;
 }
 
 
@@ -39,6 +39,7 @@
 #include <map>
 #include <vector>
 #include <iostream>
+#include <mutex>
 
 class QoccViewWidget;
 class QModelTree;
@@ -52,6 +53,7 @@ namespace insight {
 
 class SubsetParameter;
 class SelectableSubsetParameter;
+class ParameterPath;
 
 
 
@@ -65,6 +67,10 @@ public:
   typedef std::shared_ptr<ParameterSet> Ptr;
   typedef boost::tuple<std::string, Parameter*> SingleEntry;
   typedef std::vector< boost::tuple<std::string, Parameter*> > EntryList;
+  typedef std::vector< std::pair<std::string, Parameter*> > FlatIndex;
+
+private:
+  unsigned long instanceId_;
 
 public:
   ParameterSet();
@@ -74,6 +80,14 @@ public:
 
   void operator=(const ParameterSet& o);
 
+  /**
+   * unique number of this set object, never reused during program run
+   */
+  inline unsigned long instanceId() const
+  {
+    return instanceId_;
+  }
+
   EntryList entries() const;
 
   /**
@@ -88,6 +102,19 @@ public:
    */
   ParameterSet& merge ( const ParameterSet& other );
 
+  /**
+   * returns the parameter at the given path ("a/b/c").
+   * Path components may be keys of (selectable) subsets, indices of arrays or ".".
+   */
+  Parameter& getParameter ( const std::string& name );
+  const Parameter& getParameter ( const std::string& name ) const;
+
+  /**
+   * same as above, with a path, which is already split into its components.
+   * name is only used in error messages.
+   */
+  Parameter& getParameter ( const std::vector<std::string>& path, const std::string& name );
+
   template<class T>
   T& get ( const std::string& name );
 
@@ -97,6 +124,33 @@ public:
       return const_cast<ParameterSet&>(*this).get<T>(name);
   }
 
+  template<class T>
+  T& get ( const ParameterPath& path );
+
+  template<class T>
+  const T& get ( const ParameterPath& path ) const
+  {
+      return const_cast<ParameterSet&>(*this).get<T>(path);
+  }
+
+  /**
+   * list of all parameters in depth-first order with their full paths.
+   * Of selectable subsets, only the parameters of the current selection are listed.
+   */
+  FlatIndex flatIndex();
+
+  /**
+   * compares all parameter values with another parameter set
+   */
+  bool isDifferent ( const ParameterSet& other ) const;
+
+  /**
+   * copies the parameter values from other without rebuilding this set.
+   * Returns false and leaves this set unchanged,
+   * if the structure of other differs (keys, types, array sizes or selections).
+   */
+  bool assignValues ( const ParameterSet& other );
+
   template<class T>
   const typename T::value_type& getOrDefault ( const std::string& name, const typename T::value_type& defaultValue ) const
   {
@@ -249,6 +303,7 @@ public:
       {
         this->find(key)->second.reset(newp);
 //        boost::ptr_map<std::string, Parameter>::replace ( this->find ( key ), newp );
+        parameterStructureChanged();
       }
   }
 
@@ -332,6 +387,18 @@ public:
   std::string latexRepresentation() const override;
   std::string plainTextRepresentation(int indent=0) const override;
 
+  using Parameter::isDifferent;
+  using ParameterSet::isDifferent;
+
+  /**
+   * compares the contained parameter values.
+   * Required to resolve the ambiguity between the two inherited variants.
+   */
+  inline bool isDifferent ( const SubsetParameter& other ) const
+  {
+    return ParameterSet::isDifferent ( static_cast<const ParameterSet&>(other) );
+  }
+
   bool isPacked() const override;
   void pack() override;
   void unpack(const boost::filesystem::path& basePath) override;
@@ -389,11 +456,6 @@ public:
    */
   SelectableSubsetParameter ( const key_type& defaultSelection, const SubsetList& defaultValue, const std::string& description,  bool isHidden=false, bool isExpert=false, bool isNecessary=false, int order=0 );
 
-  inline key_type& selection()
-  {
-    return selection_;
-  }
-  
   inline const key_type& selection() const
   {
     return selection_;
@@ -421,6 +483,10 @@ public:
     return * ( value_.find ( selection_ )->second );
   }
   
+  /**
+   * switch to the subset with the given key
+   */
+  void setSelection(const key_type& key);
   void setSelection(const key_type& key, const ParameterSet& ps);
 
   std::string latexRepresentation() const override;
@@ -449,95 +515,58 @@ template<class T>
 ParameterSet& ParameterSet::setSelectableSubset(const std::string& key, const typename T::Parameters& p)
 {
     SelectableSubsetParameter& ssp = this->get<SelectableSubsetParameter>(key);
-    ssp.selection()=p.type();
+    ssp.setSelection(p.type());
     ssp().merge(p);
     return *this;
 }
 
+/**
+ * A parameter path, which is split once and remembers the parameter,
+ * it was resolved to last time. The cached result is used for the same set
+ * (see ParameterSet::instanceId()) as long as the parameter structure
+ * (see parameterStructureGeneration()) is unchanged.
+ * Intended for repeated access to the same parameter, e.g. in parameter studies.
+ */
+class ParameterPath
+{
+  std::string path_;
+  std::vector<std::string> components_;
+
+  mutable std::mutex mx_;
+  mutable unsigned long cachedSetId_;
+  mutable unsigned long cachedGeneration_;
+  mutable Parameter* cachedParameter_;
+
+public:
+  explicit ParameterPath ( const std::string& path );
+  ParameterPath ( const ParameterPath& o );
+
+  inline const std::string& path() const
+  {
+    return path_;
+  }
+
+  Parameter& resolve ( ParameterSet& ps ) const;
+};
+
+
+template<class T>
+T& ParameterSet::get ( const ParameterPath& path )
+{
+  if ( T* pt=dynamic_cast<T*> ( &path.resolve(*this) ) )
+    return *pt;
+  else
+    throw insight::Exception ( "Parameter "+path.path()+" not of requested type!" );
+}
+
+
   template<class T>
   T& ParameterSet::get ( const std::string& name )
   {
-    using namespace boost;
-    using namespace boost::algorithm;
-    typedef T PT;
-
-    if ( boost::contains ( name, "/" ) )
-      {
-        std::string prefix = copy_range<std::string> ( *make_split_iterator ( name, first_finder ( "/" ) ) );
-        std::string remain=name;
-        erase_head ( remain, prefix.size()+1 );
-        
-        std::vector<std::string> path;
-        boost::split(path, name, boost::is_any_of("/"));
-        insight::ArrayParameter* ap=NULL;
-        if (path.size()>=2)
-        {
-            if ( this->find(path[0]) != this->end() ) 
-                ap=dynamic_cast<insight::ArrayParameter*> ( find(path[0])->second.get() );
-        }
-        
-        if (ap)
-        {
-            int i=boost::lexical_cast<int>(path[1]);
-            if (path.size()==2)
-            {
-                PT* pt=dynamic_cast<PT*> ( &ap[i] );
-                if ( pt )
-                    return ( *pt );
-                else
-                {
-                    throw insight::Exception ( "Parameter "+name+" not of requested type!" );
-                }
-            }
-            else
-            {
-                std::string key=accumulate
-                (
-                    path.begin()+2, 
-                    path.end(), 
-                    std::string(),
-                    [](std::string &ss, std::string &s)
-                    {
-                        return ss.empty() ? s : ss + "/" + s;
-                    }
-                );
-
-                if (SubsetParameter* sps=dynamic_cast<SubsetParameter*>(&(*ap)[i]))
-                {
-                    return sps->get<T> ( key );
-                }
-                else
-                if (SelectableSubsetParameter* sps=dynamic_cast<SelectableSubsetParameter*>(&(*ap)[i]))
-                {
-                    return (*sps)().get<T> ( key );
-                }
-                else
-                {
-                    throw insight::Exception ( "Array "+path[0]+" does not contain parameter sets!" );
-                }
-            }
-        }
-        else
-            return this->getSubset ( prefix ).get<T> ( remain );
-      }
+    if ( T* pt=dynamic_cast<T*> ( &getParameter(name) ) )
+      return *pt;
     else
-      {
-        iterator i = find ( name );
-        if ( i==end() )
-          {
-            throw insight::Exception ( "Parameter "+name+" not found in parameterset" );
-          }
-        else
-          {
-            PT* const pt=dynamic_cast<PT* const> ( i->second.get() );
-            if ( pt )
-              return ( *pt );
-            else
-            {
-              throw insight::Exception ( "Parameter "+name+" not of requested type!" );
-            }
-          }
-      }
+      throw insight::Exception ( "Parameter "+name+" not of requested type!" );
   }
 
 
@@ -0,0 +1,398 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "parameterstructio.h"
+
+#include "rapidxml/rapidxml.hpp"
+#include "rapidxml/rapidxml_print.hpp"
+
+#include "boost/format.hpp"
+
+#include <cstring>
+#include <sstream>
+
+using namespace std;
+
+namespace insight {
+
+
+
+
+namespace
+{
+
+const char binaryFormatMagic[]={'I', 'S', 'P', 'B'};
+const std::uint8_t binaryFormatVersion=1;
+
+void toLittleEndian(std::uint64_t v, unsigned char* b)
+{
+  for (int i=0; i<8; i++)
+  {
+    b[i]=static_cast<unsigned char>(v>>(8*i));
+  }
+}
+
+std::uint64_t fromLittleEndian(const unsigned char* b)
+{
+  std::uint64_t v=0;
+  for (int i=0; i<8; i++)
+  {
+    v|=std::uint64_t(b[i])<<(8*i);
+  }
+  return v;
+}
+
+}
+
+
+
+
+void ParameterValueWriter::writeFileState(const PathParameter&)
+{}
+
+
+void ParameterValueWriter::writeSize(size_t n)
+{
+  unsigned char b[8];
+  toLittleEndian(n, b);
+  write(b, 8);
+}
+
+
+ParameterValueWriter::~ParameterValueWriter()
+{}
+
+
+void ParameterValueWriter::operator()(bool v)
+{
+  unsigned char b = v ? 1 : 0;
+  write(&b, 1);
+}
+
+
+void ParameterValueWriter::operator()(int v)
+{
+  unsigned char b[8];
+  toLittleEndian(static_cast<std::uint64_t>(static_cast<std::int64_t>(v)), b);
+  write(b, 8);
+}
+
+
+void ParameterValueWriter::operator()(double v)
+{
+  if (v==0.) v=0.; // no distinction of -0
+
+  std::uint64_t bits;
+  static_assert(sizeof(bits)==sizeof(v), "unexpected size of double");
+  std::memcpy(&bits, &v, sizeof(v));
+
+  unsigned char b[8];
+  toLittleEndian(bits, b);
+  write(b, 8);
+}
+
+
+void ParameterValueWriter::operator()(const std::string& v)
+{
+  writeSize(v.size());
+  write(v.data(), v.size());
+}
+
+
+void ParameterValueWriter::operator()(const arma::mat& v)
+{
+  writeSize(v.n_rows);
+  writeSize(v.n_cols);
+  for (arma::uword i=0; i<v.n_elem; i++)
+  {
+    (*this)(v(i));
+  }
+}
+
+
+void ParameterValueWriter::operator()(const std::set<double>& v)
+{
+  writeSize(v.size());
+  for (double x: v)
+  {
+    (*this)(x);
+  }
+}
+
+
+void ParameterValueWriter::operator()(const std::shared_ptr<PathParameter>& v)
+{
+  if (!v)
+    throw insight::Exception("Cannot write parameter values: no file parameter object!");
+
+  (*this)(v->originalFilePath().string());
+  (*this)(v->hasFileContent());
+  if (v->hasFileContent())
+  {
+    writeSize(v->binaryFileContentSize());
+    write(v->binaryFileContent(), v->binaryFileContentSize());
+  }
+  else
+  {
+    writeFileState(*v);
+  }
+}
+
+
+void ParameterValueWriter::operator()(const ParameterSet& v)
+{
+  std::ostringstream os;
+  v.saveToStream(os, "");
+  (*this)(os.str());
+}
+
+
+
+
+ParameterHash::ParameterHash(const boost::filesystem::path& baseDirectory)
+  : hash_(14695981039346656037ULL),
+    baseDirectory_(baseDirectory)
+{}
+
+
+void ParameterHash::write(const void* data, size_t n)
+{
+  const unsigned char* b=static_cast<const unsigned char*>(data);
+  for (size_t i=0; i<n; i++)
+  {
+    hash_ ^= b[i];
+    hash_ *= 1099511628211ULL;
+  }
+}
+
+
+void ParameterHash::writeFileState(const PathParameter& p)
+{
+  boost::filesystem::path f = p.originalFilePath();
+  if (f.empty())
+    return; // no file selected
+
+  if (f.is_relative() && !baseDirectory_.empty())
+  {
+    f = baseDirectory_ / f;
+  }
+
+  if (!boost::filesystem::is_regular_file(f))
+  {
+    throw insight::Exception(
+          "Cannot compute parameter hash: file "+f.string()+" does not exist!" );
+  }
+
+  writeSize(boost::filesystem::file_size(f));
+  writeSize(boost::filesystem::last_write_time(f));
+}
+
+
+std::uint64_t ParameterHash::value() const
+{
+  return hash_;
+}
+
+
+std::string ParameterHash::hexValue() const
+{
+  return str(boost::format("%016x") % hash_);
+}
+
+
+
+
+void BinaryParameterWriter::write(const void* data, size_t n)
+{
+  os_.write(static_cast<const char*>(data), n);
+}
+
+
+BinaryParameterWriter::BinaryParameterWriter(std::ostream& os)
+  : os_(os)
+{
+  write(binaryFormatMagic, sizeof(binaryFormatMagic));
+  write(&binaryFormatVersion, 1);
+}
+
+
+
+
+void BinaryParameterReader::read(void* data, size_t n)
+{
+  is_.read(static_cast<char*>(data), n);
+  if (size_t(is_.gcount())!=n)
+    throw insight::Exception("Unexpected end of binary parameter data!");
+}
+
+
+size_t BinaryParameterReader::readSize()
+{
+  unsigned char b[8];
+  read(b, 8);
+  return fromLittleEndian(b);
+}
+
+
+BinaryParameterReader::BinaryParameterReader(std::istream& is)
+  : is_(is)
+{
+  char magic[sizeof(binaryFormatMagic)];
+  std::uint8_t version;
+  read(magic, sizeof(magic));
+  read(&version, 1);
+  if (std::memcmp(magic, binaryFormatMagic, sizeof(magic))!=0)
+    throw insight::Exception("Not a binary parameter file!");
+  if (version!=binaryFormatVersion)
+    throw insight::Exception(str(boost::format("Unsupported version %d of binary parameter data!") % int(version)));
+}
+
+
+void BinaryParameterReader::operator()(bool& v)
+{
+  unsigned char b;
+  read(&b, 1);
+  v = (b!=0);
+}
+
+
+void BinaryParameterReader::operator()(int& v)
+{
+  unsigned char b[8];
+  read(b, 8);
+  v=static_cast<int>(static_cast<std::int64_t>(fromLittleEndian(b)));
+}
+
+
+void BinaryParameterReader::operator()(double& v)
+{
+  unsigned char b[8];
+  read(b, 8);
+  std::uint64_t bits=fromLittleEndian(b);
+  std::memcpy(&v, &bits, sizeof(v));
+}
+
+
+void BinaryParameterReader::operator()(std::string& v)
+{
+  v.resize(readSize());
+  if (!v.empty())
+  {
+    read(&v[0], v.size());
+  }
+}
+
+
+void BinaryParameterReader::operator()(arma::mat& v)
+{
+  size_t r=readSize();
+  size_t c=readSize();
+  v.set_size(r, c);
+  for (arma::uword i=0; i<v.n_elem; i++)
+  {
+    (*this)(v(i));
+  }
+}
+
+
+void BinaryParameterReader::operator()(std::set<double>& v)
+{
+  v.clear();
+  size_t n=readSize();
+  for (size_t i=0; i<n; i++)
+  {
+    double x;
+    (*this)(x);
+    v.insert(x);
+  }
+}
+
+
+void BinaryParameterReader::operator()(std::shared_ptr<PathParameter>& v)
+{
+  std::string fp;
+  bool hasContent;
+  (*this)(fp);
+  (*this)(hasContent);
+
+  std::shared_ptr<std::string> content;
+  if (hasContent)
+  {
+    content.reset(new std::string);
+    (*this)(*content);
+  }
+
+  // don't modify the existing object, it might be shared with a copy of the struct
+  std::shared_ptr<PathParameter> np( v ? v->clonePathParameter() : new PathParameter("") );
+  *np = FileContainer(fp, content);
+  v=np;
+}
+
+
+void BinaryParameterReader::operator()(ParameterSet& v)
+{
+  std::string xml;
+  (*this)(xml);
+
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(&xml[0]);
+  rapidxml::xml_node<> *rootnode = doc.first_node("root");
+  if (!rootnode)
+    throw insight::Exception("Invalid parameter set in binary parameter data!");
+  v.readFromNode(doc, *rootnode, "");
+}
+
+
+
+
+bool ParameterValueEquality::operator()(const arma::mat& a, const arma::mat& b) const
+{
+  if (a.n_rows!=b.n_rows || a.n_cols!=b.n_cols) return false;
+  for (arma::uword i=0; i<a.n_elem; i++)
+  {
+    if (a(i)!=b(i)) return false;
+  }
+  return true;
+}
+
+
+bool ParameterValueEquality::operator()(const std::shared_ptr<PathParameter>& a, const std::shared_ptr<PathParameter>& b) const
+{
+  if (!a || !b) return a==b;
+  if (a->originalFilePath()!=b->originalFilePath()) return false;
+  if (a->hasFileContent()!=b->hasFileContent()) return false;
+  if (a->hasFileContent())
+  {
+    return a->binaryFileContentSize()==b->binaryFileContentSize()
+        && std::memcmp(a->binaryFileContent(), b->binaryFileContent(), a->binaryFileContentSize())==0;
+  }
+  return true;
+}
+
+
+bool ParameterValueEquality::operator()(const ParameterSet& a, const ParameterSet& b) const
+{
+  return !a.isDifferent(b);
+}
+
+
+
+
+}
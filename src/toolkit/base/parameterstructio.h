@@ -0,0 +1,377 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef INSIGHT_PARAMETERSTRUCTIO_H
+#define INSIGHT_PARAMETERSTRUCTIO_H
+
+#include "base/parameterset.h"
+
+#include "boost/variant.hpp"
+#include "boost/units/quantity.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace insight {
+
+
+
+
+/**
+ * Visits the values of a PDL-generated parameter struct and
+ * writes them in a compact, platform independent binary form
+ * (fixed width, little endian). Derived classes decide, where the bytes go.
+ *
+ * The generated structs call the visitor for each of their members
+ * in their visitValues function.
+ */
+class ParameterValueWriter
+{
+protected:
+  virtual void write(const void* data, size_t n) =0;
+
+  /**
+   * called for path parameters, whose file content is not in memory
+   */
+  virtual void writeFileState(const PathParameter& p);
+
+  void writeSize(size_t n);
+
+  struct AlternativeWriter
+      : public boost::static_visitor<>
+  {
+    ParameterValueWriter& w;
+    AlternativeWriter(ParameterValueWriter& wr) : w(wr) {}
+    template<class T> void operator()(const T& v) const { w(v); }
+  };
+
+public:
+  virtual ~ParameterValueWriter();
+
+  void operator()(bool v);
+  void operator()(int v);
+  void operator()(double v);
+  void operator()(const std::string& v);
+  void operator()(const arma::mat& v);
+  void operator()(const std::set<double>& v);
+  void operator()(const std::shared_ptr<PathParameter>& v);
+
+  /**
+   * dynamic parameter sets (parameters of dynamically selected classes)
+   * are stored in their XML representation
+   */
+  void operator()(const ParameterSet& v);
+
+  template<class T>
+  typename std::enable_if<std::is_enum<T>::value>::type
+  operator()(T v)
+  {
+    (*this)(int(v));
+  }
+
+  template<class Unit, class Y>
+  void operator()(const boost::units::quantity<Unit,Y>& v)
+  {
+    (*this)(double(v.value()));
+  }
+
+  template<class T>
+  void operator()(const std::vector<T>& v)
+  {
+    writeSize(v.size());
+    for (const auto& e: v)
+    {
+      (*this)(e);
+    }
+  }
+
+  template<class... Ts>
+  void operator()(const boost::variant<Ts...>& v)
+  {
+    (*this)(v.which());
+    boost::apply_visitor(AlternativeWriter(*this), v);
+  }
+
+  /**
+   * object of a dynamically selected class: type name and parameters
+   */
+  template<class T>
+  void operator()(const std::shared_ptr<T>& v)
+  {
+    if (!v)
+      throw insight::Exception("Cannot write parameter values: no object selected!");
+    (*this)(std::string(v->type()));
+    (*this)(v->getParameters());
+  }
+
+  /**
+   * generated parameter structs
+   */
+  template<class T>
+  typename std::enable_if<std::is_class<T>::value>::type
+  operator()(const T& v)
+  {
+    v.visitValues(*this);
+  }
+};
+
+
+
+
+/**
+ * 64 bit FNV-1a hash over the binary representation of the parameter values.
+ * It does not depend on the platform or the process and is thus usable
+ * as a persistent cache key.
+ *
+ * For external files, which are not packed, the size and modification time
+ * of the file enter the hash. Relative paths are resolved against baseDirectory
+ * (the directory of the parameter set). A missing file raises an exception.
+ * Since the modification time changes, when the files are copied or checked out
+ * elsewhere, such keys are only stable on the same machine. Pack the files
+ * to get keys, which are stable across machines.
+ */
+class ParameterHash
+    : public ParameterValueWriter
+{
+  std::uint64_t hash_;
+  boost::filesystem::path baseDirectory_;
+
+protected:
+  void write(const void* data, size_t n) override;
+  void writeFileState(const PathParameter& p) override;
+
+public:
+  ParameterHash(const boost::filesystem::path& baseDirectory = boost::filesystem::path());
+
+  using ParameterValueWriter::operator();
+
+  std::uint64_t value() const;
+
+  /**
+   * hash value as hexadecimal string, e.g. for directory names
+   */
+  std::string hexValue() const;
+};
+
+
+
+
+class BinaryParameterWriter
+    : public ParameterValueWriter
+{
+  std::ostream& os_;
+
+protected:
+  void write(const void* data, size_t n) override;
+
+public:
+  /**
+   * writes a format header
+   */
+  BinaryParameterWriter(std::ostream& os);
+
+  using ParameterValueWriter::operator();
+};
+
+
+
+
+/**
+ * Reads values, which were written by BinaryParameterWriter,
+ * into a PDL-generated parameter struct.
+ * The struct has to be of the same type as the written one.
+ */
+class BinaryParameterReader
+{
+  std::istream& is_;
+
+  void read(void* data, size_t n);
+  size_t readSize();
+
+  template<class V>
+  void readAlternative(V&, int)
+  {
+    throw insight::Exception("Invalid selection in binary parameter data!");
+  }
+
+  template<class V, class T, class... Ts>
+  void readAlternative(V& v, int which)
+  {
+    if (which==0)
+    {
+      T a;
+      (*this)(a);
+      v=a;
+    }
+    else
+    {
+      readAlternative<V, Ts...>(v, which-1);
+    }
+  }
+
+public:
+  /**
+   * checks the format header
+   */
+  BinaryParameterReader(std::istream& is);
+
+  void operator()(bool& v);
+  void operator()(int& v);
+  void operator()(double& v);
+  void operator()(std::string& v);
+  void operator()(arma::mat& v);
+  void operator()(std::set<double>& v);
+  void operator()(std::shared_ptr<PathParameter>& v);
+
+  /**
+   * reads the values into the existing parameters of v
+   */
+  void operator()(ParameterSet& v);
+
+  template<class T>
+  typename std::enable_if<std::is_enum<T>::value>::type
+  operator()(T& v)
+  {
+    int i;
+    (*this)(i);
+    v=T(i);
+  }
+
+  template<class Unit, class Y>
+  void operator()(boost::units::quantity<Unit,Y>& v)
+  {
+    double x;
+    (*this)(x);
+    v=boost::units::quantity<Unit,Y>::from_value(Y(x));
+  }
+
+  template<class T>
+  void operator()(std::vector<T>& v)
+  {
+    v.resize(readSize());
+    for (auto& e: v)
+    {
+      (*this)(e);
+    }
+  }
+
+  template<class... Ts>
+  void operator()(boost::variant<Ts...>& v)
+  {
+    int which;
+    (*this)(which);
+    readAlternative<boost::variant<Ts...>, Ts...>(v, which);
+  }
+
+  template<class T>
+  void operator()(std::shared_ptr<T>& v)
+  {
+    std::string type;
+    (*this)(type);
+    ParameterSet ps = T::defaultParameters(type);
+    (*this)(ps);
+    v.reset( T::lookup(type, ps) );
+  }
+
+  template<class T>
+  typename std::enable_if<std::is_class<T>::value>::type
+  operator()(T& v)
+  {
+    v.readValues(*this);
+  }
+};
+
+
+
+
+/**
+ * value comparison for the members of PDL-generated parameter structs
+ */
+class ParameterValueEquality
+{
+  struct AlternativeEquality
+      : public boost::static_visitor<bool>
+  {
+    template<class T, class U>
+    bool operator()(const T&, const U&) const { return false; }
+
+    template<class T>
+    bool operator()(const T& a, const T& b) const { return ParameterValueEquality()(a, b); }
+  };
+
+public:
+  bool operator()(const arma::mat& a, const arma::mat& b) const;
+  bool operator()(const std::shared_ptr<PathParameter>& a, const std::shared_ptr<PathParameter>& b) const;
+  bool operator()(const ParameterSet& a, const ParameterSet& b) const;
+
+  template<class T>
+  typename std::enable_if<!std::is_class<T>::value, bool>::type
+  operator()(T a, T b) const
+  {
+    return a==b;
+  }
+
+  template<class T>
+  bool operator()(const std::vector<T>& a, const std::vector<T>& b) const
+  {
+    if (a.size()!=b.size()) return false;
+    for (size_t i=0; i<a.size(); i++)
+    {
+      if (!(*this)(a[i], b[i])) return false;
+    }
+    return true;
+  }
+
+  template<class... Ts>
+  bool operator()(const boost::variant<Ts...>& a, const boost::variant<Ts...>& b) const
+  {
+    return boost::apply_visitor(AlternativeEquality(), a, b);
+  }
+
+  template<class T>
+  bool operator()(const std::shared_ptr<T>& a, const std::shared_ptr<T>& b) const
+  {
+    if (!a || !b) return a==b;
+    return a->type()==b->type() && (*this)(a->getParameters(), b->getParameters());
+  }
+
+  /**
+   * strings, ranges, dimensioned values and generated parameter structs
+   */
+  template<class T>
+  typename std::enable_if<std::is_class<T>::value, bool>::type
+  operator()(const T& a, const T& b) const
+  {
+    return a==b;
+  }
+};
+
+
+
+
+}
+
+#endif // INSIGHT_PARAMETERSTRUCTIO_H
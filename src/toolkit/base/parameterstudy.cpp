@@ -58,7 +58,11 @@ ParameterStudy<BaseAnalysis,var_params>::ParameterStudy
   const boost::filesystem::path& exePath
 )
   : Analysis ( name, description, ps, exePath )
-{}
+{
+  varParamPaths_.reserve(var_params.size());
+  for (const std::string& parname: var_params)
+    varParamPaths_.emplace_back(parname);
+}
 
 
 
@@ -136,7 +140,7 @@ void ParameterStudy<BaseAnalysis,var_params>::generateInstance
     for (int j=0; j<var_params.size(); j++)
     {
       // Replace RangeParameter by actual single value
-      const DoubleRangeParameter& rp = templ.get<DoubleRangeParameter>(var_params[j]);
+      const DoubleRangeParameter& rp = templ.get<DoubleRangeParameter>(varParamPaths_[j]);
       DoubleParameter* p=rp.toDoubleParameter(i[j]);
       newp->replace(var_params[j], p);
 
@@ -179,7 +183,7 @@ void ParameterStudy<BaseAnalysis,var_params>::generateInstances
   }
   else
   {
-    const DoubleRangeParameter& crp = templ.get<DoubleRangeParameter>(var_params[myIdx]);
+    const DoubleRangeParameter& crp = templ.get<DoubleRangeParameter>(varParamPaths_[myIdx]);
     for (i[myIdx] = crp.values().begin(); i[myIdx] != crp.values().end(); ++i[myIdx])
     {
         generateInstances(instances, templ, myIdx+1, i);
@@ -55,6 +55,9 @@ protected:
   SynchronisedAnalysisQueue queue_;
   boost::thread_group workers_;
 
+  // var_params, split once for the repeated lookups during instance generation
+  std::vector<ParameterPath> varParamPaths_;
+
   
 public:
 //   declareType("Parameter Study");
@@ -11,46 +11,45 @@ namespace insight
 
 ConvergenceAnalysisDisplayer::ConvergenceAnalysisDisplayer ( const std::string& progvar, double threshold )
     : progvar_ ( progvar ),
+      cumulativeSum_ ( 1, 0.0 ),
       istart_ ( 10 ),
       co_ ( 15 ),
       threshold_ ( threshold ),
       converged_ ( false )
 {}
 
+double ConvergenceAnalysisDisplayer::runningMean ( size_t i ) const
+{
+    size_t i0=i/2;
+    return ( cumulativeSum_[i]-cumulativeSum_[i0] ) / double ( i-i0 );
+}
+
 void ConvergenceAnalysisDisplayer::update ( const ProgressState& pi )
 {
     decltype ( pi.second ) ::const_iterator pv=pi.second.find ( progvar_ );
 
     if ( pv != pi.second.end() ) {
-        trackedValues_.push_back ( pv->second );
+        cumulativeSum_.push_back ( cumulativeSum_.back() + pv->second );
     }
 
-    if ( trackedValues_.size() > istart_ ) {
-        std::vector<double> ym;
-        for ( size_t i=istart_; i<trackedValues_.size(); i++ ) {
-            size_t i0=i/2;
-            double sum=0.0;
-            for ( size_t j=i0; j<i; j++ ) {
-                sum+=trackedValues_[j];
-            }
-            ym.push_back ( sum/double ( i-i0 ) );
+    size_t nTracked = cumulativeSum_.size()-1;
+
+    // only the last co_+1 running means are required
+    if ( nTracked > istart_ && ( nTracked-istart_ ) > co_ ) {
+        double maxrely=0.0;
+        for ( size_t i=nTracked-1; i>=nTracked-co_; i-- ) {
+            double ym1=runningMean ( i ), ym0=runningMean ( i-1 );
+            double rely=fabs ( ym1-ym0 ) / ( fabs ( ym1 )+1e-10 );
+            maxrely=std::max ( rely, maxrely );
         }
 
-        if ( ym.size() >co_ ) {
-            double maxrely=0.0;
-            for ( size_t j=ym.size()-1; j>=ym.size()-co_; j-- ) {
-                double rely=fabs ( ym[j]-ym[j-1] ) / ( fabs ( ym[j] )+1e-10 );
-                maxrely=std::max ( rely, maxrely );
-            }
-
-            std::cout<<"max rel. change of "<<progvar_<<" = "<<maxrely;
-
-            if ( maxrely<threshold_ ) {
-                std::cout<<" >>> CONVERGED"<<std::endl;
-                converged_=true;
-            } else {
-                std::cout<<", not converged"<<std::endl;
-            }
+        std::cout<<"max rel. change of "<<progvar_<<" = "<<maxrely;
+
+        if ( maxrely<threshold_ ) {
+            std::cout<<" >>> CONVERGED"<<std::endl;
+            converged_=true;
+        } else {
+            std::cout<<", not converged"<<std::endl;
         }
     }
 }
@@ -11,7 +11,17 @@ class ConvergenceAnalysisDisplayer
   : public ProgressDisplayer
 {
   std::string progvar_;
-  std::vector<double> trackedValues_;
+
+  /**
+   * prefix sums of the tracked values:
+   * cumulativeSum_[i] = sum of the first i tracked values
+   */
+  std::vector<double> cumulativeSum_;
+
+  /**
+   * mean of the tracked values in [i/2, i)
+   */
+  double runningMean(size_t i) const;
 
   int istart_, co_;
   double threshold_;
@@ -42,12 +42,18 @@ boost::filesystem::path RemoteLocation::socket() const
 
 
 
-void RemoteLocation::queueRemoteCommand(const std::string& command, bool waitForPreviousFinished)
+void RemoteLocation::queueRemoteCommand
+(
+    const std::string& command,
+    bool waitForPreviousFinished,
+    const TaskSpoolerInterface::JobResources& resources
+)
 {
+  std::string opts = algorithm::join(resources.options(), " ");
   if (waitForPreviousFinished)
-      execRemoteCmd("tsp -d " + command);
+      execRemoteCmd("tsp -d " + opts + " " + command);
   else
-      execRemoteCmd("tsp " + command);
+      execRemoteCmd("tsp " + opts + " " + command);
 }
 
 
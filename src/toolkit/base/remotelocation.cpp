@@ -98,7 +98,8 @@ RemoteLocation::RemoteLocation(const RemoteLocation& orec)
 RemoteLocation::RemoteLocation(const boost::filesystem::path& mf)
   : autoCreateRemoteDirRequired_(false)
 {
-  CurrentExceptionContext ce("reading configuration for remote execution in  directory "+mf.parent_path().string()+" from file "+mf.string());
+  CurrentExceptionContext ce(
+        [&]() { return "reading configuration for remote execution in  directory "+mf.parent_path().string()+" from file "+mf.string(); } );
 
   if (!boost::filesystem::exists(mf))
   {
@@ -511,7 +512,8 @@ std::vector<bfs_path> RemoteLocation::remoteSubdirs() const
 
 int RemoteLocation::execRemoteCmd(const std::string& command, bool throwOnFail)
 {
-  insight::CurrentExceptionContext ex("executing command on remote host: "+command);
+  insight::CurrentExceptionContext ex(
+        [&]() { return "executing command on remote host: "+command; } );
   assertValid();
 
     std::ostringstream cmd;
@@ -558,7 +560,8 @@ void RemoteLocation::putFile
     std::function<void(int,const std::string&)> pf
     )
 {
-  CurrentExceptionContext ex("put file "+localFile.string()+" to remote location");
+  CurrentExceptionContext ex(
+        [&]() { return "put file "+localFile.string()+" to remote location"; } );
   assertValid();
 
   boost::filesystem::path lf=localFile, rf=remoteFileName;
@@ -583,7 +586,8 @@ void RemoteLocation::syncToRemote
     std::function<void(int,const std::string&)> pf
 )
 {
-  CurrentExceptionContext ex("upload local directory "+localDir.string()+" to remote location");
+  CurrentExceptionContext ex(
+        [&]() { return "upload local directory "+localDir.string()+" to remote location"; } );
   assertValid();
 
     std::vector<std::string> args=
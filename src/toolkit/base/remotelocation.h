@@ -171,7 +171,12 @@ public:
 
     boost::filesystem::path socket() const;
 
-    void queueRemoteCommand(const std::string& command, bool waitForPreviousFinished=true);
+    void queueRemoteCommand
+    (
+        const std::string& command,
+        bool waitForPreviousFinished=true,
+        const TaskSpoolerInterface::JobResources& resources = TaskSpoolerInterface::JobResources()
+    );
     void waitRemoteQueueFinished();
     void waitLastCommandFinished();
 
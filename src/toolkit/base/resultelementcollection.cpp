@@ -2,6 +2,7 @@
 
 #include "base/resultelements/resultsection.h"
 #include "base/resultelements/numericalresult.h"
+#include "base/filecontainer.h"
 
 using namespace std;
 using namespace boost;
@@ -119,6 +120,21 @@ double ResultElementCollection::getScalar(const std::string& path) const
     return this->get<NumericalResult<double> >(path).value();
 }
 
+ResultElementCollection::FileContainerList ResultElementCollection::fileContainers(const string& prefix)
+{
+    FileContainerList fcl;
+    for ( value_type& i: *this ) {
+        if ( auto *fc = dynamic_cast<FileContainer*>(i.second.get()) ) {
+            fcl.push_back ( FileContainerList::value_type(prefix+i.first, fc) );
+        }
+        if ( auto *rec = dynamic_cast<ResultElementCollection*>(i.second.get()) ) {
+            auto sfcl = rec->fileContainers ( prefix+i.first+"/" );
+            fcl.insert ( fcl.end(), sfcl.begin(), sfcl.end() );
+        }
+    }
+    return fcl;
+}
+
 void ResultElementCollection::appendElementsToNode ( rapidxml::xml_document<>& doc, rapidxml::xml_node<>& node ) const
 {
     for ( const_iterator i=begin(); i!= end(); i++ ) {
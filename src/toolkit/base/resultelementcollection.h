@@ -8,6 +8,9 @@
 namespace insight {
 
 
+class FileContainer;
+
+
 class ResultElementCollection
     : public std::map<std::string, ResultElementPtr>
 {
@@ -46,6 +49,14 @@ public:
 
     double getScalar(const std::string& path) const;
 
+    typedef std::vector<std::pair<std::string, FileContainer*> > FileContainerList;
+
+    /**
+     * all elements, which contain a file, including those in subsections.
+     * The paths are relative to this collection, as accepted by get().
+     */
+    FileContainerList fileContainers(const std::string& prefix = std::string());
+
     /**
      * append the result elements to the given xml node
      */
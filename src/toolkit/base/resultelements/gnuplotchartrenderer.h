@@ -44,7 +44,8 @@ public:
       using namespace poppler;
       using namespace boost::filesystem;
 
-    CurrentExceptionContext ex("rendering chart into image "+outimagepath.string()+" usign gnuplot");
+    CurrentExceptionContext ex(
+          [&]() { return "rendering chart into image "+outimagepath.string()+" usign gnuplot"; } );
 
     string bn ( outimagepath.filename().stem().string() );
 
@@ -100,7 +100,7 @@ xml_node< char >* ResultSection::appendToNode ( const string& name, xml_document
 
 std::shared_ptr< ResultElement > ResultSection::clone() const
 {
-    std::shared_ptr<ResultSection> res( new ResultSection ( sectionName_ ) );
+    std::shared_ptr<ResultSection> res( new ResultSection ( sectionName_, introduction_ ) );
     for ( const value_type& re: *this ) {
         ( *res ) [re.first] = re.second->clone();
     }
@@ -447,6 +447,22 @@ ParameterPtr ResultSet::convertIntoParameter() const
 
 
 
+std::shared_ptr<ResultSet> ResultSet::skeleton() const
+{
+    // the copy shares the elements, replace them by (deep) clones
+    auto sk = std::make_shared<ResultSet> ( *this );
+    for ( value_type& i: *sk ) {
+        i.second = i.second->clone();
+    }
+    for ( auto& fc: sk->fileContainers() ) {
+        fc.second->clearPackedData();
+    }
+    return sk;
+}
+
+
+
+
 ResultElementPtr ResultSet::clone() const
 {
     std::unique_ptr<ResultSet> nr ( new ResultSet ( p_, title_, subtitle_, &author_, &date_ ) );
@@ -134,6 +134,13 @@ public:
     virtual void saveToFile ( const boost::filesystem::path& file ) const;
     virtual void saveToStream( std::ostream& os ) const;
 
+    /**
+     * copy of the result set, in which the file contents (e.g. images) are left out.
+     * Used to transfer the structure of large results first
+     * and the file contents separately, see fileContainers().
+     */
+    std::shared_ptr<ResultSet> skeleton() const;
+
     /**
      * read result set from xml file
      */
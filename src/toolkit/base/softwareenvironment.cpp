@@ -66,7 +66,8 @@ int SoftwareEnvironment::version() const
 
 fs::path SoftwareEnvironment::which(const string &command) const
 {
-  insight::CurrentExceptionContext ex("determining full path to "+command);
+  insight::CurrentExceptionContext ex(
+        [&]() { return "determining full path to "+command; } );
   std::vector<std::string> result;
 
   executeCommand("which", { command }, &result);
@@ -92,9 +93,8 @@ void SoftwareEnvironment::executeCommand
   std::string finalcmd=cmds.back();
 
   CurrentExceptionContext ex(
-        "executing command \""+finalcmd+"\""
-        + (argv.size()>0 ? " with arguments:\n"+boost::join(argv, "\n"):"")
-        );
+        [&]() { return "executing command \""+finalcmd+"\""
+        + (argv.size()>0 ? " with arguments:\n"+boost::join(argv, "\n"):""); } );
 
   JobPtr job = forkCommand(cmd, argv, ovr_machine);
 
@@ -130,9 +130,8 @@ JobPtr SoftwareEnvironment::forkCommand
 ) const
 {
   CurrentExceptionContext ex(
-        "launching command \""+cmd_exe+"\" as subprocess"
-        + (cmd_argv.size()>0 ? " with arguments:\n"+boost::join(cmd_argv, "\n") : "")
-        );
+        [&]() { return "launching command \""+cmd_exe+"\" as subprocess"
+        + (cmd_argv.size()>0 ? " with arguments:\n"+boost::join(cmd_argv, "\n") : ""); } );
 
   std::string machine=executionMachine_;
   if (ovr_machine) machine=*ovr_machine;
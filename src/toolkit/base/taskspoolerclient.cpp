@@ -0,0 +1,389 @@
+#include "taskspoolerclient.h"
+#include "base/exception.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "protocol.h"
+
+using namespace std;
+using namespace boost;
+
+namespace insight
+{
+
+
+
+
+namespace
+{
+
+/**
+ * the message layout of the server (src/taskspooler/protocol.h),
+ * zero initialized
+ */
+struct Msg : public msg
+{
+  Msg(msg_types t)
+  {
+    memset(static_cast<msg*>(this), 0, sizeof(msg));
+    type=t;
+  }
+};
+
+static_assert(sizeof(Msg)==sizeof(msg), "Msg must not add data to the protocol message");
+
+
+void sendAll(int fd, const char* data, size_t n)
+{
+  while (n>0)
+  {
+    ssize_t r = ::send(fd, data, n, MSG_NOSIGNAL);
+    if (r<=0)
+      throw insight::Exception("TaskSpoolerClient: could not send to task spooler server!");
+    data+=r;
+    n-=r;
+  }
+}
+
+/**
+ * returns false, if the server closed the connection before any data was read
+ */
+bool recvAll(int fd, char* data, size_t n)
+{
+  size_t got=0;
+  while (got<n)
+  {
+    ssize_t r = ::recv(fd, data+got, n-got, 0);
+    if (r==0 && got==0) return false;
+    if (r<=0)
+      throw insight::Exception("TaskSpoolerClient: incomplete message from task spooler server!");
+    got+=r;
+  }
+  return true;
+}
+
+void sendMsg(int fd, const Msg& m)
+{
+  sendAll(fd, reinterpret_cast<const char*>(&m), sizeof(m));
+}
+
+bool recvMsg(int fd, Msg& m)
+{
+  return recvAll(fd, reinterpret_cast<char*>(&m), sizeof(m));
+}
+
+/**
+ * receives the text, which follows a LIST_LINE message
+ */
+std::string recvLine(int fd, const Msg& m)
+{
+  std::vector<char> buf(std::max(m.u.size, 1), '\0');
+  if (m.u.size>0)
+    recvAll(fd, buf.data(), m.u.size);
+  buf.back()='\0';
+  std::string line(buf.data());
+  while (!line.empty() && line.back()=='\n') line.pop_back();
+  return line;
+}
+
+}
+
+
+
+
+int TaskSpoolerClient::connectToServer() const
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family=AF_UNIX;
+  if (socket_.string().size() >= sizeof(addr.sun_path))
+    throw insight::Exception("TaskSpoolerClient: socket path is too long: "+socket_.string());
+  strncpy(addr.sun_path, socket_.c_str(), sizeof(addr.sun_path)-1);
+
+  int fd=::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd<0)
+    throw insight::Exception("TaskSpoolerClient: could not create socket!");
+
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))!=0)
+  {
+    ::close(fd);
+    throw insight::Exception("TaskSpoolerClient: could not connect to task spooler server at "+socket_.string());
+  }
+  return fd;
+}
+
+
+
+
+TaskSpoolerClient::TaskSpoolerClient(const boost::filesystem::path& socket)
+  : socket_(socket),
+    fd_(-1),
+    stopEvents_(false)
+{
+  wakeupPipe_[0]=wakeupPipe_[1]=-1;
+
+  fd_=connectToServer();
+
+  try
+  {
+    sendMsg(fd_, Msg(GET_VERSION));
+    Msg m(VERSION);
+    if (!recvMsg(fd_, m) || m.type!=VERSION || m.u.version!=PROTOCOL_VERSION)
+      throw insight::Exception("TaskSpoolerClient: unexpected protocol version of task spooler server!");
+  }
+  catch (...)
+  {
+    ::close(fd_);
+    throw;
+  }
+}
+
+
+
+
+TaskSpoolerClient::~TaskSpoolerClient()
+{
+  stopJobEvents();
+  if (fd_>=0) ::close(fd_);
+}
+
+
+
+
+TaskSpoolerInterface::JobList TaskSpoolerClient::jobs() const
+{
+  TaskSpoolerInterface::JobList jl;
+
+  // the server closes the connection after the list
+  int fd=connectToServer();
+  try
+  {
+    sendMsg(fd, Msg(LIST));
+
+    Msg m(LIST_LINE);
+    int i=0;
+    while (recvMsg(fd, m))
+    {
+      if (m.type!=LIST_LINE)
+        throw insight::Exception("TaskSpoolerClient: unexpected answer to list request!");
+
+      std::string line=recvLine(fd, m);
+      TaskSpoolerInterface::Job j;
+      if ( (i++>0) && TaskSpoolerInterface::parseJobListLine(line, j) )
+      {
+        jl.push_back(j);
+      }
+    }
+  }
+  catch (...)
+  {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+
+  return jl;
+}
+
+
+
+
+void TaskSpoolerClient::clearFinished()
+{
+  std::lock_guard<std::mutex> lock(mx_);
+  sendMsg(fd_, Msg(CLEAR_FINISHED));
+}
+
+
+
+
+int TaskSpoolerClient::killRunningJob()
+{
+  int pid=0;
+  {
+    std::lock_guard<std::mutex> lock(mx_);
+
+    Msg m(ASK_OUTPUT);
+    m.u.jobid=-1;
+    sendMsg(fd_, m);
+
+    if (!recvMsg(fd_, m))
+      throw insight::Exception("TaskSpoolerClient: connection closed by task spooler server!");
+
+    if (m.type==LIST_LINE)
+    {
+      recvLine(fd_, m); // no running job
+      return 1;
+    }
+    else if (m.type!=ANSWER_OUTPUT)
+      throw insight::Exception("TaskSpoolerClient: unexpected answer to output request!");
+
+    if (m.u.output.ofilename_size>0)
+    {
+      std::vector<char> fn(m.u.output.ofilename_size);
+      recvAll(fd_, fn.data(), fn.size());
+    }
+    pid=m.u.output.pid;
+  }
+
+  if (pid<=0) return 1;
+
+  // the pid is that of the process group
+  return ::kill(-pid, SIGTERM);
+}
+
+
+
+
+void TaskSpoolerClient::shutdownServer()
+{
+  std::lock_guard<std::mutex> lock(mx_);
+  sendMsg(fd_, Msg(KILL_SERVER));
+}
+
+
+
+
+void TaskSpoolerClient::runEventLoop(JobEventReceiver receiver, int pollInterval)
+{
+  std::map<int, TaskSpoolerInterface::JobState> lastStates;
+  std::map<int, int> waiters; // job id => connection, which waits for the end of the job
+
+  auto closeWaiter = [&](std::map<int,int>::iterator w)
+  {
+    ::close(w->second);
+    return waiters.erase(w);
+  };
+
+  while (!stopEvents_)
+  {
+    TaskSpoolerInterface::JobList jl;
+    try
+    {
+      jl=jobs();
+    }
+    catch (const std::exception&)
+    {
+      // server gone, try again later
+    }
+
+    std::set<int> unfinished;
+    for (const auto& j: jl)
+    {
+      auto ls = lastStates.find(j.id);
+      if (ls==lastStates.end() || ls->second!=j.state)
+      {
+        receiver(j);
+      }
+      lastStates[j.id]=j.state;
+
+      if (j.state==TaskSpoolerInterface::Running || j.state==TaskSpoolerInterface::Queued)
+      {
+        unfinished.insert(j.id);
+        if (waiters.find(j.id)==waiters.end())
+        {
+          try
+          {
+            int fd=connectToServer();
+            Msg m(WAITJOB);
+            m.u.jobid=j.id;
+            sendMsg(fd, m);
+            waiters[j.id]=fd;
+          }
+          catch (const std::exception&)
+          {}
+        }
+      }
+    }
+
+    for (auto w=waiters.begin(); w!=waiters.end(); )
+    {
+      if (unfinished.find(w->first)==unfinished.end())
+        w=closeWaiter(w);
+      else
+        ++w;
+    }
+
+    // wait for an answer to any of the wait requests
+    std::vector<pollfd> pfds;
+    pfds.push_back(pollfd{wakeupPipe_[0], POLLIN, 0});
+    for (const auto& w: waiters)
+    {
+      pfds.push_back(pollfd{w.second, POLLIN, 0});
+    }
+
+    if (::poll(pfds.data(), pfds.size(), pollInterval)>0)
+    {
+      for (size_t i=1; i<pfds.size(); i++)
+      {
+        if (pfds[i].revents)
+        {
+          for (auto w=waiters.begin(); w!=waiters.end(); ++w)
+          {
+            if (w->second==pfds[i].fd)
+            {
+              closeWaiter(w);
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  for (auto w=waiters.begin(); w!=waiters.end(); )
+  {
+    w=closeWaiter(w);
+  }
+}
+
+
+
+
+void TaskSpoolerClient::startJobEvents(JobEventReceiver receiver, int pollInterval)
+{
+  stopJobEvents();
+
+  if (::pipe(wakeupPipe_)!=0)
+    throw insight::Exception("TaskSpoolerClient: could not create pipe!");
+
+  stopEvents_=false;
+  eventThread_ = std::thread(&TaskSpoolerClient::runEventLoop, this, receiver, pollInterval);
+}
+
+
+
+
+void TaskSpoolerClient::stopJobEvents()
+{
+  if (eventThread_.joinable())
+  {
+    stopEvents_=true;
+    char c=0;
+    if (::write(wakeupPipe_[1], &c, 1)!=1)
+    {
+      // poll will time out anyway
+    }
+    eventThread_.join();
+  }
+
+  for (int& fd: wakeupPipe_)
+  {
+    if (fd>=0) ::close(fd);
+    fd=-1;
+  }
+}
+
+
+
+
+}
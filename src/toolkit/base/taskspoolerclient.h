@@ -0,0 +1,80 @@
+#ifndef TASKSPOOLERCLIENT_H
+#define TASKSPOOLERCLIENT_H
+
+#include "base/taskspoolerinterface.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace insight
+{
+
+
+
+/**
+ * Client for the socket protocol of the bundled task spooler (src/taskspooler),
+ * without running the tsp executable.
+ *
+ * A connection to the server is kept open for the simple requests.
+ * The job list is requested on a separate connection each time,
+ * since the server closes the connection after sending the list.
+ * The messages are binary structs, so the server has to run on the same architecture.
+ * Remote servers are reached through a forwarded socket.
+ *
+ * Jobs are not started here: in the task spooler design, the client process
+ * itself executes the job, once the server permits.
+ */
+class TaskSpoolerClient
+{
+public:
+  typedef std::function<void(const TaskSpoolerInterface::Job&)> JobEventReceiver;
+
+protected:
+  boost::filesystem::path socket_;
+
+  std::mutex mx_;
+  int fd_;
+
+  std::thread eventThread_;
+  std::atomic<bool> stopEvents_;
+  int wakeupPipe_[2];
+
+  int connectToServer() const;
+  void runEventLoop(JobEventReceiver receiver, int pollInterval);
+
+public:
+  /**
+   * connects to the server and checks the protocol version.
+   * Throws, if the server is not reachable.
+   */
+  TaskSpoolerClient(const boost::filesystem::path& socket);
+  ~TaskSpoolerClient();
+
+  TaskSpoolerInterface::JobList jobs() const;
+
+  void clearFinished();
+
+  /**
+   * sends SIGTERM to the process group of the running job.
+   * Returns 0 on success.
+   */
+  int killRunningJob();
+
+  void shutdownServer();
+
+  /**
+   * Call the receiver for each change of a job state.
+   * Finished jobs are reported immediately, since the server notifies
+   * waiting clients. Other changes are detected within pollInterval (ms).
+   * The receiver is called from a separate thread.
+   */
+  void startJobEvents(JobEventReceiver receiver, int pollInterval=500);
+  void stopJobEvents();
+};
+
+
+
+}
+
+#endif // TASKSPOOLERCLIENT_H
@@ -1,9 +1,12 @@
 #include "taskspoolerinterface.h"
+#include "taskspoolerclient.h"
 #include "base/exception.h"
 #include "base/tools.h"
 #include <boost/asio.hpp>
 #include <boost/process/async.hpp>
 
+#include <chrono>
+
 using namespace std;
 using namespace boost;
 
@@ -12,6 +15,25 @@ namespace insight
 
 
 
+TaskSpoolerInterface::JobResources::JobResources(int c, int m)
+  : cores(c), memoryMB(m)
+{}
+
+
+std::vector<std::string> TaskSpoolerInterface::JobResources::options() const
+{
+  std::vector<std::string> opts = { "-N", lexical_cast<std::string>(cores) };
+  if (memoryMB>0)
+  {
+    opts.push_back("-M");
+    opts.push_back(lexical_cast<std::string>(memoryMB));
+  }
+  return opts;
+}
+
+
+
+
 bool TaskSpoolerInterface::JobList::hasRunningJobs() const
 {
   for (const auto& j: *this)
@@ -41,6 +63,65 @@ bool TaskSpoolerInterface::JobList::hasFailedJobs() const
   return false;
 }
 
+bool TaskSpoolerInterface::parseJobListLine(const std::string& line, Job& j)
+{
+  static const boost::regex re_q("^([^ ]*) +([^ ]*) +([^ ]*) +(.*)$");
+  static const boost::regex re_f("^([^ ]*) +([^ ]*) +([^ ]*) +([^ ]*) +([^ ]*) +(.*)$");
+
+  boost::smatch m1;
+  if (!boost::regex_match(line, m1, re_q))
+    return false;
+
+  try
+  {
+    j.id=boost::lexical_cast<int>(m1[1]);
+  }
+  catch (...)
+  {
+    return false;
+  }
+
+  if (m1[2]=="running")
+    j.state=Running;
+  else if (m1[2]=="queued")
+    j.state=Queued;
+  else if (m1[2]=="finished")
+    j.state=Finished;
+  else
+    j.state=Unknown;
+
+  if (j.state==Queued)
+  {
+    j.output="";
+    j.commandLine=m1[4];
+  }
+  else if (j.state==Running)
+  {
+    j.output=m1[3];
+    j.commandLine=m1[4];
+  }
+  else if (j.state==Finished)
+  {
+    try {
+      boost::smatch m2;
+      boost::regex_match(line, m2, re_f);
+
+      j.output=boost::filesystem::path(m2[3]);
+
+      j.elevel=boost::lexical_cast<int>(m2[4]);
+
+      j.commandLine=m2[6];
+    }
+    catch (...)
+    {}
+  }
+
+  return true;
+}
+
+
+
+
 TaskSpoolerInterface::TaskSpoolerInterface(const boost::filesystem::path& socket, const std::string& remote_machine)
   : remote_machine_(remote_machine),
     socket_(socket),
@@ -49,8 +130,40 @@ TaskSpoolerInterface::TaskSpoolerInterface(const boost::filesystem::path& socket
     tail_cout_(ios_)*/
 {
   env_["TS_SOCKET"]=socket.string();
+
+  if (!remote_machine_.empty())
+  {
+    // forward the remote server socket, for the native protocol client
+    tunnelSocket_ =
+        boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path("tsp-%%%%-%%%%-%%%%.socket");
+    try
+    {
+      tunnel_.reset(new boost::process::child(
+                      boost::process::search_path("ssh"),
+                      boost::process::args({
+                                             "-nNT",
+                                             "-o", "ExitOnForwardFailure=yes",
+                                             "-L", tunnelSocket_.string()+":"+socket_.string(),
+                                             remote_machine_
+                                           })
+                      ));
+
+      for (int i=0; i<100 && tunnel_->running() && !boost::filesystem::exists(tunnelSocket_); i++)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    }
+    catch (const boost::process::process_error&)
+    {
+      tunnel_.reset();
+    }
+  }
 }
 
+
+
+
 TaskSpoolerInterface::~TaskSpoolerInterface()
 {
   stopTail();
@@ -60,11 +173,77 @@ TaskSpoolerInterface::~TaskSpoolerInterface()
   {
     stopTaskspoolerServer();
   }
+
+  resetClient();
+
+  if (tunnel_)
+  {
+    if (tunnel_->running()) tunnel_->terminate();
+    tunnel_.reset();
+    boost::filesystem::remove(tunnelSocket_);
+  }
 }
 
 
+
+
+std::shared_ptr<TaskSpoolerClient> TaskSpoolerInterface::client() const
+{
+  std::lock_guard<std::mutex> lock(clientMutex_);
+  if (!client_)
+  {
+    boost::filesystem::path sock = socket_;
+    if (!remote_machine_.empty())
+    {
+      if (!tunnel_ || !tunnel_->running())
+        return nullptr;
+      sock = tunnelSocket_;
+    }
+
+    try
+    {
+      client_.reset(new TaskSpoolerClient(sock));
+    }
+    catch (const std::exception&)
+    {
+      // server not running (yet) or not compatible:
+      // fall back to tsp executable
+    }
+  }
+  return client_;
+}
+
+
+
+
+void TaskSpoolerInterface::resetClient() const
+{
+  std::shared_ptr<TaskSpoolerClient> c;
+  {
+    std::lock_guard<std::mutex> lock(clientMutex_);
+    c.swap(client_);
+  }
+  // destruct outside the lock: this stops the event thread,
+  // which might be calling into this object
+}
+
+
+
+
 TaskSpoolerInterface::JobList TaskSpoolerInterface::jobs() const
 {
+  if (auto c=client())
+  {
+    try
+    {
+      return c->jobs();
+    }
+    catch (const std::exception&)
+    {
+      resetClient();
+    }
+  }
+
   JobList jl;
   boost::process::ipstream is;
   std::shared_ptr<boost::process::child> c;
@@ -96,61 +275,15 @@ TaskSpoolerInterface::JobList TaskSpoolerInterface::jobs() const
   if (!c->running())
     throw insight::Exception("Could not execute task spooler executable!");
 
-  std::vector<std::string> data;
   std::string line;
   int i=0;
-  boost::regex re_q("^([^ ]*) +([^ ]*) +([^ ]*) +(.*)$");
-  boost::regex re_f("^([^ ]*) +([^ ]*) +([^ ]*) +([^ ]*) +([^ ]*) +(.*)$");
   while (std::getline(is, line))
   {
-    if (i>0)
+    Job j;
+    if ( (i++>0) && parseJobListLine(line, j) )
     {
-      boost::smatch m1;
-      if (boost::regex_match(line, m1, re_q))
-      {
-        Job j;
-
-        j.id=boost::lexical_cast<int>(m1[1]);
-
-        if (m1[2]=="running")
-          j.state=Running;
-        else if (m1[2]=="queued")
-          j.state=Queued;
-        else if (m1[2]=="finished")
-          j.state=Finished;
-        else
-          j.state=Unknown;
-
-        if (j.state==Queued)
-        {
-          j.output="";
-          j.commandLine=m1[4];
-        }
-        else if (j.state==Running)
-        {
-          j.output=m1[3];
-          j.commandLine=m1[4];
-        }
-        else if (j.state==Finished)
-        {
-          try {
-            boost::smatch m2;
-            boost::regex_match(line, m2, re_f);
-
-            j.output=boost::filesystem::path(m2[3]);
-
-            j.elevel=boost::lexical_cast<int>(m2[4]);
-
-            j.commandLine=m2[6];
-          }
-          catch (...)
-          {}
-        }
-
-        jl.push_back(j);
-      }
+      jl.push_back(j);
     }
-    i++;
   }
 
   c->wait();
@@ -160,6 +293,19 @@ TaskSpoolerInterface::JobList TaskSpoolerInterface::jobs() const
 
 int TaskSpoolerInterface::clean()
 {
+  if (auto c=client())
+  {
+    try
+    {
+      c->clearFinished();
+      return 0;
+    }
+    catch (const std::exception&)
+    {
+      resetClient();
+    }
+  }
+
   if (!remote_machine_.empty())
   {
     std::ostringstream cmd;
@@ -185,6 +331,22 @@ int TaskSpoolerInterface::clean()
 
 int TaskSpoolerInterface::kill()
 {
+  // the job can only be signalled directly on the local machine
+  if (remote_machine_.empty())
+  {
+    if (auto c=client())
+    {
+      try
+      {
+        return c->killRunningJob();
+      }
+      catch (const std::exception&)
+      {
+        resetClient();
+      }
+    }
+  }
+
   if (!remote_machine_.empty())
   {
     std::ostringstream cmd;
@@ -208,6 +370,35 @@ int TaskSpoolerInterface::kill()
 
 
 
+bool TaskSpoolerInterface::startJobEvents(std::function<void(const Job&)> receiver)
+{
+  if (auto c=client())
+  {
+    c->startJobEvents(receiver);
+    return true;
+  }
+  return false;
+}
+
+
+
+
+void TaskSpoolerInterface::stopJobEvents()
+{
+  std::shared_ptr<TaskSpoolerClient> c;
+  {
+    std::lock_guard<std::mutex> lock(clientMutex_);
+    c=client_;
+  }
+  if (c)
+  {
+    c->stopJobEvents();
+  }
+}
+
+
+
+
 void TaskSpoolerInterface::read_start(void)
 {
   // read until EOL, then pass to receivers
@@ -370,14 +561,14 @@ void TaskSpoolerInterface::stopTail()
 }
 
 
-int TaskSpoolerInterface::startJob(const std::vector<std::string>& commandline)
+int TaskSpoolerInterface::startJob(const std::vector<std::string>& commandline, const JobResources& resources)
 {
+  std::vector<std::string> tspargs = resources.options();
+  std::copy( commandline.begin(), commandline.end(), std::back_inserter(tspargs) );
+
   if (!remote_machine_.empty())
   {
-//    std::vector<std::string> args({remote_machine_, "TS_SOCKET=\""+socket_.string()+"\"", "tsp"});
-
-    //std::copy( commandline.begin(), commandline.end(), std::back_inserter(args) );
-    auto cmd = "TS_SOCKET=\""+socket_.string()+"\" tsp " + algorithm::join(commandline, " ");
+    auto cmd = "TS_SOCKET=\""+socket_.string()+"\" tsp " + algorithm::join(tspargs, " ");
 
     return boost::process::system(
           boost::process::search_path("ssh"),
@@ -388,7 +579,7 @@ int TaskSpoolerInterface::startJob(const std::vector<std::string>& commandline)
   {
     return boost::process::system(
           boost::process::search_path("tsp"),
-          boost::process::args(commandline),
+          boost::process::args(tspargs),
           env_
           );
   }
@@ -404,6 +595,20 @@ void TaskSpoolerInterface::cancelAllJobs()
 
 int TaskSpoolerInterface::stopTaskspoolerServer()
 {
+  if (auto c=client())
+  {
+    try
+    {
+      c->shutdownServer();
+      resetClient();
+      return 0;
+    }
+    catch (const std::exception&)
+    {
+      resetClient();
+    }
+  }
+
   if (!remote_machine_.empty())
   {
     auto cmd = "TS_SOCKET=\""+socket_.string()+"\" tsp -K";
@@ -5,16 +5,37 @@
 #include "boost/process.hpp"
 #include "boost/asio/io_service.hpp"
 
+#include <mutex>
+
 namespace insight
 {
 
 
+class TaskSpoolerClient;
+
+
 class TaskSpoolerInterface
 {
   std::string remote_machine_;
   boost::filesystem::path socket_;
   boost::process::environment env_;
 
+  /**
+   * native protocol client, if the server is reachable.
+   * Otherwise, the tsp executable is used.
+   */
+  mutable std::mutex clientMutex_;
+  mutable std::shared_ptr<TaskSpoolerClient> client_;
+
+  /**
+   * ssh process, which forwards the remote server socket to tunnelSocket_
+   */
+  std::shared_ptr<boost::process::child> tunnel_;
+  boost::filesystem::path tunnelSocket_;
+
+  std::shared_ptr<TaskSpoolerClient> client() const;
+  void resetClient() const;
+
   std::shared_ptr<boost::asio::io_service> ios_;
   std::shared_ptr<boost::process::async_pipe> tail_cout_;
   std::shared_ptr<std::thread> ios_run_thread_;
@@ -41,6 +62,31 @@ public:
     std::string commandLine;
   };
 
+  /**
+   * resources, which a job declares to the scheduler.
+   * The server starts it, when these are free. Other jobs may run
+   * alongside, as long as the resources suffice.
+   */
+  struct JobResources
+  {
+    /**
+     * number of cores (slots in the task spooler)
+     */
+    int cores;
+
+    /**
+     * memory in MB, 0 if not known
+     */
+    int memoryMB;
+
+    JobResources(int cores=1, int memoryMB=0);
+
+    /**
+     * returns the tsp command line options
+     */
+    std::vector<std::string> options() const;
+  };
+
   struct JobList
   : public std::vector<Job>
   {
@@ -49,6 +95,11 @@ public:
     bool hasFailedJobs() const;
   };
 
+  /**
+   * parse a line of the job listing (as produced by "tsp -l")
+   */
+  static bool parseJobListLine(const std::string& line, Job& j);
+
 public:
   TaskSpoolerInterface(const boost::filesystem::path& socket, const std::string& remote_machine="");
   ~TaskSpoolerInterface();
@@ -58,6 +109,14 @@ public:
   int clean();
   int kill();
 
+  /**
+   * Calls receiver for each change of a job state.
+   * Needs a connection to the server by the native protocol.
+   * Returns false, if this is not available. Then the job list has to be polled.
+   */
+  bool startJobEvents(std::function<void(const Job&)> receiver);
+  void stopJobEvents();
+
   // =============================
   // tail
   void startTail(std::function<void(const std::string&)> receiver, bool blocking=false);
@@ -66,7 +125,7 @@ public:
 
   // =============================
   // jobs
-  int startJob(const std::vector<std::string>& commandline);
+  int startJob(const std::vector<std::string>& commandline, const JobResources& resources = JobResources());
   void cancelAllJobs();
 
   int stopTaskspoolerServer();
@@ -681,7 +681,8 @@ readSTL
   const vtk_TransformerList& trsf
 )
 {
-  CurrentExceptionContext ce("Reading STL file "+path.string()+" using VTK reader");
+  CurrentExceptionContext ce(
+        [&]() { return "Reading STL file "+path.string()+" using VTK reader"; } );
 
   if (!boost::filesystem::exists(path))
     throw insight::Exception("file "+path.string()+" does not exist!");
@@ -736,7 +737,8 @@ void writeSTL
    const boost::filesystem::path& outfile
 )
 {
-  CurrentExceptionContext ec("Writing STL mesh to file "+outfile.string());
+  CurrentExceptionContext ec(
+        [&]() { return "Writing STL mesh to file "+outfile.string(); } );
 
   std::string file_ext = outfile.filename().extension().string();
   boost::to_lower(file_ext);
@@ -0,0 +1,472 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "trisurface.h"
+#include "base/exception.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace insight
+{
+
+
+
+
+namespace
+{
+
+TriSurface::Point cross(const TriSurface::Point& a, const TriSurface::Point& b)
+{
+  return {{ a[1]*b[2]-a[2]*b[1], a[2]*b[0]-a[0]*b[2], a[0]*b[1]-a[1]*b[0] }};
+}
+
+TriSurface::Point diff(const TriSurface::Point& a, const TriSurface::Point& b)
+{
+  return {{ a[0]-b[0], a[1]-b[1], a[2]-b[2] }};
+}
+
+double dot(const TriSurface::Point& a, const TriSurface::Point& b)
+{
+  return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+
+/**
+ * collects triangles from a list of corner coordinates and merges identical vertices
+ */
+class VertexWelder
+{
+  TriSurface::Point p_[3];
+  int n_;
+  std::map<TriSurface::Point, int> index_;
+  std::vector<TriSurface::Point> points_;
+  std::vector<TriSurface::Triangle> triangles_;
+  std::vector<int> regions_;
+  std::vector<std::string> regionNames_;
+
+  int pointIndex(const TriSurface::Point& p)
+  {
+    auto i=index_.find(p);
+    if (i!=index_.end())
+      return i->second;
+    int pi=points_.size();
+    points_.push_back(p);
+    index_[p]=pi;
+    return pi;
+  }
+
+public:
+  VertexWelder()
+    : n_(0)
+  {}
+
+  void beginRegion(const std::string& name)
+  {
+    regionNames_.push_back(
+          name.empty() ? "patch"+std::to_string(regionNames_.size()) : name );
+  }
+
+  void addVertex(const TriSurface::Point& p)
+  {
+    p_[n_++]=p;
+    if (n_==3)
+    {
+      TriSurface::Triangle t{{ pointIndex(p_[0]), pointIndex(p_[1]), pointIndex(p_[2]) }};
+      if (t[0]!=t[1] && t[1]!=t[2] && t[2]!=t[0])
+      {
+        triangles_.push_back(t);
+        regions_.push_back(std::max<int>(0, regionNames_.size()-1));
+      }
+      n_=0;
+    }
+  }
+
+  TriSurface surface() const
+  {
+    // a single solid is kept as region as well, so that its name is preserved
+    if (!regionNames_.empty())
+      return TriSurface(points_, triangles_, regions_, regionNames_);
+    else
+      return TriSurface(points_, triangles_);
+  }
+};
+
+}
+
+
+
+
+TriSurface::TriSurface()
+{}
+
+
+TriSurface::TriSurface(const std::vector<Point>& points, const std::vector<Triangle>& triangles)
+  : points_(points),
+    triangles_(triangles)
+{}
+
+
+TriSurface::TriSurface
+(
+  const std::vector<Point>& points,
+  const std::vector<Triangle>& triangles,
+  const std::vector<int>& regions,
+  const std::vector<std::string>& regionNames
+)
+  : points_(points),
+    triangles_(triangles),
+    regions_(regions),
+    regionNames_(regionNames)
+{
+  if (regions_.size()!=triangles_.size())
+    throw insight::Exception("TriSurface: number of region indices does not match number of triangles!");
+}
+
+
+TriSurface TriSurface::readSTL(const boost::filesystem::path& file)
+{
+  if (!bf::exists(file))
+    throw insight::Exception("STL file "+file.string()+" does not exist!");
+
+  std::ifstream f(file.c_str(), std::ios::binary);
+  if (!f.good())
+    throw insight::Exception("Could not open STL file "+file.string()+"!");
+
+  VertexWelder w;
+
+  // binary files have a fixed size per triangle,
+  // ASCII files may start with "solid" as well
+  auto fsize=bf::file_size(file);
+  bool binary=false;
+  if (fsize>=84)
+  {
+    char header[84];
+    f.read(header, 84);
+    std::uint32_t n;
+    std::memcpy(&n, header+80, 4);
+    binary = ( fsize == 84 + 50*std::uintmax_t(n) );
+
+    if (binary)
+    {
+      for (std::uint32_t i=0; i<n; i++)
+      {
+        char rec[50];
+        f.read(rec, 50);
+        if (!f.good())
+          throw insight::Exception("Unexpected end of binary STL file "+file.string());
+        for (int j=0; j<3; j++)
+        {
+          float c[3];
+          std::memcpy(c, rec+12*(j+1), 12);
+          w.addVertex(Point{{c[0], c[1], c[2]}});
+        }
+      }
+    }
+  }
+
+  if (!binary)
+  {
+    f.clear();
+    f.seekg(0);
+    std::string line;
+    while (std::getline(f, line))
+    {
+      std::istringstream ls(line);
+      std::string kw;
+      ls >> kw;
+      if (kw=="solid")
+      {
+        std::string name;
+        ls >> name;
+        w.beginRegion(name);
+      }
+      else if (kw=="vertex")
+      {
+        Point p;
+        ls >> p[0] >> p[1] >> p[2];
+        if (ls.fail())
+          throw insight::Exception("Invalid vertex in STL file "+file.string()+": "+line);
+        w.addVertex(p);
+      }
+    }
+  }
+
+  return w.surface();
+}
+
+
+void TriSurface::writeSTL(const boost::filesystem::path& file, bool binary, const std::string& solidName) const
+{
+  if (binary)
+  {
+    std::ofstream f(file.c_str(), std::ios::binary);
+    char header[80];
+    std::memset(header, 0, 80);
+    std::strncpy(header, solidName.c_str(), 79);
+    f.write(header, 80);
+    std::uint32_t n=triangles_.size();
+    f.write(reinterpret_cast<const char*>(&n), 4);
+    for (size_t i=0; i<triangles_.size(); i++)
+    {
+      float rec[12];
+      Point nrm=normal(i);
+      for (int k=0; k<3; k++)
+      {
+        rec[k]=nrm[k];
+        for (int j=0; j<3; j++)
+          rec[3*(j+1)+k]=points_[triangles_[i][j]][k];
+      }
+      f.write(reinterpret_cast<const char*>(rec), 48);
+      std::uint16_t attr=0;
+      f.write(reinterpret_cast<const char*>(&attr), 2);
+    }
+  }
+  else
+  {
+    std::ofstream f(file.c_str());
+
+    // snprintf is considerably faster than ostream formatting
+    char buf[128];
+    auto writeTriangle = [&](size_t i)
+    {
+      Point n=normal(i);
+      int l=snprintf(buf, sizeof(buf), "facet normal %.9g %.9g %.9g\n outer loop\n", n[0], n[1], n[2]);
+      f.write(buf, l);
+      for (int j=0; j<3; j++)
+      {
+        const Point& p=points_[triangles_[i][j]];
+        l=snprintf(buf, sizeof(buf), "  vertex %.17g %.17g %.17g\n", p[0], p[1], p[2]);
+        f.write(buf, l);
+      }
+      f<<" endloop\nendfacet\n";
+    };
+
+    if (regionNames_.empty())
+    {
+      f<<"solid "<<solidName<<"\n";
+      for (size_t i=0; i<triangles_.size(); i++)
+        writeTriangle(i);
+      f<<"endsolid "<<solidName<<"\n";
+    }
+    else
+    {
+      for (size_t r=0; r<regionNames_.size(); r++)
+      {
+        f<<"solid "<<regionNames_[r]<<"\n";
+        for (size_t i=0; i<triangles_.size(); i++)
+        {
+          if (region(i)==int(r)) writeTriangle(i);
+        }
+        f<<"endsolid "<<regionNames_[r]<<"\n";
+      }
+    }
+  }
+}
+
+
+int TriSurface::addPoint(const Point& p)
+{
+  points_.push_back(p);
+  return points_.size()-1;
+}
+
+
+void TriSurface::addTriangle(const Triangle& t)
+{
+  triangles_.push_back(t);
+  if (!regions_.empty()) regions_.push_back(0);
+}
+
+
+void TriSurface::append(const TriSurface& other)
+{
+  if (!regionNames_.empty() || !other.regionNames_.empty())
+  {
+    // keep the regions of both surfaces apart
+    if (regionNames_.empty())
+    {
+      regionNames_.push_back("patch0");
+      regions_.resize(triangles_.size(), 0);
+    }
+    int rofs=regionNames_.size();
+    if (other.regionNames_.empty())
+      regionNames_.push_back("patch"+std::to_string(rofs));
+    else
+      regionNames_.insert(regionNames_.end(), other.regionNames_.begin(), other.regionNames_.end());
+    for (size_t i=0; i<other.triangles_.size(); i++)
+      regions_.push_back(rofs+other.region(i));
+  }
+
+  int ofs=points_.size();
+  points_.insert(points_.end(), other.points_.begin(), other.points_.end());
+  for (const auto& t: other.triangles_)
+  {
+    triangles_.push_back(Triangle{{ t[0]+ofs, t[1]+ofs, t[2]+ofs }});
+  }
+}
+
+
+void TriSurface::translate(const Point& delta)
+{
+  for (auto& p: points_)
+  {
+    for (int k=0; k<3; k++)
+      p[k]+=delta[k];
+  }
+}
+
+
+void TriSurface::bounds(Point& min, Point& max) const
+{
+  for (int k=0; k<3; k++)
+  {
+    min[k]=std::numeric_limits<double>::max();
+    max[k]=-std::numeric_limits<double>::max();
+  }
+  for (const auto& p: points_)
+  {
+    for (int k=0; k<3; k++)
+    {
+      min[k]=std::min(min[k], p[k]);
+      max[k]=std::max(max[k], p[k]);
+    }
+  }
+}
+
+
+bool TriSurface::isClosed() const
+{
+  // each directed edge has to occur exactly once, together with its reverse
+  std::map<std::pair<int,int>, int> edges;
+  for (const auto& t: triangles_)
+  {
+    for (int j=0; j<3; j++)
+    {
+      if (++edges[std::make_pair(t[j], t[(j+1)%3])] > 1)
+        return false;
+    }
+  }
+  for (const auto& e: edges)
+  {
+    if (edges.find(std::make_pair(e.first.second, e.first.first))==edges.end())
+      return false;
+  }
+  return true;
+}
+
+
+void TriSurface::removeUnusedPoints()
+{
+  std::vector<int> newIndex(points_.size(), -1);
+  std::vector<Point> pts;
+  for (auto& t: triangles_)
+  {
+    for (int& i: t)
+    {
+      if (newIndex[i]<0)
+      {
+        newIndex[i]=pts.size();
+        pts.push_back(points_[i]);
+      }
+      i=newIndex[i];
+    }
+  }
+  points_.swap(pts);
+}
+
+
+double TriSurface::volume() const
+{
+  double v=0;
+  for (const auto& t: triangles_)
+  {
+    v+=dot(points_[t[0]], cross(points_[t[1]], points_[t[2]]));
+  }
+  return v/6.;
+}
+
+
+TriSurface::Point TriSurface::normal(int triangle) const
+{
+  const auto& t=triangles_[triangle];
+  Point n=cross(
+        diff(points_[t[1]], points_[t[0]]),
+        diff(points_[t[2]], points_[t[0]]) );
+  double l=std::sqrt(dot(n, n));
+  if (l>0)
+  {
+    for (int k=0; k<3; k++) n[k]/=l;
+  }
+  return n;
+}
+
+
+double TriSurface::area(int triangle) const
+{
+  const auto& t=triangles_[triangle];
+  Point n=cross(
+        diff(points_[t[1]], points_[t[0]]),
+        diff(points_[t[2]], points_[t[0]]) );
+  return 0.5*std::sqrt(dot(n, n));
+}
+
+
+std::vector<std::pair<int,int> > TriSurface::featureEdges(double includedAngle) const
+{
+  const double minCos = std::cos( (180.-includedAngle)*M_PI/180. );
+
+  std::map<std::pair<int,int>, std::vector<int> > edgeTris;
+  for (size_t i=0; i<triangles_.size(); i++)
+  {
+    const auto& t=triangles_[i];
+    for (int j=0; j<3; j++)
+    {
+      int a=t[j], b=t[(j+1)%3];
+      edgeTris[std::make_pair(std::min(a,b), std::max(a,b))].push_back(i);
+    }
+  }
+
+  std::vector<std::pair<int,int> > fe;
+  for (const auto& e: edgeTris)
+  {
+    if ( e.second.size()!=2
+         || dot(normal(e.second[0]), normal(e.second[1])) < minCos )
+    {
+      fe.push_back(e.first);
+    }
+  }
+  return fe;
+}
+
+
+
+
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef INSIGHT_TRISURFACE_H
+#define INSIGHT_TRISURFACE_H
+
+#include "boost/filesystem.hpp"
+
+#include <array>
+#include <vector>
+#include <string>
+
+namespace insight
+{
+
+
+
+
+/**
+ * A triangulated surface with shared vertices.
+ * The triangle vertices are ordered counter-clockwise, when seen from outside.
+ * Optionally, the triangles are assigned to named regions (the solids of an STL file).
+ */
+class TriSurface
+{
+public:
+  typedef std::array<double,3> Point;
+  typedef std::array<int,3> Triangle;
+
+protected:
+  std::vector<Point> points_;
+  std::vector<Triangle> triangles_;
+
+  // region index of each triangle, empty if the surface has no named regions
+  std::vector<int> regions_;
+  std::vector<std::string> regionNames_;
+
+public:
+  TriSurface();
+  TriSurface(const std::vector<Point>& points, const std::vector<Triangle>& triangles);
+  TriSurface(
+      const std::vector<Point>& points,
+      const std::vector<Triangle>& triangles,
+      const std::vector<int>& regions,
+      const std::vector<std::string>& regionNames );
+
+  /**
+   * reads an ASCII or binary STL file.
+   * Vertices with identical coordinates are merged,
+   * triangles, which collapse by that, are dropped.
+   * The solids of an ASCII file become regions (also a single one, to keep its name).
+   */
+  static TriSurface readSTL(const boost::filesystem::path& file);
+
+  /**
+   * writes an STL file. In ASCII format, each region is written as a separate solid,
+   * solidName is used, if there are no regions.
+   */
+  void writeSTL(const boost::filesystem::path& file, bool binary=false, const std::string& solidName="patch0") const;
+
+  inline const std::vector<Point>& points() const { return points_; }
+  inline const std::vector<Triangle>& triangles() const { return triangles_; }
+
+  inline const std::vector<std::string>& regionNames() const { return regionNames_; }
+  inline int region(int triangle) const { return regions_.empty() ? 0 : regions_[triangle]; }
+
+  int addPoint(const Point& p);
+  void addTriangle(const Triangle& t);
+
+  /**
+   * adds all points and triangles of other
+   */
+  void append(const TriSurface& other);
+
+  void translate(const Point& delta);
+
+  /**
+   * replaces each point p by f(p)
+   */
+  template<class F>
+  void transformPoints(F f)
+  {
+    for (auto& p: points_) p=f(p);
+  }
+
+  void bounds(Point& min, Point& max) const;
+
+  /**
+   * true, if each edge is shared by exactly two triangles with opposite orientation
+   */
+  bool isClosed() const;
+
+  /**
+   * removes points, which are not used by any triangle
+   */
+  void removeUnusedPoints();
+
+  /**
+   * enclosed volume, only meaningful for closed surfaces
+   */
+  double volume() const;
+
+  Point normal(int triangle) const;
+  double area(int triangle) const;
+
+  /**
+   * Edges, at which the adjacent triangles enclose an angle smaller than includedAngle (in degrees),
+   * and all edges, which are not shared by exactly two triangles.
+   * Like in OpenFOAM's surfaceFeatureExtract, 180 selects all edges.
+   */
+  std::vector<std::pair<int,int> > featureEdges(double includedAngle) const;
+};
+
+
+
+
+}
+
+#endif // INSIGHT_TRISURFACE_H
@@ -0,0 +1,1354 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include "trisurfaceboolean.h"
+#include "base/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+using namespace std;
+
+namespace insight
+{
+
+
+
+
+namespace
+{
+
+typedef TriSurface::Point Point;
+typedef std::array<double,2> Point2;
+typedef std::array<int,3> Triangle;
+
+
+/**
+ * thrown internally, if the configuration cannot be resolved.
+ * Leads to a retry with displaced tool surface.
+ */
+struct Degenerate {};
+
+
+
+
+// ======== exact orientation predicates
+// floating point filter with fallback to expansion arithmetic, following
+// J.R. Shewchuk: Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates
+
+const double epsilon = std::ldexp(1.0, -53);
+const double o3dErrBound = (7.0 + 56.0*epsilon)*epsilon;
+const double o2dErrBound = (3.0 + 16.0*epsilon)*epsilon;
+
+typedef std::vector<double> Expansion;
+
+inline void twoSum(double a, double b, double& x, double& y)
+{
+  double s=a+b;
+  double bv=s-a;
+  double av=s-bv;
+  y=(a-av)+(b-bv);
+  x=s;
+}
+
+inline void twoProduct(double a, double b, double& x, double& y)
+{
+  double p=a*b;
+  y=std::fma(a, b, -p);
+  x=p;
+}
+
+/**
+ * adds b to the expansion e, zero components are eliminated
+ */
+Expansion grow(const Expansion& e, double b)
+{
+  Expansion h;
+  h.reserve(e.size()+1);
+  double q=b;
+  for (double ei: e)
+  {
+    double hh;
+    twoSum(q, ei, q, hh);
+    if (hh!=0.) h.push_back(hh);
+  }
+  if (q!=0. || h.empty()) h.push_back(q);
+  return h;
+}
+
+Expansion sum(const Expansion& e, const Expansion& f)
+{
+  Expansion h(e);
+  for (double fi: f) h=grow(h, fi);
+  return h;
+}
+
+Expansion negated(const Expansion& e)
+{
+  Expansion h(e);
+  for (double& hi: h) hi=-hi;
+  return h;
+}
+
+Expansion scale(const Expansion& e, double b)
+{
+  Expansion h;
+  for (double ei: e)
+  {
+    double x, y;
+    twoProduct(ei, b, x, y);
+    h=grow(h, y);
+    h=grow(h, x);
+  }
+  return h;
+}
+
+Expansion product(const Expansion& e, const Expansion& f)
+{
+  Expansion h;
+  for (double fi: f) h=sum(h, scale(e, fi));
+  return h;
+}
+
+/**
+ * exact difference a-b
+ */
+Expansion difference(double a, double b)
+{
+  double x, y;
+  twoSum(a, -b, x, y);
+  return grow(Expansion(1, y), x);
+}
+
+int sign(const Expansion& e)
+{
+  double v=e.back(); // component of largest magnitude
+  return (v>0.) ? 1 : ( (v<0.) ? -1 : 0 );
+}
+
+
+/**
+ * sign of ((b-a)x(c-a)).(d-a):
+ * positive, if d is on the side of the plane abc, into which its normal points
+ */
+double orient3dValue(const Point& a, const Point& b, const Point& c, const Point& d, double* permanent=nullptr)
+{
+  double ux=b[0]-a[0], uy=b[1]-a[1], uz=b[2]-a[2];
+  double vx=c[0]-a[0], vy=c[1]-a[1], vz=c[2]-a[2];
+  double wx=d[0]-a[0], wy=d[1]-a[1], wz=d[2]-a[2];
+
+  if (permanent)
+  {
+    *permanent =
+          std::fabs(ux)*( std::fabs(vy*wz) + std::fabs(vz*wy) )
+        + std::fabs(uy)*( std::fabs(vz*wx) + std::fabs(vx*wz) )
+        + std::fabs(uz)*( std::fabs(vx*wy) + std::fabs(vy*wx) );
+  }
+
+  return ux*(vy*wz - vz*wy) + uy*(vz*wx - vx*wz) + uz*(vx*wy - vy*wx);
+}
+
+int orient3d(const Point& a, const Point& b, const Point& c, const Point& d)
+{
+  double perm;
+  double det=orient3dValue(a, b, c, d, &perm);
+  if (std::fabs(det) > o3dErrBound*perm)
+    return det>0. ? 1 : -1;
+
+  Expansion
+      ux=difference(b[0],a[0]), uy=difference(b[1],a[1]), uz=difference(b[2],a[2]),
+      vx=difference(c[0],a[0]), vy=difference(c[1],a[1]), vz=difference(c[2],a[2]),
+      wx=difference(d[0],a[0]), wy=difference(d[1],a[1]), wz=difference(d[2],a[2]);
+
+  Expansion e=product(ux, sum(product(vy, wz), negated(product(vz, wy))));
+  e=sum(e, product(uy, sum(product(vz, wx), negated(product(vx, wz)))));
+  e=sum(e, product(uz, sum(product(vx, wy), negated(product(vy, wx)))));
+  return sign(e);
+}
+
+/**
+ * positive, if a, b, c are ordered counter-clockwise
+ */
+int orient2d(const Point2& a, const Point2& b, const Point2& c)
+{
+  double l=(b[0]-a[0])*(c[1]-a[1]);
+  double r=(b[1]-a[1])*(c[0]-a[0]);
+  double det=l-r;
+  if (std::fabs(det) > o2dErrBound*(std::fabs(l)+std::fabs(r)))
+    return det>0. ? 1 : -1;
+
+  Expansion e=sum(
+        product(difference(b[0],a[0]), difference(c[1],a[1])),
+        negated(product(difference(b[1],a[1]), difference(c[0],a[0])))
+        );
+  return sign(e);
+}
+
+/**
+ * positive, if d is inside the circumcircle of the counter-clockwise triangle abc.
+ * Only used for the quality of the triangulation, thus not exact.
+ */
+bool inCircle(const Point2& a, const Point2& b, const Point2& c, const Point2& d)
+{
+  double adx=a[0]-d[0], ady=a[1]-d[1];
+  double bdx=b[0]-d[0], bdy=b[1]-d[1];
+  double cdx=c[0]-d[0], cdy=c[1]-d[1];
+  double alift=adx*adx+ady*ady, blift=bdx*bdx+bdy*bdy, clift=cdx*cdx+cdy*cdy;
+  double t1=alift*(bdx*cdy-cdx*bdy), t2=blift*(cdx*ady-adx*cdy), t3=clift*(adx*bdy-bdx*ady);
+  double det=t1+t2+t3;
+  return det > 1e-12*(std::fabs(t1)+std::fabs(t2)+std::fabs(t3));
+}
+
+
+
+
+// ======== geometric helpers
+
+struct Box
+{
+  Point min, max;
+
+  Box()
+  {
+    for (int k=0; k<3; k++)
+    {
+      min[k]=std::numeric_limits<double>::max();
+      max[k]=-std::numeric_limits<double>::max();
+    }
+  }
+
+  void extend(const Point& p)
+  {
+    for (int k=0; k<3; k++)
+    {
+      min[k]=std::min(min[k], p[k]);
+      max[k]=std::max(max[k], p[k]);
+    }
+  }
+
+  void extend(const Box& b)
+  {
+    extend(b.min);
+    extend(b.max);
+  }
+
+  bool overlaps(const Box& o) const
+  {
+    for (int k=0; k<3; k++)
+    {
+      if (o.max[k]<min[k] || o.min[k]>max[k]) return false;
+    }
+    return true;
+  }
+
+  /**
+   * conservative test, whether the segment p-q touches the box
+   */
+  bool overlaps(const Point& p, const Point& q) const
+  {
+    double t0=0., t1=1.;
+    for (int k=0; k<3; k++)
+    {
+      double tol=1e-9*(std::fabs(max[k])+std::fabs(min[k])+max[k]-min[k]) + 1e-300;
+      double lo=min[k]-tol, hi=max[k]+tol;
+      double d=q[k]-p[k];
+      if (d==0.)
+      {
+        if (p[k]<lo || p[k]>hi) return false;
+      }
+      else
+      {
+        double ta=(lo-p[k])/d, tb=(hi-p[k])/d;
+        if (ta>tb) std::swap(ta, tb);
+        t0=std::max(t0, ta);
+        t1=std::min(t1, tb);
+        if (t0>t1) return false;
+      }
+    }
+    return true;
+  }
+};
+
+
+/**
+ * bounding volume hierarchy of the triangles of a surface
+ */
+class TriangleTree
+{
+  struct Node
+  {
+    Box box;
+    int left, right;
+    int first, count; // triangles in leaf, count==0 for inner nodes
+  };
+
+  const TriSurface& surf_;
+  std::vector<int> order_;
+  std::vector<Box> boxes_;
+  std::vector<Point> centers_;
+  std::vector<Node> nodes_;
+
+  int build(int first, int count)
+  {
+    Node n;
+    Box cb;
+    for (int i=first; i<first+count; i++)
+    {
+      n.box.extend(boxes_[order_[i]]);
+      cb.extend(centers_[order_[i]]);
+    }
+
+    int ni=nodes_.size();
+    nodes_.push_back(n);
+
+    if (count<=4)
+    {
+      nodes_[ni].left=nodes_[ni].right=-1;
+      nodes_[ni].first=first;
+      nodes_[ni].count=count;
+    }
+    else
+    {
+      int axis=0;
+      for (int k=1; k<3; k++)
+      {
+        if (cb.max[k]-cb.min[k] > cb.max[axis]-cb.min[axis]) axis=k;
+      }
+      int half=count/2;
+      std::nth_element(
+            order_.begin()+first, order_.begin()+first+half, order_.begin()+first+count,
+            [&](int i, int j) { return centers_[i][axis] < centers_[j][axis]; }
+      );
+      int l=build(first, half);
+      int r=build(first+half, count-half);
+      nodes_[ni].left=l;
+      nodes_[ni].right=r;
+      nodes_[ni].first=first;
+      nodes_[ni].count=0;
+    }
+    return ni;
+  }
+
+public:
+  TriangleTree(const TriSurface& s)
+    : surf_(s)
+  {
+    const auto& tris=s.triangles();
+    order_.resize(tris.size());
+    boxes_.resize(tris.size());
+    centers_.resize(tris.size());
+    for (size_t i=0; i<tris.size(); i++)
+    {
+      order_[i]=i;
+      for (int j=0; j<3; j++)
+        boxes_[i].extend(s.points()[tris[i][j]]);
+      for (int k=0; k<3; k++)
+        centers_[i][k]=0.5*(boxes_[i].min[k]+boxes_[i].max[k]);
+    }
+    if (tris.size()>0) build(0, tris.size());
+  }
+
+  const Box& box(int tri) const { return boxes_[tri]; }
+
+  /**
+   * calls visit(tri) for all triangles in leaves, whose boxes pass boxTest
+   */
+  template<class BoxTest, class Visitor>
+  void traverse(BoxTest boxTest, Visitor visit) const
+  {
+    if (nodes_.empty()) return;
+    std::vector<int> stack(1, 0);
+    while (!stack.empty())
+    {
+      const Node& n=nodes_[stack.back()];
+      stack.pop_back();
+      if (!boxTest(n.box)) continue;
+      if (n.count>0)
+      {
+        for (int i=n.first; i<n.first+n.count; i++)
+        {
+          if (boxTest(boxes_[order_[i]])) visit(order_[i]);
+        }
+      }
+      else
+      {
+        stack.push_back(n.left);
+        stack.push_back(n.right);
+      }
+    }
+  }
+};
+
+
+enum SegmentTriangleIntersection { No, Yes, Touching };
+
+/**
+ * the dominant axis of the normal and the two remaining axes,
+ * ordered such, that the projection preserves the orientation
+ */
+void projectionAxes(const Point& t0, const Point& t1, const Point& t2, int& ax, int& ay)
+{
+  Point n{{
+      (t1[1]-t0[1])*(t2[2]-t0[2]) - (t1[2]-t0[2])*(t2[1]-t0[1]),
+      (t1[2]-t0[2])*(t2[0]-t0[0]) - (t1[0]-t0[0])*(t2[2]-t0[2]),
+      (t1[0]-t0[0])*(t2[1]-t0[1]) - (t1[1]-t0[1])*(t2[0]-t0[0])
+    }};
+  int k=0;
+  for (int i=1; i<3; i++)
+  {
+    if (std::fabs(n[i])>std::fabs(n[k])) k=i;
+  }
+  ax=(k+1)%3;
+  ay=(k+2)%3;
+  if (n[k]<0.) std::swap(ax, ay);
+}
+
+inline Point2 project(const Point& p, int ax, int ay)
+{
+  return Point2{{p[ax], p[ay]}};
+}
+
+/**
+ * whether the closed triangle may contain the point p, which lies in its plane
+ */
+bool mayContain(const Point& t0, const Point& t1, const Point& t2, const Point& p)
+{
+  int ax, ay;
+  projectionAxes(t0, t1, t2, ax, ay);
+  Point2 a=project(t0, ax, ay), b=project(t1, ax, ay), c=project(t2, ax, ay), q=project(p, ax, ay);
+  return orient2d(a, b, q)>=0 && orient2d(b, c, q)>=0 && orient2d(c, a, q)>=0;
+}
+
+/**
+ * whether the segment p-q, which lies in the plane of the triangle,
+ * may touch the closed triangle
+ */
+bool mayTouch(const Point& t0, const Point& t1, const Point& t2, const Point& p, const Point& q)
+{
+  int ax, ay;
+  projectionAxes(t0, t1, t2, ax, ay);
+  Point2 c[3]={project(t0, ax, ay), project(t1, ax, ay), project(t2, ax, ay)};
+  Point2 pp=project(p, ax, ay), qq=project(q, ax, ay);
+  for (int j=0; j<3; j++)
+  {
+    if (orient2d(c[j], c[(j+1)%3], pp)<0 && orient2d(c[j], c[(j+1)%3], qq)<0)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Yes, if the segment p-q crosses the interior of the triangle in a single point.
+ * Touching, if it hits an edge or vertex, or an end point lies on the triangle.
+ */
+SegmentTriangleIntersection intersect
+(
+  const Point& p, const Point& q,
+  const Point& t0, const Point& t1, const Point& t2
+)
+{
+  int op=orient3d(t0, t1, t2, p);
+  int oq=orient3d(t0, t1, t2, q);
+
+  if (op*oq>0) return No;
+
+  if (op==0 && oq==0)
+    return mayTouch(t0, t1, t2, p, q) ? Touching : No;
+  if (op==0)
+    return mayContain(t0, t1, t2, p) ? Touching : No;
+  if (oq==0)
+    return mayContain(t0, t1, t2, q) ? Touching : No;
+
+  int s0=orient3d(p, q, t0, t1);
+  int s1=orient3d(p, q, t1, t2);
+  int s2=orient3d(p, q, t2, t0);
+
+  if ( (s0>0 || s1>0 || s2>0) && (s0<0 || s1<0 || s2<0) )
+    return No;
+  if (s0==0 || s1==0 || s2==0)
+    return Touching;
+  return Yes;
+}
+
+
+
+
+// ======== retriangulation of a single cut triangle
+
+struct EdgePoint
+{
+  double t; // parameter along the triangle edge
+  int vertex;
+};
+
+struct TriangleCut
+{
+  std::vector<EdgePoint> edgePoints[3];
+  std::vector<int> interiorPoints;
+  std::vector<std::pair<int,int> > segments;
+
+  bool empty() const
+  {
+    return segments.empty();
+  }
+};
+
+
+inline std::uint64_t edgeKey(int a, int b)
+{
+  return (std::uint64_t(std::uint32_t(a))<<32) | std::uint32_t(b);
+}
+
+
+/**
+ * constrained triangulation of a triangle, whose edges carry additional points,
+ * with interior points and constraint segments.
+ * All computations are done in the projection to the plane of the triangle.
+ */
+class TriangleSplitter
+{
+  std::vector<Point2> p_;
+  std::vector<unsigned> onEdge_; // bit j is set, if the vertex lies on edge j of the triangle
+  std::vector<Triangle> tris_;
+  std::unordered_map<std::uint64_t, int> edges_; // directed edge => triangle
+  std::set<std::uint64_t> constraints_;
+
+  bool collinear(int a, int b, int c) const
+  {
+    return (onEdge_[a]&onEdge_[b]&onEdge_[c])!=0;
+  }
+
+  void setTri(int i, int a, int b, int c)
+  {
+    tris_[i]=Triangle{{a, b, c}};
+    edges_[edgeKey(a,b)]=i;
+    edges_[edgeKey(b,c)]=i;
+    edges_[edgeKey(c,a)]=i;
+  }
+
+  int addTri(int a, int b, int c)
+  {
+    tris_.push_back(Triangle());
+    setTri(tris_.size()-1, a, b, c);
+    return tris_.size()-1;
+  }
+
+  void unsetTri(int i)
+  {
+    const auto& t=tris_[i];
+    for (int j=0; j<3; j++)
+      edges_.erase(edgeKey(t[j], t[(j+1)%3]));
+  }
+
+  int triangleOf(int a, int b) const
+  {
+    auto i=edges_.find(edgeKey(a,b));
+    return i==edges_.end() ? -1 : i->second;
+  }
+
+  static int thirdVertex(const Triangle& t, int a, int b)
+  {
+    for (int j=0; j<3; j++)
+    {
+      if (t[j]!=a && t[j]!=b) return t[j];
+    }
+    return -1;
+  }
+
+  bool isConstraint(int a, int b) const
+  {
+    return constraints_.count(edgeKey(std::min(a,b), std::max(a,b)))>0;
+  }
+
+  /**
+   * flips the edge a-b, if the resulting triangles are valid
+   */
+  bool flip(int a, int b)
+  {
+    int t1=triangleOf(a, b), t2=triangleOf(b, a);
+    if (t1<0 || t2<0) return false;
+    int c=thirdVertex(tris_[t1], a, b);
+    int d=thirdVertex(tris_[t2], a, b);
+    if (collinear(a, d, c) || collinear(d, b, c)) return false;
+    if (orient2d(p_[a], p_[d], p_[c])<=0 || orient2d(p_[d], p_[b], p_[c])<=0) return false;
+    unsetTri(t1);
+    unsetTri(t2);
+    setTri(t1, a, d, c);
+    setTri(t2, d, b, c);
+    return true;
+  }
+
+  bool delaunayPass()
+  {
+    bool flipped=false;
+    for (size_t i=0; i<tris_.size(); i++)
+    {
+      for (int j=0; j<3; j++)
+      {
+        int a=tris_[i][j], b=tris_[i][(j+1)%3];
+        if (isConstraint(a, b)) continue;
+        int t2=triangleOf(b, a);
+        if (t2<0) continue;
+        int c=tris_[i][(j+2)%3];
+        int d=thirdVertex(tris_[t2], a, b);
+        if (inCircle(p_[a], p_[b], p_[c], p_[d]) && flip(a, b))
+        {
+          flipped=true;
+          break; // triangle i was modified
+        }
+      }
+    }
+    return flipped;
+  }
+
+  void makeDelaunay()
+  {
+    for (int pass=0; pass<100; pass++)
+    {
+      if (!delaunayPass()) break;
+    }
+  }
+
+  void insertPoint(int v)
+  {
+    const Point2& p=p_[v];
+    for (size_t i=0; i<tris_.size(); i++)
+    {
+      Triangle t=tris_[i];
+      int o[3];
+      for (int j=0; j<3; j++)
+        o[j]=orient2d(p_[t[j]], p_[t[(j+1)%3]], p);
+
+      if (o[0]>0 && o[1]>0 && o[2]>0)
+      {
+        unsetTri(i);
+        setTri(i, t[0], t[1], v);
+        addTri(t[1], t[2], v);
+        addTri(t[2], t[0], v);
+        return;
+      }
+
+      for (int j=0; j<3; j++)
+      {
+        if (o[j]==0 && o[(j+1)%3]>0 && o[(j+2)%3]>0)
+        {
+          // on edge a-b
+          int a=t[j], b=t[(j+1)%3], c=t[(j+2)%3];
+          int i2=triangleOf(b, a);
+          if (i2<0) throw Degenerate();
+          int d=thirdVertex(tris_[i2], a, b);
+          unsetTri(i);
+          unsetTri(i2);
+          setTri(i, a, v, c);
+          addTri(v, b, c);
+          setTri(i2, b, v, d);
+          addTri(v, a, d);
+          return;
+        }
+      }
+    }
+    throw Degenerate();
+  }
+
+  bool crosses(int u, int v, int a, int b) const
+  {
+    if (a==u || a==v || b==u || b==v) return false;
+    return orient2d(p_[u], p_[v], p_[a])*orient2d(p_[u], p_[v], p_[b]) < 0
+        && orient2d(p_[a], p_[b], p_[u])*orient2d(p_[a], p_[b], p_[v]) < 0;
+  }
+
+  void recoverConstraint(int u, int v)
+  {
+    for (int iter=0; iter<100+10*int(tris_.size()); iter++)
+    {
+      if (triangleOf(u, v)>=0 || triangleOf(v, u)>=0) return;
+
+      std::vector<std::pair<int,int> > crossing;
+      for (const auto& t: tris_)
+      {
+        for (int j=0; j<3; j++)
+        {
+          int a=t[j], b=t[(j+1)%3];
+          if (a<b && crosses(u, v, a, b))
+          {
+            if (isConstraint(a, b)) throw Degenerate(); // crossing constraints
+            crossing.push_back(std::make_pair(a, b));
+          }
+        }
+      }
+      if (crossing.empty()) throw Degenerate(); // passes through a vertex
+
+      bool flipped=false;
+      for (const auto& e: crossing)
+      {
+        if (triangleOf(e.first, e.second)>=0 && flip(e.first, e.second))
+          flipped=true;
+      }
+      if (!flipped) throw Degenerate();
+    }
+    throw Degenerate();
+  }
+
+public:
+  /**
+   * boundary: vertices along the triangle boundary, counter-clockwise,
+   * onEdge: the triangle edges, on which each boundary vertex lies
+   */
+  TriangleSplitter
+  (
+    const std::vector<Point2>& points,
+    const std::vector<int>& boundary,
+    const std::vector<unsigned>& onEdge,
+    const std::vector<int>& interior,
+    const std::vector<std::pair<int,int> >& constraints
+  )
+    : p_(points),
+      onEdge_(onEdge)
+  {
+    // the boundary polygon is convex, each vertex, which is not collinear
+    // with its neighbours, is an ear, unless the cut passes along a triangle edge.
+    // Cut off the best shaped first.
+    std::vector<int> poly(boundary);
+    while (poly.size()>3)
+    {
+      int n=poly.size(), best=-1;
+      double bestQ=-1.;
+      for (int i=0; i<n; i++)
+      {
+        int a=poly[(i+n-1)%n], b=poly[i], c=poly[(i+1)%n];
+        if (collinear(a, b, c)) continue;
+        // the new edge a-c must not pass through other boundary vertices
+        bool valid=true;
+        for (int j=0; j<n && valid; j++)
+        {
+          int x=poly[j];
+          if (x!=a && x!=b && x!=c && collinear(a, c, x)) valid=false;
+        }
+        if (!valid) continue;
+        const Point2 &pa=p_[a], &pb=p_[b], &pc=p_[c];
+        double area=(pb[0]-pa[0])*(pc[1]-pa[1]) - (pb[1]-pa[1])*(pc[0]-pa[0]);
+        double l2=0;
+        for (const auto& e: { std::make_pair(pa,pb), std::make_pair(pb,pc), std::make_pair(pc,pa) })
+          l2+=std::pow(e.first[0]-e.second[0], 2)+std::pow(e.first[1]-e.second[1], 2);
+        double q=area/std::max(l2, 1e-300);
+        if (q>bestQ)
+        {
+          bestQ=q;
+          best=i;
+        }
+      }
+      if (best<0) throw Degenerate();
+      addTri(poly[(best+n-1)%n], poly[best], poly[(best+1)%n]);
+      poly.erase(poly.begin()+best);
+    }
+    addTri(poly[0], poly[1], poly[2]);
+
+    for (int v: interior)
+      insertPoint(v);
+
+    makeDelaunay();
+
+    for (const auto& c: constraints)
+    {
+      recoverConstraint(c.first, c.second);
+      constraints_.insert(edgeKey(std::min(c.first,c.second), std::max(c.first,c.second)));
+    }
+
+    makeDelaunay();
+
+    for (const auto& t: tris_)
+    {
+      if (orient2d(p_[t[0]], p_[t[1]], p_[t[2]])<=0)
+        throw Degenerate();
+    }
+  }
+
+  const std::vector<Triangle>& triangles() const { return tris_; }
+};
+
+
+
+
+// ======== the boolean operation
+
+/**
+ * removes the connected parts of the surface, whose mean thickness (volume/area)
+ * is below minThickness, i.e. the slivers between coincident faces,
+ * which remain from the displacement of the tool
+ */
+void removeThinShells(TriSurface& s, double minThickness)
+{
+  const auto& tris=s.triangles();
+
+  std::unordered_map<std::uint64_t, std::vector<int> > edges;
+  for (size_t i=0; i<tris.size(); i++)
+  {
+    for (int j=0; j<3; j++)
+    {
+      int a=tris[i][j], b=tris[i][(j+1)%3];
+      edges[edgeKey(std::min(a,b), std::max(a,b))].push_back(i);
+    }
+  }
+
+  std::vector<bool> keep(tris.size(), false);
+  std::vector<bool> visited(tris.size(), false);
+  bool removed=false;
+  for (size_t seed=0; seed<tris.size(); seed++)
+  {
+    if (visited[seed]) continue;
+
+    std::vector<int> members, front(1, seed);
+    visited[seed]=true;
+    double volume=0., area=0.;
+    while (!front.empty())
+    {
+      int i=front.back();
+      front.pop_back();
+      members.push_back(i);
+      const Point &p0=s.points()[tris[i][0]], &p1=s.points()[tris[i][1]], &p2=s.points()[tris[i][2]];
+      volume+=( p0[0]*(p1[1]*p2[2]-p1[2]*p2[1])
+               +p0[1]*(p1[2]*p2[0]-p1[0]*p2[2])
+               +p0[2]*(p1[0]*p2[1]-p1[1]*p2[0]) )/6.;
+      area+=s.area(i);
+      for (int j=0; j<3; j++)
+      {
+        int a=tris[i][j], b=tris[i][(j+1)%3];
+        for (int n: edges[edgeKey(std::min(a,b), std::max(a,b))])
+        {
+          if (!visited[n])
+          {
+            visited[n]=true;
+            front.push_back(n);
+          }
+        }
+      }
+    }
+
+    bool thin = std::fabs(volume) < minThickness*area;
+    for (int i: members) keep[i]=!thin;
+    removed = removed || thin;
+  }
+
+  if (removed)
+  {
+    std::vector<Triangle> kept;
+    for (size_t i=0; i<tris.size(); i++)
+    {
+      if (keep[i]) kept.push_back(tris[i]);
+    }
+    s=TriSurface(s.points(), kept);
+    s.removeUnusedPoints();
+  }
+}
+
+
+class BooleanOperation
+{
+  const TriSurface &a_, &b_;
+  int nA_, nB_, mA_;
+
+  std::vector<Point> eventPoints_;
+  std::map<std::tuple<int,int,int>, int> eventIndex_;
+  std::vector<TriangleCut> cuts_;
+  std::unordered_map<std::uint64_t, std::vector<int> > edgeTriangles_; // undirected edge => triangles
+  std::set<std::uint64_t> segments_;
+
+  const Point& point(int v) const
+  {
+    if (v<nA_) return a_.points()[v];
+    else if (v<nA_+nB_) return b_.points()[v-nA_];
+    else return eventPoints_[v-nA_-nB_];
+  }
+
+  Triangle triangle(int t) const
+  {
+    if (t<mA_) return a_.triangles()[t];
+    const auto& bt=b_.triangles()[t-mA_];
+    return Triangle{{ bt[0]+nA_, bt[1]+nA_, bt[2]+nA_ }};
+  }
+
+  /**
+   * the vertex, where the edge v0-v1 crosses triangle t
+   */
+  int crossingVertex(int v0, int v1, int t)
+  {
+    int vmin=std::min(v0, v1), vmax=std::max(v0, v1);
+    auto key=std::make_tuple(vmin, vmax, t);
+    auto i=eventIndex_.find(key);
+    if (i!=eventIndex_.end()) return i->second;
+
+    Triangle tv=triangle(t);
+    const Point &p=point(vmin), &q=point(vmax);
+    const Point &t0=point(tv[0]), &t1=point(tv[1]), &t2=point(tv[2]);
+    double dp=orient3dValue(t0, t1, t2, p), dq=orient3dValue(t0, t1, t2, q);
+    double s=std::max(0., std::min(1., dp/(dp-dq)));
+
+    Point x;
+    for (int k=0; k<3; k++) x[k]=p[k]+s*(q[k]-p[k]);
+    int v=nA_+nB_+eventPoints_.size();
+    eventPoints_.push_back(x);
+    eventIndex_[key]=v;
+
+    cuts_[t].interiorPoints.push_back(v);
+    for (int et: edgeTriangles_[edgeKey(vmin, vmax)])
+    {
+      Triangle ev=triangle(et);
+      for (int j=0; j<3; j++)
+      {
+        if (ev[j]==vmin && ev[(j+1)%3]==vmax)
+          cuts_[et].edgePoints[j].push_back(EdgePoint{s, v});
+        else if (ev[j]==vmax && ev[(j+1)%3]==vmin)
+          cuts_[et].edgePoints[j].push_back(EdgePoint{1.-s, v});
+      }
+    }
+
+    return v;
+  }
+
+  void intersectPair(int ta, int tb)
+  {
+    Triangle va=triangle(ta), vb=triangle(tb);
+
+    // quick rejection: all vertices on one side of the other plane
+    for (int pass=0; pass<2; pass++)
+    {
+      const Triangle &t=pass==0?va:vb, &o=pass==0?vb:va;
+      int pos=0, neg=0;
+      for (int j=0; j<3; j++)
+      {
+        int s=orient3d(point(t[0]), point(t[1]), point(t[2]), point(o[j]));
+        if (s>0) pos++;
+        if (s<0) neg++;
+      }
+      if (pos==3 || neg==3) return;
+    }
+
+    std::vector<int> ev;
+    for (int pass=0; pass<2; pass++)
+    {
+      const Triangle &e=pass==0?va:vb, &t=pass==0?vb:va;
+      int ot=pass==0?tb:ta;
+      for (int j=0; j<3; j++)
+      {
+        auto r=intersect(
+              point(e[j]), point(e[(j+1)%3]),
+              point(t[0]), point(t[1]), point(t[2])
+            );
+        if (r==Touching)
+          throw Degenerate();
+        else if (r==Yes)
+          ev.push_back(crossingVertex(e[j], e[(j+1)%3], ot));
+      }
+    }
+
+    if (ev.empty()) return;
+    if (ev.size()!=2 || ev[0]==ev[1]) throw Degenerate();
+
+    auto seg=std::make_pair(ev[0], ev[1]);
+    cuts_[ta].segments.push_back(seg);
+    cuts_[tb].segments.push_back(seg);
+    segments_.insert(edgeKey(std::min(ev[0],ev[1]), std::max(ev[0],ev[1])));
+  }
+
+  void retriangulate(int t, std::vector<Triangle>& result) const
+  {
+    const TriangleCut& cut=cuts_[t];
+    Triangle tv=triangle(t);
+    if (cut.empty())
+    {
+      result.push_back(tv);
+      return;
+    }
+
+    int ax, ay;
+    projectionAxes(point(tv[0]), point(tv[1]), point(tv[2]), ax, ay);
+
+    std::vector<int> global;
+    std::map<int,int> local;
+    std::vector<Point2> pts;
+    std::vector<unsigned> onEdge;
+    auto addVertex = [&](int v, unsigned edges)
+    {
+      local[v]=global.size();
+      global.push_back(v);
+      pts.push_back(project(point(v), ax, ay));
+      onEdge.push_back(edges);
+      return global.size()-1;
+    };
+
+    std::vector<int> boundary;
+    for (int j=0; j<3; j++)
+    {
+      boundary.push_back(addVertex(tv[j], (1u<<j) | (1u<<((j+2)%3)) ));
+      auto ep=cut.edgePoints[j];
+      std::sort(ep.begin(), ep.end(),
+                [](const EdgePoint& x, const EdgePoint& y) { return x.t<y.t; } );
+      for (size_t i=0; i<ep.size(); i++)
+      {
+        if (i>0 && !(ep[i-1].t<ep[i].t)) throw Degenerate();
+        boundary.push_back(addVertex(ep[i].vertex, 1u<<j));
+      }
+    }
+
+    std::vector<int> interior;
+    for (int v: cut.interiorPoints)
+      interior.push_back(addVertex(v, 0));
+
+    std::vector<std::pair<int,int> > constraints;
+    for (const auto& s: cut.segments)
+      constraints.push_back(std::make_pair(local.at(s.first), local.at(s.second)));
+
+    TriangleSplitter ts(pts, boundary, onEdge, interior, constraints);
+    for (const auto& lt: ts.triangles())
+      result.push_back(Triangle{{ global[lt[0]], global[lt[1]], global[lt[2]] }});
+  }
+
+  /**
+   * whether p is inside the closed surface s
+   */
+  bool isInside(const Point& p, const TriangleTree& tree, const TriSurface& s, int ofs, double length, std::mt19937& gen) const
+  {
+    std::normal_distribution<double> nd;
+    for (int attempt=0; attempt<20; attempt++)
+    {
+      Point d{{nd(gen), nd(gen), nd(gen)}};
+      double l=std::sqrt(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]);
+      if (l==0.) continue;
+      Point q;
+      for (int k=0; k<3; k++) q[k]=p[k]+length*d[k]/l;
+
+      int n=0;
+      bool degenerate=false;
+      tree.traverse(
+            [&](const Box& b) { return !degenerate && b.overlaps(p, q); },
+            [&](int t)
+            {
+              const auto& tv=s.triangles()[t];
+              auto r=intersect(p, q, point(tv[0]+ofs), point(tv[1]+ofs), point(tv[2]+ofs));
+              if (r==Yes) n++;
+              else if (r==Touching) degenerate=true;
+            }
+      );
+      if (!degenerate) return (n%2)==1;
+    }
+    throw Degenerate();
+  }
+
+  /**
+   * splits the triangles into the connected parts, which are bounded by the intersection curve,
+   * and determines for each triangle, whether it is inside the other surface
+   */
+  std::vector<bool> classify
+  (
+    const std::vector<Triangle>& tris,
+    const TriangleTree& otherTree, const TriSurface& other, int otherOfs,
+    double length, std::mt19937& gen
+  ) const
+  {
+    std::unordered_map<std::uint64_t, std::vector<int> > edges;
+    for (size_t i=0; i<tris.size(); i++)
+    {
+      for (int j=0; j<3; j++)
+      {
+        int a=tris[i][j], b=tris[i][(j+1)%3];
+        edges[edgeKey(std::min(a,b), std::max(a,b))].push_back(i);
+      }
+    }
+
+    std::vector<int> component(tris.size(), -1);
+    std::vector<bool> inside(tris.size(), false);
+    for (size_t seed=0; seed<tris.size(); seed++)
+    {
+      if (component[seed]>=0) continue;
+
+      std::vector<int> members, front(1, seed);
+      component[seed]=seed;
+      while (!front.empty())
+      {
+        int i=front.back();
+        front.pop_back();
+        members.push_back(i);
+        for (int j=0; j<3; j++)
+        {
+          int a=tris[i][j], b=tris[i][(j+1)%3];
+          auto k=edgeKey(std::min(a,b), std::max(a,b));
+          if (segments_.count(k)) continue;
+          for (int n: edges[k])
+          {
+            if (component[n]<0)
+            {
+              component[n]=seed;
+              front.push_back(n);
+            }
+          }
+        }
+      }
+
+      // probe from the center of the largest triangle
+      int probe=-1;
+      double maxArea=-1;
+      for (int i: members)
+      {
+        const Point &p0=point(tris[i][0]), &p1=point(tris[i][1]), &p2=point(tris[i][2]);
+        Point n{{
+            (p1[1]-p0[1])*(p2[2]-p0[2]) - (p1[2]-p0[2])*(p2[1]-p0[1]),
+            (p1[2]-p0[2])*(p2[0]-p0[0]) - (p1[0]-p0[0])*(p2[2]-p0[2]),
+            (p1[0]-p0[0])*(p2[1]-p0[1]) - (p1[1]-p0[1])*(p2[0]-p0[0])
+          }};
+        double a=n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
+        if (a>maxArea)
+        {
+          maxArea=a;
+          probe=i;
+        }
+      }
+      Point c;
+      for (int k=0; k<3; k++)
+        c[k]=( point(tris[probe][0])[k] + point(tris[probe][1])[k] + point(tris[probe][2])[k] )/3.;
+
+      bool in=isInside(c, otherTree, other, otherOfs, length, gen);
+      for (int i: members) inside[i]=in;
+    }
+
+    return inside;
+  }
+
+  /**
+   * moves the points of the displaced tool back and recomputes the intersection points
+   * from the original edges and triangles. If an edge lies in the plane of the triangle,
+   * the intersection point is moved along with the surface of the edge
+   * and snapped to a nearby vertex of the edge or triangle.
+   */
+  void restoreOriginalTool(std::vector<Point>& pts, const Point& toolDisplacement) const
+  {
+    for (int i=nA_; i<nA_+nB_; i++)
+    {
+      for (int k=0; k<3; k++) pts[i][k]-=toolDisplacement[k];
+    }
+
+    double tol=0.;
+    for (int k=0; k<3; k++) tol+=toolDisplacement[k]*toolDisplacement[k];
+    tol=2.*std::sqrt(tol);
+
+    for (const auto& e: eventIndex_)
+    {
+      int vmin=std::get<0>(e.first), vmax=std::get<1>(e.first);
+      Triangle tv=triangle(std::get<2>(e.first));
+      Point& x=pts[e.second];
+
+      const Point &p=pts[vmin], &q=pts[vmax];
+      double dp=orient3dValue(pts[tv[0]], pts[tv[1]], pts[tv[2]], p);
+      double dq=orient3dValue(pts[tv[0]], pts[tv[1]], pts[tv[2]], q);
+      if ( dp!=dq && ( (dp<=0. && dq>=0.) || (dp>=0. && dq<=0.) ) )
+      {
+        double s=dp/(dp-dq);
+        for (int k=0; k<3; k++) x[k]=p[k]+s*(q[k]-p[k]);
+      }
+      else
+      {
+        if (vmin>=nA_)
+        {
+          for (int k=0; k<3; k++) x[k]-=toolDisplacement[k];
+        }
+        double dmin=tol;
+        for (int c: {vmin, vmax, tv[0], tv[1], tv[2]})
+        {
+          double d=0.;
+          for (int k=0; k<3; k++) d+=std::pow(pts[c][k]-x[k], 2);
+          d=std::sqrt(d);
+          if (d<dmin)
+          {
+            dmin=d;
+            x=pts[c];
+          }
+        }
+      }
+    }
+  }
+
+public:
+  TriSurface result;
+  int nIntersectionEdges;
+
+  /**
+   * toolDisplacement: the translation, by which b was displaced from the original tool.
+   * The points of the result are moved back by it.
+   */
+  BooleanOperation(const TriSurface& a, const TriSurface& b, TriSurfaceBoolean::Operation op, const Point& toolDisplacement)
+    : a_(a), b_(b),
+      nA_(a.points().size()),
+      nB_(b.points().size()),
+      mA_(a.triangles().size())
+  {
+    int mB=b.triangles().size();
+    cuts_.resize(mA_+mB);
+
+    for (int t=0; t<mA_+mB; t++)
+    {
+      Triangle tv=triangle(t);
+      for (int j=0; j<3; j++)
+      {
+        int v0=tv[j], v1=tv[(j+1)%3];
+        edgeTriangles_[edgeKey(std::min(v0,v1), std::max(v0,v1))].push_back(t);
+      }
+    }
+
+    TriangleTree treeA(a), treeB(b);
+
+    // intersection curve
+    for (int ta=0; ta<mA_; ta++)
+    {
+      const Box& ba=treeA.box(ta);
+      treeB.traverse(
+            [&](const Box& bb) { return ba.overlaps(bb); },
+            [&](int tb) { intersectPair(ta, tb+mA_); }
+      );
+    }
+    nIntersectionEdges=segments_.size();
+
+    // split the intersected triangles
+    std::vector<Triangle> trisA, trisB;
+    for (int t=0; t<mA_; t++) retriangulate(t, trisA);
+    for (int t=mA_; t<mA_+mB; t++) retriangulate(t, trisB);
+
+    Box bb;
+    for (const auto& p: a.points()) bb.extend(p);
+    for (const auto& p: b.points()) bb.extend(p);
+    double diag=0;
+    for (int k=0; k<3; k++) diag+=std::pow(bb.max[k]-bb.min[k], 2);
+    double length=4.*std::sqrt(diag) + 1.;
+
+    std::mt19937 gen(4711);
+    auto insideA=classify(trisA, treeB, b, nA_, length, gen);
+    auto insideB=classify(trisB, treeA, a, 0, length, gen);
+
+    // assemble
+    std::vector<Point> pts(a.points());
+    pts.insert(pts.end(), b.points().begin(), b.points().end());
+    pts.insert(pts.end(), eventPoints_.begin(), eventPoints_.end());
+
+    if (toolDisplacement!=Point{{0., 0., 0.}})
+    {
+      restoreOriginalTool(pts, toolDisplacement);
+    }
+
+    std::vector<Triangle> res;
+    bool keepAInside = (op==TriSurfaceBoolean::Intersect);
+    bool keepBInside = (op!=TriSurfaceBoolean::Union);
+    for (size_t i=0; i<trisA.size(); i++)
+    {
+      if (insideA[i]==keepAInside) res.push_back(trisA[i]);
+    }
+    for (size_t i=0; i<trisB.size(); i++)
+    {
+      if (insideB[i]==keepBInside)
+      {
+        if (op==TriSurfaceBoolean::Subtract)
+          res.push_back(Triangle{{trisB[i][0], trisB[i][2], trisB[i][1]}});
+        else
+          res.push_back(trisB[i]);
+      }
+    }
+
+    result=TriSurface(pts, res);
+    result.removeUnusedPoints();
+    if (!result.isClosed()) throw Degenerate();
+  }
+};
+
+
+}
+
+
+
+
+void TriSurfaceBoolean::compute(const TriSurface& object, const TriSurface& tool, Operation op, const TriSurface::Point& toolDisplacement)
+{
+  BooleanOperation bo(object, tool, op, toolDisplacement);
+  result_=bo.result;
+  nIntersectionEdges_=bo.nIntersectionEdges;
+}
+
+
+
+
+TriSurfaceBoolean::TriSurfaceBoolean(const TriSurface& object, const TriSurface& tool, Operation op)
+  : nIntersectionEdges_(0),
+    nPerturbations_(0)
+{
+  if (!object.isClosed())
+    throw insight::Exception("TriSurfaceBoolean: the object surface is not closed!");
+  if (!tool.isClosed())
+    throw insight::Exception("TriSurfaceBoolean: the tool surface is not closed!");
+
+  Point bmin, bmax;
+  tool.bounds(bmin, bmax);
+  double diag=0;
+  for (int k=0; k<3; k++) diag+=std::pow(bmax[k]-bmin[k], 2);
+  diag=std::sqrt(diag);
+
+  const int maxPerturbations=5;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> ud(-1., 1.);
+
+  TriSurface t(tool);
+  Point displacement{{0., 0., 0.}};
+  for (;;)
+  {
+    try
+    {
+      compute(object, t, op, displacement);
+      if (nPerturbations_>0)
+      {
+        // coincident faces leave slivers of about the thickness of the displacement
+        double d=std::sqrt(displacement[0]*displacement[0]+displacement[1]*displacement[1]+displacement[2]*displacement[2]);
+        removeThinShells(result_, 2.*d);
+      }
+      return;
+    }
+    catch (const Degenerate&)
+    {
+      if (nPerturbations_>=maxPerturbations)
+        throw insight::Exception(
+            "TriSurfaceBoolean: could not resolve degenerate configuration of the surfaces"
+            " (self-intersecting input?)");
+    }
+
+    // displace the tool slightly and retry
+    nPerturbations_++;
+    t=tool;
+    double d=1e-6*diag*nPerturbations_;
+    displacement=Point{{d*ud(gen), d*ud(gen), d*ud(gen)}};
+    t.translate(displacement);
+  }
+}
+
+
+
+
+}
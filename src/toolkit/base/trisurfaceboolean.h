@@ -0,0 +1,89 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef INSIGHT_TRISURFACEBOOLEAN_H
+#define INSIGHT_TRISURFACEBOOLEAN_H
+
+#include "base/trisurface.h"
+
+namespace insight
+{
+
+
+
+
+/**
+ * Boolean operation between two closed triangulated surfaces.
+ *
+ * The intersection curve is computed with exact orientation predicates.
+ * Its vertices are identified symbolically by the edge of one surface
+ * and the triangle of the other surface, which it crosses.
+ * Both surfaces share these vertices, so the result is watertight.
+ * The intersected triangles are retriangulated with the intersection segments
+ * as constraints and the parts of the surfaces are selected by ray casting.
+ *
+ * Degenerate configurations (coplanar faces, vertices on faces of the other surface)
+ * are resolved by retrying with a slightly displaced tool surface.
+ * The result is then mapped back to the original tool: its points are displaced back
+ * and the intersection points are recomputed from the original edges and triangles
+ * (or snapped to a nearby vertex, where an edge lies in the plane of the triangle).
+ * Parts of the result, which are thinner than the displacement
+ * (the slivers between coincident faces), are removed.
+ */
+class TriSurfaceBoolean
+{
+public:
+  enum Operation { Union, Subtract, Intersect };
+
+protected:
+  TriSurface result_;
+  int nIntersectionEdges_;
+  int nPerturbations_;
+
+  void compute(const TriSurface& object, const TriSurface& tool, Operation op, const TriSurface::Point& toolDisplacement);
+
+public:
+  /**
+   * computes object <op> tool.
+   * Both surfaces have to be closed.
+   */
+  TriSurfaceBoolean(const TriSurface& object, const TriSurface& tool, Operation op);
+
+  inline const TriSurface& result() const { return result_; }
+
+  /**
+   * number of segments of the intersection curve
+   */
+  inline int nIntersectionEdges() const { return nIntersectionEdges_; }
+
+  /**
+   * number of retries with displaced tool surface,
+   * which were needed to resolve degenerate configurations
+   */
+  inline int nPerturbations() const { return nPerturbations_; }
+};
+
+
+
+
+}
+
+#endif // INSIGHT_TRISURFACEBOOLEAN_H
@@ -214,7 +214,8 @@ MinMax calcRange(
 
 std::set<vtkDataObject*> MultiBlockDataSetExtractor::findObjectsBelowGroup(const std::string& name_pattern, vtkDataObject* input)
 {
-  insight::CurrentExceptionContext ex("searching for groups with names matching \""+name_pattern+"\"");
+  insight::CurrentExceptionContext ex(
+        [&]() { return "searching for groups with names matching \""+name_pattern+"\""; } );
 
   std::set<vtkDataObject*> res;
 
@@ -21,6 +21,8 @@
 #include "vtktools.h"
 
 #include <iostream>
+#include <cstdint>
+#include <cstring>
 #include "boost/foreach.hpp"
 
 #include "base/exception.h"
@@ -37,6 +39,186 @@ namespace insight
 namespace vtk
 {
 
+
+
+
+bool isLittleEndian()
+{
+  const uint16_t one=1;
+  return *reinterpret_cast<const uint8_t*>(&one)==1;
+}
+
+
+/**
+ * legacy binary VTK files are big endian
+ */
+template<class T, class S>
+void writeLegacyBinary(std::ostream& os, const S* data, size_t n)
+{
+  static_assert(sizeof(T)==4, "only 4-byte types are supported");
+
+  bool swap=isLittleEndian();
+  std::vector<char> buf(n*sizeof(T));
+  for (size_t i=0; i<n; i++)
+  {
+    T v=static_cast<T>(data[i]);
+    char *b=&buf[i*sizeof(T)];
+    memcpy(b, &v, sizeof(T));
+    if (swap)
+    {
+      std::swap(b[0], b[3]);
+      std::swap(b[1], b[2]);
+    }
+  }
+  os.write(buf.data(), buf.size());
+  os << '\n';
+}
+
+
+void writeLegacyValues(std::ostream& os, const std::vector<double>& v, int nPerLine, bool binary)
+{
+  if (binary)
+  {
+    writeLegacyBinary<float>(os, v.data(), v.size());
+  }
+  else
+  {
+    for (size_t i=0; i<v.size(); i++)
+    {
+      os << v[i] << ( ((i+1)%nPerLine==0) ? '\n' : ' ' );
+    }
+  }
+}
+
+
+void writeLegacyFields(std::ostream& os, const FieldList& fl, bool binary)
+{
+  for (const FieldList::value_type& f: fl)
+  {
+    const DataField& df=f.second;
+    if (df.nComponents==1)
+    {
+      os<<"SCALARS "<<f.first<<" float 1\n";
+      os<<"LOOKUP_TABLE default\n";
+      writeLegacyValues(os, df.values, 1, binary);
+    }
+    else if (df.nComponents==3)
+    {
+      os<<"VECTORS "<<f.first<<" float\n";
+      writeLegacyValues(os, df.values, 3, binary);
+    }
+    else if (df.nComponents==9)
+    {
+      os<<"TENSORS "<<f.first<<" float\n";
+      writeLegacyValues(os, df.values, 3, binary);
+    }
+  }
+}
+
+
+
+
+/**
+ * collects the raw data blocks of a VTK XML file
+ * and hands out their offsets into the appended data section
+ */
+class XMLAppendedData
+{
+  struct Block
+  {
+    const char* data;
+    uint64_t nbytes;
+  };
+
+  std::vector<Block> blocks_;
+  uint64_t offset_=0;
+
+public:
+  void dataArray
+  (
+      std::ostream& os,
+      const std::string& type, const std::string& name, int nComponents,
+      const void* data, uint64_t nbytes
+  )
+  {
+    os << "<DataArray type=\"" << type << "\"";
+    if (!name.empty()) os << " Name=\"" << name << "\"";
+    os << " NumberOfComponents=\"" << nComponents << "\""
+       << " format=\"appended\" offset=\"" << offset_ << "\"/>\n";
+
+    blocks_.push_back( Block{ static_cast<const char*>(data), nbytes } );
+    offset_ += sizeof(uint64_t) + nbytes;
+  }
+
+  void dataArray(std::ostream& os, const std::string& name, const DataField& df)
+  {
+    dataArray(os, "Float64", name, df.nComponents, df.values.data(), df.values.size()*sizeof(double));
+  }
+
+  void write(std::ostream& os) const
+  {
+    os << "<AppendedData encoding=\"raw\">\n_";
+    for (const Block& b: blocks_)
+    {
+      os.write(reinterpret_cast<const char*>(&b.nbytes), sizeof(uint64_t));
+      os.write(b.data, b.nbytes);
+    }
+    os << "\n</AppendedData>\n";
+  }
+};
+
+
+
+
+void CellConnectivity::append(int nc, const int ci[])
+{
+  connectivity_.insert(connectivity_.end(), ci, ci+nc);
+  offsets_.push_back(connectivity_.size());
+}
+
+
+void CellConnectivity::writeLegacy(std::ostream& os, const string& keyword, bool binary) const
+{
+  os << keyword << " " << offsets_.size() << " " << legacySize() << '\n';
+
+  std::vector<int> cl;
+  cl.reserve(legacySize());
+  size_t j0=0;
+  for (size_t i=0; i<offsets_.size(); i++)
+  {
+    size_t j1=offsets_[i];
+    cl.push_back(j1-j0);
+    cl.insert(cl.end(), connectivity_.begin()+j0, connectivity_.begin()+j1);
+    j0=j1;
+  }
+
+  if (binary)
+  {
+    writeLegacyBinary<int32_t>(os, cl.data(), cl.size());
+  }
+  else
+  {
+    size_t k=0;
+    for (size_t i=0; i<offsets_.size(); i++)
+    {
+      int n=cl[k++];
+      os<<n;
+      for (int j=0; j<n; j++) os<<' '<<cl[k++];
+      os<<'\n';
+    }
+  }
+}
+
+
+void CellConnectivity::writeXML(std::ostream& os, XMLAppendedData& ad) const
+{
+  ad.dataArray(os, "Int32", "connectivity", 1, connectivity_.data(), connectivity_.size()*sizeof(int));
+  ad.dataArray(os, "Int32", "offsets", 1, offsets_.data(), offsets_.size()*sizeof(int));
+}
+
+
+
+
 vtkModel::vtkModel()
 {
 }
@@ -47,55 +229,114 @@ vtkModel::~vtkModel()
 
 void vtkModel::setPoints(int npts, const double* x, const double* y, const double* z)
 {
+  pts_.reserve(pts_.size()+3*npts);
   for (int i=0; i<npts; i++)
   {
-    pts_.push_back(vec3(x[i], y[i], z[i]));
+    pts_.push_back(x[i]);
+    pts_.push_back(y[i]);
+    pts_.push_back(z[i]);
+  }
+}
+
+
+void vtkModel::setField(FieldList& fl, const string& name, size_t n, int ncmpt, const double* const cmpts[])
+{
+  DataField& f = fl[name];
+  f.nComponents=ncmpt;
+  f.values.resize(n*ncmpt);
+  for (size_t i=0; i<n; i++)
+  {
+    for (int c=0; c<ncmpt; c++)
+    {
+      f.values[i*ncmpt+c]=cmpts[c][i];
+    }
   }
 }
 
 
 void vtkModel::appendPointScalarField(const std::string& name, const double v[])
 {
-  pointScalarFields_[name]=ScalarField(v, v+pts_.size());
+  const double* c[]={v};
+  setField(pointFields_, name, nPoints(), 1, c);
 }
 
 void vtkModel::appendPointVectorField(const std::string& name, const double x[], const double y[], const double z[])
 {
-  //cout<<"Append PointVectorField "<<name<<" to VTK"<<endl;
-  pointVectorFields_[name]=VectorField();
-  VectorField& vf = pointVectorFields_[name];
-  for (size_t i=0; i<pts_.size(); i++)
-  {
-    //cout<<i<<" "<<x[i]<<" "<<y[i]<<" "<<z[i]<<endl;
-    vf.push_back(vec3(x[i], y[i], z[i]));
-  }  
+  const double* c[]={x, y, z};
+  setField(pointFields_, name, nPoints(), 3, c);
 }
 
 void vtkModel::appendPointTensorField(const string& name, const double xx[], const double xy[], const double xz[], const double yx[], const double yy[], const double yz[], const double zx[], const double zy[], const double zz[])
 {
-  //cout<<"Append PointVectorField "<<name<<" to VTK"<<endl;
-  pointVectorFields_[name]=VectorField();
-  VectorField& vf = pointVectorFields_[name];
-  for (size_t i=0; i<pts_.size(); i++)
-  {
-    //cout<<i<<" "<<x[i]<<" "<<y[i]<<" "<<z[i]<<endl;
-    vf.push_back(tensor3(xx[i], xy[i], xz[i], yx[i], yy[i], yz[i], zx[i], zy[i], zz[i]));
-  }  
+  const double* c[]={xx, xy, xz, yx, yy, yz, zx, zy, zz};
+  setField(pointFields_, name, nPoints(), 9, c);
 }
 
 
+size_t vtkModel::nCells() const
+{
+  return 0;
+}
 
-void vtkModel::writeGeometryToLegacyFile(std::ostream& os) const
+std::string vtkModel::legacyDataSetType() const
 {
-  os << "POINTS "<<pts_.size()<<" float"<<endl;
-  for (const arma::mat& p: pts_)
+  return "POLYDATA";
+}
+
+void vtkModel::writeCellsToLegacyFile(ostream&, bool) const
+{}
+
+std::string vtkModel::xmlDataSetType() const
+{
+  return "PolyData";
+}
+
+std::string vtkModel::xmlPieceAttributes() const
+{
+  return str(boost::format(
+      "NumberOfPoints=\"%d\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\""
+        ) % nPoints() );
+}
+
+void vtkModel::writeCellsToXMLFile(ostream&, XMLAppendedData&) const
+{}
+
+
+
+void vtkModel::writeGeometryToLegacyFile(std::ostream& os, bool binary) const
+{
+  os << "POINTS "<<nPoints()<<" float\n";
+  writeLegacyValues(os, pts_, 3, binary);
+  writeCellsToLegacyFile(os, binary);
+}
+
+
+void vtkModel::writeDataToLegacyFile(std::ostream& os, bool binary) const
+{
+  os<<"POINT_DATA "<<nPoints()<<'\n';
+  writeLegacyFields(os, pointFields_, binary);
+
+  if (cellFields_.size()>0)
   {
-    os << p(0)<<" "<<p(1)<<" "<<p(2)<<endl;
-  }  
+    os<<"CELL_DATA "<<nCells()<<'\n';
+    writeLegacyFields(os, cellFields_, binary);
+  }
+}
+
+
+void vtkModel::writeLegacyFile(std::ostream& os, bool binary) const
+{
+  os << "# vtk DataFile Version 2.0\n";
+  os << "InsightCAE vtkModel\n";
+  os << (binary ? "BINARY" : "ASCII") << '\n';
+  os << "DATASET " << legacyDataSetType() << '\n';
+  writeGeometryToLegacyFile(os, binary);
+  writeDataToLegacyFile(os, binary);
+  os.flush();
 }
 
 
-void vtkModel::createLegacyFile(const boost::filesystem::path& fn, bool create_dir) const
+void vtkModel::createLegacyFile(const boost::filesystem::path& fn, bool create_dir, bool binary) const
 {
     if (create_dir)
     {
@@ -104,12 +345,75 @@ void vtkModel::createLegacyFile(const boost::filesystem::path& fn, bool create_d
     }
     
     std::cout<<"Writing to "<<fn<<std::endl;
-    std::ofstream f(fn.c_str());
-    writeLegacyFile(f);
+    std::ofstream f(fn.c_str(), binary ? std::ios::out|std::ios::binary : std::ios::out);
+    writeLegacyFile(f, binary);
     f.close();
 }
 
 
+void vtkModel::writeXMLFile(std::ostream& os) const
+{
+  XMLAppendedData ad;
+  std::string dst=xmlDataSetType();
+
+  os << "<?xml version=\"1.0\"?>\n"
+     << "<VTKFile type=\"" << dst << "\" version=\"1.0\""
+        " byte_order=\"" << (isLittleEndian() ? "LittleEndian" : "BigEndian") << "\""
+        " header_type=\"UInt64\">\n"
+     << "<" << dst << ">\n"
+     << "<Piece " << xmlPieceAttributes() << ">\n";
+
+  os << "<PointData>\n";
+  for (const FieldList::value_type& f: pointFields_)
+    ad.dataArray(os, f.first, f.second);
+  os << "</PointData>\n";
+
+  os << "<CellData>\n";
+  for (const FieldList::value_type& f: cellFields_)
+    ad.dataArray(os, f.first, f.second);
+  os << "</CellData>\n";
+
+  os << "<Points>\n";
+  ad.dataArray(os, "Float64", "Points", 3, pts_.data(), pts_.size()*sizeof(double));
+  os << "</Points>\n";
+
+  writeCellsToXMLFile(os, ad);
+
+  os << "</Piece>\n"
+     << "</" << dst << ">\n";
+
+  ad.write(os);
+
+  os << "</VTKFile>\n";
+  os.flush();
+}
+
+
+void vtkModel::createXMLFile(const boost::filesystem::path& fn, bool create_dir) const
+{
+    if (create_dir)
+    {
+        if (!boost::filesystem::exists(fn.parent_path()))
+            boost::filesystem::create_directories(fn.parent_path());
+    }
+
+    std::cout<<"Writing to "<<fn<<std::endl;
+    std::ofstream f(fn.c_str(), std::ios::out|std::ios::binary);
+    writeXMLFile(f);
+    f.close();
+}
+
+
+void vtkModel::createFile(const boost::filesystem::path& fn, bool create_dir) const
+{
+  std::string ext=boost::algorithm::to_lower_copy(fn.extension().string());
+  if ( ext==".vtp" || ext==".vtu" )
+    createXMLFile(fn, create_dir);
+  else
+    createLegacyFile(fn, create_dir, true);
+}
+
+
 
 
 vtkUnstructuredGridModel::vtkUnstructuredGridModel()
@@ -118,64 +422,97 @@ vtkUnstructuredGridModel::vtkUnstructuredGridModel()
 
 void vtkUnstructuredGridModel::appendCell(int nc, const int ci[], int type)
 {
-  cells_.push_back( Cell(Polygon(ci, ci+nc), type) );
+  cells_.append(nc, ci);
+  cellTypes_.push_back(static_cast<unsigned char>(type));
 }
 
 int vtkUnstructuredGridModel::nCellPts() const
 {
-  int n=0;
-  for (const Cell& c: cells_)
-  {
-    n+=std::get<0>(c).size()+1;
-  }
-  return n;
+  return cells_.legacySize();
 }
 
-void vtkUnstructuredGridModel::writeLegacyFile(std::ostream& os) const
+size_t vtkUnstructuredGridModel::nCells() const
 {
-  os << "# vtk DataFile Version 2.0" << endl;
-  os << "vtkUnstructuredGridModel" << endl;
-  os << "ASCII" <<endl;
-  os << "DATASET UNSTRUCTURED_GRID"<<endl;
-  writeGeometryToLegacyFile(os);
-  os<<"CELLS "<<cells_.size()<<" "<<nCellPts()<<endl;
-  for (const Cell& c: cells_)
+  return cells_.size();
+}
+
+std::string vtkUnstructuredGridModel::legacyDataSetType() const
+{
+  return "UNSTRUCTURED_GRID";
+}
+
+void vtkUnstructuredGridModel::writeCellsToLegacyFile(std::ostream& os, bool binary) const
+{
+  cells_.writeLegacy(os, "CELLS", binary);
+
+  os<<"CELL_TYPES "<<cellTypes_.size()<<'\n';
+  if (binary)
   {
-    const Polygon& p = std::get<0>(c);
-    os<<p.size();
-    for (const int& i: p)
-    {
-      os<<" "<<i;
-    }
-    os<<endl;
+    writeLegacyBinary<int32_t>(os, cellTypes_.data(), cellTypes_.size());
   }
-  os<<"CELL_TYPES "<<cells_.size()<<endl;
-  for (const Cell& c: cells_)
+  else
   {
-    os<<std::get<1>(c)<<endl;
+    for (unsigned char t: cellTypes_)
+    {
+      os<<int(t)<<'\n';
+    }
   }
-  writeDataToLegacyFile(os);
 }
 
-void vtkModel2d::appendCellScalarField(const std::string& name, const double s[])
+std::string vtkUnstructuredGridModel::xmlDataSetType() const
 {
-  cellScalarFields_[name]=ScalarField();
-  ScalarField& vf = cellScalarFields_[name];
-  for (size_t i=0; i<poly_.size(); i++)
-  {
-    vf.push_back(s[i]);
-  }  
+  return "UnstructuredGrid";
+}
+
+std::string vtkUnstructuredGridModel::xmlPieceAttributes() const
+{
+  return str(boost::format("NumberOfPoints=\"%d\" NumberOfCells=\"%d\"") % nPoints() % nCells() );
+}
+
+void vtkUnstructuredGridModel::writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const
+{
+  os << "<Cells>\n";
+  cells_.writeXML(os, ad);
+  ad.dataArray(os, "UInt8", "types", 1, cellTypes_.data(), cellTypes_.size());
+  os << "</Cells>\n";
+}
+
+
+
+
+vtkModel2d::vtkModel2d()
+{
+}
+
+vtkModel2d::~vtkModel2d()
+{
+}
+
+void vtkModel2d::appendPolygon(int nc, const int ci[])
+{
+  poly_.append(nc, ci);
 }
 
+int vtkModel2d::nPolyPts() const
+{
+  return poly_.legacySize();
+}
+
+size_t vtkModel2d::nCells() const
+{
+  return poly_.size();
+}
+
+void vtkModel2d::appendCellScalarField(const std::string& name, const double s[])
+{
+  const double* c[]={s};
+  setField(cellFields_, name, nCells(), 1, c);
+}
 
 void vtkModel2d::appendCellVectorField(const std::string& name, const double x[], const double y[], const double z[])
 {
-  cellVectorFields_[name]=VectorField();
-  VectorField& vf = cellVectorFields_[name];
-  for (size_t i=0; i<poly_.size(); i++)
-  {
-    vf.push_back(vec3(x[i], y[i], z[i]));
-  }  
+  const double* c[]={x, y, z};
+  setField(cellFields_, name, nCells(), 3, c);
 }
 
 void vtkModel2d::appendCellTensorField(const std::string& name, 
@@ -184,148 +521,66 @@ void vtkModel2d::appendCellTensorField(const std::string& name,
 			    const double zx[], const double zy[], const double zz[]
 			  )
 {
-  cellVectorFields_[name]=VectorField();
-  VectorField& vf = cellVectorFields_[name];
-  for (size_t i=0; i<poly_.size(); i++)
-  {
-    vf.push_back(tensor3(xx[i], xy[i], xz[i], yx[i], yy[i], yz[i], zx[i], zy[i], zz[i]));
-  } 
+  const double* c[]={xx, xy, xz, yx, yy, yz, zx, zy, zz};
+  setField(cellFields_, name, nCells(), 9, c);
 }
 
-void vtkModel::writeDataToLegacyFile(std::ostream& os) const
+void vtkModel2d::writeCellsToLegacyFile(std::ostream& os, bool binary) const
 {
-  os<<"POINT_DATA "<<pts_.size()<<endl;
-  for (const ScalarFieldList::value_type& sf: pointScalarFields_)
-  {
-    os<<"SCALARS "<<sf.first<<" float 1"<<endl;
-    os<<"LOOKUP_TABLE default"<<endl;
-    for (const double& v: sf.second)
-    {
-      os<<v<<endl;
-    }
-  }
-  for (const VectorFieldList::value_type& sf: pointVectorFields_)
-  {
-//     cout<<sf.first<<endl;
-    if (pts_.size()>0)
-    {
-      const arma::mat& fe=sf.second[0];
-      if ( (fe.n_rows==3) && (fe.n_cols==1) )
-      {
-	// vector 
-	os<<"VECTORS "<<sf.first<<" float"<<endl;
-	for (const arma::mat& v: sf.second)
-	{
-	  os<<v(0)<<" "<<v(1)<<" "<<v(2)<<endl;
-	}
-      }
-      else if ( (fe.n_rows==3) && (fe.n_cols==3) )
-      {
-	// tensor
-	os<<"TENSORS "<<sf.first<<" float"<<endl;
-	for (const arma::mat& v: sf.second)
-	{
-	  os<<v(0,0)<<" "<<v(0,1)<<" "<<v(0,2)<<endl;
-	  os<<v(1,0)<<" "<<v(1,1)<<" "<<v(1,2)<<endl;
-	  os<<v(2,0)<<" "<<v(2,1)<<" "<<v(2,2)<<endl;
-	}
-      }
-    }
-  }
+  poly_.writeLegacy(os, "POLYGONS", binary);
 }
 
-void vtkModel2d::writeDataToLegacyFile(std::ostream& os) const
+std::string vtkModel2d::xmlPieceAttributes() const
 {
-  vtkModel::writeDataToLegacyFile(os);
-  
-  os<<"CELL_DATA "<<poly_.size()<<endl;
-  for (const ScalarFieldList::value_type& sf: cellScalarFields_)
-  {
-    os<<"SCALARS "<<sf.first<<" float 1"<<endl;
-    os<<"LOOKUP_TABLE default"<<endl;
-    for (const double& v: sf.second)
-    {
-      os<<v<<endl;
-    }
-  }
-  for (const VectorFieldList::value_type& sf: cellVectorFields_)
-  {
-    if (poly_.size()>0)
-    {
-      const arma::mat& fe=sf.second[0];
-      if ( (fe.n_rows==3) && (fe.n_cols==1) )
-      {
-	os<<"VECTORS "<<sf.first<<" float"<<endl;
-	for (const arma::mat& v: sf.second)
-	{
-	  os<<v(0)<<" "<<v(1)<<" "<<v(2)<<endl;
-	}
-      }
-      else if ( (fe.n_rows==3) && (fe.n_cols==3) )
-      {
-	// tensor
-	os<<"TENSORS "<<sf.first<<" float"<<endl;
-	for (const arma::mat& v: sf.second)
-	{
-	  os<<v(0,0)<<" "<<v(0,1)<<" "<<v(0,2)<<endl;
-	  os<<v(1,0)<<" "<<v(1,1)<<" "<<v(1,2)<<endl;
-	  os<<v(2,0)<<" "<<v(2,1)<<" "<<v(2,2)<<endl;
-	}
-      }
-    }
-  }
+  return str(boost::format(
+      "NumberOfPoints=\"%d\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"%d\""
+        ) % nPoints() % nCells() );
 }
 
-void vtkModel::writeLegacyFile(std::ostream& os) const
+void vtkModel2d::writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const
 {
-  os << "# vtk DataFile Version 2.0" << endl;
-  os << "vtkModel2d" << endl;
-  os << "ASCII" <<endl;
-  os << "DATASET POLYDATA"<<endl;
-  writeGeometryToLegacyFile(os);
-  writeDataToLegacyFile(os);
+  os << "<Polys>\n";
+  poly_.writeXML(os, ad);
+  os << "</Polys>\n";
 }
 
-vtkModel2d::vtkModel2d()
+
+
+
+vtkModel1d::vtkModel1d()
 {
 }
 
-vtkModel2d::~vtkModel2d()
+void vtkModel1d::appendLine(int nc, const int ci[])
 {
+  lines_.append(nc, ci);
 }
 
-void vtkModel2d::appendPolygon(int nc, const int ci[])
+size_t vtkModel1d::nCells() const
 {
-  poly_.push_back(Polygon(ci, ci+nc));
+  return lines_.size();
 }
 
-int vtkModel2d::nPolyPts() const
+void vtkModel1d::writeCellsToLegacyFile(std::ostream& os, bool binary) const
 {
-  int n=0;
-  for (const Polygon& p: poly_)
-  {
-    n+=p.size()+1;
-  }
-  return n;
+  lines_.writeLegacy(os, "LINES", binary);
 }
 
+std::string vtkModel1d::xmlPieceAttributes() const
+{
+  return str(boost::format(
+      "NumberOfPoints=\"%d\" NumberOfVerts=\"0\" NumberOfLines=\"%d\" NumberOfStrips=\"0\" NumberOfPolys=\"0\""
+        ) % nPoints() % nCells() );
+}
 
-void vtkModel2d::writeGeometryToLegacyFile(std::ostream& os) const
+void vtkModel1d::writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const
 {
-  vtkModel::writeGeometryToLegacyFile(os);
-  
-  os<<"POLYGONS "<<poly_.size()<<" "<<nPolyPts()<<endl;
-  for (const Polygon& p: poly_)
-  {
-    os<<p.size();
-    for (const int& i: p)
-    {
-      os<<" "<<i;
-    }
-    os<<endl;
-  }
+  os << "<Lines>\n";
+  lines_.writeXML(os, ad);
+  os << "</Lines>\n";
 }
 
+
 }
 
 
@@ -36,37 +36,78 @@ class vtkPolyData;
 namespace insight {
   
 namespace vtk {
-  
-typedef std::vector<arma::mat> PointList;
-typedef std::vector<int> Polygon;
-typedef std::vector<Polygon> PolygonList;
-typedef std::tuple<Polygon,int> Cell;
-typedef std::vector<Cell> CellList;
 
-typedef std::vector<double> ScalarField;
-typedef std::map<std::string, ScalarField> ScalarFieldList;
-typedef std::vector<arma::mat> VectorField;
-typedef std::map<std::string, VectorField> VectorFieldList;
+
+/**
+ * a data field in VTK tuple layout:
+ * all components of one entity are stored consecutively,
+ * tensors row by row (xx xy xz yx ...)
+ */
+struct DataField
+{
+  int nComponents;
+  std::vector<double> values;
+
+  inline size_t nTuples() const { return nComponents>0 ? values.size()/nComponents : 0; }
+};
+
+typedef std::map<std::string, DataField> FieldList;
+
+
+class XMLAppendedData;
+
+
+/**
+ * cell topology (polygons, lines or general cells) in flat arrays:
+ * all vertex indices consecutively and the end offset of each cell
+ */
+class CellConnectivity
+{
+  std::vector<int> connectivity_, offsets_;
+
+public:
+  void append(int nc, const int ci[]);
+
+  inline size_t size() const { return offsets_.size(); }
+
+  /**
+   * number of integers in the cell list of a legacy VTK file
+   */
+  inline size_t legacySize() const { return connectivity_.size()+offsets_.size(); }
+
+  void writeLegacy(std::ostream& os, const std::string& keyword, bool binary) const;
+  void writeXML(std::ostream& os, XMLAppendedData& ad) const;
+};
+
+
 
 class vtkModel
 {
   
 protected:
-  PointList pts_;
-  ScalarFieldList pointScalarFields_;
-  VectorFieldList pointVectorFields_;
-  ScalarFieldList cellScalarFields_;
-  VectorFieldList cellVectorFields_;
+  // point coordinates x0 y0 z0 x1 y1 z1 ...
+  std::vector<double> pts_;
+  FieldList pointFields_;
+  FieldList cellFields_;
+
+  void setField(FieldList& fl, const std::string& name, size_t n, int ncmpt, const double* const cmpts[]);
+
+  virtual size_t nCells() const;
+
+  virtual std::string legacyDataSetType() const;
+  virtual void writeCellsToLegacyFile(std::ostream& os, bool binary) const;
+
+  virtual std::string xmlDataSetType() const;
+  virtual std::string xmlPieceAttributes() const;
+  virtual void writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const;
   
 public:
     vtkModel();
     virtual ~vtkModel();
 
     void setPoints(int npts, const double* x, const double* y, const double* z);
-    
+    inline size_t nPoints() const { return pts_.size()/3; }
 
-    int nPolyPts() const;
-    
     void appendPointScalarField(const std::string& name, const double v[]);
     void appendPointVectorField(const std::string& name, const double x[], const double y[], const double z[]);
     void appendPointTensorField(const std::string& name, 
@@ -75,10 +116,22 @@ public:
 			       const double zx[], const double zy[], const double zz[]
 			       );
     
-    virtual void writeGeometryToLegacyFile(std::ostream& os) const;
-    virtual void writeDataToLegacyFile(std::ostream& os) const;
-    virtual void writeLegacyFile(std::ostream& os) const;
-    virtual void createLegacyFile(const boost::filesystem::path& fn, bool create_dir=false) const;
+    virtual void writeGeometryToLegacyFile(std::ostream& os, bool binary=false) const;
+    virtual void writeDataToLegacyFile(std::ostream& os, bool binary=false) const;
+    virtual void writeLegacyFile(std::ostream& os, bool binary=false) const;
+    virtual void createLegacyFile(const boost::filesystem::path& fn, bool create_dir=false, bool binary=false) const;
+
+    /**
+     * write VTK XML file (VTP for poly data, VTU for unstructured grids)
+     * with all arrays as raw appended data
+     */
+    virtual void writeXMLFile(std::ostream& os) const;
+    virtual void createXMLFile(const boost::filesystem::path& fn, bool create_dir=false) const;
+
+    /**
+     * write XML format, if the file extension is .vtp or .vtu, binary legacy format otherwise
+     */
+    void createFile(const boost::filesystem::path& fn, bool create_dir=false) const;
 };
 
 
@@ -86,24 +139,37 @@ public:
 class vtkUnstructuredGridModel
     : public vtkModel
 {
-  CellList cells_;
+  CellConnectivity cells_;
+  std::vector<unsigned char> cellTypes_;
+
+protected:
+  size_t nCells() const override;
+  std::string legacyDataSetType() const override;
+  void writeCellsToLegacyFile(std::ostream& os, bool binary) const override;
+  std::string xmlDataSetType() const override;
+  std::string xmlPieceAttributes() const override;
+  void writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const override;
 
 public:
     vtkUnstructuredGridModel();
 
     void appendCell(int nc, const int ci[], int type);
     int nCellPts() const;
-
-    virtual void writeLegacyFile(std::ostream& os) const;
 };
 
 
+
 class vtkModel2d
 : public vtkModel
 {
   
 protected:
-  PolygonList poly_;
+  CellConnectivity poly_;
+
+  size_t nCells() const override;
+  void writeCellsToLegacyFile(std::ostream& os, bool binary) const override;
+  std::string xmlPieceAttributes() const override;
+  void writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const override;
   
 public:
     vtkModel2d();
@@ -119,9 +185,29 @@ public:
 			       const double yx[], const double yy[], const double yz[],
 			       const double zx[], const double zy[], const double zz[]
 			      );
+};
+
+
+
+/**
+ * poly data consisting of lines only (e.g. feature edges)
+ */
+class vtkModel1d
+: public vtkModel
+{
+
+protected:
+  CellConnectivity lines_;
+
+  size_t nCells() const override;
+  void writeCellsToLegacyFile(std::ostream& os, bool binary) const override;
+  std::string xmlPieceAttributes() const override;
+  void writeCellsToXMLFile(std::ostream& os, XMLAppendedData& ad) const override;
+
+public:
+    vtkModel1d();
 
-    virtual void writeDataToLegacyFile(std::ostream& os) const;
-    virtual void writeGeometryToLegacyFile(std::ostream& os) const;
+    void appendLine(int nc, const int ci[]);
 };
 
 typedef std::shared_ptr<vtkModel2d> vtkModel2dPtr;
@@ -19,6 +19,7 @@
  */
 
 #include "openfoam/blockmesh.h"
+#include "openfoam/blockmeshgenerator.h"
 
 #include "base/vtktools.h"
 
@@ -341,28 +342,23 @@ void Block::swapGrad()
      s+=")\n"
      return s
 */
-std::vector<OFDictData::data>
-Block::bmdEntry(const PointMap& allPoints, int OFversion) const
+PointList Block::hexCorners() const
 {
-  std::vector<OFDictData::data> retval;
-  retval.push_back( OFDictData::data("hex") );
-  
-  OFDictData::list cl;
   std::vector<int> ci;
   if (!inv_) ci+=0,1,2,3,4,5,6,7; else ci+=4,5,6,7,0,1,2,3;
-  for (std::vector<int>::const_iterator i=ci.begin(); i!=ci.end(); i++)
+
+  PointList hc;
+  for (int i: ci)
   {
-    cl.push_back( OFDictData::data(allPoints.find(corners_[*i])->second) );
+    hc.push_back(corners_[i]);
   }
-  retval.push_back( cl );
-  
-  retval.push_back( OFDictData::data(zone_) );
+  return hc;
+}
 
-  OFDictData::list rl;
-  rl += resolution_[0], resolution_[1], resolution_[2];
-  retval.push_back( rl );
 
-  OFDictData::list gl;
+std::vector<double> Block::edgeGradings() const
+{
+  std::vector<double> gl;
   for (GradingList::const_iterator g=grading_.begin(); g!=grading_.end(); g++)
   {
     try
@@ -383,6 +379,34 @@ Block::bmdEntry(const PointMap& allPoints, int OFversion) const
 	}
     }
   }
+  return gl;
+}
+
+
+std::vector<OFDictData::data>
+Block::bmdEntry(const PointMap& allPoints, int OFversion) const
+{
+  std::vector<OFDictData::data> retval;
+  retval.push_back( OFDictData::data("hex") );
+  
+  OFDictData::list cl;
+  for (const Point& c: hexCorners())
+  {
+    cl.push_back( OFDictData::data(allPoints.find(c)->second) );
+  }
+  retval.push_back( cl );
+  
+  retval.push_back( OFDictData::data(zone_) );
+
+  OFDictData::list rl;
+  rl += resolution_[0], resolution_[1], resolution_[2];
+  retval.push_back( rl );
+
+  OFDictData::list gl;
+  for (double g: edgeGradings())
+  {
+    gl.push_back( OFDictData::data(g) );
+  }
   retval.push_back( gl );
 
   return retval;
@@ -594,6 +618,30 @@ ArcEdge::bmdEntry(const PointMap& allPoints, int OFversion) const
 }
 
 
+Point ArcEdge::position(double lambda) const
+{
+  if (lambda<=0.) return c0_;
+  if (lambda>=1.) return c1_;
+
+  // circle through start, mid and end point
+  arma::mat a=c0_-midpoint_, b=c1_-midpoint_;
+  arma::mat axb=arma::cross(a, b);
+  double naxb=arma::dot(axb, axb);
+  if (naxb<SMALL)
+    throw insight::Exception("The points of the arc edge are colinear!");
+  arma::mat centre = midpoint_ + arma::cross( arma::dot(a,a)*b - arma::dot(b,b)*a, axb ) / (2.*naxb);
+
+  // rotation from start over mid to end point
+  arma::mat n=arma::cross(midpoint_-c0_, c1_-midpoint_);
+  n/=arma::norm(n, 2);
+  arma::mat r0=c0_-centre, r1=c1_-centre;
+  double angle=atan2( arma::dot(n, arma::cross(r0, r1)), arma::dot(r0, r1) );
+  if (angle<=0.) angle+=2.*M_PI;
+
+  return centre + cos(lambda*angle)*r0 + sin(lambda*angle)*arma::cross(n, r0);
+}
+
+
 Edge* ArcEdge::transformed(const arma::mat& tm, const arma::mat trans) const
 {
   return new ArcEdge(tm*c0_+trans, tm*c1_+trans, tm*midpoint_+trans);
@@ -631,6 +679,11 @@ EllipseEdge::bmdEntry(const PointMap& allPoints, int OFversion) const
   return l;
 }
 
+Point EllipseEdge::position(double) const
+{
+  throw insight::UnsupportedFeature("Ellipse edges are not supported by the in-process mesh generator!");
+}
+
 Edge* EllipseEdge::transformed(const arma::mat& tm, const arma::mat trans) const
 {
   throw insight::Exception("Not implemented!");
@@ -749,6 +802,44 @@ std::vector<OFDictData::data> SplineEdge::bmdEntry(const PointMap& allPoints, in
   return l;
 };
 
+Point SplineEdge::position(double lambda) const
+{
+  if (lambda<=0.) return c0_;
+  if (lambda>=1.) return c1_;
+
+  PointList pts=allPoints();
+  int nseg=pts.size()-1;
+
+  // segments are parametrized by chord length
+  std::vector<double> param(pts.size(), 0.);
+  for (size_t i=1; i<pts.size(); i++)
+  {
+    param[i]=param[i-1]+arma::norm(pts[i]-pts[i-1], 2);
+  }
+  int seg=0;
+  while (seg<nseg-1 && lambda*param.back()>=param[seg+1]) seg++;
+  double mu=(lambda*param.back()-param[seg])/(param[seg+1]-param[seg]);
+
+  const Point& p0=pts[seg];
+  const Point& p1=pts[seg+1];
+  arma::mat e0 = (seg==0) ? arma::mat(2.*p0-p1) : pts[seg-1];
+  arma::mat e1 = (seg+1==nseg) ? arma::mat(2.*p1-p0) : pts[seg+2];
+
+  return 0.5*
+      (
+        2.*p0
+        + mu*
+        (
+          (-e0+p1)
+          + mu*
+          (
+            (2.*e0-5.*p0+4.*p1-e1)
+            + mu*(-e0+3.*p0-3.*p1+e1)
+          )
+        )
+      );
+}
+
 Edge* SplineEdge::transformed(const arma::mat& tm, const arma::mat trans) const
 {
   PointList pl;
@@ -1346,8 +1437,13 @@ void blockMesh::writeVTK(const boost::filesystem::path& fn) const
      m.appendCell( 8, pi.data(), 12 ); // 12 = HEXAHEDRON
    }
 
-  std::ofstream os(fn.c_str());
-  m.writeLegacyFile(os);
+  m.createFile(fn);
+}
+
+void blockMesh::writePolyMesh(const boost::filesystem::path& location) const
+{
+  BlockMeshGenerator gen(*this);
+  gen.write(location/"constant"/"polyMesh", OFversion());
 }
 
 int blockMesh::nBlocks() const
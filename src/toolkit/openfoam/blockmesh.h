@@ -105,6 +105,7 @@ public:
   virtual Patch* clone() const;
 
   inline const FaceList& faces() const { return faces_; }
+  inline const std::string& typ() const { return typ_; }
 
   std::vector<OFDictData::data> 
   bmdEntry(const PointMap& allPoints, const std::string& name, int OFversion) const;
@@ -168,6 +169,20 @@ public:
 
   PointList face(const std::string& id) const;
 
+  /**
+   * corners in the order of the hex definition in blockMeshDict
+   * (with inversion applied)
+   */
+  PointList hexCorners() const;
+
+  /**
+   * expansion ratios of the 12 block edges in the order of the edgeGrading entry
+   */
+  std::vector<double> edgeGradings() const;
+
+  inline const std::vector<int>& resolution() const { return resolution_; }
+  inline const std::string& zone() const { return zone_; }
+
   void swapGrad();
 
   std::vector<OFDictData::data>
@@ -284,6 +299,12 @@ public:
   bmdEntry(const PointMap& allPoints, int OFversion) const =0;
 
   virtual void registerPoints(blockMesh& bmd) const;
+
+  /**
+   * point on the edge at parameter lambda (0: c0, 1: c1),
+   * parametrized in the same way as in blockMesh
+   */
+  virtual Point position(double lambda) const =0;
   
   virtual Edge* transformed(const arma::mat& tm, const arma::mat trans=vec3(0,0,0)) const =0;
   virtual Edge* clone() const =0;
@@ -303,6 +324,7 @@ public:
   ArcEdge(const Point& c0, const Point& c1, const Point& midpoint);
 
   virtual std::vector<OFDictData::data> bmdEntry(const PointMap& allPoints, int OFversion) const;
+  Point position(double lambda) const override;
 
   virtual Edge* transformed(const arma::mat& tm, const arma::mat trans=vec3(0,0,0)) const;
   virtual Edge* clone() const;
@@ -327,6 +349,7 @@ public:
     );
     
     virtual std::vector<OFDictData::data> bmdEntry(const PointMap& allPoints, int OFversion) const;
+    Point position(double lambda) const override;
 
     virtual Edge* transformed(const arma::mat& tm, const arma::mat trans=vec3(0,0,0)) const;
     virtual Edge* clone() const;
@@ -410,6 +433,11 @@ public:
 
   virtual std::vector<OFDictData::data> bmdEntry(const PointMap& allPoints, int OFversion) const;
 
+  /**
+   * Catmull-Rom spline, like "spline" edges of blockMesh
+   */
+  Point position(double lambda) const override;
+
   virtual Edge* transformed(const arma::mat& tm, const arma::mat trans=vec3(0,0,0)) const;
   virtual Edge* clone() const;
 
@@ -534,6 +562,10 @@ public:
   
   void setScaleFactor(double sf);
   void setDefaultPatch(const std::string& name, std::string type="patch");
+
+  inline double scaleFactor() const { return scaleFactor_; }
+  inline const std::string& defaultPatchName() const { return defaultPatchName_; }
+  inline const std::string& defaultPatchType() const { return defaultPatchType_; }
   
   inline const boost::ptr_vector<Block>& allBlocks() const { return allBlocks_; }
   inline const boost::ptr_vector<Edge>& allEdges() const { return allEdges_; }
@@ -598,6 +630,13 @@ public:
 
   void writeVTK(const boost::filesystem::path& fn) const;
 
+  /**
+   * creates the mesh in constant/polyMesh of the case at location
+   * in process, without running the blockMesh utility (see BlockMeshGenerator).
+   * Throws UnsupportedFeature, if the configuration cannot be handled.
+   */
+  virtual void writePolyMesh(const boost::filesystem::path& location) const;
+
   int nBlocks() const;
   
   static std::string category() { return "Meshing"; }
@@ -36,20 +36,38 @@ namespace bmd
 
 
 BlockMeshTemplate::BlockMeshTemplate ( OpenFOAMCase& c, const ParameterSet& ps )
-    : blockMesh ( c, ps )
+    : blockMesh ( c, ps ),
+      bmdCreated_ ( false )
 {
 }
 
 
+void BlockMeshTemplate::create_bmd_once() const
+{
+    if (!bmdCreated_)
+    {
+        const_cast<BlockMeshTemplate*> ( this ) -> create_bmd();
+        bmdCreated_=true;
+    }
+}
+
+
 
 
 void BlockMeshTemplate::addIntoDictionaries ( OFdicts& dictionaries ) const
 {
-    const_cast<BlockMeshTemplate*> ( this ) -> create_bmd();
+    create_bmd_once();
     blockMesh::addIntoDictionaries ( dictionaries );
 }
 
 
+void BlockMeshTemplate::writePolyMesh(const boost::filesystem::path& location) const
+{
+    create_bmd_once();
+    blockMesh::writePolyMesh ( location );
+}
+
+
 arma::mat BlockMeshTemplate::correct_trihedron(arma::mat& ex, arma::mat &ez)
 {
     ex /= arma::norm(ex, 2);    
@@ -568,6 +586,12 @@ void blockMeshDict_Sphere::create_bmd()
     }
 }
 
+void blockMeshDict_Sphere::writePolyMesh(const boost::filesystem::path&) const
+{
+    throw insight::UnsupportedFeature("Projected faces are not supported by the in-process mesh generator!");
+}
+
+
 void blockMeshDict_Sphere::addIntoDictionaries ( OFdicts& dictionaries ) const
 {
     BlockMeshTemplate::addIntoDictionaries(dictionaries);
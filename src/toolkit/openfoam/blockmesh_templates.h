@@ -23,6 +23,9 @@
 #define INSIGHT_BLOCKMESH_TEMPLATES_H
 
 #include "openfoam/blockmesh.h"
+#include "blockmesh_templates__blockMeshDict_Cylinder__Parameters_headers.h"
+#include "blockmesh_templates__blockMeshDict_Box__Parameters_headers.h"
+#include "blockmesh_templates__blockMeshDict_Sphere__Parameters_headers.h"
 
 namespace insight {
   
@@ -35,9 +38,19 @@ namespace bmd
 class BlockMeshTemplate
     : public insight::bmd::blockMesh
 {
+    mutable bool bmdCreated_;
+
+protected:
+    /**
+     * calls create_bmd, if this was not done before.
+     * The blocks depend only on the parameters, which are fixed after construction.
+     */
+    void create_bmd_once() const;
+
 public:
     BlockMeshTemplate(OpenFOAMCase& c, const ParameterSet& ps);
     void addIntoDictionaries ( OFdicts& dictionaries ) const override;
+    void writePolyMesh(const boost::filesystem::path& location) const override;
     virtual void create_bmd () =0;
 
     static arma::mat correct_trihedron(arma::mat& ex, arma::mat &ez);
@@ -247,6 +260,10 @@ public:
     void create_bmd() override;
     void addIntoDictionaries ( OFdicts& dictionaries ) const override;
 
+    /**
+     * not supported: the outer faces are projected onto the sphere
+     */
+    void writePolyMesh(const boost::filesystem::path& location) const override;
 };
 
 
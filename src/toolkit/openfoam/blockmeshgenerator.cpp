@@ -0,0 +1,852 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "openfoam/blockmeshgenerator.h"
+#include "openfoam/openfoamdict.h"
+
+#include "base/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+namespace bf = boost::filesystem;
+
+namespace insight
+{
+
+namespace bmd
+{
+
+
+
+
+namespace
+{
+
+typedef BlockMeshGenerator::Vector Vector;
+typedef BlockMeshGenerator::Face Face;
+
+
+// local coordinates of the hex vertices
+const int hexVertex[8][3] = {
+  {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+  {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1}
+};
+
+// block edges in the order of the edgeGrading entry: 4 in x-, 4 in y- and 4 in z-direction
+const int hexEdge[12][2] = {
+  {0,1}, {3,2}, {7,6}, {4,5},
+  {0,3}, {1,2}, {5,6}, {4,7},
+  {0,4}, {1,5}, {2,6}, {3,7}
+};
+
+// outward oriented faces of the hex cell shape, numbered like in OpenFOAM's hex model
+const int hexFace[6][4] = {
+  {0,4,7,3}, {1,2,6,5},
+  {0,1,5,4}, {3,7,6,2},
+  {0,3,2,1}, {4,5,6,7}
+};
+
+
+/**
+ * index of the block edge in direction dir, which starts at local coordinates c.
+ * The coordinate in direction dir is ignored.
+ */
+int edgeAt(int dir, const int c[3])
+{
+  for (int e=4*dir; e<4*dir+4; e++)
+  {
+    const int* v=hexVertex[hexEdge[e][0]];
+    bool match=true;
+    for (int k=0; k<3; k++)
+    {
+      if (k!=dir && v[k]!=c[k]) match=false;
+    }
+    if (match) return e;
+  }
+  throw insight::Exception("Internal error: invalid block edge location!");
+}
+
+
+/**
+ * The position of a point inside a block is a weighted sum over the points on all 12 edges.
+ * The importance of an edge in direction d is the sum of two bilinear weights,
+ * taken on the block faces at both ends of d, each multiplied by the weight
+ * of the edge's own end at that face, (1-w_d) or w_d (same as in blockMesh).
+ * For each edge, the indices of the edges, which provide these weights, are stored.
+ */
+struct EdgeImportance
+{
+  int d, a, b;      // edge direction and the two other directions
+  int sa, sb;       // side of the edge in directions a and b
+  int ea[2], eb[2]; // edges in directions a and b on the faces d=0 and d=1
+};
+
+
+std::vector<EdgeImportance> edgeImportances()
+{
+  std::vector<EdgeImportance> imp(12);
+  for (int e=0; e<12; e++)
+  {
+    EdgeImportance& ie=imp[e];
+    const int* v=hexVertex[hexEdge[e][0]];
+    ie.d=e/4;
+    ie.a=(ie.d+1)%3;
+    ie.b=(ie.d+2)%3;
+    ie.sa=v[ie.a];
+    ie.sb=v[ie.b];
+    for (int t=0; t<2; t++)
+    {
+      int c[3];
+      c[ie.d]=t;
+      c[ie.a]=ie.sa;
+      c[ie.b]=ie.sb;
+      ie.ea[t]=edgeAt(ie.a, c);
+      ie.eb[t]=edgeAt(ie.b, c);
+    }
+  }
+  return imp;
+}
+
+
+/**
+ * relative positions of the n+1 points on an edge with expansion ratio r
+ * (ratio of last to first cell length)
+ */
+std::vector<double> edgeDivisions(int n, double r)
+{
+  std::vector<double> w(n+1);
+  if (n>1 && std::fabs(r-1.)>1e-12)
+  {
+    double lambda=std::pow(r, 1./double(n-1));
+    for (int i=0; i<=n; i++)
+    {
+      w[i]=(1.-std::pow(lambda, i))/(1.-std::pow(lambda, n));
+    }
+  }
+  else
+  {
+    for (int i=0; i<=n; i++)
+    {
+      w[i]=double(i)/double(n);
+    }
+  }
+  w[0]=0.;
+  w[n]=1.;
+  return w;
+}
+
+
+Vector toVector(const arma::mat& p)
+{
+  return Vector{{ p(0), p(1), p(2) }};
+}
+
+
+double distance(const Vector& p1, const Vector& p2)
+{
+  double dx=p1[0]-p2[0], dy=p1[1]-p2[1], dz=p1[2]-p2[2];
+  return std::sqrt(dx*dx+dy*dy+dz*dz);
+}
+
+
+struct BlockPoints
+{
+  int n[3];
+  std::vector<Vector> corners;
+  std::vector<double> w[12];    // relative positions of the points on the edges
+  std::vector<Vector> ep[12];   // points on the edges
+  bool curved[12];
+
+  std::vector<Vector> points;
+
+  inline int pointIndex(int i, int j, int k) const
+  {
+    return i + (n[0]+1)*( j + (n[1]+1)*k );
+  }
+
+  inline int cellIndex(int i, int j, int k) const
+  {
+    return i + n[0]*( j + n[1]*k );
+  }
+
+  inline int nPoints() const
+  {
+    return (n[0]+1)*(n[1]+1)*(n[2]+1);
+  }
+
+  inline int nCells() const
+  {
+    return n[0]*n[1]*n[2];
+  }
+
+  /**
+   * the 4 point indices of face f of cell (i,j,k)
+   */
+  Face cellFace(int i, int j, int k, int f) const
+  {
+    Face res;
+    for (int m=0; m<4; m++)
+    {
+      const int* v=hexVertex[hexFace[f][m]];
+      res[m]=pointIndex(i+v[0], j+v[1], k+v[2]);
+    }
+    return res;
+  }
+
+  BlockPoints(const Block& b, const boost::ptr_vector<Edge>& edges)
+  {
+    for (int d=0; d<3; d++)
+    {
+      n[d]=b.resolution()[d];
+      if (n[d]<1)
+        throw insight::Exception("Invalid block resolution!");
+    }
+
+    PointList hc=b.hexCorners();
+    for (const auto& c: hc)
+    {
+      corners.push_back(toVector(c));
+    }
+    for (int i=0; i<8; i++)
+    {
+      for (int j=i+1; j<8; j++)
+      {
+        if (arma::norm(hc[i]-hc[j], 2) < 1e-10)
+          throw insight::UnsupportedFeature("Blocks with collapsed vertices are not supported by the in-process mesh generator!");
+      }
+    }
+
+    std::vector<double> grad=b.edgeGradings();
+    for (int e=0; e<12; e++)
+    {
+      const Point& p0=hc[hexEdge[e][0]];
+      const Point& p1=hc[hexEdge[e][1]];
+
+      w[e]=edgeDivisions(n[e/4], grad[e]);
+
+      const Edge* ce=nullptr;
+      for (const auto& ed: edges)
+      {
+        if (ed.connectsPoints(p0, p1))
+        {
+          ce=&ed;
+          break;
+        }
+      }
+
+      curved[e] = (ce!=nullptr);
+      ep[e].resize(w[e].size());
+      if (ce)
+      {
+        bool reversed = arma::norm(ce->c0()-p0, 2) > arma::norm(ce->c1()-p0, 2);
+        for (size_t i=0; i<w[e].size(); i++)
+        {
+          ep[e][i]=toVector( ce->position( reversed ? 1.-w[e][i] : w[e][i] ) );
+        }
+        ep[e].front()=toVector(p0);
+        ep[e].back()=toVector(p1);
+      }
+      else
+      {
+        for (size_t i=0; i<w[e].size(); i++)
+        {
+          for (int k=0; k<3; k++)
+          {
+            ep[e][i][k]=p0(k)+w[e][i]*(p1(k)-p0(k));
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * smallest distance between consecutive points on the block edges
+   */
+  double minEdgeSpacing() const
+  {
+    double ms=std::numeric_limits<double>::max();
+    for (int e=0; e<12; e++)
+    {
+      for (size_t i=1; i<ep[e].size(); i++)
+      {
+        ms=std::min(ms, distance(ep[e][i], ep[e][i-1]));
+      }
+    }
+    return ms;
+  }
+
+  void createPoints(const std::vector<EdgeImportance>& imps)
+  {
+    points.resize(nPoints());
+
+    double imp[12];
+    int idx[3];
+    for (idx[2]=0; idx[2]<=n[2]; idx[2]++)
+    {
+      for (idx[1]=0; idx[1]<=n[1]; idx[1]++)
+      {
+        for (idx[0]=0; idx[0]<=n[0]; idx[0]++)
+        {
+          Vector& p=points[pointIndex(idx[0], idx[1], idx[2])];
+
+          for (int e=0; e<12; e++)
+          {
+            const EdgeImportance& ie=imps[e];
+            double wd=w[e][idx[ie.d]];
+            imp[e]=0.;
+            for (int t=0; t<2; t++)
+            {
+              double wa=w[ie.ea[t]][idx[ie.a]];
+              double wb=w[ie.eb[t]][idx[ie.b]];
+              imp[e] += (t ? wd : 1.-wd) * (ie.sa ? wa : 1.-wa) * (ie.sb ? wb : 1.-wb);
+            }
+          }
+          for (int d=0; d<3; d++)
+          {
+            double s=imp[4*d]+imp[4*d+1]+imp[4*d+2]+imp[4*d+3];
+            for (int e=4*d; e<4*d+4; e++)
+            {
+              imp[e]/=s;
+            }
+          }
+
+          Vector lin{{0,0,0}}, corr{{0,0,0}};
+          for (int e=0; e<12; e++)
+          {
+            const Vector& c0=corners[hexEdge[e][0]];
+            const Vector& c1=corners[hexEdge[e][1]];
+            int i=idx[e/4];
+            double we=w[e][i];
+            for (int k=0; k<3; k++)
+            {
+              double l = c0[k] + we*(c1[k]-c0[k]);
+              lin[k] += imp[e]*l;
+              if (curved[e])
+              {
+                corr[k] += imp[e]*(ep[e][i][k]-l);
+              }
+            }
+          }
+          for (int k=0; k<3; k++)
+          {
+            p[k]=lin[k]/3. + corr[k];
+          }
+        }
+      }
+    }
+
+    // exact block vertices
+    for (int v=0; v<8; v++)
+    {
+      points[pointIndex(
+            hexVertex[v][0]*n[0],
+            hexVertex[v][1]*n[1],
+            hexVertex[v][2]*n[2] )] = corners[v];
+    }
+  }
+
+  /**
+   * index of the block face with the given corners or -1, if it is not a face of this block
+   */
+  int findFace(const PointList& fc, double tol) const
+  {
+    if (fc.size()!=4) return -1;
+    for (int f=0; f<6; f++)
+    {
+      bool match=true;
+      for (const auto& p: fc)
+      {
+        Vector pv=toVector(p);
+        bool found=false;
+        for (int m=0; m<4; m++)
+        {
+          if (distance(pv, corners[hexFace[f][m]])<tol) found=true;
+        }
+        if (!found) { match=false; break; }
+      }
+      if (match) return f;
+    }
+    return -1;
+  }
+};
+
+
+int findRoot(std::vector<int>& parent, int i)
+{
+  while (parent[i]!=i)
+  {
+    parent[i]=parent[parent[i]];
+    i=parent[i];
+  }
+  return i;
+}
+
+
+struct FaceKeyHash
+{
+  size_t operator()(const Face& f) const
+  {
+    size_t h=0;
+    for (int l: f)
+    {
+      h ^= std::hash<int>()(l) + 0x9e3779b9 + (h<<6) + (h>>2);
+    }
+    return h;
+  }
+};
+
+
+Face sortedFace(Face f)
+{
+  std::sort(f.begin(), f.end());
+  return f;
+}
+
+
+template<class T>
+void writeBinaryList(std::ostream& out, const T* data, size_t n, size_t nCmpt=1)
+{
+  // no delimiters for empty lists in binary format
+  out << "\n" << n << "\n";
+  if (n>0)
+  {
+    out << "(";
+    out.write(reinterpret_cast<const char*>(data), n*nCmpt*sizeof(T));
+    out << ")";
+  }
+  out << "\n";
+}
+
+
+void writeHeader(std::ostream& out, const std::string& className, const std::string& objname, bool binary=true)
+{
+  OFDictData::dictFile hdr;
+  hdr.className=className;
+  writeOpenFOAMDictHeader(out, hdr, objname, binary);
+  out << "\n";
+}
+
+}
+
+
+
+
+BlockMeshGenerator::BlockMeshGenerator(const blockMesh& bm)
+: nCells_(0)
+{
+  auto imps = edgeImportances();
+
+  // create the points of all blocks
+  std::vector<BlockPoints> blocks;
+  std::vector<int> pointOffset, cellOffset;
+  int nBlockPoints=0;
+  double tol=std::numeric_limits<double>::max();
+  for (const auto& b: bm.allBlocks())
+  {
+    blocks.push_back(BlockPoints(b, bm.allEdges()));
+    BlockPoints& bp=blocks.back();
+    bp.createPoints(imps);
+    tol=std::min(tol, 1e-3*bp.minEdgeSpacing());
+
+    pointOffset.push_back(nBlockPoints);
+    cellOffset.push_back(nCells_);
+    nBlockPoints+=bp.nPoints();
+    nCells_+=bp.nCells();
+  }
+
+  if (blocks.size()==0)
+    throw insight::Exception("The block mesh contains no blocks!");
+
+
+  // merge coincident points on block faces.
+  // The lowest index of a group of merged points is its root.
+  std::vector<int> parent(nBlockPoints);
+  for (int i=0; i<nBlockPoints; i++) parent[i]=i;
+  {
+    struct Candidate { double x; int block, index; };
+    std::vector<Candidate> cand;
+    for (size_t bi=0; bi<blocks.size(); bi++)
+    {
+      const BlockPoints& bp=blocks[bi];
+      for (int k=0; k<=bp.n[2]; k++)
+        for (int j=0; j<=bp.n[1]; j++)
+          for (int i=0; i<=bp.n[0]; i++)
+          {
+            if (i==0 || j==0 || k==0 || i==bp.n[0] || j==bp.n[1] || k==bp.n[2])
+            {
+              int pi=bp.pointIndex(i,j,k);
+              cand.push_back(Candidate{bp.points[pi][0], int(bi), pointOffset[bi]+pi});
+            }
+          }
+    }
+    std::sort(cand.begin(), cand.end(),
+              [](const Candidate& c1, const Candidate& c2) { return c1.x<c2.x; } );
+
+    auto pointAt = [&](const Candidate& c) -> const Vector&
+    {
+      return blocks[c.block].points[c.index-pointOffset[c.block]];
+    };
+
+    for (size_t p=0; p<cand.size(); p++)
+    {
+      for (size_t q=p+1; q<cand.size() && cand[q].x-cand[p].x<tol; q++)
+      {
+        if (cand[p].block!=cand[q].block
+            && distance(pointAt(cand[p]), pointAt(cand[q]))<tol)
+        {
+          int rp=findRoot(parent, cand[p].index), rq=findRoot(parent, cand[q].index);
+          if (rp<rq) parent[rq]=rp; else parent[rp]=rq;
+        }
+      }
+    }
+  }
+
+  // number the points in the order of the blocks, merged points get the label of their first occurrence
+  std::vector<int> pointLabel(nBlockPoints, -1);
+  for (int i=0; i<nBlockPoints; i++)
+  {
+    int r=findRoot(parent, i);
+    if (pointLabel[r]<0)
+    {
+      int bi=int(std::upper_bound(pointOffset.begin(), pointOffset.end(), r)-pointOffset.begin())-1;
+      pointLabel[r]=int(points_.size());
+      points_.push_back(blocks[bi].points[r-pointOffset[bi]]);
+    }
+    pointLabel[i]=pointLabel[r];
+  }
+
+  double sf=bm.scaleFactor();
+  for (auto& p: points_)
+  {
+    for (int k=0; k<3; k++) p[k]*=sf;
+  }
+
+
+  // cell shapes and connectivity
+  auto cellFace = [&](int bi, int i, int j, int k, int f) -> Face
+  {
+    Face lf=blocks[bi].cellFace(i, j, k, f);
+    for (auto& l: lf) l=pointLabel[pointOffset[bi]+l];
+    return lf;
+  };
+
+  struct CellFaceRef { int block, i, j, k; };
+  std::vector<CellFaceRef> cellRef(nCells_);
+  std::vector<std::array<int,6> > nbr(nCells_), patchOfFace(nCells_);
+  std::unordered_map<Face, std::pair<int,int>, FaceKeyHash> blockFaces;
+
+  for (size_t bi=0; bi<blocks.size(); bi++)
+  {
+    const BlockPoints& bp=blocks[bi];
+    for (int k=0; k<bp.n[2]; k++)
+      for (int j=0; j<bp.n[1]; j++)
+        for (int i=0; i<bp.n[0]; i++)
+        {
+          int c=cellOffset[bi]+bp.cellIndex(i,j,k);
+          cellRef[c]=CellFaceRef{int(bi), i, j, k};
+          patchOfFace[c].fill(-1);
+
+          int ijk[3]={i, j, k};
+          for (int f=0; f<6; f++)
+          {
+            int d=f/2, s=f%2;
+            int o[3]={ijk[0], ijk[1], ijk[2]};
+            o[d] += s ? 1 : -1;
+            if (o[d]>=0 && o[d]<bp.n[d])
+            {
+              nbr[c][f]=cellOffset[bi]+bp.cellIndex(o[0], o[1], o[2]);
+            }
+            else
+            {
+              nbr[c][f]=-1;
+              Face key=sortedFace(cellFace(int(bi), i, j, k, f));
+              auto ins=blockFaces.insert(std::make_pair(key, std::make_pair(c, f)));
+              if (!ins.second)
+              {
+                auto& other=ins.first->second;
+                if (other.first<0)
+                  throw insight::Exception("Non-conformal block connection: a face is shared by more than two cells!");
+                nbr[c][f]=other.first;
+                nbr[other.first][other.second]=c;
+                other.first=-1;
+              }
+            }
+          }
+        }
+  }
+  blockFaces.clear();
+
+
+  // internal faces in upper triangular order (sorted by owner, then by neighbour)
+  for (int c=0; c<nCells_; c++)
+  {
+    std::vector<std::pair<int,int> > nf;
+    for (int f=0; f<6; f++)
+    {
+      if (nbr[c][f]>c) nf.push_back(std::make_pair(nbr[c][f], f));
+    }
+    std::sort(nf.begin(), nf.end());
+    const CellFaceRef& cr=cellRef[c];
+    for (const auto& n: nf)
+    {
+      faces_.push_back(cellFace(cr.block, cr.i, cr.j, cr.k, n.second));
+      owner_.push_back(c);
+      neighbour_.push_back(n.first);
+    }
+  }
+
+
+  // boundary patches
+  struct PatchFaces
+  {
+    Boundary b;
+    std::vector<const PointList*> blockFaces;
+  };
+  std::vector<PatchFaces> patches;
+  for (const auto& pe: bm.allPatches())
+  {
+    const Patch& p=*pe.second;
+    const auto& pf=p.faces();
+    if (p.typ()=="cyclic")
+    {
+      size_t h=pf.size()/2;
+      PatchFaces p0{ Boundary{pe.first+"_half0", "cyclic", pe.first+"_half1", 0, 0}, {} };
+      PatchFaces p1{ Boundary{pe.first+"_half1", "cyclic", pe.first+"_half0", 0, 0}, {} };
+      for (size_t i=0; i<pf.size(); i++)
+      {
+        (i<h ? p0 : p1).blockFaces.push_back(&pf[i]);
+      }
+      patches.push_back(p0);
+      patches.push_back(p1);
+    }
+    else
+    {
+      PatchFaces pp{ Boundary{pe.first, p.typ(), "", 0, 0}, {} };
+      for (const auto& f: pf)
+      {
+        pp.blockFaces.push_back(&f);
+      }
+      patches.push_back(pp);
+    }
+  }
+
+  for (size_t pi=0; pi<patches.size(); pi++)
+  {
+    PatchFaces& pf=patches[pi];
+    pf.b.startFace=int(faces_.size());
+
+    for (const PointList* fc: pf.blockFaces)
+    {
+      int bi=-1, bf=-1;
+      for (size_t i=0; i<blocks.size() && bf<0; i++)
+      {
+        bf=blocks[i].findFace(*fc, tol);
+        if (bf>=0) bi=int(i);
+      }
+      if (bf<0)
+        throw insight::Exception("Patch "+pf.b.name+" contains a face, which is not a block face!");
+
+      const BlockPoints& bp=blocks[bi];
+      int d=bf/2, s=bf%2;
+      int a=(d==0)?1:0, b=(d==2)?1:2;
+      for (int ib=0; ib<bp.n[b]; ib++)
+      {
+        for (int ia=0; ia<bp.n[a]; ia++)
+        {
+          int ijk[3];
+          ijk[d] = s ? bp.n[d]-1 : 0;
+          ijk[a] = ia;
+          ijk[b] = ib;
+          int c=cellOffset[bi]+bp.cellIndex(ijk[0], ijk[1], ijk[2]);
+          if (nbr[c][bf]>=0)
+            throw insight::Exception("Patch "+pf.b.name+" contains an internal face!");
+          if (patchOfFace[c][bf]>=0)
+            throw insight::Exception("A face of patch "+pf.b.name+" is also part of another patch!");
+          patchOfFace[c][bf]=int(pi);
+          faces_.push_back(cellFace(bi, ijk[0], ijk[1], ijk[2], bf));
+          owner_.push_back(c);
+        }
+      }
+    }
+
+    pf.b.nFaces=int(faces_.size())-pf.b.startFace;
+    boundary_.push_back(pf.b);
+  }
+
+  // remaining boundary faces into default patch
+  Boundary def{bm.defaultPatchName(), bm.defaultPatchType(), "", int(faces_.size()), 0};
+  for (int c=0; c<nCells_; c++)
+  {
+    const CellFaceRef& cr=cellRef[c];
+    for (int f=0; f<6; f++)
+    {
+      if (nbr[c][f]<0 && patchOfFace[c][f]<0)
+      {
+        faces_.push_back(cellFace(cr.block, cr.i, cr.j, cr.k, f));
+        owner_.push_back(c);
+      }
+    }
+  }
+  def.nFaces=int(faces_.size())-def.startFace;
+  if (def.nFaces>0)
+  {
+    boundary_.push_back(def);
+  }
+
+
+  // cell zones
+  for (size_t bi=0; bi<blocks.size(); bi++)
+  {
+    const std::string& zone=bm.allBlocks()[bi].zone();
+    if (!zone.empty())
+    {
+      auto& zl=cellZones_[zone];
+      for (int c=cellOffset[bi]; c<cellOffset[bi]+blocks[bi].nCells(); c++)
+      {
+        zl.push_back(c);
+      }
+    }
+  }
+}
+
+
+
+
+void BlockMeshGenerator::write(const boost::filesystem::path& polyMeshDir, int OFversion) const
+{
+  if (OFversion<210)
+    throw insight::UnsupportedFeature("The in-process mesh generator requires OpenFOAM 2.1 or newer!");
+
+  bf::create_directories(polyMeshDir);
+
+  // remove remainders of a previous mesh
+  for (const std::string& fn: {"points", "faces", "owner", "neighbour", "boundary",
+                                "cellZones", "faceZones", "pointZones"})
+  {
+    bf::remove(polyMeshDir/fn);
+    bf::remove(polyMeshDir/(fn+".gz"));
+  }
+
+  {
+    std::ofstream f( (polyMeshDir/"points").c_str(), std::ios::binary );
+    writeHeader(f, "vectorField", "points");
+    writeBinaryList(f, points_.data()->data(), points_.size(), 3);
+  }
+
+  {
+    std::ofstream f( (polyMeshDir/"faces").c_str(), std::ios::binary );
+    if (OFversion>=230)
+    {
+      std::vector<std::int32_t> offsets(faces_.size()+1), labels(4*faces_.size());
+      for (size_t i=0; i<faces_.size(); i++)
+      {
+        offsets[i]=std::int32_t(4*i);
+        std::copy(faces_[i].begin(), faces_[i].end(), labels.begin()+4*i);
+      }
+      offsets.back()=std::int32_t(labels.size());
+
+      writeHeader(f, "faceCompactList", "faces");
+      writeBinaryList(f, offsets.data(), offsets.size());
+      writeBinaryList(f, labels.data(), labels.size());
+    }
+    else
+    {
+      writeHeader(f, "faceList", "faces");
+      f << "\n" << faces_.size() << "\n(\n";
+      for (const auto& fc: faces_)
+      {
+        std::int32_t l[4]={fc[0], fc[1], fc[2], fc[3]};
+        f << "4(";
+        f.write(reinterpret_cast<const char*>(l), sizeof(l));
+        f << ")\n";
+      }
+      f << ")\n";
+    }
+  }
+
+  {
+    std::vector<std::int32_t> o(owner_.begin(), owner_.end());
+    std::ofstream f( (polyMeshDir/"owner").c_str(), std::ios::binary );
+    writeHeader(f, "labelList", "owner");
+    writeBinaryList(f, o.data(), o.size());
+  }
+
+  {
+    std::vector<std::int32_t> n(neighbour_.begin(), neighbour_.end());
+    std::ofstream f( (polyMeshDir/"neighbour").c_str(), std::ios::binary );
+    writeHeader(f, "labelList", "neighbour");
+    writeBinaryList(f, n.data(), n.size());
+  }
+
+  {
+    OFDictData::dictFile bd;
+    bd.className="polyBoundaryMesh";
+    for (const auto& b: boundary_)
+    {
+      OFDictData::dict d;
+      d["type"]=b.type;
+      d["nFaces"]=b.nFaces;
+      d["startFace"]=b.startFace;
+      if (!b.neighbourPatch.empty())
+      {
+        d["neighbourPatch"]=b.neighbourPatch;
+      }
+      bd[b.name]=d;
+    }
+    std::ofstream f( (polyMeshDir/"boundary").c_str() );
+    writeOpenFOAMBoundaryDict(f, bd);
+  }
+
+  if (cellZones_.size()>0)
+  {
+    std::ofstream f( (polyMeshDir/"cellZones").c_str() );
+    writeHeader(f, "regIOobject", "cellZones", false);
+    f << cellZones_.size() << "\n(\n";
+    for (const auto& z: cellZones_)
+    {
+      f << z.first << "\n{\n"
+        << " type cellZone;\n"
+        << " cellLabels List<label> " << z.second.size() << "\n(\n";
+      for (int c: z.second)
+      {
+        f << c << "\n";
+      }
+      f << ");\n}\n";
+    }
+    f << ")\n";
+  }
+
+  std::cout << "Written mesh with "<<nCells_<<" cells, "<<points_.size()<<" points and "
+            << faces_.size()<<" faces ("<<neighbour_.size()<<" internal) to "<<polyMeshDir<<std::endl;
+}
+
+
+
+
+}
+
+}
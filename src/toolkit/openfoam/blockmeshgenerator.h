@@ -0,0 +1,98 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef INSIGHT_BLOCKMESHGENERATOR_H
+#define INSIGHT_BLOCKMESHGENERATOR_H
+
+#include "openfoam/blockmesh.h"
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace insight {
+
+namespace bmd
+{
+
+
+
+
+/**
+ * In-process creation of the hex mesh of a blockMesh configuration,
+ * replaces the blockMesh utility for simple block structures.
+ *
+ * The numbering of points and cells and the order of the internal faces
+ * are the same as in the mesh of the blockMesh utility.
+ * The points inside the blocks are interpolated from the (curved) block edges
+ * in the same manner as blockMesh does, curved blocks may thus differ slightly.
+ *
+ * Not supported are degenerate blocks (collapsed vertices), ellipse edges,
+ * projected faces and merged patch pairs.
+ */
+class BlockMeshGenerator
+{
+public:
+  typedef std::array<double,3> Vector;
+  typedef std::array<int,4> Face;
+
+  struct Boundary
+  {
+    std::string name, type, neighbourPatch;
+    int startFace, nFaces;
+  };
+
+protected:
+  std::vector<Vector> points_;
+  std::vector<Face> faces_;
+  std::vector<int> owner_, neighbour_;
+  std::vector<Boundary> boundary_;
+  std::map<std::string, std::vector<int> > cellZones_;
+  int nCells_;
+
+public:
+  BlockMeshGenerator(const blockMesh& bm);
+
+  inline const std::vector<Vector>& points() const { return points_; }
+  inline const std::vector<Face>& faces() const { return faces_; }
+  inline const std::vector<int>& owner() const { return owner_; }
+  inline const std::vector<int>& neighbour() const { return neighbour_; }
+  inline const std::vector<Boundary>& boundary() const { return boundary_; }
+  inline const std::map<std::string, std::vector<int> >& cellZones() const { return cellZones_; }
+
+  inline int nCells() const { return nCells_; }
+  inline int nInternalFaces() const { return int(neighbour_.size()); }
+
+  /**
+   * writes the mesh in binary format into polyMeshDir (usually constant/polyMesh).
+   * Existing mesh files are replaced, zone files of a previous mesh are removed.
+   */
+  void write(const boost::filesystem::path& polyMeshDir, int OFversion) const;
+};
+
+
+
+
+}
+
+}
+
+#endif // INSIGHT_BLOCKMESHGENERATOR_H
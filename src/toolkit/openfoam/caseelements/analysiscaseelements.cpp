@@ -72,7 +72,8 @@ std::map<std::string,arma::mat> readAndCombineGroupedTabularFiles
     const std::string& filterChars
 )
 {
-  CurrentExceptionContext ex("reading output files "+fileNamePattern+" for function object "+FOName+" (filtering out any of '"+filterChars+"')");
+  CurrentExceptionContext ex(
+        [&]() { return "reading output files "+fileNamePattern+" for function object "+FOName+" (filtering out any of '"+filterChars+"')"; } );
 
   std::string fileNameBase, fileNameExt;
   {
@@ -144,7 +145,8 @@ std::map<std::string,arma::mat> readAndCombineGroupedTabularFiles
       while ( getline ( f, line ) )
       {
         lineNo++;
-        CurrentExceptionContext ex(str(format("reading line %d of file %s")%lineNo%ffp.string()));
+        CurrentExceptionContext ex(
+              [&]() { return str(format("reading line %d of file %s")%lineNo%ffp.string()); } );
 
         trim(line);
 
@@ -400,7 +402,8 @@ arma::cube probes::readProbes
     const std::string& fieldName 
 )
 {
-  CurrentExceptionContext ex("reading probes data of field "+fieldName+" from function object "+foName+" in case directory \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "reading probes data of field "+fieldName+" from function object "+foName+" in case directory \""+location.string()+"\""; } );
 
   typedef std::vector<arma::mat> Instant;
   typedef std::map<double, Instant> History;
@@ -515,7 +518,8 @@ arma::mat probes::readProbesLocations
     const std::string& foName
 )
 {
-  CurrentExceptionContext ex("reading location of probe points of function object "+foName+" from controlDict in case \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "reading location of probe points of function object "+foName+" from controlDict in case \""+location.string()+"\""; } );
 
   OFDictData::dict controlDict;
   readOpenFOAMDict(location/"system"/"controlDict", controlDict);
@@ -898,6 +902,11 @@ OFDictData::dict twoPointCorrelation::functionObjectDict() const
   fod["np"]=p_.np;
   fod["homogeneousTranslationUnit"]=OFDictData::vector3(p_.homogeneousTranslationUnit);
   fod["nph"]=p_.nph;
+  if (p_.method==Parameters::method_type::fft)
+  {
+    fod["method"]="fft";
+    fod["periodic"]=p_.periodic;
+  }
 
   fod["csys"]=csysConfiguration();
   
@@ -911,7 +920,8 @@ boost::ptr_vector<arma::mat> twoPointCorrelation::readCorrelations
     const std::string& tpcName
 )
 {
-  CurrentExceptionContext ex("reading correlation data of function object "+tpcName+" in case \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "reading correlation data of function object "+tpcName+" in case \""+location.string()+"\""; } );
   int nk=9;
   
   std::vector<double> t; // time step array
@@ -1080,7 +1090,9 @@ void cleanFileContent(string& file)
 
 void readForcesLine(std::istream& f, int nc_expected, bool& skip, std::vector<double>& row)
 {
-  CurrentExceptionContext ex("reading a line from forces file", false);
+  CurrentExceptionContext ex(
+        []() { return std::string("reading a line from forces file"); },
+        false );
 
   std::string line;
 
@@ -1115,7 +1127,8 @@ arma::mat forces::readForces
     const std::string& foName
 )
 {
-  CurrentExceptionContext ex("reading output of forces function object "+foName+" in case \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "reading output of forces function object "+foName+" in case \""+location.string()+"\""; } );
 
   std::vector<std::vector<double> >  fl;
 
@@ -1179,11 +1192,15 @@ arma::mat forces::readForces
           {
             std::vector<double> r1, r2;
             {
-              CurrentExceptionContext ex(str(format("reading line %d from files \"%s\"")%line_num%f_name.string()), false);
+              CurrentExceptionContext ex(
+                    [&]() { return str(format("reading line %d from files \"%s\"")%line_num%f_name.string()); },
+                    false );
               readForcesLine ( f, ncexp, skip, r1 );
             }
             {
-              CurrentExceptionContext ex(str(format("reading line %d from files \"%s\"")%line_num%f2_name.string()), false);
+              CurrentExceptionContext ex(
+                    [&]() { return str(format("reading line %d from files \"%s\"")%line_num%f2_name.string()); },
+                    false );
               readForcesLine ( f2, ncexp, skip, r2 );
             }
 
@@ -1204,7 +1221,9 @@ arma::mat forces::readForces
           }
         else
           {
-            CurrentExceptionContext ex(str(format("reading line %d from file \"%s\"")%line_num%f_name.string()), false);
+            CurrentExceptionContext ex(
+                  [&]() { return str(format("reading line %d from file \"%s\"")%line_num%f_name.string()); },
+                  false );
             readForcesLine ( f, ncexp, skip, row );
             if ( row.size()==0 )
             {
@@ -24,6 +24,20 @@
 #include "openfoam/caseelements/openfoamcaseelement.h"
 #include "base/resultset.h"
 #include "base/analysis.h"
+#include "analysiscaseelements__outputFilterFunctionObject__Parameters_headers.h"
+#include "analysiscaseelements__fieldAveraging__Parameters_headers.h"
+#include "analysiscaseelements__probes__Parameters_headers.h"
+#include "analysiscaseelements__volumeIntegrate__Parameters_headers.h"
+#include "analysiscaseelements__surfaceIntegrate__Parameters_headers.h"
+#include "analysiscaseelements__fieldMinMax__Parameters_headers.h"
+#include "analysiscaseelements__cuttingPlane__Parameters_headers.h"
+#include "analysiscaseelements__twoPointCorrelation__Parameters_headers.h"
+#include "analysiscaseelements__cylindricalTwoPointCorrelation__Parameters_headers.h"
+#include "analysiscaseelements__forces__Parameters_headers.h"
+#include "analysiscaseelements__extendedForces__Parameters_headers.h"
+#include "analysiscaseelements__catalyst__Parameters_headers.h"
+#include "analysiscaseelements__ComputeLengthScale__Parameters_headers.h"
+#include "analysiscaseelements__TPCArrayBase__Parameters_headers.h"
 
 namespace insight {
 
@@ -398,6 +412,8 @@ directionSpan = vector (1 0 0) "Direction and distance of correlation"
 homogeneousTranslationUnit = vector (0 1 0) "Translational distance between two subsequent correlation lines for homogeneous averaging"
 np = int 50 "Number of correlation points"
 nph = int 1 "Number of homogeneous averaging locations"
+method = selection ( direct fft ) direct "Evaluation method. direct correlates the first point of each line with all others on the master processor. fft correlates all point pairs of each line at once and distributes the lines over the processors."
+periodic = bool false "If method is fft: treat the lines as periodic instead of zero-padding them. The period is then np times the point spacing, i.e. directionSpan*np/(np-1)."
 
 <<<PARAMETERSET
 */
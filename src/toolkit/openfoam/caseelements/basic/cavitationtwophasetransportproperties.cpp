@@ -74,7 +74,7 @@ void cavitationTwoPhaseTransportProperties::modifyDefaults(ParameterSet& ps)
         ParameterSet defp = phaseChangeModels::phaseChangeModel::defaultParameters(i->first);
         msp.addItem( i->first, defp );
     }
-    msp.selection() = phaseChangeModels::phaseChangeModel::factories_->begin()->first;
+    msp.setSelection(phaseChangeModels::phaseChangeModel::factories_->begin()->first);
 
 }
 
@@ -2,6 +2,8 @@
 #define INSIGHT_CAVITATIONTWOPHASETRANSPORTPROPERTIES_H
 
 #include "openfoam/caseelements/basic/twophasetransportproperties.h"
+#include "cavitationtwophasetransportproperties__SchnerrSauer__Parameters_headers.h"
+#include "cavitationtwophasetransportproperties__cavitationTwoPhaseTransportProperties__Parameters_headers.h"
 
 
 namespace insight {
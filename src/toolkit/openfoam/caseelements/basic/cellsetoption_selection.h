@@ -3,6 +3,7 @@
 
 #include <string>
 #include "base/boost_include.h"
+#include "cellsetoption_selection__cellSetOption_Selection__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_CONSTANTPRESSUREGRADIENTSOURCE_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "constantpressuregradientsource__ConstantPressureGradientSource__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_COPYFILES_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "copyfiles__copyFiles__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_CUSTOMDICTENTRIES_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "customdictentries__customDictEntries__Parameters_headers.h"
 
 
 namespace insight {
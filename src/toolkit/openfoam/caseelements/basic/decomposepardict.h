@@ -3,6 +3,7 @@
 
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "decomposepardict__decomposeParDict__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_FIXEDVALUECONSTRAINT_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "fixedvalueconstraint__fixedValueConstraint__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_GRAVITY_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "gravity__gravity__Parameters_headers.h"
 
 namespace insight {
 
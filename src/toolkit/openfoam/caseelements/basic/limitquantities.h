@@ -3,6 +3,7 @@
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
 #include "openfoam/caseelements/basic/cellsetoption_selection.h"
+#include "limitquantities__limitQuantities__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_MINIMUMTIMESTEPLIMIT_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "minimumtimesteplimit__minimumTimestepLimit__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_MIRRORMESH_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "mirrormesh__mirrorMesh__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_MRFZONE_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "mrfzone__MRFZone__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_PASSIVESCALAR_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "passivescalar__PassiveScalar__Parameters_headers.h"
 
 namespace insight {
 
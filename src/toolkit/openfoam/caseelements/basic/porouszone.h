@@ -2,6 +2,7 @@
 #define INSIGHT_POROUSZONE_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "porouszone__porousZone__Parameters_headers.h"
 
 
 namespace insight {
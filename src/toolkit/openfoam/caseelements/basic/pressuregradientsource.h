@@ -2,6 +2,7 @@
 #define INSIGHT_PRESSUREGRADIENTSOURCE_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "pressuregradientsource__PressureGradientSource__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_PROVIDEFIELDS_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "providefields__provideFields__Parameters_headers.h"
 
 namespace insight {
 
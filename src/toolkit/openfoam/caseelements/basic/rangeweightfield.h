@@ -2,6 +2,7 @@
 #define RANGEWEIGHTFIELD_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "rangeweightfield__rangeWeightField__Parameters_headers.h"
 
 namespace insight {
 
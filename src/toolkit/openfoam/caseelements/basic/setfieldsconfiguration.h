@@ -2,6 +2,7 @@
 #define INSIGHT_SETFIELDSCONFIGURATION_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "setfieldsconfiguration__setFieldsConfiguration__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,8 @@
 #define INSIGHT_SINGLEPHASETRANSPORTMODEL_H
 
 #include "openfoam/caseelements/basic/transportmodel.h"
+#include "singlephasetransportmodel__singlePhaseTransportProperties__Parameters_headers.h"
+#include "singlephasetransportmodel__boussinesqSinglePhaseTransportProperties__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_SOURCE_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "source__source__Parameters_headers.h"
 
 
 namespace insight {
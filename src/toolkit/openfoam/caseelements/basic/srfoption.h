@@ -2,6 +2,7 @@
 #define INSIGHT_SRFOPTION_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "srfoption__SRFoption__Parameters_headers.h"
 
 
 namespace insight {
@@ -2,6 +2,7 @@
 #define INSIGHT_TWOPHASETRANSPORTPROPERTIES_H
 
 #include "openfoam/caseelements/basic/transportmodel.h"
+#include "twophasetransportproperties__twoPhaseTransportProperties__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_VOLUMEDRAG_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "volumedrag__volumeDrag__Parameters_headers.h"
 
 
 namespace insight {
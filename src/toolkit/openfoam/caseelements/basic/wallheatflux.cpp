@@ -43,7 +43,8 @@ std::map<std::string,arma::mat> wallHeatFlux::readWallHeatFlux(
     const std::string& regionName,
     const std::string& foName )
 {
-  CurrentExceptionContext ex("reading output of wallHeatFlux function object "+foName+" in case \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "reading output of wallHeatFlux function object "+foName+" in case \""+location.string()+"\""; } );
 
   using namespace boost;
   using namespace boost::filesystem;
@@ -2,6 +2,7 @@
 #define INSIGHT_WALLHEATFLUX_H
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "wallheatflux__wallHeatFlux__Parameters_headers.h"
 
 namespace insight {
 
@@ -7,6 +7,10 @@
 #include "openfoam/openfoamcase.h"
 
 #include "openfoam/fielddata.h"
+#include "boundarycondition_heat__FixedTemperatureBC__Parameters_headers.h"
+#include "boundarycondition_heat__TemperatureGradientBC__Parameters_headers.h"
+#include "boundarycondition_heat__ExternalWallBC__Parameters_headers.h"
+#include "boundarycondition_heat__CHTCoupledWall__Parameters_headers.h"
 
 
 
@@ -6,6 +6,7 @@
 #include "base/parameterset.h"
 #include "base/resultset.h"
 #include "openfoam/openfoamcase.h"
+#include "boundarycondition_multiphase__uniformPhases__Parameters_headers.h"
 
 
 namespace insight
@@ -5,6 +5,7 @@
 #include "base/parameterset.h"
 #include "base/resultset.h"
 #include "openfoam/openfoamcase.h"
+#include "boundarycondition_turbulence__uniformIntensityAndLengthScale__Parameters_headers.h"
 
 
 namespace insight
@@ -2,6 +2,7 @@
 #define INSIGHT_COMPRESSIBLEINLETBC_H
 
 #include "openfoam/caseelements/boundaryconditions/velocityinletbc.h"
+#include "compressibleinletbc__CompressibleInletBC__Parameters_headers.h"
 
 namespace insight {
 
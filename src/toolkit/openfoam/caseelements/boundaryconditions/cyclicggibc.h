@@ -3,6 +3,7 @@
 
 
 #include "openfoam/caseelements/boundaryconditions/ggibcbase.h"
+#include "cyclicggibc__CyclicGGIBC__Parameters_headers.h"
 
 namespace insight {
 
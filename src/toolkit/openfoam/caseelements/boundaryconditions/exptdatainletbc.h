@@ -4,6 +4,7 @@
 #include "openfoam/caseelements/boundarycondition.h"
 
 #include "openfoam/caseelements/boundaryconditions/boundarycondition_multiphase.h"
+#include "exptdatainletbc__ExptDataInletBC__Parameters_headers.h"
 
 namespace insight {
 
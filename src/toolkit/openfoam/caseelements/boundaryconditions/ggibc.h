@@ -3,6 +3,7 @@
 
 
 #include "openfoam/caseelements/boundaryconditions/ggibcbase.h"
+#include "ggibc__GGIBC__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_GGIBCBASE_H
 
 #include "openfoam/caseelements/boundarycondition.h"
+#include "ggibcbase__GGIBCBase__Parameters_headers.h"
 
 namespace insight {
 
@@ -5,6 +5,7 @@
 #include "openfoam/caseelements/boundarycondition.h"
 
 #include "openfoam/caseelements/boundaryconditions/boundarycondition_multiphase.h"
+#include "mappedvelocityinletbc__MappedVelocityInletBC__Parameters_headers.h"
 
 namespace insight {
 
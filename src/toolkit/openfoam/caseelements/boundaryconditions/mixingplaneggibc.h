@@ -2,6 +2,7 @@
 #define INSIGHT_MIXINGPLANEGGIBC_H
 
 #include "openfoam/caseelements/boundaryconditions/ggibcbase.h"
+#include "mixingplaneggibc__MixingPlaneGGIBC__Parameters_headers.h"
 
 namespace insight {
 
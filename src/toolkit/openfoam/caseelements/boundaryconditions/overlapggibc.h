@@ -3,6 +3,7 @@
 
 
 #include "openfoam/caseelements/boundaryconditions/ggibcbase.h"
+#include "overlapggibc__OverlapGGIBC__Parameters_headers.h"
 
 namespace insight {
 
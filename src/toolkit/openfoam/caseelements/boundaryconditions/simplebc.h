@@ -4,6 +4,7 @@
 #include <string>
 
 #include "openfoam/caseelements/boundarycondition.h"
+#include "simplebc__SimpleBC__Parameters_headers.h"
 
 namespace insight {
 
@@ -4,6 +4,7 @@
 #include "openfoam/caseelements/boundarycondition.h"
 
 #include "openfoam/caseelements/boundaryconditions/boundarycondition_multiphase.h"
+#include "suctioninletbc__SuctionInletBC__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,8 @@
 #define INSIGHT_CHTMULTIREGIONNUMERICS_H
 
 #include "openfoam/caseelements/numerics/fvnumerics.h"
+#include "chtmultiregionnumerics__chtMultiRegionNumerics__Parameters_headers.h"
+#include "chtmultiregionnumerics__chtMultiRegionFluidNumerics__Parameters_headers.h"
 
 namespace insight {
 
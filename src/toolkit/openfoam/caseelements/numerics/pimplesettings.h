@@ -4,6 +4,9 @@
 
 #include "base/parameterset.h"
 #include "openfoam/openfoamcase.h"
+#include "pimplesettings__PIMPLESettings__Parameters_headers.h"
+#include "pimplesettings__CompressiblePIMPLESettings__Parameters_headers.h"
+#include "pimplesettings__MultiphasePIMPLESettings__Parameters_headers.h"
 
 
 namespace insight
@@ -2,6 +2,7 @@
 #define INSIGHT_SCALARTRANSPORTFOAMNUMERICS_H
 
 #include "openfoam/caseelements/numerics/fvnumerics.h"
+#include "scalartransportfoamnumerics__scalarTransportFoamNumerics__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_SIMPLEDYMFOAMNUMERICS_H
 
 #include "openfoam/caseelements/numerics/steadyincompressiblenumerics.h"
+#include "simpledymfoamnumerics__simpleDyMFoamNumerics__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_STEADYCOMPRESSIBLENUMERICS_H
 
 #include "openfoam/caseelements/numerics/fvnumerics.h"
+#include "steadycompressiblenumerics__steadyCompressibleNumerics__Parameters_headers.h"
 
 namespace insight {
 
@@ -2,6 +2,7 @@
 #define INSIGHT_STEADYINCOMPRESSIBLENUMERICS_H
 
 #include "openfoam/caseelements/numerics/fvnumerics.h"
+#include "steadyincompressiblenumerics__steadyIncompressibleNumerics__Parameters_headers.h"
 
 namespace insight {
 
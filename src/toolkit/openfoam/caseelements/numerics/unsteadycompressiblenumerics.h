@@ -4,6 +4,7 @@
 #include "openfoam/caseelements/numerics/fvnumerics.h"
 
 #include "openfoam/caseelements/numerics/pimplesettings.h"
+#include "unsteadycompressiblenumerics__unsteadyCompressibleNumerics__Parameters_headers.h"
 
 namespace insight {
 
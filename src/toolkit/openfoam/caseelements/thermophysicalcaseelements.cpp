@@ -1149,14 +1149,16 @@ SpeciesData::SpeciesLibrary::SpeciesLibrary()
           {
             if ( itr->path().extension() == ".species" )
             {
-              CurrentExceptionContext ex("reading species data base "+itr->path().string());
+              CurrentExceptionContext ex(
+                    [&]() { return "reading species data base "+itr->path().string(); } );
               std::ifstream fs(itr->path().string());
               OFDictData::dict sd;
               readOpenFOAMDict(fs, sd);
 
               for (const auto& s: sd)
               {
-                CurrentExceptionContext ex2("reading species "+s.first);
+                CurrentExceptionContext ex2(
+                      [&]() { return "reading species "+s.first; } );
                 auto name=s.first;
                 auto ssd=sd.subDict(s.first);
 
@@ -27,6 +27,10 @@
 #include <string>
 #include <array>
 #include <map>
+#include "thermophysicalcaseelements__cavitatingFoamThermodynamics__Parameters_headers.h"
+#include "thermophysicalcaseelements__SpeciesData__Parameters_headers.h"
+#include "thermophysicalcaseelements__compressibleSinglePhaseThermophysicalProperties__Parameters_headers.h"
+#include "thermophysicalcaseelements__compressibleMixtureThermophysicalProperties__Parameters_headers.h"
 
 namespace insight {
 
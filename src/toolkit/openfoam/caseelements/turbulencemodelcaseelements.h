@@ -34,6 +34,8 @@
 #include "boost/utility.hpp"
 #include "boost/variant.hpp"
 #include "progrock/cppx/collections/options_boosted.h"
+#include "turbulencemodelcaseelements__Smagorinsky_LESModel__Parameters_headers.h"
+#include "turbulencemodelcaseelements__kOmegaSST_RASModel__Parameters_headers.h"
 
 namespace insight 
 {
@@ -4,6 +4,7 @@
 #include "base/parameterset.h"
 #include "base/resultset.h"
 #include "openfoam/openfoamdict.h"
+#include "fielddata__FieldData__Parameters_headers.h"
 
 namespace insight
 {
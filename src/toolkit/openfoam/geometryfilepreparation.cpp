@@ -0,0 +1,513 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "geometryfilepreparation.h"
+
+#include "base/exception.h"
+#include "base/trisurface.h"
+#include "base/units.h"
+#include "openfoam/openfoamcase.h"
+#include "openfoam/openfoamdict.h"
+
+#include "boost/iostreams/filtering_stream.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
+#include "boost/algorithm/string.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+using namespace std;
+using namespace boost;
+namespace bf = boost::filesystem;
+
+namespace insight
+{
+
+
+
+
+namespace
+{
+
+/**
+ * precomputed point transformation
+ */
+class PointTransformer
+{
+  double R_[3][3], s_[3], t_[3];
+
+public:
+  PointTransformer(const GeometryFilePreparation::Transformation& tr)
+  {
+    // same as quaternion(roll, pitch, yaw) in OpenFOAM: Rx*Ry*Rz
+    arma::mat R =
+        rotMatrix(tr.rollPitchYaw(0)*SI::deg, vec3(1,0,0))
+        * rotMatrix(tr.rollPitchYaw(1)*SI::deg, vec3(0,1,0))
+        * rotMatrix(tr.rollPitchYaw(2)*SI::deg, vec3(0,0,1));
+    for (int i=0; i<3; i++)
+    {
+      for (int j=0; j<3; j++) R_[i][j]=R(i,j);
+      s_[i]=tr.scale(i);
+      t_[i]=tr.translate(i);
+    }
+  }
+
+  TriSurface::Point operator()(const TriSurface::Point& p) const
+  {
+    double x[3]={ p[0]+t_[0], p[1]+t_[1], p[2]+t_[2] };
+    TriSurface::Point r;
+    for (int i=0; i<3; i++)
+    {
+      r[i] = s_[i]*( R_[i][0]*x[0] + R_[i][1]*x[1] + R_[i][2]*x[2] );
+    }
+    return r;
+  }
+};
+
+
+void skipComments(std::istream& in)
+{
+  for (;;)
+  {
+    in >> std::ws;
+    if (in.peek()!='/') return;
+    in.get();
+    if (in.peek()=='/')
+    {
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    else if (in.peek()=='*')
+    {
+      char c, prev=0;
+      while (in.get(c) && !(prev=='*' && c=='/')) prev=c;
+    }
+    else
+    {
+      in.unget();
+      return;
+    }
+  }
+}
+
+
+/**
+ * reads an ASCII featureEdgeMesh file.
+ * Returns false, if the file is in binary format.
+ */
+bool readEMesh(const bf::path& file, arma::mat& points, arma::mat& edges)
+{
+  bf::path fn = file;
+  bool compressed=false;
+  if (!bf::exists(fn))
+  {
+    fn = file.string()+".gz";
+    compressed=true;
+    if (!bf::exists(fn))
+      throw insight::Exception("feature edge file does not exist: neither "+file.string()+" nor "+fn.string());
+  }
+
+  std::ifstream f(fn.c_str(), std::ios::binary);
+  boost::iostreams::filtering_istream in;
+  if (compressed) in.push(boost::iostreams::gzip_decompressor());
+  in.push(f);
+
+  std::string t;
+  while (in >> t)
+  {
+    if (t=="format")
+    {
+      in >> t;
+      if (t!="ascii;") return false;
+    }
+    else if (t=="}")
+    {
+      break;
+    }
+  }
+
+  skipComments(in);
+  points=readOpenFOAMNumericList(in, 3);
+  skipComments(in);
+  edges=readOpenFOAMNumericList(in, 2);
+  return true;
+}
+
+
+void writeEMesh(const bf::path& file, const std::vector<TriSurface::Point>& points, const std::vector<std::pair<int,int> >& edges)
+{
+  std::ofstream f(file.c_str());
+  f << "FoamFile\n"
+       "{\n"
+       " version     2.0;\n"
+       " format      ascii;\n"
+       " class       featureEdgeMesh;\n"
+       " location    \"constant/triSurface\";\n"
+       " object      " << file.filename().string() << ";\n"
+       "}\n\n";
+
+  char buf[96];
+  f << points.size() << "\n(\n";
+  for (const auto& p: points)
+  {
+    int l=snprintf(buf, sizeof(buf), "(%.17g %.17g %.17g)\n", p[0], p[1], p[2]);
+    f.write(buf, l);
+  }
+  f << ")\n\n";
+
+  f << edges.size() << "\n(\n";
+  for (const auto& e: edges)
+  {
+    f << "(" << e.first << " " << e.second << ")\n";
+  }
+  f << ")\n";
+}
+
+
+void computeBounds(const std::vector<TriSurface::Point>& pts, GeometryFilePreparation::Result& res)
+{
+  res.bbMin=vec3(1,1,1)*1e100;
+  res.bbMax=vec3(1,1,1)*-1e100;
+  for (const auto& p: pts)
+  {
+    for (int k=0; k<3; k++)
+    {
+      res.bbMin(k)=std::min(res.bbMin(k), p[k]);
+      res.bbMax(k)=std::max(res.bbMax(k), p[k]);
+    }
+  }
+}
+
+
+bool isSTL(const bf::path& file)
+{
+  return boost::algorithm::to_lower_copy(file.extension().string())==".stl";
+}
+
+}
+
+
+
+
+GeometryFilePreparation::Transformation::Transformation
+(
+  const arma::mat& s,
+  const arma::mat& t,
+  const arma::mat& rpy
+)
+  : scale(s), translate(t), rollPitchYaw(rpy)
+{}
+
+
+bool GeometryFilePreparation::Transformation::isIdentity() const
+{
+  return arma::norm(scale-vec3(1,1,1), 2)==0.
+      && arma::norm(translate, 2)==0.
+      && arma::norm(rollPitchYaw, 2)==0.;
+}
+
+
+bool GeometryFilePreparation::Transformation::operator==(const Transformation& o) const
+{
+  return arma::norm(scale-o.scale, 2)==0.
+      && arma::norm(translate-o.translate, 2)==0.
+      && arma::norm(rollPitchYaw-o.rollPitchYaw, 2)==0.;
+}
+
+
+
+
+GeometryFilePreparation::Task* GeometryFilePreparation::findTask(const boost::filesystem::path& to)
+{
+  bf::path ato=bf::absolute(to);
+  for (auto& t: tasks_)
+  {
+    if (bf::absolute(t.to)==ato || (!t.featureEdgeFile.empty() && bf::absolute(t.featureEdgeFile)==ato))
+      return &t;
+  }
+  return nullptr;
+}
+
+
+
+
+void GeometryFilePreparation::process(Task& task)
+{
+  PointTransformer trsf(task.transformation);
+
+  if (task.type==Task::Surface)
+  {
+    if (!isSTL(task.from) || !isSTL(task.to))
+    {
+      if (!task.featureEdgeFile.empty())
+        throw insight::Exception("feature edges can only be extracted from STL files");
+      task.external=true;
+      return;
+    }
+
+    TriSurface s=TriSurface::readSTL(task.from);
+    s.transformPoints(trsf);
+    s.writeSTL(task.to, false, task.to.stem().string());
+
+    task.result.nPoints=s.points().size();
+    task.result.nElements=s.triangles().size();
+    computeBounds(s.points(), task.result);
+
+    if (!task.featureEdgeFile.empty())
+    {
+      auto fe=s.featureEdges(task.includedAngle);
+
+      // store only the points of the feature edges
+      std::vector<int> newIndex(s.points().size(), -1);
+      std::vector<TriSurface::Point> fp;
+      for (auto& e: fe)
+      {
+        for (int* i: {&e.first, &e.second})
+        {
+          if (newIndex[*i]<0)
+          {
+            newIndex[*i]=fp.size();
+            fp.push_back(s.points()[*i]);
+          }
+          *i=newIndex[*i];
+        }
+      }
+      writeEMesh(task.featureEdgeFile, fp, fe);
+    }
+  }
+  else if (task.type==Task::FeatureEdges)
+  {
+    arma::mat p, e;
+    if (!readEMesh(task.from, p, e))
+    {
+      task.external=true;
+      return;
+    }
+
+    std::vector<TriSurface::Point> pts(p.n_rows);
+    for (arma::uword i=0; i<p.n_rows; i++)
+    {
+      pts[i]=trsf(TriSurface::Point{{p(i,0), p(i,1), p(i,2)}});
+    }
+    std::vector<std::pair<int,int> > edges(e.n_rows);
+    for (arma::uword i=0; i<e.n_rows; i++)
+    {
+      edges[i]=std::make_pair(int(e(i,0)), int(e(i,1)));
+    }
+    writeEMesh(task.to, pts, edges);
+
+    task.result.nPoints=pts.size();
+    task.result.nElements=edges.size();
+    computeBounds(pts, task.result);
+  }
+}
+
+
+
+
+void GeometryFilePreparation::addSurface
+(
+  const boost::filesystem::path& from,
+  const boost::filesystem::path& to,
+  const Transformation& transformation,
+  const boost::filesystem::path& featureEdgeFile,
+  double includedAngle
+)
+{
+  // the same surface may be used for several purposes (e.g. geometry and refinement region):
+  // it must be written only once, concurrent writes would corrupt the file
+  Task* et=findTask(to);
+
+  if (!featureEdgeFile.empty())
+  {
+    Task* ft=findTask(featureEdgeFile);
+    if (ft && ft!=et)
+      throw insight::Exception("feature edge file "+featureEdgeFile.string()+" is already written by another geometry file");
+  }
+
+  if (et)
+  {
+    if (et->type!=Task::Surface || bf::absolute(et->to)!=bf::absolute(to) || bf::absolute(et->from)!=bf::absolute(from))
+      throw insight::Exception("target file "+to.string()+" is written from different geometry files");
+    if (!(et->transformation==transformation))
+      throw insight::Exception("geometry file "+to.string()+" is used with different transformations");
+    if (!featureEdgeFile.empty())
+    {
+      if (et->featureEdgeFile.empty())
+      {
+        et->featureEdgeFile=featureEdgeFile;
+        et->includedAngle=includedAngle;
+      }
+      else if (bf::absolute(et->featureEdgeFile)!=bf::absolute(featureEdgeFile) || et->includedAngle!=includedAngle)
+        throw insight::Exception("feature edges of "+to.string()+" are requested with different settings");
+    }
+    return;
+  }
+
+  Task t;
+  t.type=Task::Surface;
+  t.from=from;
+  t.to=to;
+  t.transformation=transformation;
+  t.featureEdgeFile=featureEdgeFile;
+  t.includedAngle=includedAngle;
+  t.external=false;
+  tasks_.push_back(t);
+}
+
+
+
+
+void GeometryFilePreparation::addFeatureEdges
+(
+  const boost::filesystem::path& from,
+  const boost::filesystem::path& to,
+  const Transformation& transformation
+)
+{
+  if (Task* et=findTask(to))
+  {
+    if (et->type!=Task::FeatureEdges || bf::absolute(et->from)!=bf::absolute(from))
+      throw insight::Exception("target file "+to.string()+" is written from different geometry files");
+    if (!(et->transformation==transformation))
+      throw insight::Exception("feature edge file "+to.string()+" is used with different transformations");
+    return;
+  }
+
+  Task t;
+  t.type=Task::FeatureEdges;
+  t.from=from;
+  t.to=to;
+  t.transformation=transformation;
+  t.includedAngle=0.;
+  t.external=false;
+  tasks_.push_back(t);
+}
+
+
+
+
+void GeometryFilePreparation::run(const OpenFOAMCase& ofc, const boost::filesystem::path& location, int nThreads)
+{
+  CurrentExceptionContext ex(
+        [&]() { return str(format("preparing %d geometry files") % tasks_.size()); } );
+
+  if (nThreads<=0)
+    nThreads=std::max(1u, std::thread::hardware_concurrency());
+  nThreads=std::min<int>(nThreads, tasks_.size());
+
+  // the largest files first for better load balance
+  std::vector<size_t> order(tasks_.size());
+  std::vector<std::uintmax_t> sizes(tasks_.size(), 0);
+  for (size_t i=0; i<tasks_.size(); i++)
+  {
+    if (!bf::exists(tasks_[i].to.parent_path()))
+      bf::create_directories(tasks_[i].to.parent_path());
+
+    order[i]=i;
+    boost::system::error_code ec;
+    sizes[i]=bf::file_size(tasks_[i].from, ec);
+    if (ec) sizes[i]=0;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return sizes[a]>sizes[b]; } );
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]()
+  {
+    for (size_t i=next++; i<order.size(); i=next++)
+    {
+      Task& t=tasks_[order[i]];
+      try
+      {
+        process(t);
+      }
+      catch (const std::exception& e)
+      {
+        t.error=e.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i=1; i<nThreads; i++)
+    threads.push_back(std::thread(worker));
+  worker();
+  for (auto& t: threads)
+    t.join();
+
+  std::string errors;
+  for (const auto& t: tasks_)
+  {
+    if (!t.error.empty())
+      errors+="\n"+t.from.string()+": "+t.error;
+  }
+  if (!errors.empty())
+    throw insight::Exception("Failed to prepare geometry files:"+errors);
+
+  for (const auto& t: tasks_)
+  {
+    if (t.external)
+    {
+      ofc.executeCommand(location,
+        t.type==Task::Surface ? "surfaceTransformPoints" : "eMeshTransformPoints",
+        {
+          absolute(t.from).string(),
+          absolute(t.to).string(),
+          "-scale", OFDictData::to_OF(t.transformation.scale),
+          "-translate", OFDictData::to_OF(t.transformation.translate),
+          "-rollPitchYaw", OFDictData::to_OF(t.transformation.rollPitchYaw)
+        }
+      );
+    }
+    else
+    {
+      std::cout << t.to.filename().string() << ": "
+                << t.result.nPoints << " points, "
+                << t.result.nElements << (t.type==Task::Surface ? " triangles" : " edges")
+                << ", bounding box " << toStr(t.result.bbMin) << " - " << toStr(t.result.bbMax)
+                << std::endl;
+    }
+  }
+}
+
+
+
+
+bool GeometryFilePreparation::result(const boost::filesystem::path& to, Result& res) const
+{
+  for (const auto& t: tasks_)
+  {
+    if (t.to==to && !t.external && t.error.empty())
+    {
+      res=t.result;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+
+
+}
@@ -0,0 +1,145 @@
+/*
+ * This file is part of Insight CAE, a workbench for Computer-Aided Engineering 
+ * Copyright (C) 2014  Hannes Kroeger <hannes@kroegeronline.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef INSIGHT_GEOMETRYFILEPREPARATION_H
+#define INSIGHT_GEOMETRYFILEPREPARATION_H
+
+#include "base/boost_include.h"
+#include "base/linearalgebra.h"
+
+#include <string>
+#include <vector>
+
+namespace insight {
+
+class OpenFOAMCase;
+
+
+
+
+/**
+ * In-process preparation of geometry files for meshing,
+ * replaces the calls to surfaceTransformPoints and eMeshTransformPoints.
+ *
+ * All registered files are read, transformed and written concurrently.
+ * Optionally, feature edges are extracted from the transformed surfaces.
+ * Files in formats, which cannot be handled internally (anything else than STL
+ * and ASCII eMesh files), are passed to the OpenFOAM utilities afterwards.
+ */
+class GeometryFilePreparation
+{
+public:
+  /**
+   * transformation like in surfaceTransformPoints:
+   * translation first, then rotation by rollPitchYaw (degrees, X, Y and Z axis), then scaling
+   */
+  struct Transformation
+  {
+    arma::mat scale, translate, rollPitchYaw;
+
+    Transformation
+    (
+      const arma::mat& scale = vec3(1,1,1),
+      const arma::mat& translate = vec3(0,0,0),
+      const arma::mat& rollPitchYaw = vec3(0,0,0)
+    );
+
+    bool isIdentity() const;
+    bool operator==(const Transformation& o) const;
+  };
+
+  struct Result
+  {
+    int nPoints, nElements;
+    arma::mat bbMin, bbMax;
+  };
+
+protected:
+  struct Task
+  {
+    enum Type { Surface, FeatureEdges } type;
+    boost::filesystem::path from, to;
+    Transformation transformation;
+    boost::filesystem::path featureEdgeFile;
+    double includedAngle;
+
+    bool external;
+    Result result;
+    std::string error;
+  };
+
+  std::vector<Task> tasks_;
+
+  /**
+   * the task, which writes the given target file (if any)
+   */
+  Task* findTask(const boost::filesystem::path& to);
+
+  static void process(Task& task);
+
+public:
+  /**
+   * registers a surface file (STL).
+   * If featureEdgeFile is not empty, the feature edges of the transformed
+   * surface are written to this eMesh file.
+   * Registering the same target file again is allowed, if source and transformation are the same.
+   */
+  void addSurface
+  (
+    const boost::filesystem::path& from,
+    const boost::filesystem::path& to,
+    const Transformation& transformation,
+    const boost::filesystem::path& featureEdgeFile = boost::filesystem::path(),
+    double includedAngle = 150.
+  );
+
+  /**
+   * registers a feature edge file (eMesh).
+   * A compressed file is used, if from itself does not exist.
+   * Registering the same target file again is allowed, if source and transformation are the same.
+   */
+  void addFeatureEdges
+  (
+    const boost::filesystem::path& from,
+    const boost::filesystem::path& to,
+    const Transformation& transformation
+  );
+
+  inline size_t size() const { return tasks_.size(); }
+
+  /**
+   * processes all registered files.
+   * @nThreads: number of concurrent threads, all available cores, if <=0
+   */
+  void run(const OpenFOAMCase& ofc, const boost::filesystem::path& location, int nThreads=0);
+
+  /**
+   * point and element count and bounding box of the prepared file.
+   * Not available for files, which were processed by OpenFOAM utilities.
+   */
+  bool result(const boost::filesystem::path& to, Result& res) const;
+};
+
+
+
+
+}
+
+#endif // INSIGHT_GEOMETRYFILEPREPARATION_H
@@ -3,9 +3,11 @@
 namespace insight {
 
 
-OFEnvironment::OFEnvironment(int version, const boost::filesystem::path& bashrc)
+OFEnvironment::OFEnvironment(int version, const boost::filesystem::path& bashrc, WriteFormat writeFormat, bool writeCompressed)
 : version_(version),
-  bashrc_(bashrc)
+  bashrc_(bashrc),
+  writeFormat_(writeFormat),
+  writeCompressed_(writeCompressed)
 {
 }
 
@@ -19,6 +21,12 @@ const boost::filesystem::path& OFEnvironment::bashrc() const
   return bashrc_;
 }
 
+void OFEnvironment::setWriteFormat(WriteFormat writeFormat, bool writeCompressed)
+{
+  writeFormat_=writeFormat;
+  writeCompressed_=writeCompressed;
+}
+
 
 
 } // namespace insight
@@ -10,15 +10,31 @@ namespace insight {
 class OFEnvironment
     : public SoftwareEnvironment
 {
+public:
+    /**
+     * storage format of large numeric lists (e.g. nonuniform fields)
+     */
+    typedef enum {
+        asciiFormat,
+        binaryFormat
+    } WriteFormat;
+
 protected:
     int version_;
     boost::filesystem::path bashrc_;
+    WriteFormat writeFormat_;
+    bool writeCompressed_;
 
 public:
-    OFEnvironment ( int version, const boost::filesystem::path& bashrc );
+    OFEnvironment ( int version, const boost::filesystem::path& bashrc, WriteFormat writeFormat=asciiFormat, bool writeCompressed=false );
 
     virtual int version() const;
     virtual const boost::filesystem::path& bashrc() const;
+
+    inline WriteFormat writeFormat() const { return writeFormat_; }
+    inline bool writeBinary() const { return writeFormat_==binaryFormat; }
+    inline bool writeCompressed() const { return writeCompressed_; }
+    void setWriteFormat(WriteFormat writeFormat, bool writeCompressed=false);
     //virtual int executeCommand(const std::vector<std::string>& args) const;
 };
 
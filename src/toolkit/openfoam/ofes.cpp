@@ -133,7 +133,22 @@ OFEs::OFEs()
                std::string bashrc(e->first_attribute("bashrc")->value());
                std::string version(e->first_attribute("version")->value());
 
-               (*this).insert(label, new OFEnvironment(boost::lexical_cast<int>(version), bashrc)); 
+               // optional: writeFormat="binary" writeCompression="on"
+               OFEnvironment::WriteFormat wf=OFEnvironment::asciiFormat;
+               if (xml_attribute<> *a = e->first_attribute("writeFormat"))
+               {
+                 std::string f(a->value());
+                 if (f=="binary") wf=OFEnvironment::binaryFormat;
+                 else if (f!="ascii")
+                   throw insight::Exception("Unknown write format: "+f);
+               }
+               bool compressed=false;
+               if (xml_attribute<> *a = e->first_attribute("writeCompression"))
+               {
+                 compressed = (std::string(a->value())=="on");
+               }
+
+               (*this).insert(label, new OFEnvironment(boost::lexical_cast<int>(version), bashrc, wf, compressed)); 
               }
           }
           catch (const std::exception& e)
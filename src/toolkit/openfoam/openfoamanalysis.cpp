@@ -135,7 +135,8 @@ void OpenFOAMAnalysis::calcDerivedInputData(ProgressDisplayer&)
 
 void OpenFOAMAnalysis::createDictsInMemory(OpenFOAMCase& cm, std::shared_ptr<OFdicts>& dicts)
 {
-  CurrentExceptionContext ex("creating OpenFOAM dictionaries in memory for case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "creating OpenFOAM dictionaries in memory for case \""+executionPath().string()+"\""; } );
   dicts=cm.createDictionaries();
 }
 
@@ -144,7 +145,8 @@ void OpenFOAMAnalysis::createDictsInMemory(OpenFOAMCase& cm, std::shared_ptr<OFd
 
 void OpenFOAMAnalysis::applyCustomOptions(OpenFOAMCase& cm, std::shared_ptr<OFdicts>& dicts)
 {
-  CurrentExceptionContext ex("applying custom options to OpenFOAM case configuration for case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "applying custom options to OpenFOAM case configuration for case \""+executionPath().string()+"\""; } );
 
   Parameters p(parameters_);
   
@@ -171,7 +173,8 @@ void OpenFOAMAnalysis::applyCustomOptions(OpenFOAMCase& cm, std::shared_ptr<OFdi
 
 void OpenFOAMAnalysis::writeDictsToDisk(OpenFOAMCase& cm, std::shared_ptr<OFdicts>& dicts)
 {
-  CurrentExceptionContext ex("writing OpenFOAM dictionaries to case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "writing OpenFOAM dictionaries to case \""+executionPath().string()+"\""; } );
 
   cm.createOnDisk(executionPath(), dicts);
   cm.modifyCaseOnDisk(executionPath());
@@ -182,7 +185,8 @@ void OpenFOAMAnalysis::applyCustomPreprocessing(OpenFOAMCase&, ProgressDisplayer
 
 void OpenFOAMAnalysis::mapFromOther(OpenFOAMCase& cm, ProgressDisplayer& parentAction, const boost::filesystem::path& mapFromPath, bool is_parallel)
 {
-  CurrentExceptionContext ex("mapping existing CFD solution from case \""+mapFromPath.string()+"\" to case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "mapping existing CFD solution from case \""+mapFromPath.string()+"\" to case \""+executionPath().string()+"\""; } );
 
   if (const RASModel* rm=cm.get<RASModel>(".*"))
   {
@@ -194,7 +198,8 @@ void OpenFOAMAnalysis::mapFromOther(OpenFOAMCase& cm, ProgressDisplayer& parentA
         std::string omodel=readTurbulenceModelName(oc, mapFromPath);
         if ( (rm->type()!=omodel) && (omodel!="kOmegaSST2"))
         {
-          CurrentExceptionContext ex("converting turbulence quantities in case \""+mapFromPath.string()+"\" since the turbulence model is different.");
+          CurrentExceptionContext ex(
+                [&]() { return "converting turbulence quantities in case \""+mapFromPath.string()+"\" since the turbulence model is different."; } );
           parentAction.message(ex);
           oc.executeCommand(mapFromPath, "createTurbulenceFields", list_of("-latestTime") );
         }
@@ -212,7 +217,8 @@ void OpenFOAMAnalysis::mapFromOther(OpenFOAMCase& cm, ProgressDisplayer& parentA
 
 void OpenFOAMAnalysis::initializeSolverRun(ProgressDisplayer& parentProgress, OpenFOAMCase& cm)
 {
-  CurrentExceptionContext ex("initializing solver run for case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "initializing solver run for case \""+executionPath().string()+"\""; } );
 
   Parameters p(parameters_);
     
@@ -311,7 +317,8 @@ void OpenFOAMAnalysis::runSolver(ProgressDisplayer& parentProgress, OpenFOAMCase
 
 void OpenFOAMAnalysis::finalizeSolverRun(OpenFOAMCase& cm, ProgressDisplayer& parentAction)
 {
-  CurrentExceptionContext ex("finalizing solver run for case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "finalizing solver run for case \""+executionPath().string()+"\""; } );
 
   int np=readDecomposeParDict(executionPath());
   bool is_parallel = np>1;
@@ -341,7 +348,8 @@ void OpenFOAMAnalysis::finalizeSolverRun(OpenFOAMCase& cm, ProgressDisplayer& pa
 
 ResultSetPtr OpenFOAMAnalysis::evaluateResults(OpenFOAMCase& cm, ProgressDisplayer& parentActionProgress)
 {
-  CurrentExceptionContext ex("evaluating the results for case \""+executionPath().string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "evaluating the results for case \""+executionPath().string()+"\""; } );
 
 
   Parameters p(parameters_);
@@ -378,7 +386,8 @@ void OpenFOAMAnalysis::createCaseOnDisk(OpenFOAMCase& runCase, ProgressDisplayer
 {
   path dir = executionPath();
 
-  CurrentExceptionContext ex("creating OpenFOAM case in directory \""+dir.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "creating OpenFOAM case in directory \""+dir.string()+"\""; } );
 
     Parameters p(parameters_);
 
@@ -27,6 +27,7 @@
 #include "openfoam/caseelements/turbulencemodel.h"
 #include "base/progressdisplayer/textprogressdisplayer.h"
 #include "base/progressdisplayer/convergenceanalysisdisplayer.h"
+#include "openfoamanalysis__OpenFOAMAnalysis__Parameters_headers.h"
 
 
 
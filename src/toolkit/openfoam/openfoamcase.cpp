@@ -24,6 +24,7 @@
 #include "base/analysis.h"
 #include "base/boost_include.h"
 #include "base/outputanalyzer.h"
+#include "openfoam/blockmesh.h"
 #include "openfoam/blockmeshoutputanalyzer.h"
 
 #include "openfoam/ofes.h"
@@ -168,6 +169,20 @@ bool OpenFOAMCase::hasCyclicBC() const
   return (cyclics.size()>0);
 }
 
+void OpenFOAMCase::writeField
+(
+    const boost::filesystem::path& fieldFile,
+    const OFDictData::dictFile& fieldDict,
+    const arma::mat& internalField
+) const
+{
+  writeOpenFOAMField
+  (
+      fieldFile, fieldDict, internalField,
+      env_.writeBinary(), env_.writeCompressed()
+  );
+}
+
 
 void OpenFOAMCase::modifyFilesOnDiskBeforeDictCreation ( const boost::filesystem::path& location ) const
 {
@@ -770,9 +785,27 @@ void OpenFOAMCase::runBlockMesh
 (
     const boost::filesystem::path& location,
     int nBlocks,
-    ProgressDisplayer* progressDisplayer
+    ProgressDisplayer* progressDisplayer,
+    bool inProcess
 )
 {
+  if (inProcess)
+  {
+    auto bms = findElements<bmd::blockMesh>();
+    if (bms.size()==1)
+    {
+      try
+      {
+        (*bms.begin())->writePolyMesh(location);
+        return;
+      }
+      catch (const insight::UnsupportedFeature& e)
+      {
+        std::cout<<"Using blockMesh utility: "<<e.message()<<std::endl;
+      }
+    }
+  }
+
   BlockMeshOutputAnalyzer bma(progressDisplayer, nBlocks);
   runSolver(location, bma, "blockMesh");
 }
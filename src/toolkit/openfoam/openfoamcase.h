@@ -103,6 +103,24 @@ public:
         return env_.version();
     }
 
+    /**
+     * select the format for large numeric lists written by writeField
+     */
+    inline void setWriteFormat ( OFEnvironment::WriteFormat writeFormat, bool writeCompressed=false )
+    {
+        env_.setWriteFormat(writeFormat, writeCompressed);
+    }
+
+    /**
+     * write a field file with nonuniform internal field in the format selected for this case
+     */
+    void writeField
+    (
+        const boost::filesystem::path& fieldFile,
+        const OFDictData::dictFile& fieldDict,
+        const arma::mat& internalField
+    ) const;
+
     bool isCompressible() const;
 
     void modifyFilesOnDiskBeforeDictCreation ( const boost::filesystem::path& location ) const;
@@ -161,11 +179,17 @@ public:
         std::string *ovr_machine = nullptr
     ) const;
 
+    /**
+     * creates the mesh from the blockMesh element of this case.
+     * @inProcess: write the mesh directly without the blockMesh utility, if the
+     * block configuration is supported by the in-process generator. Falls back to the utility otherwise.
+     */
     void runBlockMesh
     (
         const boost::filesystem::path& location,
         int nBlocks=1,
-        ProgressDisplayer* progressDisplayer=nullptr
+        ProgressDisplayer* progressDisplayer=nullptr,
+        bool inProcess=false
     );
 
     inline const FieldList& fields() const
@@ -32,6 +32,12 @@
 #include "boost/iostreams/filtering_stream.hpp"
 #include "boost/iostreams/filter/gzip.hpp"
 
+#include <cctype>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 using namespace std;
 using namespace boost;
 
@@ -237,6 +243,23 @@ bool readOpenFOAMDict(std::istream& in, OFDictData::dict& d)
     return true;
 }
 
+void writeOpenFOAMDictHeader(std::ostream& out, const OFDictData::dictFile& d, const std::string& objname, bool binary)
+{
+  out<<"FoamFile\n"
+     <<"{\n"
+     <<" version     "<<d.dictVersion<<";\n"
+     <<" format      "<<(binary?"binary":"ascii")<<";\n";
+  if (binary)
+  {
+    const int one=1;
+    bool lsb = *reinterpret_cast<const char*>(&one)==1;
+    out<<" arch        \""<<(lsb?"LSB":"MSB")<<";label=32;scalar=64\";\n";
+  }
+  out<<" class       "<<d.className<<";\n"
+     <<" object      "<<objname<<";\n"
+     <<"}\n";
+}
+
 void writeOpenFOAMDict(const boost::filesystem::path& dictpath, const OFDictData::dictFile& dict)
 {
   if (!exists(dictpath.parent_path())) 
@@ -251,13 +274,7 @@ void writeOpenFOAMDict(const boost::filesystem::path& dictpath, const OFDictData
 void writeOpenFOAMDict(std::ostream& out, const OFDictData::dictFile& d, const std::string& objname)
 {
   out /*<< std::scientific*/ << std::setprecision(18);
-    out<<"FoamFile"<<endl
-       <<"{"<<endl
-       <<" version     "+lexical_cast<std::string>(d.dictVersion)+";"<<endl
-       <<" format      ascii;"<<endl
-       <<" class       "+d.className+";"<<endl
-       <<" object      " << objname << ";"<<endl
-       <<"}"<<endl;
+    writeOpenFOAMDictHeader(out, d, objname);
 
     for (OFDictData::dict::const_iterator i=d.begin(); i!=d.end(); i++)
     {
@@ -334,13 +351,7 @@ void writeOpenFOAMBoundaryDict(std::ostream& out, const OFDictData::dictFile& d,
   );
 
   out /*<< std::scientific*/ << std::setprecision(18);
-    out<<"FoamFile"<<endl
-       <<"{"<<endl
-       <<" version     "+lexical_cast<std::string>(d.dictVersion)+";"<<endl
-       <<" format      ascii;"<<endl
-       <<" class       "+d.className+";"<<endl
-       <<" object      boundary;"<<endl
-       <<"}"<<endl;
+    writeOpenFOAMDictHeader(out, d, "boundary");
 
     out << ord.size() << endl
         << "(" << endl;
@@ -362,13 +373,7 @@ void writeOpenFOAMSequentialDict(std::ostream& out, const OFDictData::dictFile&
   out /*<< std::scientific*/ << std::setprecision(18);
   if (!skip_header)
   {
-    out<<"FoamFile"<<endl
-       <<"{"<<endl
-       <<" version     "+lexical_cast<std::string>(d.dictVersion)+";"<<endl
-       <<" format      ascii;"<<endl
-       <<" class       "+d.className+";"<<endl
-       <<" object      " << objname << ";"<<endl
-       <<"}"<<endl;
+    writeOpenFOAMDictHeader(out, d, objname);
   }
   for (OFDictData::dict::const_iterator i=d.begin(); i!=d.end(); i++)
   {
@@ -384,6 +389,514 @@ bool patchExists(const OFDictData::dict& bd, const std::string& patchName)
   return (bd.find(patchName)!=bd.end());
 }
 
+
+
+
+std::string OFListTypeName(arma::uword nCmpt)
+{
+  switch (nCmpt)
+  {
+    case 1: return "List<scalar>";
+    case 3: return "List<vector>";
+    case 6: return "List<symmTensor>";
+    case 9: return "List<tensor>";
+  }
+  throw insight::Exception(str(format("There is no OpenFOAM type with %d components!")%nCmpt));
+}
+
+
+arma::uword OFListTypeComponents(const std::string& typeName)
+{
+  if (typeName=="List<scalar>" || typeName=="List<sphericalTensor>") return 1;
+  if (typeName=="List<vector>") return 3;
+  if (typeName=="List<symmTensor>") return 6;
+  if (typeName=="List<tensor>") return 9;
+  throw insight::Exception("Unsupported list type: "+typeName);
+}
+
+
+void writeOpenFOAMNumericList(std::ostream& out, const arma::mat& v, bool binary)
+{
+  const arma::uword n=v.n_rows, nc=v.n_cols;
+
+  out << OFListTypeName(nc) << "\n" << n;
+
+  if (binary)
+  {
+    // raw data is row-major, copy in chunks to avoid a transposed copy of everything
+    const arma::uword chunk=65536;
+    std::vector<double> buf;
+
+    out << "(";
+    for (arma::uword r0=0; r0<n; r0+=chunk)
+    {
+      arma::uword r1=std::min(n, r0+chunk);
+      buf.resize((r1-r0)*nc);
+      for (arma::uword r=r0; r<r1; r++)
+      {
+        for (arma::uword c=0; c<nc; c++)
+        {
+          buf[(r-r0)*nc+c]=v(r,c);
+        }
+      }
+      out.write(reinterpret_cast<const char*>(buf.data()), buf.size()*sizeof(double));
+    }
+    out << ")";
+  }
+  else
+  {
+    // snprintf is considerably faster than ostream formatting
+    char buf[32];
+
+    out << "\n(\n";
+    for (arma::uword r=0; r<n; r++)
+    {
+      if (nc>1) out.put('(');
+      for (arma::uword c=0; c<nc; c++)
+      {
+        int l=snprintf(buf, sizeof(buf), "%.17g", v(r,c));
+        if (c>0) out.put(' ');
+        out.write(buf, l);
+      }
+      if (nc>1) out.put(')');
+      out.put('\n');
+    }
+    out << ")";
+  }
+}
+
+
+arma::mat readOpenFOAMNumericList(std::istream& in, arma::uword nCmpt, bool binary)
+{
+  arma::uword n;
+  char c;
+
+  if (! (in >> n >> c) )
+    throw insight::Exception("Could not read list size!");
+
+  if (c=='{')
+  {
+    // uniform list, e.g. written by OpenFOAM as "N{value}"
+    double v[9];
+    for (arma::uword j=0; j<nCmpt; j++)
+    {
+      in >> std::ws;
+      if (in.peek()=='(') in.get();
+      in >> v[j];
+    }
+    arma::mat res(n, nCmpt);
+    for (arma::uword j=0; j<nCmpt; j++) res.col(j).fill(v[j]);
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '}');
+    return res;
+  }
+
+  if (c!='(')
+    throw insight::Exception(str(format("Expected \"(\" after list size but got \"%c\"!")%c));
+
+  // filled transposed: memory layout of the (nCmpt x n) matrix equals the row-major file layout
+  arma::mat res(nCmpt, n);
+
+  if (binary)
+  {
+    in.read(reinterpret_cast<char*>(res.memptr()), res.n_elem*sizeof(double));
+    if (in.gcount() != std::streamsize(res.n_elem*sizeof(double)))
+      throw insight::Exception("Unexpected end of binary list data!");
+  }
+  else
+  {
+    for (arma::uword i=0; i<n; i++)
+    {
+      if (nCmpt>1) in >> c;
+      for (arma::uword j=0; j<nCmpt; j++)
+      {
+        in >> res(j,i);
+      }
+      if (nCmpt>1) in >> c;
+    }
+    if (!in)
+      throw insight::Exception("Error reading ascii list data!");
+  }
+
+  in >> c;
+  if (c!=')')
+    throw insight::Exception("Expected \")\" at end of list!");
+
+  arma::inplace_trans(res);
+  return res;
+}
+
+
+namespace
+{
+
+
+/**
+ * writes a dict like OFDictData::dict::write, but with the nonuniform
+ * lists in binary format. The text parser keeps such entries as raw strings,
+ * e.g. "nonuniform List<scalar> 2(1 2)".
+ * Returns false, if one of them is not a numeric list.
+ */
+bool writeBinaryListsDict(std::ostream& os, const OFDictData::dict& d, int indentLevel=0)
+{
+  std::string prec(indentLevel, ' ');
+  std::string pren(indentLevel+1, ' ');
+
+  os << prec << "{\n";
+  for (const OFDictData::dict::value_type& i: d)
+  {
+    os << pren << i.first << OFDictData::SPACE;
+    if (const OFDictData::dict *sd = boost::get<OFDictData::dict>(&i.second))
+    {
+      os<<"\n";
+      if (!writeBinaryListsDict(os, *sd, indentLevel+1))
+        return false;
+    }
+    else if (const std::string *s = boost::get<std::string>(&i.second))
+    {
+      std::istringstream is(*s);
+      std::string kw, type;
+      if ( (is >> kw) && kw=="nonuniform" )
+      {
+        arma::mat v;
+        try
+        {
+          is >> type;
+          v=readOpenFOAMNumericList(is, OFListTypeComponents(type), false);
+        }
+        catch (const std::exception&)
+        {
+          return false;
+        }
+        if (!(is >> std::ws).eof())
+          return false;
+
+        os << "nonuniform ";
+        writeOpenFOAMNumericList(os, v, true);
+        os << ";\n";
+      }
+      else
+      {
+        os << *s << ";\n";
+      }
+    }
+    else
+    {
+      os << i.second << ";\n";
+    }
+  }
+  os << prec << "}\n";
+
+  return true;
+}
+
+
+/**
+ * returns the existing file of a field,
+ * the uncompressed one or, if that does not exist, the compressed one.
+ */
+boost::filesystem::path existingFieldFile(const boost::filesystem::path& fieldFile, bool& compressed)
+{
+  compressed=false;
+  if (exists(fieldFile))
+    return fieldFile;
+
+  boost::filesystem::path fn = fieldFile.string()+".gz";
+  if (!exists(fn))
+    throw insight::Exception("Neither file "+fieldFile.string()+" nor "+fn.string()+" exist!");
+
+  compressed=true;
+  return fn;
+}
+
+
+/**
+ * reads the text up to and including the FoamFile header dict.
+ * The header is ascii in any format, the binary data follows later.
+ */
+std::string readFoamFileHeaderText(std::istream& in)
+{
+  std::string txt;
+  int depth=0;
+  char c;
+
+  while (in.get(c))
+  {
+    txt+=c;
+    if (c=='/' && (in.peek()=='*' || in.peek()=='/'))
+    {
+      // comments are handled by the parser, but braces inside must not count
+      char t;
+      in.get(t);
+      txt+=t;
+      char prev=0;
+      while (in.get(c))
+      {
+        txt+=c;
+        if ( (t=='*' && prev=='*' && c=='/') || (t=='/' && c=='\n') )
+          break;
+        prev=c;
+      }
+    }
+    else if (c=='{')
+    {
+      ++depth;
+    }
+    else if (c=='}')
+    {
+      if (--depth==0)
+        return txt;
+    }
+  }
+
+  throw insight::Exception("No complete FoamFile header found!");
+}
+
+
+/**
+ * parses the header text and returns the FoamFile dict
+ */
+OFDictData::dict parseFoamFileHeader(std::string header)
+{
+  OFDictData::dict d;
+  if (!parseOpenFOAMDict<OpenFOAMDictParser<std::string::iterator> >(header.begin(), header.end(), d))
+    throw insight::Exception("Failed to parse the FoamFile header!");
+  return d.subDict("FoamFile");
+}
+
+
+bool isBinaryFormat(const OFDictData::dict& foamFile)
+{
+  if (foamFile.find("format")==foamFile.end())
+    return false; // ascii is the default
+
+  const std::string& fmt = foamFile.lookup<std::string>("format");
+  if (fmt=="binary")
+    return true;
+  else if (fmt=="ascii")
+    return false;
+  else
+    throw insight::Exception("Unsupported file format: "+fmt);
+}
+
+
+}
+
+
+void writeOpenFOAMField
+(
+    const boost::filesystem::path& fieldFile,
+    const OFDictData::dictFile& d,
+    const arma::mat& internalField,
+    bool binary,
+    bool compressed
+)
+{
+  if (!exists(fieldFile.parent_path()))
+  {
+    boost::filesystem::create_directories(fieldFile.parent_path());
+  }
+
+  // nonuniform boundary values have to be binary in a binary file as well.
+  // If any of them is not a numeric list, everything is written in ascii.
+  std::ostringstream bfs;
+  bfs << std::setprecision(18);
+  OFDictData::dict::const_iterator bf=d.find("boundaryField");
+  if (bf!=d.end())
+  {
+    const OFDictData::dict* bfd = boost::get<OFDictData::dict>(&bf->second);
+    if (binary && !(bfd && writeBinaryListsDict(bfs, *bfd)))
+    {
+      binary=false;
+      bfs.str("");
+    }
+    if (!binary)
+    {
+      bfs << bf->second;
+    }
+  }
+
+  boost::filesystem::path fn = fieldFile, other = fieldFile.string()+".gz";
+  if (compressed) std::swap(fn, other);
+
+  // OpenFOAM would read a remaining file of the previous format
+  if (exists(other)) boost::filesystem::remove(other);
+
+  std::ofstream f(fn.c_str(), std::ios::binary);
+  boost::iostreams::filtering_ostream out;
+  if (compressed) out.push(boost::iostreams::gzip_compressor());
+  out.push(f);
+
+  out << std::setprecision(18);
+  writeOpenFOAMDictHeader(out, d, boost::filesystem::basename(fieldFile), binary);
+
+  // conventional order: everything else, internal field, boundary field
+  for (OFDictData::dict::const_iterator i=d.begin(); i!=d.end(); i++)
+  {
+    if ( i->first!="internalField" && i->first!="boundaryField" )
+    {
+      out<< i->first << " " << i->second;
+      if (!boost::get<OFDictData::dict>(&i->second)) out<<";";
+      out << "\n";
+    }
+  }
+
+  out << "internalField nonuniform ";
+  writeOpenFOAMNumericList(out, internalField, binary);
+  out << ";\n";
+
+  if (bf!=d.end())
+  {
+    out << bf->first << " " << bfs.str() << "\n";
+  }
+
+  // closes the chain, required to complete the gzip stream
+  out.reset();
+}
+
+
+void readOpenFOAMField
+(
+    const boost::filesystem::path& fieldFile,
+    OFDictData::dictFile& d
+)
+{
+  CurrentExceptionContext ex(
+        [&]() { return "reading field file "+fieldFile.string(); } );
+
+  bool compressed;
+  boost::filesystem::path fn = existingFieldFile(fieldFile, compressed);
+
+  std::string contents;
+  {
+    std::ifstream f(fn.c_str(), std::ios::binary);
+    boost::iostreams::filtering_istream in;
+    if (compressed) in.push(boost::iostreams::gzip_decompressor());
+    in.push(f);
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  std::istringstream is(contents);
+  std::string header = readFoamFileHeaderText(is);
+  OFDictData::dict foamFile = parseFoamFileHeader(header);
+
+  if (isBinaryFormat(foamFile))
+  {
+    // replace the binary lists by their ascii representation.
+    // The contents are scanned in order and list data is skipped,
+    // so binary data is never taken for text.
+    std::string text;
+    std::string::size_type last=0, pos=header.size();
+    while (pos<contents.size())
+    {
+      char c=contents[pos];
+      if (c=='/' && pos+1<contents.size() && (contents[pos+1]=='*' || contents[pos+1]=='/'))
+      {
+        pos = (contents[pos+1]=='*') ?
+              contents.find("*/", pos+2) : contents.find('\n', pos+2);
+        if (pos==std::string::npos) break;
+        pos += (contents[pos]=='*') ? 2 : 1;
+      }
+      else if (c=='"')
+      {
+        pos=contents.find('"', pos+1);
+        if (pos==std::string::npos) break;
+        ++pos;
+      }
+      else if ( contents.compare(pos, 5, "List<")==0
+                && (pos==0 || std::isspace(static_cast<unsigned char>(contents[pos-1]))) )
+      {
+        std::string::size_type te=contents.find('>', pos);
+        if (te==std::string::npos)
+          throw insight::Exception("Incomplete list type name!");
+        std::string type=contents.substr(pos, te+1-pos);
+
+        is.clear();
+        is.seekg(te+1);
+        arma::mat v=readOpenFOAMNumericList(is, OFListTypeComponents(type), true);
+
+        std::ostringstream os;
+        writeOpenFOAMNumericList(os, v, false);
+        text.append(contents, last, pos-last);
+        text+=os.str();
+
+        pos=last=std::string::size_type(is.tellg());
+      }
+      else
+      {
+        ++pos;
+      }
+    }
+    text.append(contents, last, std::string::npos);
+    contents.swap(text);
+  }
+
+  std::istringstream ts(contents);
+  if (!readOpenFOAMDict(ts, d))
+    throw insight::Exception("Failed to parse field file "+fn.string());
+
+  if (foamFile.find("class")!=foamFile.end())
+    d.className = foamFile.lookup<std::string>("class");
+}
+
+
+arma::mat readOpenFOAMFieldList
+(
+    const boost::filesystem::path& fieldFile,
+    const std::string& keyword
+)
+{
+  CurrentExceptionContext ex(
+        [&]() { return "reading list "+keyword+" from field file "+fieldFile.string(); } );
+
+  bool compressed;
+  boost::filesystem::path fn = existingFieldFile(fieldFile, compressed);
+
+  std::ifstream f(fn.c_str(), std::ios::binary);
+  boost::iostreams::filtering_istream in;
+  if (compressed) in.push(boost::iostreams::gzip_decompressor());
+  in.push(f);
+
+  bool binary = isBinaryFormat( parseFoamFileHeader( readFoamFileHeaderText(in) ) );
+
+  std::string t;
+  while (in >> t)
+  {
+    if (t==keyword)
+    {
+      in >> t;
+      if (t=="uniform")
+      {
+        std::string value;
+        std::getline(in, value, ';');
+        std::replace(value.begin(), value.end(), '(', ' ');
+        std::replace(value.begin(), value.end(), ')', ' ');
+        std::istringstream is(value);
+        std::vector<double> v;
+        double x;
+        while (is >> x) v.push_back(x);
+        return arma::conv_to<arma::rowvec>::from(v);
+      }
+      else if (t=="nonuniform")
+      {
+        in >> t;
+        return readOpenFOAMNumericList(in, OFListTypeComponents(t), binary);
+      }
+      else
+      {
+        throw insight::Exception("Entry "+keyword+" is neither uniform nor nonuniform!");
+      }
+    }
+    else if (t=="nonuniform")
+    {
+      // skip other lists, binary data must not be interpreted as text
+      in >> t;
+      readOpenFOAMNumericList(in, OFListTypeComponents(t), binary);
+    }
+  }
+
+  throw insight::Exception("Entry "+keyword+" not found!");
+}
+
 namespace OFDictData
 {
 
@@ -246,6 +246,12 @@ std::ostream& operator<<(std::ostream& os, const list& l);
 void readOpenFOAMDict(const boost::filesystem::path& dictFile, OFDictData::dict& d);
 
 bool readOpenFOAMDict(std::istream& in, OFDictData::dict& d);
+
+/**
+ * writes the FoamFile header with the class name of d.
+ * @binary: declare binary format (and the architecture) in the header
+ */
+void writeOpenFOAMDictHeader(std::ostream& out, const OFDictData::dictFile& d, const std::string& objname, bool binary=false);
 void writeOpenFOAMDict(std::ostream& out, const OFDictData::dictFile& d, const std::string& objname);
 void writeOpenFOAMDict(const boost::filesystem::path& dictpath, const OFDictData::dictFile& dict);
 
@@ -256,6 +262,72 @@ bool patchExists(const OFDictData::dict& bd, const std::string& patchName);
 void writeOpenFOAMSequentialDict(std::ostream& out, const OFDictData::dictFile& d, const std::string& objname, bool skip_header=false);
 
 
+
+/**
+ * OpenFOAM type name of a list, whose rows contain nCmpt components
+ * (scalar, vector, symmTensor or tensor)
+ */
+std::string OFListTypeName(arma::uword nCmpt);
+
+/**
+ * number of components of the entries of an OpenFOAM list type, e.g. 3 for "List<vector>"
+ */
+arma::uword OFListTypeComponents(const std::string& typeName);
+
+/**
+ * writes the rows of v as OpenFOAM list, e.g. "List<vector> N(...)"
+ * @binary: write the values as raw bytes. Only valid inside files with "format binary" in their header.
+ */
+void writeOpenFOAMNumericList(std::ostream& out, const arma::mat& v, bool binary=false);
+
+/**
+ * reads a list as written by writeOpenFOAMNumericList, starting at the list size.
+ * Returns a matrix with one row per list entry.
+ */
+arma::mat readOpenFOAMNumericList(std::istream& in, arma::uword nCmpt, bool binary=false);
+
+/**
+ * writes a field file. All entries of d are written as usual, except
+ * "internalField", which is written as nonuniform list of the rows of internalField.
+ * @binary: write the internal field and the nonuniform lists in the boundaryField as raw bytes.
+ * The file is written in ascii, if a nonuniform boundary value is no numeric list.
+ * @compressed: write gzip compressed file (".gz" is appended to fieldFile).
+ * An existing file with the other compression is removed.
+ */
+void writeOpenFOAMField
+(
+    const boost::filesystem::path& fieldFile,
+    const OFDictData::dictFile& d,
+    const arma::mat& internalField,
+    bool binary=false,
+    bool compressed=false
+);
+
+/**
+ * reads a field file into d, also in binary format.
+ * Binary lists are converted to ascii, so that all nonuniform entries
+ * end up as raw strings, as if the file was written in ascii.
+ * The class name is taken from the header.
+ * A compressed file is used, if fieldFile itself does not exist.
+ */
+void readOpenFOAMField
+(
+    const boost::filesystem::path& fieldFile,
+    OFDictData::dictFile& d
+);
+
+/**
+ * reads the nonuniform list of entry "keyword" from a field file.
+ * The format is taken from the file header. A compressed file is used, if fieldFile itself does not exist.
+ * For a uniform entry, a single row is returned.
+ */
+arma::mat readOpenFOAMFieldList
+(
+    const boost::filesystem::path& fieldFile,
+    const std::string& keyword = "internalField"
+);
+
+
 }
 
 #endif // INSIGHT_OPENFOAMDICT_H
@@ -153,7 +153,8 @@ void setSet(
     const boost::filesystem::path& location,
     const std::vector<std::string>& cmds )
 {
-  CurrentExceptionContext ex("executing setSet command with the instructions:\n"+boost::join(cmds, "\n"));
+  CurrentExceptionContext ex(
+        [&]() { return "executing setSet command with the instructions:\n"+boost::join(cmds, "\n"); } );
 
   std::vector<std::string> opts;
   if ((ofc.OFversion()>=220) && (listTimeDirectories(location).size()==0)) opts.push_back("-constant");
@@ -1795,7 +1796,9 @@ arma::mat readTextFile(std::istream& f)
   while (getline(f, line))
   {
     iline++;
-    CurrentExceptionContext ex(str(format("reading line %d (containing \"%s\")")%iline%line), false);
+    CurrentExceptionContext ex(
+          [&]() { return str(format("reading line %d (containing \"%s\")")%iline%line); },
+          false );
 
     algorithm::trim_left(line);
     char fc; istringstream(line) >> fc; // get first char
@@ -2390,7 +2393,8 @@ arma::mat minPatchPressure
   const std::vector<std::string>& addopts
 )
 {
-  CurrentExceptionContext ex("computing minimum pressure on patch "+patch+" in case \""+location.string()+"\"");
+  CurrentExceptionContext ex(
+        [&]() { return "computing minimum pressure on patch "+patch+" in case \""+location.string()+"\""; } );
 
   std::vector<std::string> opts;
   opts.push_back(patch);
@@ -3400,7 +3404,7 @@ void OpenFOAMCaseDirs::cleanCase
 }
 
 
-void VTKFieldToOpenFOAMField(const boost::filesystem::path& vtkfile, const std::string& fieldname, std::ostream& out)
+arma::mat readVTKCellField(const boost::filesystem::path& vtkfile, const std::string& fieldname)
 {
   vtkSmartPointer<vtkPolyDataReader> in = vtkPolyDataReader::New();
   in->SetFileName(vtkfile.c_str());
@@ -3409,48 +3413,90 @@ void VTKFieldToOpenFOAMField(const boost::filesystem::path& vtkfile, const std::
   in->ReadAllTensorsOn();
   in->Update();
 
-  if(in->IsFilePolyData())
-  {
-    vtkPolyData* pd = in->GetOutput();
+  if(!in->IsFilePolyData())
+    throw insight::Exception("File "+vtkfile.string()+" does not contain polydata!");
 
-    if (!pd)
-      throw insight::Exception("Error reading VTK file "+vtkfile.string());
+  vtkPolyData* pd = in->GetOutput();
 
-    vtkDataArray* da = pd->GetCellData()->GetArray(fieldname.c_str());
+  if (!pd)
+    throw insight::Exception("Error reading VTK file "+vtkfile.string());
 
-    if (!da)
+  vtkDataArray* da = pd->GetCellData()->GetArray(fieldname.c_str());
+
+  if (!da)
+  {
+    int na=pd->GetCellData()->GetNumberOfArrays();
+    std::ostringstream m;
+    m<<"Error accessing cell field \""<<fieldname<<"\" in file "<<vtkfile.string()<<"!\n";
+    m<<"Available arrays: (";
+    for (int k=0; k<na; k++)
     {
-      int na=pd->GetCellData()->GetNumberOfArrays();
-      std::ostringstream m;
-      m<<"Error accessing cell field \""<<fieldname<<"\" in file "<<vtkfile.string()<<"!\n";
-      m<<"Available arrays: (";
-      for (int k=0; k<na; k++)
-      {
-        m<<" "<<pd->GetCellData()->GetArrayName(k);
-      }
-      m<<" )";
-      throw insight::Exception(m.str());
+      m<<" "<<pd->GetCellData()->GetArrayName(k);
     }
+    m<<" )";
+    throw insight::Exception(m.str());
+  }
 
-    vtkIdType ncells=da->GetNumberOfTuples();
-    vtkIdType nc=da->GetNumberOfComponents();
+  vtkIdType ncells=da->GetNumberOfTuples();
+  vtkIdType nc=da->GetNumberOfComponents();
 
-    out << ncells << "\n(\n";
-    for (vtkIdType i=0; i<ncells; i++)
-    {
-      if (nc>1) out<<" (";
-      double *cd = da->GetTuple(i);
-      for (vtkIdType j=0; j<nc; j++) out<<" "<<cd[j];
-      if (nc>1) out<<" )";
-      out<<'\n';
-    }
-    out << ")\n";
+  arma::mat res(ncells, nc);
+  for (vtkIdType i=0; i<ncells; i++)
+  {
+    double *cd = da->GetTuple(i);
+    for (vtkIdType j=0; j<nc; j++) res(i,j)=cd[j];
   }
+  return res;
+}
+
+void VTKFieldToOpenFOAMField(const boost::filesystem::path& vtkfile, const std::string& fieldname, std::ostream& out)
+{
+  arma::mat f=readVTKCellField(vtkfile, fieldname);
+
+  out << f.n_rows << "\n(\n";
+  for (arma::uword i=0; i<f.n_rows; i++)
+  {
+    if (f.n_cols>1) out<<" (";
+    for (arma::uword j=0; j<f.n_cols; j++) out<<" "<<f(i,j);
+    if (f.n_cols>1) out<<" )";
+    out<<'\n';
+  }
+  out << ")\n";
+}
+
+void VTKFieldToOpenFOAMField
+(
+    const boost::filesystem::path& vtkfile,
+    const std::string& fieldname,
+    const OpenFOAMCase& ofc,
+    const boost::filesystem::path& fieldFile
+)
+{
+  CurrentExceptionContext ex(
+        [&]() { return "transferring cell field "+fieldname+" from "+vtkfile.string()+" into field file "+fieldFile.string(); } );
+
+  arma::mat f=readVTKCellField(vtkfile, fieldname);
+
+  OFDictData::dictFile fd;
+  readOpenFOAMField(fieldFile, fd);
+
+  switch (f.n_cols)
+  {
+    case 1: fd.className="volScalarField"; break;
+    case 3: fd.className="volVectorField"; break;
+    case 6: fd.className="volSymmTensorField"; break;
+    case 9: fd.className="volTensorField"; break;
+    default:
+      throw insight::Exception(str(format("Unsupported number of components in cell field: %d") % f.n_cols));
+  }
+
+  ofc.writeField(fieldFile, fd, f);
 }
 
 decompositionState::decompositionState(const boost::filesystem::path& casedir)
 {
-  CurrentExceptionContext ce("Checking decomposition state of case in "+casedir.string());
+  CurrentExceptionContext ce(
+        [&]() { return "Checking decomposition state of case in "+casedir.string(); } );
 
   if (!boost::filesystem::exists(casedir))
     throw insight::Exception("Case directory "+casedir.string()+" does not exist!");
@@ -31,6 +31,15 @@
 #include "base/resultset.h"
 #include "openfoam/openfoamcase.h"
 #include "progrock/cppx/collections/options_boosted.h"
+#include "openfoamtools__createPatchOperator__Parameters_headers.h"
+#include "openfoamtools__createCyclicOperator__Parameters_headers.h"
+#include "openfoamtools__sampleOps_set__Parameters_headers.h"
+#include "openfoamtools__sampleOps_line__Parameters_headers.h"
+#include "openfoamtools__sampleOps_uniformLine__Parameters_headers.h"
+#include "openfoamtools__sampleOps_circumferentialAveragedUniformLine__Parameters_headers.h"
+#include "openfoamtools__sampleOps_linearAveragedPolyLine__Parameters_headers.h"
+#include "openfoamtools__sampleOps_linearAveragedUniformLine__Parameters_headers.h"
+#include "openfoamtools__HomogeneousAveragedProfile__Parameters_headers.h"
 
 
 #ifdef SWIG
@@ -944,8 +953,30 @@ public:
   );
 };
 
+/**
+ * reads a cell field from a VTK polydata file.
+ * Returns one row per cell and one column per component.
+ */
+arma::mat readVTKCellField(const boost::filesystem::path& vtkfile, const std::string& fieldname);
+
+/**
+ * writes a cell field from a VTK file as bare ascii list, e.g. for manual inclusion into a field file
+ */
 void VTKFieldToOpenFOAMField(const boost::filesystem::path& vtkfile, const std::string& fieldname, std::ostream& out);
 
+/**
+ * replaces the internal field of a field file by the cell field from a VTK file.
+ * The dimensions and boundary conditions are taken from the existing (ascii) field file.
+ * The field is written in the format selected for the case (OpenFOAMCase::setWriteFormat).
+ */
+void VTKFieldToOpenFOAMField
+(
+    const boost::filesystem::path& vtkfile,
+    const std::string& fieldname,
+    const OpenFOAMCase& ofc,
+    const boost::filesystem::path& fieldFile
+);
+
 struct decompositionState
 {
   bool hasProcessorDirectories;
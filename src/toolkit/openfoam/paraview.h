@@ -9,6 +9,15 @@
 #include "base/analysis.h"
 #include "base/resultset.h"
 #include "openfoam/openfoamcase.h"
+#include "paraview__PVScriptElement__Parameters_headers.h"
+#include "paraview__CustomScriptElement__Parameters_headers.h"
+#include "paraview__Cutplane__Parameters_headers.h"
+#include "paraview__Arrows__Parameters_headers.h"
+#include "paraview__Streamtracer__Parameters_headers.h"
+#include "paraview__PVScene__Parameters_headers.h"
+#include "paraview__SingleView__Parameters_headers.h"
+#include "paraview__IsoView__Parameters_headers.h"
+#include "paraview__ParaviewVisualization__Parameters_headers.h"
 
 
 
@@ -49,22 +49,34 @@ std::string ExternalGeometryFile::fileName() const
 }
 
 
-void ExternalGeometryFile::putIntoConstantTrisurface(const OpenFOAMCase& ofc, const path& location) const
+boost::filesystem::path ExternalGeometryFile::targetFile(const path& location) const
 {
-  boost::filesystem::path from( p_.fileName->filePath(location) );
-  boost::filesystem::path to( location/"constant"/"triSurface"/from.filename() );
-  
-  if (!exists(to.parent_path()))
-    create_directories(to.parent_path());
+  return location/"constant"/"triSurface"/p_.fileName->fileName().filename();
+}
 
-  ofc.executeCommand(location, "surfaceTransformPoints",
-    list_of<std::string>
-    (absolute(from).string())
-    (absolute(to).string())
-    ("-scale")(OFDictData::to_OF(p_.scale))
-    ("-translate")(OFDictData::to_OF(p_.translate))
-    ("-rollPitchYaw")(OFDictData::to_OF(p_.rollPitchYaw))
-  );
+
+void ExternalGeometryFile::addToPreparation
+(
+  GeometryFilePreparation& prep,
+  const path& location,
+  const path& featureEdgeFile,
+  double includedAngle
+) const
+{
+  prep.addSurface(
+        p_.fileName->filePath(location),
+        targetFile(location),
+        GeometryFilePreparation::Transformation(p_.scale, p_.translate, p_.rollPitchYaw),
+        featureEdgeFile, includedAngle
+        );
+}
+
+
+void ExternalGeometryFile::putIntoConstantTrisurface(const OpenFOAMCase& ofc, const path& location) const
+{
+  GeometryFilePreparation prep;
+  addToPreparation(prep, location);
+  prep.run(ofc, location);
 }
 
   
@@ -78,7 +90,15 @@ namespace snappyHexMeshFeats
     
 defineType(Feature);
 defineDynamicClass(Feature);
-    
+
+void Feature::addGeometryFiles
+(
+  GeometryFilePreparation&,
+  const boost::filesystem::path&
+) const
+{
+}
+
 void Feature::modifyFiles
 (
   const OpenFOAMCase&,
@@ -110,6 +130,14 @@ void Geometry::addIntoDictionary(OFDictData::dict& sHMDict) const
     fn="\""+fn+"\"";
   sHMDict.subDict("geometry")[fn]=geodict;
 
+  if (const auto* fe = boost::get<Parameters::featureEdges_extract_type>(&p_.featureEdges))
+  {
+    OFDictData::dict refdict;
+    refdict["file"]=std::string("\"")+featureEdgeFile(path()).filename().string()+"\"";
+    refdict["levels"]=OFDictData::list( {OFDictData::list({fe->distance, fe->level}) });
+    sHMDict.subDict("castellatedMeshControls").getList("features").push_back(refdict);
+  }
+
   OFDictData::dict castdict;
   OFDictData::list levels;
   levels.push_back(p_.minLevel);
@@ -150,10 +178,23 @@ void Geometry::addIntoDictionary(OFDictData::dict& sHMDict) const
 
 }
 
-void Geometry::modifyFiles(const OpenFOAMCase& ofc, 
-	      const boost::filesystem::path& location) const
+boost::filesystem::path Geometry::featureEdgeFile(const boost::filesystem::path& location) const
+{
+  path to=targetFile(location);
+  return to.parent_path()/(to.stem().string()+".eMesh");
+}
+
+void Geometry::addGeometryFiles(GeometryFilePreparation& prep,
+              const boost::filesystem::path& location) const
 {
-  ExternalGeometryFile::putIntoConstantTrisurface(ofc, location);
+  if (const auto* fe = boost::get<Parameters::featureEdges_extract_type>(&p_.featureEdges))
+  {
+    ExternalGeometryFile::addToPreparation(prep, location, featureEdgeFile(location), fe->includedAngle);
+  }
+  else
+  {
+    ExternalGeometryFile::addToPreparation(prep, location);
+  }
 }
 
 
@@ -198,34 +239,21 @@ void ExplicitFeatureCurve::addIntoDictionary(OFDictData::dict& sHMDict) const
 
 }
 
-void ExplicitFeatureCurve::modifyFiles(const OpenFOAMCase& ofc, const path& location) const
+void ExplicitFeatureCurve::addGeometryFiles(GeometryFilePreparation& prep, const path& location) const
 {
   boost::filesystem::path from(p_.fileName->filePath(location));
   if (!exists(from))
   {
-    boost::filesystem::path alt_from=from; alt_from.replace_extension(".eMesh.gz");
-    if (!exists(alt_from)) //from=alt_from;
-//     else
+    boost::filesystem::path alt_from=from.string()+".gz";
+    if (!exists(alt_from))
       throw insight::Exception("feature edge file does not exist: neither "+from.string()+" nor "+alt_from.string());
   }
   boost::filesystem::path to(location/"constant"/"triSurface"/from.filename());
-  
-//   if (to!=from) // might occur, if file path in target location is specified (e.g. after surfaceFeatureExtract)
-//   {
-//     if (!exists(to.parent_path()))
-//       create_directories(to.parent_path());
-//     
-//     std::cout<<"copy from "<<from<<" to "<<to<<std::endl;
-//     copy_file(from, to, copy_option::overwrite_if_exists);
-//   }
-  ofc.executeCommand(location, "eMeshTransformPoints",
-    list_of<std::string>
-    (absolute(from).string())
-    (absolute(to).string())
-    ("-scale")(OFDictData::to_OF(p_.scale))
-    ("-translate")(OFDictData::to_OF(p_.translate))
-    ("-rollPitchYaw")(OFDictData::to_OF(p_.rollPitchYaw))
-  );
+
+  prep.addFeatureEdges(
+        from, to,
+        GeometryFilePreparation::Transformation(p_.scale, p_.translate, p_.rollPitchYaw)
+        );
 }
 
 
@@ -374,10 +402,10 @@ bool RefinementGeometry::setGeometrySubdict(OFDictData::dict& geodict, std::stri
   return true;
 }
 
-void RefinementGeometry::modifyFiles(const OpenFOAMCase& ofc, 
-	      const boost::filesystem::path& location) const
+void RefinementGeometry::addGeometryFiles(GeometryFilePreparation& prep,
+              const boost::filesystem::path& location) const
 {
-  geometryfile_.putIntoConstantTrisurface(ofc, location);
+  geometryfile_.addToPreparation(prep, location);
 }
 
 
@@ -579,6 +607,25 @@ double computeFinalLayerThickness(double totalLayerThickness, double expRatio, i
 }
 
 
+/**
+ * transforms the geometry files of all features concurrently,
+ * then lets each feature do its remaining file modifications
+ */
+template<class FeatureList>
+void prepareFeatureFiles(const OpenFOAMCase& ofc, const boost::filesystem::path& location, const FeatureList& features)
+{
+  GeometryFilePreparation prep;
+  for (const auto& feat: features)
+  {
+    feat->addGeometryFiles(prep, location);
+  }
+  prep.run(ofc, location);
+
+  for (const auto& feat: features)
+  {
+    feat->modifyFiles(ofc, location);
+  }
+}
 
 
 
@@ -676,10 +723,7 @@ void snappyHexMeshConfiguration::addIntoDictionaries(OFdicts& dictionaries) cons
 
 void snappyHexMeshConfiguration::modifyCaseOnDisk ( const OpenFOAMCase& cm, const boost::filesystem::path& location ) const
 {
-  for (const snappyHexMeshConfiguration::Parameters::features_default_type& feat: p_.features)
-  {
-      feat->modifyFiles(cm, location);
-  }
+  prepareFeatureFiles(cm, location, p_.features);
 }
 
 
@@ -805,9 +849,10 @@ void snappyHexMesh
     setNoQualityCtrls(qualityCtrls);
   }
 
+  prepareFeatureFiles(ofc, location, p.features);
+
   for (const snappyHexMeshConfiguration::Parameters::features_default_type& feat: p.features)
   {
-      feat->modifyFiles(ofc, location);
       feat->addIntoDictionary(sHMDict);
   }
   
@@ -27,7 +27,19 @@
 #include "base/boost_include.h"
 
 #include "openfoam/caseelements/openfoamcaseelement.h"
+#include "openfoam/geometryfilepreparation.h"
 #include "base/progressdisplayer.h"
+#include "snappyhexmesh__ExternalGeometryFile__Parameters_headers.h"
+#include "snappyhexmesh__Geometry__Parameters_headers.h"
+#include "snappyhexmesh__PatchLayers__Parameters_headers.h"
+#include "snappyhexmesh__ExplicitFeatureCurve__Parameters_headers.h"
+#include "snappyhexmesh__RefinementRegion__Parameters_headers.h"
+#include "snappyhexmesh__RefinementBox__Parameters_headers.h"
+#include "snappyhexmesh__RefinementCylinder__Parameters_headers.h"
+#include "snappyhexmesh__RefinementSphere__Parameters_headers.h"
+#include "snappyhexmesh__RefinementGeometry__Parameters_headers.h"
+#include "snappyhexmesh__NearTemplatePatchRefinement__Parameters_headers.h"
+#include "snappyhexmesh__snappyHexMeshConfiguration__Parameters_headers.h"
 
 namespace insight {
   
@@ -56,7 +68,22 @@ public:
   ExternalGeometryFile( const ParameterSet& ps = Parameters::makeDefault() );
   
   std::string fileName() const;
-  
+
+  /**
+   * location of the transformed file in constant/triSurface
+   */
+  boost::filesystem::path targetFile(const boost::filesystem::path& location) const;
+
+  /**
+   * registers the transformation of the file into constant/triSurface
+   */
+  void addToPreparation(
+      GeometryFilePreparation& prep,
+      const boost::filesystem::path& location,
+      const boost::filesystem::path& featureEdgeFile = boost::filesystem::path(),
+      double includedAngle = 150.
+      ) const;
+
   virtual void putIntoConstantTrisurface(
       const OpenFOAMCase& ofc,
       const boost::filesystem::path& location
@@ -84,6 +111,15 @@ public:
   declareDynamicClass ( Feature );
 
   virtual void addIntoDictionary ( OFDictData::dict& sHMDict ) const =0;
+
+  /**
+   * registers geometry files, which need to be transformed into the case.
+   * The files of all features are prepared together, before modifyFiles is called.
+   */
+  virtual void addGeometryFiles (
+      GeometryFilePreparation& prep,
+      const boost::filesystem::path& location ) const;
+
   virtual void modifyFiles (
       const OpenFOAMCase& ofc,
       const boost::filesystem::path& location ) const;
@@ -108,6 +144,15 @@ maxLevel = int 4 "Maximum refinement level"
 nLayers = int 2 "Number of prism layers"
 zoneName = string "" "Zone name"
 
+featureEdges = selectablesubset {{
+ none set { }
+ extract set {
+  includedAngle = double 150 "Edges, at which the adjacent faces enclose an angle smaller than this value (in degrees), become feature edges"
+  level = int 4 "Refinement level at the feature edges"
+  distance = double 0 "Refinement distance"
+ }
+}} none "Extract feature edges from the transformed surface for explicit feature snapping"
+
 regionRefinements = array [ set {
  regionname = string "" "Name of geometry region" *necessary
  minLevel = int 0 "Minimum refinement level"
@@ -127,9 +172,11 @@ public:
   ParameterSet getParameters() const override { return p_; }
   inline const Parameters& parameters() const { return p_; }
   
+  boost::filesystem::path featureEdgeFile(const boost::filesystem::path& location) const;
+
   void addIntoDictionary(OFDictData::dict& sHMDict) const override;
-  void modifyFiles(const OpenFOAMCase& ofc,
-                   const boost::filesystem::path& location) const override;
+  void addGeometryFiles(GeometryFilePreparation& prep,
+                        const boost::filesystem::path& location) const override;
 };
 
 
@@ -194,8 +241,8 @@ public:
   inline const Parameters& parameters() const { return p_; }
 
   void addIntoDictionary(OFDictData::dict& sHMDict) const override;
-  void modifyFiles(const OpenFOAMCase& ofc,
-                   const boost::filesystem::path& location) const override;
+  void addGeometryFiles(GeometryFilePreparation& prep,
+                        const boost::filesystem::path& location) const override;
 };
 
 
@@ -368,8 +415,8 @@ public:
 
   bool setGeometrySubdict(OFDictData::dict& d, std::string& entryTitle) const override;
   //   virtual void addIntoDictionary(OFDictData::dict& sHMDict) const;
-  void modifyFiles(const OpenFOAMCase& ofc,
-                   const boost::filesystem::path& location) const override;
+  void addGeometryFiles(GeometryFilePreparation& prep,
+                        const boost::filesystem::path& location) const override;
 
 };
 
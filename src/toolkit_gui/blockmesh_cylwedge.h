@@ -27,6 +27,7 @@
 #include "Geom_BoundedCurve.hxx"
 #include "gp_Pnt.hxx"
 #include "gp_Vec.hxx"
+#include "blockmesh_cylwedge__blockMeshDict_CylWedge__Parameters_headers.h"
 
 namespace insight
 {
@@ -126,21 +126,22 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
     int nuBy2, int nx, int nr, double deltax
 )
 {
-  insight::CurrentExceptionContext ex(boost::str(boost::format(
+  insight::CurrentExceptionContext ex(
+        [&]() { return boost::str(boost::format(
      "inserting blocks between z0=%g and z1=%g"
-    ) % z0 % z1) );
+    ) % z0 % z1); } );
 
   bool is_highest = !no_top_edg;
 
   auto cyl_isec = [&](double r, Handle_Geom_Curve spine, gp_Pnt nearp)
   {
-    insight::CurrentExceptionContext ex(boost::str(boost::format(
+    insight::CurrentExceptionContext ex( [&]() { return boost::str(boost::format(
        "determining point on spine for radius r=%g (endpoints %s and %s); starting at point %s"
       ) % r
         % vector_to_string( vec3(spine->Value(spine->FirstParameter())) )
         % vector_to_string( vec3(spine->Value(spine->LastParameter())) )
         % vector_to_string( vec3(nearp) )
-      ), false
+      ); }, false
     );
 
     gp_Ax3 cyl_cs(center, ez);
@@ -494,8 +495,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   double dr;
   {
     CurrentExceptionContext ex(
-          str(format("Creating intermediate blocks between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating intermediate blocks between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     arma::mat
         pr0 = vec3(spine_rvs->Value(block.rvs_u0)),
@@ -586,8 +586,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   if (g_begin.collapse_pt_loc == Gusset::Rvs )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at inner gusset (reverse orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at inner gusset (reverse orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(g_begin.fwd_u0),
@@ -697,8 +696,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   else if (g_begin.collapse_pt_loc == Gusset::Fwd )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at inner gusset (forward orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at inner gusset (forward orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(g_begin.rvs_u0),
@@ -804,8 +802,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   else if (g_begin.collapse_pt_loc == Gusset::None )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at inner gusset (radial orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at inner gusset (radial orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(t0)
@@ -833,8 +830,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   if (do_pro_inner_blocks)
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at inner protrusion between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at inner protrusion between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(t00),
@@ -915,8 +911,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   if (g_end.collapse_pt_loc == Gusset::Fwd )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at outer gusset (forward orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at outer gusset (forward orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(g_end.rvs_u0),
@@ -1018,8 +1013,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   else if (g_end.collapse_pt_loc == Gusset::Rvs )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at outer gusset (reverse orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at outer gusset (reverse orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(g_end.fwd_u0),
@@ -1112,8 +1106,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   else if (g_end.collapse_pt_loc == Gusset::None )
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at outer gusset (radial orientation) between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at outer gusset (radial orientation) between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pb = spine_rvs->Value(t1)
@@ -1143,8 +1136,7 @@ void blockMeshDict_CylWedgeOrtho::insertBlocks
   if (do_pro_outer_blocks)
   {
     CurrentExceptionContext ex(
-          str(format("Creating blocks at outer protrusion between %s and %s")%toStr(vL0)%toStr(vL1))
-          );
+          [&]() { return str(format("Creating blocks at outer protrusion between %s and %s")%toStr(vL0)%toStr(vL1)); } );
 
     gp_Pnt
         pa = spine_rvs->Value(t1),
@@ -2,6 +2,7 @@
 #define BLOCKMESH_TUBEMESH_H
 
 #include "blockmesh_curvedcylinder.h"
+#include "blockmesh_tubemesh__blockMeshDict_TubeMesh__Parameters_headers.h"
 
 namespace insight {
 
@@ -10,6 +10,7 @@ ISMetaTypeRegistrator::ISMetaTypeRegistrator()
   qRegisterMetaType<insight::TaskSpoolerInterface::JobList>("insight::TaskSpoolerInterface::JobList");
   qRegisterMetaType<arma::mat>("arma::mat");
   qRegisterMetaType<std::exception_ptr>("std::exception_ptr");
+  qRegisterMetaType<std::shared_ptr<std::string> >("std::shared_ptr<std::string>");
 }
 
 
@@ -18,6 +18,7 @@ Q_DECLARE_METATYPE(insight::ProgressState);
 Q_DECLARE_METATYPE(insight::ProgressStatePtr);
 Q_DECLARE_METATYPE(insight::TaskSpoolerInterface::JobList);
 Q_DECLARE_METATYPE(arma::mat);
+Q_DECLARE_METATYPE(std::shared_ptr<std::string>);
 
 class ISMetaTypeRegistrator
 {
@@ -1470,7 +1470,7 @@ void SelectableSubsetParameterWrapper::onApply()
 {
   if (widgetsDisplayed_)
   {
-    param().selection()=selBox_->currentText().toStdString();
+    param().setSelection(selBox_->currentText().toStdString());
     insertSubset();
     setText(1, param().selection().c_str());
     emit parameterSetChanged();
@@ -17,7 +17,9 @@ addToFactoryTable(QResultElement, QImage);
 
 QImage::QImage(QObject *parent, const QString &label, insight::ResultElementPtr rep)
     : QResultElement(parent, label, rep),
-      delta_w_(0)
+      delta_w_(0),
+      id_(nullptr),
+      width_(0)
 {
   if (auto im = resultElementAs<insight::Image>())
   {
@@ -71,8 +73,23 @@ void QImage::resetContents(int width, int height)
 {
   QResultElement::resetContents(width, height);
 
+  width_=width;
   id_->setPixmap(image_.scaledToWidth(width-delta_w_));
   id_->adjustSize();
 }
 
+void QImage::updateContents()
+{
+  if (auto im = resultElementAs<insight::Image>())
+  {
+    setImage( QPixmap(QString::fromStdString(im->filePath().string())) );
+  }
+
+  if (id_ && width_>0)
+  {
+    id_->setPixmap(image_.scaledToWidth(width_-delta_w_));
+    id_->adjustSize();
+  }
+}
+
 } // namespace insight
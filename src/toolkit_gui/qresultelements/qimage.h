@@ -4,8 +4,9 @@
 #include "qresultsetmodel.h"
 
 #include <QPixmap>
+#include <QPointer>
+#include <QLabel>
 
-class QLabel;
 class QScrollArea;
 
 namespace insight {
@@ -17,7 +18,8 @@ class QImage
 
   int delta_w_;
   QScrollArea* sa_;
-  QLabel *id_;
+  QPointer<QLabel> id_; // the display widget may have been deleted
+  int width_;
   QPixmap image_;
 
 protected:
@@ -31,6 +33,7 @@ public:
   QVariant previewInformation(int role) const override;
   void createFullDisplay(QVBoxLayout *layout) override;
   void resetContents(int width, int height) override;
+  void updateContents() override;
 };
 
 } // namespace insight
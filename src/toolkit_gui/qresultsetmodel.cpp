@@ -10,6 +10,8 @@
 #include <QSpacerItem>
 #include <QDebug>
 
+#include "boost/algorithm/string.hpp"
+
 namespace insight
 {
 
@@ -135,6 +137,12 @@ void QResultElement::resetContents(int, int)
 
 
 
+void QResultElement::updateContents()
+{}
+
+
+
+
 
 
 
@@ -306,6 +314,34 @@ QModelIndex QResultSetModel::parent(const QModelIndex &index) const
   return QModelIndex();
 }
 
+void QResultSetModel::updateElement(const std::string &path)
+{
+  std::vector<std::string> labels;
+  boost::split(labels, path, boost::is_any_of("/"));
+
+  QResultElement* e=root_;
+  for (const auto& l: labels)
+  {
+    QResultElement* c=nullptr;
+    for (auto* ce: e->children_)
+    {
+      if (ce->label_==QString::fromStdString(l))
+      {
+        c=ce;
+        break;
+      }
+    }
+    if (!c) return; // not displayed
+    e=c;
+  }
+
+  e->updateContents();
+
+  auto *pe=e->parentResultElement();
+  int row = pe ? pe->children_.indexOf(e) : 0;
+  Q_EMIT dataChanged(createIndex(row, 0, e), createIndex(row, columnCount()-1, e));
+}
+
 int QResultSetModel::columnCount(const QModelIndex &) const
 {
   return 2;
@@ -71,6 +71,11 @@ public:
     virtual QVariant previewInformation(int role) const =0;
     virtual void createFullDisplay(QVBoxLayout* layout);
     virtual void resetContents(int width, int height);
+
+    /**
+     * called, when the content of the result element has been replaced
+     */
+    virtual void updateContents();
 };
 
 
@@ -129,6 +134,12 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant headerData(int section, Qt::Orientation orient, int role) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * refresh the display of the element at path (labels separated by "/"),
+     * after its content has been replaced
+     */
+    void updateElement(const std::string& path);
 };
 
 void connectToCWithContentsDisplay(QTreeView* ToCView, QWidget* content);
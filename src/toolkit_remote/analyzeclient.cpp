@@ -24,8 +24,18 @@
 #include "Wt/Json/Array.h"
 #include "Wt/Json/Parser.h"
 #include "Wt/Json/Serializer.h"
+#include "Wt/Utils.h"
+
+#include "base/filecontainer.h"
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/iostreams/filtering_stream.hpp"
+#include "boost/iostreams/filter/gzip.hpp"
 
 #include <functional>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 
@@ -99,6 +109,144 @@ void AnalyzeClient::controlRequest(const std::string &action, AnalyzeClient::Rep
 
 
 
+void AnalyzeClient::displayProgress(const Wt::Json::Object& payload)
+{
+  if (progressDisplayer_)
+  {
+    if (!payload.isNull("states"))
+    {
+      Wt::Json::Array states = payload.get("states");
+      for (Wt::Json::Array::const_iterator i=states.begin(); i!=states.end(); i++)
+      {
+        Wt::Json::Object s=*i;
+
+        ProgressVariableList pvl;
+        if (!s.isNull("ProgressVariableList"))
+        {
+          Wt::Json::Object pvs = s.get("ProgressVariableList");
+          for (const auto& pv: pvs)
+          {
+            pvl[pv.first]=pv.second.toNumber();
+          }
+        }
+
+        progressDisplayer_->update(
+              ProgressState(
+                s.get("time").toNumber(),
+                pvl,
+                s.get("logMessage").toString()
+                )
+              );
+      }
+    }
+
+    if (!payload.isNull("progressStates"))
+    {
+      Wt::Json::Array progressStates = payload.get("progressStates");
+      for (auto i=progressStates.begin();
+           i!=progressStates.end(); i++)
+      {
+        Wt::Json::Object s=*i;
+        auto path = s.get("path").toString();
+        if (!s.isNull("double"))
+        {
+          double value = s.get("double").toNumber();
+          progressDisplayer_->setActionProgressValue(path, value);
+        }
+        else if (!s.isNull("text"))
+        {
+          string text = s.get("text").toString();
+          progressDisplayer_->setMessageText(path, text);
+        }
+        else
+        {
+          progressDisplayer_->finishActionProgress(path);
+        }
+      }
+    }
+  }
+}
+
+
+
+
+void AnalyzeClient::handleStreamData(const std::string &data)
+{
+  boost::unique_lock<boost::mutex> lock(streamMx_);
+
+  try
+  {
+    streamBuffer_+=data;
+
+    // server-sent events are separated by empty lines
+    std::string::size_type end;
+    while ( (end=streamBuffer_.find("\n\n")) != std::string::npos )
+    {
+      std::istringstream ev(streamBuffer_.substr(0, end+1));
+      streamBuffer_.erase(0, end+2);
+
+      std::string line, eventData;
+      while (std::getline(ev, line))
+      {
+        if (boost::starts_with(line, "id: "))
+        {
+          lastEventId_=line.substr(4);
+        }
+        else if (boost::starts_with(line, "data: "))
+        {
+          eventData+=line.substr(6)+"\n";
+        }
+      }
+
+      if (!eventData.empty())
+      {
+        Wt::Json::Object payload;
+        Wt::Json::parse(eventData, payload);
+
+        displayProgress(payload);
+
+        if (!payload.isNull("resultsAvailable") && streamCallback_)
+        {
+          auto cb = streamCallback_;
+          bool resultsAvailable = payload.get("resultsAvailable").toBool();
+          lock.unlock();
+          cb(true, resultsAvailable);
+          lock.lock();
+        }
+      }
+    }
+  }
+  catch (const std::exception&)
+  {
+    auto ex = std::current_exception();
+    if (exHdlr_)
+      exHdlr_(ex);
+    else
+      std::rethrow_exception(ex);
+  }
+}
+
+
+
+
+void AnalyzeClient::handleStreamEnd(boost::system::error_code /*err*/, const Wt::Http::Message &)
+{
+  QueryStatusCallback cb;
+  {
+    boost::lock_guard<boost::mutex> lock(streamMx_);
+    std::swap(cb, streamCallback_);
+    streamBuffer_.clear();
+  }
+
+  if (cb)
+  {
+    cb(false, false);
+  }
+}
+
+
+
+
 void AnalyzeClient::handleHttpResponse(boost::system::error_code err, const Wt::Http::Message &response)
 {
 
@@ -152,60 +300,7 @@ void AnalyzeClient::handleHttpResponse(boost::system::error_code err, const Wt::
 
             resultsAvailable = payload["resultsAvailable"].toBool();
 
-            if (progressDisplayer_)
-            {
-              Wt::Json::Array states = payload.get("states");
-              if (states.size()>0)
-              {
-                for (Wt::Json::Array::const_iterator i=states.begin(); i!=states.end(); i++)
-                {
-                  Wt::Json::Object s=*i;
-
-                  ProgressVariableList pvl;
-                  if (!s.isNull("ProgressVariableList"))
-                  {
-                    Wt::Json::Object pvs = s.get("ProgressVariableList");
-                    for (const auto& pv: pvs)
-                    {
-                      pvl[pv.first]=pv.second.toNumber();
-                    }
-                  }
-
-                  progressDisplayer_->update(
-                        ProgressState(
-                          s.get("time").toNumber(),
-                          pvl,
-                          s.get("logMessage").toString()
-                          )
-                        );
-                }
-              }
-
-              Wt::Json::Array progressStates = payload.get("progressStates");
-              if (progressStates.size()>0)
-              {
-                for (auto i=progressStates.begin();
-                     i!=progressStates.end(); i++)
-                {
-                  Wt::Json::Object s=*i;
-                  auto path = s.get("path").toString();
-                  if (!s.isNull("double"))
-                  {
-                    double value = s.get("double").toNumber();
-                    progressDisplayer_->setActionProgressValue(path, value);
-                  }
-                  else if (!s.isNull("text"))
-                  {
-                    string text = s.get("text").toString();
-                    progressDisplayer_->setMessageText(path, text);
-                  }
-                  else
-                  {
-                    progressDisplayer_->finishActionProgress(path);
-                  }
-                }
-              }
-            }
+            displayProgress(payload);
           }
           else
           {
@@ -244,6 +339,109 @@ void AnalyzeClient::handleHttpResponse(boost::system::error_code err, const Wt::
 
       } break;
 
+      case QueryResultSkeleton: {
+        ResultSetPtr r;
+
+        if (success)
+        {
+          const auto *ct = response.getHeader("Content-Type");
+
+          if (!ct)
+            throw insight::Exception("No content type specified in response!");
+
+          if ( (*ct)=="application/xml")
+          {
+            auto body = response.body();
+            r.reset(new ResultSet(analysisName_, body));
+
+            for (const auto& fc: r->fileContainers())
+            {
+              resultTransfer_->filePaths.push_back(fc.first);
+            }
+          }
+          else
+          {
+            success=false;
+          }
+        }
+
+        boost::get<QueryResultsCallback>(currentCallback_)(success, r);
+
+        if (success)
+        {
+          // issue the next request outside of the response handler,
+          // the client remains busy until then
+          crq_=QueryResultFile;
+          ioService_.post( std::bind(&AnalyzeClient::requestNextResultFile, this) );
+        }
+        else
+        {
+          resultTransfer_.reset(); // failure already reported
+        }
+
+      } break;
+
+      case QueryResultFile: {
+        auto& rt = *resultTransfer_;
+        const auto& path = rt.filePaths[rt.currentFile];
+
+        rt.part.close();
+        size_t received = boost::filesystem::file_size(rt.partFile->path());
+
+        if (success && received==rt.expectedSize)
+        {
+          auto content = std::make_shared<std::string>();
+
+          std::ifstream f(rt.partFile->path().c_str(), std::ios::binary);
+          boost::iostreams::filtering_istream in;
+          const auto *ct = response.getHeader("Content-Type");
+          if (ct && (*ct)=="application/gzip")
+          {
+            in.push(boost::iostreams::gzip_decompressor());
+          }
+          in.push(f);
+          content->assign(
+                std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>() );
+
+          rt.partFile.reset();
+          rt.onFileReceived(path, content);
+          rt.currentFile++;
+          rt.failedAttempts=0;
+        }
+        else if (!err && response.status()==404)
+        {
+          // element without content
+          rt.partFile.reset();
+          rt.currentFile++;
+          rt.failedAttempts=0;
+        }
+        else
+        {
+          if (success && received>rt.expectedSize)
+          {
+            // inconsistent with the server data: start over
+            rt.partFile.reset();
+          }
+          else if (received>rt.offset)
+          {
+            // interrupted, but progressing: resume after the received part
+            rt.failedAttempts=0;
+          }
+
+          if (++rt.failedAttempts >= 3)
+          {
+            insight::Warning("Could not transfer result file "+path+"!");
+            rt.partFile.reset();
+            rt.failed=true;
+          }
+        }
+
+        crq_=QueryResultFile;
+        ioService_.post( std::bind(&AnalyzeClient::requestNextResultFile, this) );
+
+      } break;
+
       case QueryExepath: {
         std::string exepath;
 
@@ -303,8 +501,10 @@ AnalyzeClient::AnalyzeClient(
     ioService_(),
     httpClient_(ioService_),
     crq_(None),
+    exHdlr_(exceptionHandler),
     progressDisplayer_(progressDisplayer),
-    exHdlr_(exceptionHandler)
+    fileClient_(ioService_),
+    streamClient_(ioService_)
 {
   httpClient_.setMaximumResponseSize(512*1024*1024);
   httpClient_.setTimeout(std::chrono::seconds{24*3600});
@@ -314,6 +514,36 @@ AnalyzeClient::AnalyzeClient(
         std::bind(&AnalyzeClient::handleHttpResponse, this, std::placeholders::_1, std::placeholders::_2)
         );
 
+  // result files are written to disk as they arrive
+  fileClient_.setMaximumResponseSize(0);
+  fileClient_.setTimeout(std::chrono::seconds{24*3600});
+
+  fileClient_.headersReceived().connect
+      (
+        std::bind(&AnalyzeClient::handleFileHeaders, this, std::placeholders::_1)
+        );
+  fileClient_.bodyDataReceived().connect
+      (
+        std::bind(&AnalyzeClient::handleFileData, this, std::placeholders::_1)
+        );
+  fileClient_.done().connect
+      (
+        std::bind(&AnalyzeClient::handleHttpResponse, this, std::placeholders::_1, std::placeholders::_2)
+        );
+
+  // the stream is not stored, but processed as it arrives
+  streamClient_.setMaximumResponseSize(0);
+  streamClient_.setTimeout(std::chrono::seconds{24*3600});
+
+  streamClient_.bodyDataReceived().connect
+      (
+        std::bind(&AnalyzeClient::handleStreamData, this, std::placeholders::_1)
+        );
+  streamClient_.done().connect
+      (
+        std::bind(&AnalyzeClient::handleStreamEnd, this, std::placeholders::_1, std::placeholders::_2)
+        );
+
   ioService_.start();
 }
 
@@ -322,6 +552,7 @@ AnalyzeClient::AnalyzeClient(
 
 AnalyzeClient::~AnalyzeClient()
 {
+  unsubscribeStatus();
   ioService_.stop();
 }
 
@@ -340,6 +571,7 @@ void AnalyzeClient::forgetRequest()
 {
   boost::lock_guard<boost::mutex> mxg(mx_);
   crq_=None;
+  resultTransfer_.reset();
 }
 
 
@@ -447,6 +679,44 @@ void AnalyzeClient::queryStatus(AnalyzeClient::QueryStatusCallback onStatusAvail
 
 
 
+void AnalyzeClient::subscribeStatus(AnalyzeClient::QueryStatusCallback onStatusChange)
+{
+  boost::lock_guard<boost::mutex> lock(streamMx_);
+
+  if (streamCallback_)
+    throw insight::Exception("There is already a subscription to the event stream!");
+
+  std::vector<Wt::Http::Message::Header> headers;
+  if (!lastEventId_.empty())
+  {
+    headers.push_back(Wt::Http::Message::Header("Last-Event-ID", lastEventId_));
+  }
+
+  streamCallback_=onStatusChange;
+  streamBuffer_.clear();
+  if (!streamClient_.get(url_+"/stream", headers))
+  {
+    streamCallback_=QueryStatusCallback();
+    throw insight::Exception("Could not subscribe to the event stream of remote analysis!");
+  }
+}
+
+
+
+
+void AnalyzeClient::unsubscribeStatus()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(streamMx_);
+    if (!streamCallback_) return;
+    streamCallback_=QueryStatusCallback();
+  }
+  streamClient_.abort();
+}
+
+
+
+
 void AnalyzeClient::kill(AnalyzeClient::ReportSuccessCallback onCompletion)
 {
   controlRequest("kill", onCompletion);
@@ -486,4 +756,142 @@ void AnalyzeClient::queryResults(AnalyzeClient::QueryResultsCallback onResultsAv
 
 
 
+void AnalyzeClient::queryResultsInParts(
+    QueryResultsCallback onSkeletonAvailable,
+    ResultFileCallback onFileReceived,
+    ReportSuccessCallback onCompletion,
+    bool compress )
+{
+  boost::lock_guard<boost::mutex> mxg(mx_);
+
+  if (crq_!=None)
+    throw insight::Exception("There is an unfinished request!");
+
+  resultTransfer_.reset(new ResultTransfer);
+  resultTransfer_->currentFile=0;
+  resultTransfer_->failedAttempts=0;
+  resultTransfer_->failed=false;
+  resultTransfer_->compress=compress;
+  resultTransfer_->onFileReceived=onFileReceived;
+  resultTransfer_->onCompletion=onCompletion;
+
+  crq_=QueryResultSkeleton;
+  currentCallback_=onSkeletonAvailable;
+  if (!httpClient_.get(url_+"/results/skeleton"))
+  {
+    crq_=None;
+    resultTransfer_.reset();
+    throw insight::Exception("Could not query results of remote analysis!");
+  }
+}
+
+
+
+
+void AnalyzeClient::handleFileHeaders(const Wt::Http::Message& response)
+{
+  boost::lock_guard<boost::mutex> lock(mx_);
+
+  if (!resultTransfer_) return; // forgotten
+
+  auto& rt = *resultTransfer_;
+  rt.status = response.status();
+  rt.expectedSize = 0;
+  if (const auto *cs = response.getHeader("X-Content-Size"))
+  {
+    try
+    {
+      rt.expectedSize = boost::lexical_cast<size_t>(*cs);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+      rt.status = 0; // ignore the data
+    }
+  }
+}
+
+
+
+
+void AnalyzeClient::handleFileData(const std::string& data)
+{
+  boost::lock_guard<boost::mutex> lock(mx_);
+
+  if (!resultTransfer_) return; // forgotten
+
+  auto& rt = *resultTransfer_;
+  if (rt.status==200 && rt.part.is_open())
+  {
+    rt.part.write(data.data(), data.size());
+  }
+}
+
+
+
+
+void AnalyzeClient::requestNextResultFile()
+{
+  boost::unique_lock<boost::mutex> lock(mx_);
+
+  if (!resultTransfer_) return; // forgotten
+
+  auto& rt = *resultTransfer_;
+
+  if (!rt.failed && rt.currentFile < rt.filePaths.size())
+  {
+    if (!rt.partFile)
+    {
+      rt.partFile.reset(new TemporaryFile("result-%%%%-%%%%-%%%%.part"));
+    }
+    rt.offset = boost::filesystem::exists(rt.partFile->path()) ?
+          boost::filesystem::file_size(rt.partFile->path()) : 0;
+    rt.part.open(rt.partFile->path().c_str(), std::ios::binary|std::ios::app);
+    rt.status = 0;
+    rt.expectedSize = 0;
+
+    std::string url =
+        url_+"/results/file?path="
+        + Wt::Utils::urlEncode(rt.filePaths[rt.currentFile]);
+    if (rt.compress)
+    {
+      url+="&compression=gzip";
+    }
+    if (rt.offset>0)
+    {
+      url+="&offset="+std::to_string(rt.offset);
+    }
+
+    if (rt.part && fileClient_.get(url))
+    {
+      return;
+    }
+    rt.part.close();
+    rt.partFile.reset();
+    rt.failed=true;
+  }
+
+  // finished: the completion handler may issue further requests
+  bool success = !rt.failed;
+  auto onCompletion = rt.onCompletion;
+  resultTransfer_.reset();
+  crq_=None;
+  lock.unlock();
+
+  try
+  {
+    onCompletion(success);
+  }
+  catch (const std::exception&)
+  {
+    auto ex = std::current_exception();
+    if (exHdlr_)
+      exHdlr_(ex);
+    else
+      std::rethrow_exception(ex);
+  }
+}
+
+
+
+
 }
@@ -31,13 +31,16 @@
 #endif
 
 #include <string>
+#include <memory>
 #include <system_error>
 #include <queue>
+#include <fstream>
 #include <condition_variable>
 
 #include "base/parameterset.h"
 #include "base/resultset.h"
 #include "base/progressdisplayer.h"
+#include "base/tools.h"
 #include "boost/variant.hpp"
 
 
@@ -78,6 +81,8 @@ public:
     SimpleRequest,
     QueryStatus,
     QueryResults,
+    QueryResultSkeleton,
+    QueryResultFile,
     QueryExepath
   }
   CurrentRequestType;
@@ -91,6 +96,9 @@ public:
   // success flag, result data
   typedef std::function<void(bool, ResultSetPtr)> QueryResultsCallback;
 
+  // element path, file content
+  typedef std::function<void(const std::string&, std::shared_ptr<std::string>)> ResultFileCallback;
+
   // success flag, path
   typedef std::function<void(bool, boost::filesystem::path)> QueryExepathCallback;
 
@@ -118,10 +126,48 @@ protected:
 
   insight::ProgressDisplayer* progressDisplayer_;
 
+  // state of a transfer of the results in parts
+  struct ResultTransfer
+  {
+    std::vector<std::string> filePaths;
+    size_t currentFile;
+    int failedAttempts;
+    bool failed;
+    bool compress;
+    ResultFileCallback onFileReceived;
+    ReportSuccessCallback onCompletion;
+
+    // received part of the current file, kept until the transfer is complete
+    std::unique_ptr<TemporaryFile> partFile;
+    std::ofstream part;
+    size_t offset; // size of the part file, when the current request was issued
+    int status;
+    size_t expectedSize; // of the transferred (possibly compressed) data
+  };
+  std::unique_ptr<ResultTransfer> resultTransfer_;
+
+  // transfer of result files: the received data is not stored
+  // in the message, but appended to the part file of the result transfer
+  Wt::Http::Client fileClient_;
+
+  // subscription to the event stream of the server
+  Wt::Http::Client streamClient_;
+  boost::mutex streamMx_;
+  QueryStatusCallback streamCallback_;
+  std::string streamBuffer_, lastEventId_;
+
   void controlRequest(const std::string& action, AnalyzeClient::ReportSuccessCallback onCompletion);
 
   void handleHttpResponse(boost::system::error_code err, const Wt::Http::Message& response);
 
+  void requestNextResultFile();
+  void handleFileHeaders(const Wt::Http::Message& response);
+  void handleFileData(const std::string& data);
+
+  void displayProgress(const Wt::Json::Object& payload);
+  void handleStreamData(const std::string& data);
+  void handleStreamEnd(boost::system::error_code err, const Wt::Http::Message& response);
+
 public:
   AnalyzeClient(
       const std::string analysisName,
@@ -150,6 +196,18 @@ public:
 
   void queryStatus( QueryStatusCallback onStatusAvailable );
 
+  /**
+   * Follow the progress through the event stream of the server,
+   * instead of polling with queryStatus.
+   * The progress is passed to the progress displayer as soon as it arrives.
+   * onStatusChange is called with the results availability flag
+   * at each status change, and with a false success flag, when the stream ends.
+   * A repeated subscription continues after the last received event.
+   * The callbacks are executed in the thread of the HTTP client.
+   */
+  void subscribeStatus( QueryStatusCallback onStatusChange );
+  void unsubscribeStatus();
+
   void kill( ReportSuccessCallback onCompletion );
   void exit( ReportSuccessCallback onCompletion );
   void wnow( ReportSuccessCallback onCompletion );
@@ -157,6 +215,23 @@ public:
 
   void queryResults( QueryResultsCallback onResultsAvailable );
 
+  /**
+   * Fetches the results in parts: first the result set without any file contents,
+   * which is passed to onSkeletonAvailable, then the contents of the file elements
+   * one after another. The skeleton is not modified here, the consumer inserts the
+   * received contents (FileContainer::replaceContentBuffer).
+   * The received data of each file is written into a temporary part file.
+   * An interrupted transfer is resumed after the received part,
+   * it is given up after a few attempts without progress.
+   * onCompletion is called after the last file, it is not called,
+   * if the skeleton could not be fetched.
+   */
+  void queryResultsInParts(
+      QueryResultsCallback onSkeletonAvailable,
+      ResultFileCallback onFileReceived,
+      ReportSuccessCallback onCompletion,
+      bool compress = true );
+
 };
 
 
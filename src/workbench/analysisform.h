@@ -266,6 +266,8 @@ private Q_SLOTS:
   // ================================================================================
   // ===== error handling
   void onResultReady(insight::ResultSetPtr);
+  void onResultSkeletonReady(insight::ResultSetPtr);
+  void onResultFileReceived(const QString& path, std::shared_ptr<std::string> content);
   void onAnalysisError(std::exception_ptr e);
   void onAnalysisCancelled();
 
@@ -6,6 +6,7 @@
 
 #include "base/remotelocation.h"
 #include "base/remoteexecution.h"
+#include "base/filecontainer.h"
 #include "openfoam/ofes.h"
 
 #include "remoteparaview.h"
@@ -112,10 +113,22 @@ void AnalysisForm::onKillAnalysis()
 
 void AnalysisForm::onResultReady(insight::ResultSetPtr results)
 {
-  results_=results;
-
   currentWorkbenchAction_.reset();
 
+  if (results!=results_) // otherwise already displayed in parts
+  {
+    onResultSkeletonReady(results);
+  }
+
+
+  QMessageBox::information(this, "Finished!", "The analysis has finished");
+
+}
+
+void AnalysisForm::onResultSkeletonReady(insight::ResultSetPtr results)
+{
+  results_=results;
+
   resultsModel_=new insight::QResultSetModel(results_, ui->resultsToC);
   ui->resultsToC->setModel(resultsModel_);
   ui->resultsToC->expandAll();
@@ -123,12 +136,26 @@ void AnalysisForm::onResultReady(insight::ResultSetPtr results)
   ui->resultsToC->resizeColumnToContents(1);
 
   ui->tabWidget->setCurrentWidget(ui->outputTab);
+}
 
 
-  QMessageBox::information(this, "Finished!", "The analysis has finished");
 
+
+void AnalysisForm::onResultFileReceived(const QString& path, std::shared_ptr<std::string> content)
+{
+  if (!results_) return;
+
+  auto p = path.toStdString();
+  if (auto *fc = dynamic_cast<insight::FileContainer*>(&results_->get<insight::ResultElement>(p)))
+  {
+    fc->replaceContentBuffer(content);
+    resultsModel_->updateElement(p);
+  }
 }
 
+
+
+
 void AnalysisForm::onAnalysisError(std::__exception_ptr::exception_ptr e)
 {
   currentWorkbenchAction_.reset();
@@ -8,6 +8,7 @@
 
 #include <boost/chrono.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include "boost/process.hpp"
 
 using namespace std;
@@ -79,7 +80,61 @@ RemoteRun::RemoteRun(AnalysisForm *af, bool resume)
           launchRemoteAnalysisServer();
 
 
-          auto monitor = [this]
+          // the result set is displayed first, the files are filled in as they arrive
+          auto fetchResults = [this]
+          {
+            auto skeleton = std::make_shared<insight::ResultSetPtr>();
+
+            ac_->queryResultsInParts(
+
+                [this,skeleton](bool success, insight::ResultSetPtr results)
+                {
+                    if (!success)
+                    {
+                      throw insight::Exception("Failed to fetch results!");
+                    }
+                    else
+                    {
+                      *skeleton=results;
+                      Q_EMIT resultSkeletonReady( results );
+                    }
+                },
+
+                [this](const std::string& path, std::shared_ptr<std::string> content)
+                {
+                    Q_EMIT resultFileReceived( QString::fromStdString(path), content );
+                },
+
+                [this,skeleton](bool success)
+                {
+                    if (!success)
+                    {
+                      throw insight::Exception("Failed to fetch result files!");
+                    }
+                    else
+                    {
+                      Q_EMIT finished( *skeleton );
+
+                      ac_->exit(
+                            [this](bool success)
+                            {
+                              if (!success)
+                              {
+                                throw insight::Exception("Failed to stop remote server!");
+                              }
+                              else
+                              {
+                                remote_.cleanup();
+                              }
+                            }
+                      );
+                    }
+                }
+            );
+          };
+
+          // fallback for servers without event stream
+          auto pollStatus = [this]
           {
             std::atomic<bool> runMonitor(true);
 
@@ -94,41 +149,9 @@ RemoteRun::RemoteRun(AnalysisForm *af, bool resume)
                     {
                       Q_EMIT statusMessage( "Failed to query status!" );
                     }
-                    else
+                    else if (resultsavail)
                     {
-                      if (resultsavail)
-                      {
-                        runMonitor=false;
-
-                        ac_->queryResults(
-
-                            [this](bool success, insight::ResultSetPtr results)
-                            {
-                                if (!success)
-                                {
-                                  throw insight::Exception("Failed to fetch results!");
-                                }
-                                else
-                                {
-                                  Q_EMIT finished( results );
-
-                                  ac_->exit(
-                                        [this](bool success)
-                                        {
-                                          if (!success)
-                                          {
-                                            throw insight::Exception("Failed to stop remote server!");
-                                          }
-                                          else
-                                          {
-                                            remote_.cleanup();
-                                          }
-                                        }
-                                  );
-                                }
-                            }
-                        );
-                      }
+                      runMonitor=false;
                     }
                   }
                 );
@@ -136,6 +159,76 @@ RemoteRun::RemoteRun(AnalysisForm *af, bool resume)
 
               boost::this_thread::sleep_for(boost::chrono::milliseconds(1000));
             }
+
+            while (ac_->isBusy())
+            {
+              boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+            }
+          };
+
+          // follow the event stream of the server until the results are available
+          auto monitor = [this,&fetchResults,&pollStatus]
+          {
+            boost::mutex m;
+            boost::condition_variable cv;
+            bool resultsAvailable=false, streamEnded=false, streamReceived=false;
+
+            try
+            {
+              while (!resultsAvailable)
+              {
+                {
+                  boost::mutex::scoped_lock lck(m);
+                  streamEnded=false;
+                }
+
+                ac_->subscribeStatus(
+                  [&](bool success, bool resultsavail)
+                  {
+                    boost::mutex::scoped_lock lck(m);
+                    if (success)
+                    {
+                      streamReceived=true;
+                      resultsAvailable=resultsavail;
+                    }
+                    else
+                    {
+                      streamEnded=true;
+                    }
+                    cv.notify_all();
+                  }
+                );
+
+                boost::mutex::scoped_lock lck(m);
+                while (!(resultsAvailable || streamEnded))
+                {
+                  cv.wait(lck);
+                }
+
+                if (!resultsAvailable)
+                {
+                  if (!streamReceived)
+                  {
+                    lck.unlock();
+                    pollStatus();
+                    break;
+                  }
+
+                  // reconnect, continues after the last received event
+                  lck.unlock();
+                  Q_EMIT statusMessage( "Lost connection to event stream, reconnecting." );
+                  boost::this_thread::sleep_for(boost::chrono::milliseconds(1000));
+                }
+              }
+            }
+            catch (...)
+            {
+              ac_->unsubscribeStatus();
+              throw;
+            }
+            ac_->unsubscribeStatus();
+
+            fetchResults();
           };
 
 
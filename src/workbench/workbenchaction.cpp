@@ -32,6 +32,14 @@ WorkbenchAction::WorkbenchAction(AnalysisForm *af)
           af_, &AnalysisForm::onResultReady,
           Qt::QueuedConnection);
 
+  connect(this, &WorkbenchAction::resultSkeletonReady,
+          af_, &AnalysisForm::onResultSkeletonReady,
+          Qt::QueuedConnection);
+
+  connect(this, &WorkbenchAction::resultFileReceived,
+          af_, &AnalysisForm::onResultFileReceived,
+          Qt::QueuedConnection);
+
   connect(this, &WorkbenchAction::failed,
           af_, &AnalysisForm::onAnalysisError,
           Qt::QueuedConnection);
@@ -36,6 +36,11 @@ Q_SIGNALS:
   void statusMessage(const QString& msg);
 
   void finished(insight::ResultSetPtr results);
+
+  // results, which are transferred in parts:
+  // the result set without file contents first, then the single files
+  void resultSkeletonReady(insight::ResultSetPtr skeleton);
+  void resultFileReceived(const QString& path, std::shared_ptr<std::string> content);
   void failed(std::exception_ptr e);
   void cancelled();
 };